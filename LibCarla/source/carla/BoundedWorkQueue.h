@@ -0,0 +1,171 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Logging.h" // 记录任务中抛出的异常
+#include "carla/NonCopyable.h" // 确保队列不可拷贝
+
+#include <algorithm> // std::max
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace carla {
+
+  /// 由固定数量的后台线程执行任务的有界队列，用于把磁盘写入等耗时操作
+  /// 移出传感器回调线程。
+  ///
+  /// 队列满时，根据构造参数阻塞提交者（背压）或者丢弃新任务。析构时
+  /// 会先执行完队列中剩余的任务再结束线程。
+  class BoundedWorkQueue : private NonCopyable {
+  public:
+
+    /// 队列的统计信息，用于观察背压情况。
+    struct Stats {
+      size_t submitted = 0u;   ///< 被接受的任务数
+      size_t completed = 0u;   ///< 已执行完的任务数（包括失败的任务）
+      size_t failed = 0u;      ///< 抛出异常的任务数
+      size_t dropped = 0u;     ///< 因队列已满被丢弃的任务数
+      size_t blocked = 0u;     ///< 因队列已满而阻塞过的提交次数
+      size_t pending = 0u;     ///< 尚未执行完的任务数
+      size_t max_pending = 0u; ///< 队列中同时等待的最大任务数
+    };
+
+    BoundedWorkQueue(
+        size_t number_of_threads,
+        size_t capacity,
+        bool block_when_full = true)
+      : _capacity(std::max<size_t>(capacity, 1u)),
+        _block_when_full(block_when_full) {
+      number_of_threads = std::max<size_t>(number_of_threads, 1u);
+      _threads.reserve(number_of_threads);
+      for (size_t i = 0u; i < number_of_threads; ++i) {
+        _threads.emplace_back([this]() { Run(); });
+      }
+    }
+
+    /// 执行完剩余任务后合并所有线程。
+    ~BoundedWorkQueue() {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done = true;
+      }
+      _not_empty.notify_all();
+      _not_full.notify_all();
+      for (auto &thread : _threads) {
+        if (thread.joinable()) {
+          thread.join();
+        }
+      }
+    }
+
+    /// 提交一个任务。队列已满且不阻塞时丢弃任务并返回 false。
+    bool Push(std::function<void()> task) {
+      std::unique_lock<std::mutex> lock(_mutex);
+      if (_queue.size() >= _capacity) {
+        if (!_block_when_full) {
+          ++_stats.dropped;
+          return false;
+        }
+        ++_stats.blocked;
+        _not_full.wait(lock, [this]() { return _queue.size() < _capacity || _done; });
+        if (_done) {
+          return false;
+        }
+      }
+      _queue.emplace_back(std::move(task));
+      ++_stats.submitted;
+      ++_stats.pending;
+      _stats.max_pending = std::max(_stats.max_pending, _queue.size());
+      lock.unlock();
+      _not_empty.notify_one();
+      return true;
+    }
+
+    /// 阻塞直到所有已提交的任务执行完毕。
+    void Flush() {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _idle.wait(lock, [this]() { return _stats.pending == 0u; });
+    }
+
+    Stats GetStats() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _stats;
+    }
+
+    size_t GetCapacity() const {
+      return _capacity;
+    }
+
+    size_t GetNumberOfThreads() const {
+      return _threads.size();
+    }
+
+  private:
+
+    void Run() {
+      for (;;) {
+        std::function<void()> task;
+        {
+          std::unique_lock<std::mutex> lock(_mutex);
+          _not_empty.wait(lock, [this]() { return !_queue.empty() || _done; });
+          if (_queue.empty()) {
+            return; // _done 且没有剩余任务
+          }
+          task = std::move(_queue.front());
+          _queue.pop_front();
+        }
+        _not_full.notify_one();
+        bool failed = false;
+        try {
+          task();
+        } catch (const std::exception &e) {
+          log_error("BoundedWorkQueue: task failed:", e.what());
+          failed = true;
+        } catch (...) {
+          log_error("BoundedWorkQueue: task failed with unknown exception");
+          failed = true;
+        }
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          ++_stats.completed;
+          _stats.failed += failed ? 1u : 0u;
+          --_stats.pending;
+          if (_stats.pending == 0u) {
+            _idle.notify_all();
+          }
+        }
+      }
+    }
+
+    const size_t _capacity;
+
+    const bool _block_when_full;
+
+    mutable std::mutex _mutex;
+
+    std::condition_variable _not_empty;
+
+    std::condition_variable _not_full;
+
+    std::condition_variable _idle;
+
+    std::deque<std::function<void()>> _queue;
+
+    Stats _stats;
+
+    bool _done = false;
+
+    std::vector<std::thread> _threads;
+  };
+
+} // namespace carla
@@ -7,6 +7,7 @@
 #pragma once  // 确保此头文件只被包含一次
 
 #include "carla/Buffer.h"  // 包含 Buffer 头文件，定义 Buffer 类
+#include "carla/profiler/Metrics.h"
 
 #if defined(__clang__)  // 检查是否使用 Clang 编译器
 #  pragma clang diagnostic push   // 保存当前的编译警告状态
@@ -33,10 +34,18 @@ namespace carla {
 
     explicit BufferPool(size_t estimated_size) : _queue(estimated_size) {}  // 带参数的构造函数，初始化队列大小
 
+    ~BufferPool() {
+      GetMetrics().discarded.Increment(_queue.size_approx());
+    }
+
   /// 从队列中弹出一个缓冲区，如果队列为空，则创建一个新的缓冲区。
     Buffer Pop() {
       Buffer item; // 创建一个 Buffer 实例
-      _queue.try_dequeue(item); // 尝试从队列中弹出，失败则不处理
+      auto &metrics = GetMetrics();
+      metrics.pops.Increment();
+      if (_queue.try_dequeue(item)) { // 尝试从队列中弹出，失败则不处理
+        metrics.reused.Increment();
+      }
 #if __cplusplus >= 201703L // 检查是否支持 C++17
       item._parent_pool = weak_from_this();  // 设置父池为弱引用
 #else
@@ -50,9 +59,50 @@ namespace carla {
     friend class Buffer;  // 允许 Buffer 类访问私有成员
 
     void Push(Buffer &&buffer) {  // 定义 Push 方法，接受一个右值引用的 Buffer
+      // 先计数再入队，导出时已复用的数不会超过归还的数
+      GetMetrics().returned.Increment();
       _queue.enqueue(std::move(buffer));  // 将 Buffer 移动到队列中
     }
 
+    /// 所有缓冲区池共用的指标。池中的缓冲区数在导出时由计数器得出
+    /// （归还的数减去复用的和随池销毁的），Push 和 Pop 只做整数加法。
+    struct Metrics {
+      profiler::MetricCounter &pops;
+      profiler::MetricCounter &reused;
+      profiler::MetricCounter &returned;
+      profiler::MetricCounter &discarded;
+    };
+
+    static Metrics &GetMetrics() {
+      static Metrics metrics = MakeMetrics();
+      return metrics;
+    }
+
+    static Metrics MakeMetrics() {
+      auto &registry = profiler::MetricsRegistry::Get();
+      Metrics metrics{
+          registry.GetCounter(
+              "carla_buffer_pool_pops_total", "Buffers requested from buffer pools."),
+          registry.GetCounter(
+              "carla_buffer_pool_reused_total", "Buffers requested from buffer pools that reused pooled memory."),
+          registry.GetCounter(
+              "carla_buffer_pool_returned_total", "Buffers returned to buffer pools."),
+          registry.GetCounter(
+              "carla_buffer_pool_discarded_total", "Pooled buffers freed together with their buffer pool.")};
+      auto &reused = metrics.reused;
+      auto &returned = metrics.returned;
+      auto &discarded = metrics.discarded;
+      registry.GetDerivedGauge(
+          "carla_buffer_pool_pooled_buffers", "Buffers currently waiting in buffer pools.", "",
+          [&reused, &returned, &discarded]() {
+            // 先读减数再读被减数，并发更新时结果只会略偏大而不会为负
+            const uint64_t taken = reused.Get() + discarded.Get();
+            const uint64_t total = returned.Get();
+            return total > taken ? static_cast<double>(total - taken) : 0.0;
+          });
+      return metrics;
+    }
+
     moodycamel::ConcurrentQueue<Buffer> _queue;  // 定义并发队列用于存储 Buffer
   };
 
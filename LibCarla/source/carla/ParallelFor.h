@@ -0,0 +1,131 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/ThreadPool.h" // 复用基于 Boost.Asio 的线程池
+
+#include <algorithm> // std::min
+#include <atomic> // 原子计数器，用于分块的动态领取
+#include <condition_variable> // 调用线程等待所有分块完成
+#include <cstddef>
+#include <exception> // 在调用线程中重新抛出工作线程的异常
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace carla {
+
+  /// 进程内共享的工作线程池，所有 ParallelFor 调用复用同一组线程，
+  /// 避免每次调用都临时创建 std::thread。
+  inline ThreadPool &GetSharedThreadPool() {
+    static ThreadPool pool;
+    static std::once_flag started;
+    std::call_once(started, []() {
+      const size_t hardware = std::thread::hardware_concurrency();
+      // 调用线程本身也参与计算，因此少启动一个工作线程
+      pool.AsyncRun(hardware > 1u ? hardware - 1u : 1u);
+    });
+    return pool;
+  }
+
+  /// 共享线程池可用的并行度（包括调用线程本身）。
+  inline size_t GetParallelism() {
+    const size_t hardware = std::thread::hardware_concurrency();
+    return hardware > 0u ? hardware : 1u;
+  }
+
+namespace detail {
+
+  /// ParallelFor 的共享状态。工作线程可能在调用返回之后才被调度，
+  /// 所以状态由 shared_ptr 持有；只有领取到有效分块的线程才会访问 body。
+  struct ParallelForState {
+    std::function<void(size_t, size_t)> body;
+    size_t count = 0u;
+    size_t grain = 1u;
+    size_t number_of_chunks = 0u;
+    std::atomic_size_t next_chunk{0u};
+    std::atomic_size_t finished_chunks{0u};
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr exception;
+
+    /// 反复领取下一个未处理的分块，直到没有剩余分块为止（简单的工作窃取）。
+    void Work() {
+      for (;;) {
+        const size_t chunk = next_chunk.fetch_add(1u);
+        if (chunk >= number_of_chunks) {
+          return;
+        }
+        const size_t begin = chunk * grain;
+        const size_t end = std::min(count, begin + grain);
+        try {
+          body(begin, end);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (exception == nullptr) {
+            exception = std::current_exception();
+          }
+        }
+        if (finished_chunks.fetch_add(1u) + 1u == number_of_chunks) {
+          std::lock_guard<std::mutex> lock(mutex);
+          done.notify_all();
+        }
+      }
+    }
+  };
+
+} // namespace detail
+
+  /// 将区间 [0, @a count) 切分为大小为 @a grain 的分块，并在共享线程池上
+  /// 并行执行 @a body(begin, end)。调用线程同样参与领取分块，因此即使在
+  /// 线程池的工作线程中嵌套调用也不会死锁。每个分块写入自己的输出区间时，
+  /// 结果与线程数量无关。
+  ///
+  /// 若任一分块抛出异常，等待所有分块结束后在调用线程中重新抛出第一个异常。
+  template <typename FunctorT>
+  void ParallelFor(size_t count, FunctorT &&body, size_t grain = 1u) {
+    if (count == 0u) {
+      return;
+    }
+    grain = std::max<size_t>(grain, 1u);
+    const size_t number_of_chunks = (count + grain - 1u) / grain;
+    if (number_of_chunks == 1u || GetParallelism() == 1u) {
+      body(size_t(0u), count);
+      return;
+    }
+
+    auto state = std::make_shared<detail::ParallelForState>();
+    state->body = [&body](size_t begin, size_t end) { body(begin, end); };
+    state->count = count;
+    state->grain = grain;
+    state->number_of_chunks = number_of_chunks;
+
+    auto &pool = GetSharedThreadPool();
+    const size_t helpers = std::min(number_of_chunks, GetParallelism()) - 1u;
+    for (size_t i = 0u; i < helpers; ++i) {
+      pool.Post([state]() { state->Work(); });
+    }
+    state->Work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&]() {
+      return state->finished_chunks.load() == state->number_of_chunks;
+    });
+    if (state->exception != nullptr) {
+      std::rethrow_exception(state->exception);
+    }
+  }
+
+  /// 根据元素数量和并行度计算一个合适的分块大小，
+  /// 使每个线程大约领取 @a chunks_per_thread 个分块。
+  inline size_t ComputeGrainSize(size_t count, size_t chunks_per_thread = 4u) {
+    const size_t chunks = GetParallelism() * chunks_per_thread;
+    return std::max<size_t>(1u, (count + chunks - 1u) / chunks);
+  }
+
+} // namespace carla
@@ -12,6 +12,9 @@
 #  include <fnmatch.h>   // POSIX 标准的头文件，用于模式匹配
 #endif // _WIN32
 
+#include <algorithm>
+#include <cstring>
+
 namespace carla {
 // 实现字符串匹配功能
   bool StringUtil::Match(const char *str, const char *test) {
@@ -24,4 +27,75 @@ namespace carla {
 #endif // _WIN32
   }
 
+  WildcardPattern::WildcardPattern(std::string pattern)
+    : _pattern(std::move(pattern)) {
+#ifdef _WIN32
+    // PathMatchSpecA 不区分大小写且支持 ';' 分隔的多个模式，直接交给它处理
+    _use_fallback = true;
+#else
+    _use_fallback = _pattern.find_first_of("?[\\") != std::string::npos;
+#endif // _WIN32
+    if (_use_fallback) {
+      return;
+    }
+    _has_wildcard = _pattern.find('*') != std::string::npos;
+    if (!_has_wildcard) {
+      return;
+    }
+    _leading_wildcard = _pattern.front() == '*';
+    _trailing_wildcard = _pattern.back() == '*';
+    // 连续的 '*' 等价于单个 '*'，因此丢弃空片段
+    size_t begin = 0u;
+    while (begin < _pattern.size()) {
+      const size_t end = std::min(_pattern.find('*', begin), _pattern.size());
+      if (end > begin) {
+        _segments.emplace_back(_pattern, begin, end - begin);
+      }
+      begin = end + 1u;
+    }
+  }
+
+  bool WildcardPattern::Match(const char *str, const size_t length) const {
+    if (_use_fallback) {
+      return StringUtil::Match(std::string(str, length).c_str(), _pattern.c_str());
+    }
+    if (!_has_wildcard) {
+      return (length == _pattern.size()) &&
+             (std::memcmp(str, _pattern.data(), length) == 0);
+    }
+    const char *begin = str;
+    const char *end = str + length;
+    auto first = _segments.begin();
+    auto last = _segments.end();
+    // 第一个片段必须出现在开头
+    if (!_leading_wildcard) {
+      const size_t size = first->size();
+      if (static_cast<size_t>(end - begin) < size ||
+          std::memcmp(begin, first->data(), size) != 0) {
+        return false;
+      }
+      begin += size;
+      ++first;
+    }
+    // 最后一个片段必须出现在结尾
+    if (!_trailing_wildcard && first != last) {
+      const size_t size = (last - 1)->size();
+      if (static_cast<size_t>(end - begin) < size ||
+          std::memcmp(end - size, (last - 1)->data(), size) != 0) {
+        return false;
+      }
+      end -= size;
+      --last;
+    }
+    // 中间的片段按顺序贪心查找最早出现的位置
+    for (; first != last; ++first) {
+      const char *found = std::search(begin, end, first->begin(), first->end());
+      if (found == end) {
+        return false;
+      }
+      begin = found + first->size();
+    }
+    return true;
+  }
+
 } // namespace carla
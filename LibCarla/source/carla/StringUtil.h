@@ -9,6 +9,9 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <string>
+#include <vector>
+
 namespace carla {
 // 定义名为 StringUtil 的类，用于提供各种字符串处理工具方法
   class StringUtil {
@@ -90,4 +93,43 @@ namespace carla {
     }
   };
 
+  /// 预编译的 Unix shell 风格通配符模式，可在多次匹配之间复用。
+  ///
+  /// 只包含 '*' 的模式（如 "vehicle.*"、"*walker*"）在构造时拆分为字面
+  /// 片段，匹配时直接比较，不再调用 fnmatch；包含 '?'、'[' 或转义符的模式，
+  /// 以及 Windows 上的所有模式，仍交给 StringUtil::Match 以保持原有语义。
+  class WildcardPattern {
+  public:
+
+    WildcardPattern() = default;
+
+    explicit WildcardPattern(std::string pattern);
+
+    const std::string &GetPattern() const {
+      return _pattern;
+    }
+
+    bool Match(const char *str, size_t length) const;
+
+    bool Match(const std::string &str) const {
+      return Match(str.data(), str.size());
+    }
+
+  private:
+
+    std::string _pattern;
+
+    /// 以 '*' 分隔的非空字面片段。
+    std::vector<std::string> _segments;
+
+    bool _has_wildcard = false;
+
+    bool _leading_wildcard = false;
+
+    bool _trailing_wildcard = false;
+
+    /// 模式无法按字面片段匹配，退回到 StringUtil::Match。
+    bool _use_fallback = false;
+  };
+
 } // namespace carla
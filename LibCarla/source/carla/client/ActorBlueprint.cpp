@@ -57,6 +57,14 @@ namespace client {
           return StringUtil::Match(tag, wildcard_pattern);
         });
   }
+
+  bool ActorBlueprint::MatchTags(const WildcardPattern &wildcard_pattern) const {
+    return
+        wildcard_pattern.Match(_id) ||
+        std::any_of(_tags.begin(), _tags.end(), [&](const auto &tag) {
+          return wildcard_pattern.Match(tag);
+        });
+  }
   // 函数：GetAttribute
   // 作用：根据指定的属性 id 获取 ActorBlueprint 对象中的 ActorAttribute
   // 参数：
@@ -8,6 +8,7 @@
 
 #include "carla/Debug.h"// 包含CARLA调试工具
 #include "carla/Iterator.h"// 包含CARLA迭代器工具
+#include "carla/StringUtil.h"// 包含预编译的通配符模式
 #include "carla/client/ActorAttribute.h"// 包含CARLA客户端参与者属性
 #include "carla/rpc/ActorDefinition.h"// 包含CARLA远程过程调用参与者定义
 #include "carla/rpc/ActorDescription.h"// 包含CARLA远程过程调用参与者描述
@@ -59,6 +60,9 @@ namespace client {
     /// @a wildcard_pattern 遵循 Unix shell 风格的通配符。
     bool MatchTags(const std::string &wildcard_pattern) const;// 检查是否有标签匹配通配符模式
 
+    /// 与上面相同，但使用预编译的通配符模式，适合对多个蓝图重复匹配。
+    bool MatchTags(const WildcardPattern &wildcard_pattern) const;
+
     std::vector<std::string> GetTags() const {
       return {_tags.begin(), _tags.end()};
     }
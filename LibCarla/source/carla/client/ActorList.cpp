@@ -8,8 +8,11 @@
 
 #include "carla/StringUtil.h" // 引入字符串工具类的头文件
 #include "carla/client/detail/ActorFactory.h" // 引入参与者工厂类的头文件
+#include "carla/client/detail/Simulator.h"
 
+#include <algorithm>
 #include <iterator> // 引入迭代器相关的标准库
+#include <unordered_map>
 
 namespace carla {
 namespace client {
@@ -30,15 +33,99 @@ namespace client {
   }
 
   SharedPtr<ActorList> ActorList::Filter(const std::string &wildcard_pattern) const { // 根据通配符模式过滤参与者
-    SharedPtr<ActorList> filtered (new ActorList(_episode, {})); // 创建一个新的参与者列表用于存放过滤后的参与者
-    for (auto &&actor : _actors) { // 遍历所有参与者
-      if (StringUtil::Match(actor.GetTypeId(), wildcard_pattern)) { // 如果参与者类型与通配符匹配
-        filtered->_actors.push_back(actor); // 将匹配的参与者加入到过滤后的列表中
+    return Filter(WildcardPattern(wildcard_pattern)); // 只编译一次模式
+  }
+
+  SharedPtr<ActorList> ActorList::Filter(const WildcardPattern &wildcard_pattern) const {
+    const TypeIndex &index = GetTypeIndex();
+    std::vector<size_t> matches;
+    size_t matched_types = 0u;
+    for (size_t i = 0u; i < index.type_ids.size(); ++i) { // 每个类型 id 只匹配一次
+      if (wildcard_pattern.Match(index.type_ids[i])) {
+        matches.insert(
+            matches.end(),
+            index.positions.begin() + index.offsets[i],
+            index.positions.begin() + index.offsets[i + 1u]);
+        ++matched_types;
       }
     }
+    // 单个类型的分组本身有序，多个分组合并后需恢复列表顺序
+    if (matched_types > 1u) {
+      std::sort(matches.begin(), matches.end());
+    }
+    SharedPtr<ActorList> filtered (new ActorList(_episode, {})); // 创建一个新的参与者列表用于存放过滤后的参与者
+    filtered->_actors.reserve(matches.size());
+    for (const size_t pos : matches) {
+      filtered->_actors.push_back(_actors[pos]); // 将匹配的参与者加入到过滤后的列表中
+    }
     return filtered; // 返回过滤后的参与者列表
   }
 
+  const ActorList::TypeIndex &ActorList::GetTypeIndex() const {
+    std::call_once(_type_index_flag, [this]() {
+      // 为每个参与者分配其类型的分组编号，然后按分组做计数排序
+      std::unordered_map<std::string, size_t> groups;
+      std::vector<size_t> group_of_actor;
+      group_of_actor.reserve(_actors.size());
+      for (auto &&actor : _actors) {
+        const auto result = groups.emplace(actor.GetTypeId(), _type_index.type_ids.size());
+        if (result.second) {
+          _type_index.type_ids.push_back(actor.GetTypeId());
+        }
+        group_of_actor.push_back(result.first->second);
+      }
+      _type_index.offsets.assign(_type_index.type_ids.size() + 1u, 0u);
+      for (const size_t group : group_of_actor) {
+        ++_type_index.offsets[group + 1u];
+      }
+      for (size_t i = 1u; i < _type_index.offsets.size(); ++i) {
+        _type_index.offsets[i] += _type_index.offsets[i - 1u];
+      }
+      std::vector<size_t> next(_type_index.offsets.begin(), _type_index.offsets.end() - 1);
+      _type_index.positions.resize(_actors.size());
+      for (size_t pos = 0u; pos < group_of_actor.size(); ++pos) {
+        _type_index.positions[next[group_of_actor[pos]]++] = pos;
+      }
+    });
+    return _type_index;
+  }
+
+  ActorStateArrays ActorList::GetStateArrays() const {
+    std::vector<ActorId> ids;
+    ids.reserve(_actors.size());
+    for (auto &&actor : _actors) {
+      ids.push_back(actor.GetId());
+    }
+    ActorStateArrays arrays = _episode.Lock()->GetWorldSnapshot().GetActorStateArrays(ids);
+
+    // 状态数组保持列表顺序且只跳过缺失的参与者，按顺序对齐即可
+    arrays.bounding_boxes.reserve(6u * arrays.size());
+    arrays.type_indices.reserve(arrays.size());
+    std::unordered_map<std::string, uint32_t> type_index;
+    size_t next = 0u;
+    for (auto &&actor : _actors) {
+      if (next == arrays.size()) {
+        break;
+      }
+      if (actor.GetId() != arrays.ids[next]) {
+        continue;
+      }
+      ++next;
+      const auto &description = actor.Serialize();
+      const auto &box = description.bounding_box;
+      arrays.bounding_boxes.insert(arrays.bounding_boxes.end(), {
+          box.location.x, box.location.y, box.location.z,
+          box.extent.x, box.extent.y, box.extent.z});
+      const auto result = type_index.emplace(
+          actor.GetTypeId(), static_cast<uint32_t>(arrays.type_ids.size()));
+      if (result.second) {
+        arrays.type_ids.push_back(actor.GetTypeId());
+      }
+      arrays.type_indices.push_back(result.first->second);
+    }
+    return arrays;
+  }
+
 } // namespace client
 } // namespace carla
 
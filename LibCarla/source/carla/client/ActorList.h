@@ -6,10 +6,14 @@
 
 #pragma once // 确保该头文件只被包含一次
 
+#include "carla/StringUtil.h" // 引入预编译的通配符模式
+#include "carla/client/ActorStateArrays.h" // 引入批量状态数组定义
 #include "carla/client/detail/ActorVariant.h" // 引入 ActorVariant 类定义
 
 #include <boost/iterator/transform_iterator.hpp> // 引入 Boost 库中的 transform_iterator，用于创建变换迭代器
 
+#include <mutex> // std::once_flag，类型索引只构建一次
+#include <string>
 #include <vector> // 引入标准库中的 vector 容器，存储参与者数据
 
 namespace carla { // 开始 carla 命名空间
@@ -35,6 +39,14 @@ namespace client { // 开始 client 命名空间
     /// 根据提供的通配符模式（wildcard_pattern）过滤符合条件的参与者列表。
     SharedPtr<ActorList> Filter(const std::string &wildcard_pattern) const; // 根据通配符模式过滤参与者列表
 
+    /// 与上面相同，但使用预编译的通配符模式。模式只对每个不同的类型 id
+    /// 匹配一次，匹配类型的参与者直接取自预先构建的类型索引。
+    SharedPtr<ActorList> Filter(const WildcardPattern &wildcard_pattern) const;
+
+    /// 以紧凑数组的形式返回列表中参与者在最新快照中的状态、包围盒
+    /// 和类型，保持列表顺序；跳过最新快照中不存在的参与者。
+    ActorStateArrays GetStateArrays() const;
+
     /// 重载 [] 运算符，返回指定位置的参与者（Actor）。
     SharedPtr<Actor> operator[](size_t pos) const { 
       return _actors[pos].Get(_episode); // 获取指定位置的 Actor
@@ -71,9 +83,24 @@ namespace client { // 开始 client 命名空间
     // 构造函数，接受 EpisodeProxy 和包含多个 ActorVariant 对象的 vector。
     ActorList(detail::EpisodeProxy episode, std::vector<rpc::Actor> actors); 
 
+    /// 按类型 id 分组的参与者下标，type_ids[i] 的参与者为
+    /// positions[offsets[i], offsets[i + 1])，组内保持列表顺序。
+    struct TypeIndex {
+      std::vector<std::string> type_ids;
+      std::vector<size_t> offsets;
+      std::vector<size_t> positions;
+    };
+
+    /// 首次调用时构建类型索引，之后直接返回。
+    const TypeIndex &GetTypeIndex() const;
+
     detail::EpisodeProxy _episode; // 存储 EpisodeProxy 对象，表示当前的场景或回合
 
     std::vector<detail::ActorVariant> _actors; // 存储 ActorVariant 对象的向量，表示多个参与者
+
+    mutable std::once_flag _type_index_flag;
+
+    mutable TypeIndex _type_index;
   };
 
 } // namespace client
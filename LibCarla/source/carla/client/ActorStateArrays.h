@@ -0,0 +1,80 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/rpc/ActorId.h"
+#include "carla/sensor/data/ActorDynamicState.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace carla {
+namespace client {
+
+  /// 一组参与者状态的紧凑数组表示，所有数组按相同的参与者顺序排列，
+  /// 便于一次性转换为 NumPy 数组而不必为每个参与者创建对象。
+  struct ActorStateArrays {
+
+    /// 参与者 ID
+    std::vector<ActorId> ids;
+
+    /// 每个参与者 6 个值：x, y, z（米），pitch, yaw, roll（度）
+    std::vector<float> transforms;
+
+    /// 每个参与者 3 个值（米/秒）
+    std::vector<float> velocities;
+
+    /// 每个参与者 3 个值（度/秒）
+    std::vector<float> angular_velocities;
+
+    /// 每个参与者 3 个值（米/秒^2）
+    std::vector<float> accelerations;
+
+    /// 每个参与者 6 个值：中心 x, y, z 与半尺寸 x, y, z（米），
+    /// 只有 ActorList 会填充
+    std::vector<float> bounding_boxes;
+
+    /// 每个参与者在 type_ids 中的下标，只有 ActorList 会填充
+    std::vector<uint32_t> type_indices;
+
+    /// 出现过的参与者类型 ID，去重后按首次出现的顺序排列
+    std::vector<std::string> type_ids;
+
+    size_t size() const {
+      return ids.size();
+    }
+
+    void Reserve(size_t count) {
+      ids.reserve(count);
+      transforms.reserve(6u * count);
+      velocities.reserve(3u * count);
+      angular_velocities.reserve(3u * count);
+      accelerations.reserve(3u * count);
+    }
+
+    /// 追加一个参与者的动态状态
+    void Append(const sensor::data::ActorDynamicState &state) {
+      ids.push_back(state.id);
+      const geom::Transform transform = state.transform;
+      transforms.insert(transforms.end(), {
+          transform.location.x, transform.location.y, transform.location.z,
+          transform.rotation.pitch, transform.rotation.yaw, transform.rotation.roll});
+      AppendVector(velocities, state.velocity);
+      AppendVector(angular_velocities, state.angular_velocity);
+      AppendVector(accelerations, state.acceleration);
+    }
+
+  private:
+
+    static void AppendVector(std::vector<float> &out, const geom::Vector3D &v) {
+      out.insert(out.end(), {v.x, v.y, v.z});
+    }
+  };
+
+} // namespace client
+} // namespace carla
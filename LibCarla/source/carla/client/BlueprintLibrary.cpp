@@ -25,6 +25,11 @@ namespace client {
 //根据通配符模式过滤蓝图，返回匹配的 BlueprintLibrary 对象
   SharedPtr<BlueprintLibrary> BlueprintLibrary::Filter(
       const std::string &wildcard_pattern) const {
+    return Filter(WildcardPattern(wildcard_pattern)); // 只编译一次模式，对所有蓝图复用
+  }
+
+  SharedPtr<BlueprintLibrary> BlueprintLibrary::Filter(
+      const WildcardPattern &wildcard_pattern) const {
     map_type result; //用于存储过滤后的蓝图映射
     for (auto &pair : _blueprints) {
       if (pair.second.MatchTags(wildcard_pattern)) { //检查蓝图是否匹配通配符模式
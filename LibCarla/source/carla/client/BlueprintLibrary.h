@@ -41,6 +41,7 @@ namespace client {
 
     /// 过滤 id 或标签与 @a wildcard_pattern 匹配的 ActorBlueprint 列表。
     SharedPtr<BlueprintLibrary> Filter(const std::string &wildcard_pattern) const;
+    SharedPtr<BlueprintLibrary> Filter(const WildcardPattern &wildcard_pattern) const;
     SharedPtr<BlueprintLibrary> FilterByAttribute(const std::string &name, const std::string& value) const;
 
     const_pointer Find(const std::string &key) const;
@@ -9,6 +9,7 @@
 #include "carla/client/Junction.h"
 #include "carla/client/Waypoint.h"
 #include "carla/opendrive/OpenDriveParser.h"
+#include "carla/profiler/Tracer.h"
 #include "carla/road/Map.h"
 #include "carla/road/RoadTypes.h"
 #include "carla/trafficmanager/InMemoryMap.h"
@@ -52,6 +53,7 @@ static auto MakeMap(const std::string &opendrive_contents) {
   const geom::Location &location,
   bool project_to_road,
   int32_t lane_type) const {
+    CARLA_TRACE_SCOPE(map, GetWaypoint);
 // 定义一个可选的 road::element::Waypoint 变量
     boost::optional<road::element::Waypoint> waypoint;
 // 根据是否投影到道路选择不同的获取方式
@@ -65,6 +67,30 @@ static auto MakeMap(const std::string &opendrive_contents) {
     SharedPtr<Waypoint>(new Waypoint{shared_from_this(), *waypoint}) :
     nullptr;
   }
+// 批量获取 road::element::Waypoint 的函数，计算在 road::Map 中并行完成
+  std::vector<boost::optional<road::element::Waypoint>> Map::GetRawWaypoints(
+      const std::vector<geom::Location> &locations,
+      bool project_to_road,
+      int32_t lane_type) const {
+    return project_to_road ?
+        _map.GetClosestWaypointsOnRoad(locations, lane_type) :
+        _map.GetWaypoints(locations, lane_type);
+  }
+// 批量获取 Waypoint 的函数，未找到的位置对应 nullptr
+  std::vector<SharedPtr<Waypoint>> Map::GetWaypoints(
+      const std::vector<geom::Location> &locations,
+      bool project_to_road,
+      int32_t lane_type) const {
+    const auto waypoints = GetRawWaypoints(locations, project_to_road, lane_type);
+    std::vector<SharedPtr<Waypoint>> result;
+    result.reserve(waypoints.size());
+    for (const auto &waypoint : waypoints) {
+      result.emplace_back(waypoint.has_value() ?
+          SharedPtr<Waypoint>(new Waypoint{shared_from_this(), *waypoint}) :
+          nullptr);
+    }
+    return result;
+  }
 // 根据道路 ID、车道 ID 和 s 坐标获取 Waypoint 的函数
   SharedPtr<Waypoint> Map::GetWaypointXODR(
       carla::road::RoadId road_id,
@@ -81,6 +107,7 @@ static auto MakeMap(const std::string &opendrive_contents) {
   }
 // 获取地图拓扑结构的函数
   Map::TopologyList Map::GetTopology() const {
+    CARLA_TRACE_SCOPE(map, GetTopology);
 // 为简洁使用 re 作为 carla::road::element 的别名
     namespace re = carla::road::element;
 // 为简洁使用 re 作为 carla::road::element 的别名
@@ -111,6 +138,7 @@ static auto MakeMap(const std::string &opendrive_contents) {
   }
 // 生成间隔一定距离的 Waypoint 列表的函数
   std::vector<SharedPtr<Waypoint>> Map::GenerateWaypoints(double distance) const {
+    CARLA_TRACE_SCOPE(map, GenerateWaypoints);
  // 存储结果的 Waypoint 向量
     std::vector<SharedPtr<Waypoint>> result;
 // 生成 Waypoint 列表
@@ -123,6 +151,25 @@ static auto MakeMap(const std::string &opendrive_contents) {
     }
     return result;
   }
+// 惰性路点迭代器
+  Map::WaypointIterator::WaypointIterator(
+      SharedPtr<const Map> map,
+      road::Map::WaypointGenerator generator)
+    : _map(std::move(map)),
+      _generator(std::move(generator)) {}
+// 获取下一个路点，生成完毕后返回 nullptr
+  SharedPtr<Waypoint> Map::WaypointIterator::Next() {
+    auto waypoint = _generator.Next();
+    return waypoint.has_value() ?
+        SharedPtr<Waypoint>(new Waypoint{_map, *waypoint}) :
+        nullptr;
+  }
+// 创建惰性路点迭代器的函数
+  Map::WaypointIterator Map::GenerateWaypointsLazy(
+      double distance,
+      road::Lane::LaneType lane_type) const {
+    return WaypointIterator{shared_from_this(), _map.GenerateWaypointsLazy(distance, lane_type)};
+  }
 // 计算穿越车道的函数
   std::vector<road::element::LaneMarking> Map::CalculateCrossedLanes(
   const geom::Location &origin,
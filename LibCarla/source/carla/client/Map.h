@@ -119,6 +119,30 @@ namespace client {
         const geom::Location &location,
         bool project_to_road = true,
         int32_t lane_type = static_cast<uint32_t>(road::Lane::LaneType::Driving)) const;
+    /**
+         * @brief 批量获取路点，在客户端并行计算。
+         *
+         * @param locations 地理位置列表。
+         * @param project_to_road 是否将位置投影到最近的道路上（默认为true）。
+         * @param lane_type 车道类型掩码（默认为驾驶车道）。
+         * @return 与输入一一对应的路点列表，未找到的位置为nullptr。
+         */
+    std::vector<SharedPtr<Waypoint>> GetWaypoints(
+        const std::vector<geom::Location> &locations,
+        bool project_to_road = true,
+        int32_t lane_type = static_cast<uint32_t>(road::Lane::LaneType::Driving)) const;
+    /**
+         * @brief 批量获取路点的OpenDRIVE坐标，不创建Waypoint对象。
+         *
+         * @param locations 地理位置列表。
+         * @param project_to_road 是否将位置投影到最近的道路上（默认为true）。
+         * @param lane_type 车道类型掩码（默认为驾驶车道）。
+         * @return 与输入一一对应的可选路点（road_id, section_id, lane_id, s）。
+         */
+    std::vector<boost::optional<road::element::Waypoint>> GetRawWaypoints(
+        const std::vector<geom::Location> &locations,
+        bool project_to_road = true,
+        int32_t lane_type = static_cast<uint32_t>(road::Lane::LaneType::Driving)) const;
     /**
          * @brief 根据OpenDRIVE ID获取路点。
          *
@@ -148,6 +172,38 @@ namespace client {
          * @return 返回生成的路点（智能指针的向量）。
          */
     std::vector<SharedPtr<Waypoint>> GenerateWaypoints(double distance) const;   
+    /**
+         * @brief 惰性路点迭代器，每次调用 Next() 只生成一个路点。
+         */
+    class WaypointIterator {
+    public:
+      /**
+           * @brief 获取下一个路点。
+           *
+           * @return 返回下一个路点，全部生成完毕后返回nullptr。
+           */
+      SharedPtr<Waypoint> Next();
+
+    private:
+
+      friend Map;
+
+      WaypointIterator(SharedPtr<const Map> map, road::Map::WaypointGenerator generator);
+
+      SharedPtr<const Map> _map; // 保持地图存活
+
+      road::Map::WaypointGenerator _generator; // 底层的路点生成器
+    };
+    /**
+         * @brief 按距离惰性生成路点，顺序与 GenerateWaypoints 相同。
+         *
+         * @param distance 距离。
+         * @param lane_type 车道类型（默认为驾驶车道）。
+         * @return 返回惰性路点迭代器。
+         */
+    WaypointIterator GenerateWaypointsLazy(
+        double distance,
+        road::Lane::LaneType lane_type = road::Lane::LaneType::Driving) const;
     /**
          * @brief 计算从起点到终点所跨越的车道。
          *
@@ -8,6 +8,7 @@
 
 #include "carla/Logging.h" // 导入日志记录相关的头文件
 #include "carla/client/detail/Simulator.h" // 导入Simulator类的头文件
+#include "carla/sensor/data/LidarFilter.h" // 激光雷达点云过滤
 
 #include <exception> //导入异常处理的头文件
 
@@ -46,6 +47,12 @@ namespace client {
   void ServerSideSensor::Listen(CallbackFunctionType callback) {
     log_debug("calling sensor Listen() ", GetDisplayId()); // 打印调试信息，表示调用了Listen方法
     log_debug(GetDisplayId(), ": subscribing to stream"); // 记录订阅流的消息
+    if (_point_cloud_filter.IsEnabled()) {
+      // 在流线程中紧接着反序列化过滤点云
+      callback = [cb=std::move(callback), settings=_point_cloud_filter](SharedPtr<sensor::SensorData> data) {
+        cb(sensor::data::FilterPointCloud(std::move(data), settings));
+      };
+    }
     //锁定当前模拟场景并订阅传感器数据流
     GetEpisode().Lock()->SubscribeToSensor(*this, std::move(callback));
     listening_mask.set(0); // 将监听标志的第0位置为true，表示传感器开始监听
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "carla/client/Sensor.h"
+#include "carla/pointcloud/PointCloudFilter.h"
 #include <bitset>
 
 namespace carla {
@@ -43,6 +44,17 @@ namespace client {
       return listening_mask.test(id + 1);
     }
 
+    /// 设置激光雷达点云的过滤参数。过滤在流线程中、反序列化之后执行，
+    /// 回调收到的是过滤后的测量。在下一次调用 Listen() 时生效，对其他
+    /// 类型的传感器没有影响。
+    void SetPointCloudFilter(const pointcloud::PointCloudFilterSettings &settings) {
+      _point_cloud_filter = settings;
+    }
+
+    const pointcloud::PointCloudFilterSettings &GetPointCloudFilter() const {
+      return _point_cloud_filter;
+    }
+
     /// 启用此传感器以进行 ROS2 发布
     void EnableForROS();
 
@@ -63,6 +75,8 @@ namespace client {
   private:
 
     std::bitset<16> listening_mask;
+
+    pointcloud::PointCloudFilterSettings _point_cloud_filter;
   };
 
 } // namespace client
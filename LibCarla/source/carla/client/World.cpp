@@ -103,6 +103,14 @@ namespace client {
     return _episode.Lock()->GetWorldSnapshot();  // 返回当前世界快照
   }
 
+  void World::SetStateFilter(const rpc::EpisodeStateFilter &filter) {
+    _episode.Lock()->SetStateFilter(filter);
+  }
+
+  void World::ClearStateFilter() {
+    _episode.Lock()->ClearStateFilter();
+  }
+
   SharedPtr<Actor> World::GetActor(ActorId id) const {  // 根据ID获取参与者的方法
     auto simulator = _episode.Lock();  // 锁定当前剧集
     auto description = simulator->GetActorById(id);  // 获取指定ID的参与者描述
@@ -176,6 +184,14 @@ namespace client {
     _episode.Lock()->SetPedestriansSeed(seed); // 更新种子值
   }
 
+  bool World::SetPedestriansTileSize(float tile_size) { // 设置行人人群方格大小
+    return _episode.Lock()->SetPedestriansTileSize(tile_size);
+  }
+
+  nav::CrowdTickStats World::GetPedestriansTickStats() const { // 获取行人导航耗时统计
+    return _episode.Lock()->GetPedestriansTickStats();
+  }
+
   SharedPtr<Actor> World::GetTrafficSign(const Landmark& landmark) const { // 获取交通标志
     SharedPtr<ActorList> actors = GetActors(); // 获取所有参与者
     SharedPtr<TrafficSign> result; // 结果变量
@@ -19,9 +19,11 @@
 #include "carla/client/WorldSnapshot.h"  // 包含世界快照相关的头文件
 #include "carla/client/detail/EpisodeProxy.h"  // 包含EpisodeProxy相关的头文件
 #include "carla/geom/Transform.h"  // 包含变换矩阵相关的头文件
+#include "carla/nav/CrowdTickStats.h"  // 包含行人导航耗时统计的头文件
 #include "carla/rpc/Actor.h"  // 包含演员（对象）相关的头文件
 #include "carla/rpc/AttachmentType.h"  // 包含附加物类型相关的头文件
 #include "carla/rpc/EpisodeSettings.h"  // 包含剧集设置相关的头文件
+#include "carla/rpc/EpisodeStateFilter.h"  // 包含世界状态过滤条件的头文件
 #include "carla/rpc/EnvironmentObject.h"  // 包含环境对象相关的头文件
 #include "carla/rpc/LabelledPoint.h"  // 包含带标签点的头文件
 #include "carla/rpc/MapLayer.h"  // 包含地图图层相关的头文件
@@ -139,6 +141,13 @@ namespace client {
     /// 可以用于记录、对比不同时刻的世界状态或者进行一些基于特定时刻状态的分析和操作。
     WorldSnapshot GetSnapshot() const;
 
+    /// 设置本客户端的世界状态兴趣区域：服务器只发送距离自我参与者一定
+    /// 范围内、且类型满足掩码的参与者。之后的快照和 GetActors 只包含这些参与者。
+    void SetStateFilter(const rpc::EpisodeStateFilter &filter);
+
+    /// 取消世界状态兴趣区域，恢复接收所有参与者的状态。
+    void ClearStateFilter();
+
     /// 根据id查找actor，如果没有找到则返回nullptr。
     /// 通过传入的ActorId参数，在当前模拟世界中查找对应的参与者对象，方便快速定位特定的实体，
     /// 比如查找某一辆特定编号的车辆或者某个行人等。
@@ -209,6 +218,15 @@ namespace client {
     /// 或者设置不同的种子值来获取真正的随机行为表现。
    void SetPedestriansSeed(unsigned int seed);
 
+    /// 将行人的可行走区域划分为边长为 @a tile_size 米的方格，每个方格拥有独立的人群并行更新，
+    /// 行人移动到相邻方格时会被自动移交。小于等于 0 时使用单个人群（默认）。
+    /// 必须在生成任何行人之前调用，否则返回 false。
+    bool SetPedestriansTileSize(float tile_size);
+
+    /// 返回客户端行人导航节拍的累计耗时统计（微秒），包括人群更新、
+    /// 堵塞检查、路线事件以及向服务器发送行人命令的耗时。
+    nav::CrowdTickStats GetPedestriansTickStats() const;
+
     /// 根据提供的地标（Landmark）获取对应的交通标志（TrafficSign）的智能指针。
     /// 地标通常代表地图中的特定位置，通过它可以定位和获取对应的交通标志对象，用于查询交通规则相关的指示信息等。
     SharedPtr<Actor> GetTrafficSign(const Landmark& landmark) const;
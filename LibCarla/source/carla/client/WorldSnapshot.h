@@ -41,6 +41,17 @@ namespace client {
       return _state->ContainsActorSnapshot(actor_id);
     }
 
+    // 检查指定的 Actor 是否存在。设置了状态过滤时，过滤范围之外的 Actor
+    // 不在快照中，但仍然存在
+    bool ContainsActor(ActorId actor_id) const {
+      return _state->ContainsActor(actor_id);
+    }
+
+    // 被过滤掉、但仍然存在的 Actor ID，按升序排列
+    const std::vector<ActorId> &GetFilteredOutActorIds() const {
+      return _state->GetFilteredOutActorIds();
+    }
+
     // 根据 ActorId 查找相应的 Actor 快照，如果找到了则返回 ActorSnapshot，否则返回 boost::none
     boost::optional<ActorSnapshot> Find(ActorId actor_id) const {
       return _state->GetActorSnapshotIfPresent(actor_id);
@@ -51,6 +62,17 @@ namespace client {
       return _state->size();
     }
 
+    /// 以紧凑数组的形式返回所有参与者的状态，按参与者 ID 升序。
+    ActorStateArrays GetActorStateArrays() const {
+      return _state->GetActorStateArrays();
+    }
+
+    /// 以紧凑数组的形式返回 @a ids 中参与者的状态，保持 @a ids 的顺序，
+    /// 跳过本快照中不存在的参与者。
+    ActorStateArrays GetActorStateArrays(const std::vector<ActorId> &ids) const {
+      return _state->GetActorStateArrays(ids);
+    }
+
     // 获取指向世界快照中所有参与者快照列表的开始迭代器
     auto begin() const {
       return _state->begin();
@@ -14,6 +14,8 @@
 #include <algorithm>
 #include <iterator>
 #include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 namespace carla {
 namespace client {
@@ -25,6 +27,9 @@ namespace detail {
 
   /// 保留参与者描述列表，以避免每次都向服务器请求描述。
   ///
+  /// 读多写少：查询只获取共享锁，可以并发进行；只有插入和清空需要独占锁。
+  /// 描述主要由世界状态流在参与者生成时推送进来。
+  ///
   /// @todo Dead actors are never removed from the list.
   class CachedActorList : private MovableNonCopyable {
   public:
@@ -51,7 +56,7 @@ namespace detail {
 
   private:
 
-    mutable std::mutex _mutex;
+    mutable std::shared_timed_mutex _mutex;
 
     std::unordered_map<ActorId, rpc::Actor> _actors;
   };
@@ -61,7 +66,7 @@ namespace detail {
   // ===========================================================================
 
   inline void CachedActorList::Insert(rpc::Actor actor) {
-    std::lock_guard<std::mutex> lock(_mutex);
+    std::lock_guard<std::shared_timed_mutex> lock(_mutex);
     auto id = actor.id;
     _actors.emplace(id, std::move(actor));
   }
@@ -75,7 +80,7 @@ namespace detail {
     auto make_iterator = [&make_a_pair](auto it) {
       return boost::make_transform_iterator(std::make_move_iterator(it), make_a_pair);
     };
-    std::lock_guard<std::mutex> lock(_mutex);
+    std::lock_guard<std::shared_timed_mutex> lock(_mutex);
     _actors.insert(make_iterator(std::begin(range)), make_iterator(std::end(range)));
   }
 
@@ -83,7 +88,7 @@ namespace detail {
   inline std::vector<ActorId> CachedActorList::GetMissingIds(const RangeT &range) const {
     std::vector<ActorId> result;
     result.reserve(range.size());
-    std::lock_guard<std::mutex> lock(_mutex);
+    std::shared_lock<std::shared_timed_mutex> lock(_mutex);
     std::copy_if(std::begin(range), std::end(range), std::back_inserter(result), [this](auto id) {
       return _actors.find(id) == _actors.end();
     });
@@ -91,7 +96,7 @@ namespace detail {
   }
 
   inline boost::optional<rpc::Actor> CachedActorList::GetActorById(ActorId id) const {
-    std::lock_guard<std::mutex> lock(_mutex);
+    std::shared_lock<std::shared_timed_mutex> lock(_mutex);
     auto it = _actors.find(id);
     if (it != _actors.end()) {
       return it->second;
@@ -103,7 +108,7 @@ namespace detail {
   inline std::vector<rpc::Actor> CachedActorList::GetActorsById(const RangeT &range) const {
     std::vector<rpc::Actor> result;
     result.reserve(range.size());
-    std::lock_guard<std::mutex> lock(_mutex);
+    std::shared_lock<std::shared_timed_mutex> lock(_mutex);
     for (auto &&id : range) {
       auto it = _actors.find(id);
       if (it != _actors.end()) {
@@ -114,7 +119,7 @@ namespace detail {
   }
 
   inline void CachedActorList::Clear() {
-    std::lock_guard<std::mutex> lock(_mutex);
+    std::lock_guard<std::shared_timed_mutex> lock(_mutex);
     _actors.clear();
   }
 
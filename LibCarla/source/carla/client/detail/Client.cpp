@@ -186,6 +186,15 @@ namespace detail {
     return _pimpl->CallAndWait<rpc::EpisodeInfo>("get_episode_info");
   }
 
+  streaming::Token Client::OpenFilteredEpisodeStream(const rpc::EpisodeStateFilter &filter) {
+    return _pimpl->CallAndWait<streaming::Token>("open_filtered_episode_stream", filter);
+  }
+
+  void Client::CloseFilteredEpisodeStream(const streaming::Token &token) {
+    carla::streaming::detail::token_type thisToken(token);
+    _pimpl->AsyncCall("close_filtered_episode_stream", thisToken.get_stream_id());
+  }
+
   rpc::MapInfo Client::GetMapInfo() {
     return _pimpl->CallAndWait<rpc::MapInfo>("get_map_info");
   }
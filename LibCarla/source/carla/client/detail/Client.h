@@ -19,6 +19,7 @@
 #include "carla/rpc/EnvironmentObject.h"
 #include "carla/rpc/EpisodeInfo.h"
 #include "carla/rpc/EpisodeSettings.h"
+#include "carla/rpc/EpisodeStateFilter.h"
 #include "carla/rpc/LabelledPoint.h"
 #include "carla/rpc/LightState.h"
 #include "carla/rpc/MapInfo.h"
@@ -123,6 +124,13 @@ namespace detail {
 
     rpc::EpisodeInfo GetEpisodeInfo();
 
+    /// 在服务器上创建一个只发送满足 @a filter 的参与者的世界状态流，
+    /// 返回该流的令牌。
+    streaming::Token OpenFilteredEpisodeStream(const rpc::EpisodeStateFilter &filter);
+
+    /// 关闭由 OpenFilteredEpisodeStream 创建的世界状态流。
+    void CloseFilteredEpisodeStream(const streaming::Token &token);
+
     rpc::MapInfo GetMapInfo();
 
     std::vector<uint8_t> GetNavigationMesh() const;
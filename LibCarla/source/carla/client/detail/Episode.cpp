@@ -8,6 +8,7 @@
 #include "carla/client/detail/Episode.h"
 
 #include "carla/Logging.h"
+#include "carla/MsgPack.h"
 #include "carla/client/detail/Client.h"
 #include "carla/client/detail/WalkerNavigation.h"
 #include "carla/sensor/Deserializer.h"
@@ -21,9 +22,9 @@ namespace detail {
 // 使用命名空间中的chrono_literals，用于方便地表示时间常量
 using namespace std::chrono_literals;
 // 静态函数，将传感器数据强制转换为特定类型
-  static auto &CastData(const sensor::SensorData &data) {
+  static auto CastData(SharedPtr<sensor::SensorData> data) {
     using target_t = const sensor::data::RawEpisodeState;
-    return static_cast<target_t &>(data);
+    return boost::static_pointer_cast<target_t>(std::move(data));
   }
 // 模板函数，根据给定的参与者ID范围获取演员列表
   template <typename RangeT>
@@ -45,25 +46,85 @@ using namespace std::chrono_literals;
     : _client(client),
       _state(std::make_shared<EpisodeState>(info.id)),
       _simulator(simulator),
-      _token(info.token) {}
+      _token(info.token),
+      _subscribed_token(info.token) {}
 // 析构函数，尝试取消订阅流并处理可能的异常
   Episode::~Episode() {
     try {
-      _client.UnSubscribeFromStream(_token);
+      std::lock_guard<std::mutex> lock(_subscription_mutex);
+      ReleaseStateSubscription();
     } catch (const std::exception &e) {
       log_error("exception trying to disconnect from episode:", e.what());
     }
   }
 // 开始监听流数据的函数
   void Episode::Listen() {
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    SubscribeToState(_token);
+  }
+
+  void Episode::SetStateFilter(const rpc::EpisodeStateFilter &filter) {
+    auto token = _client.OpenFilteredEpisodeStream(filter);
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    ReleaseStateSubscription();
+    _has_state_filter = true;
+    SubscribeToState(token);
+  }
+
+  void Episode::ClearStateFilter() {
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    if (!_has_state_filter) {
+      return;
+    }
+    ReleaseStateSubscription();
+    _has_state_filter = false;
+    SubscribeToState(_token);
+  }
+
+  void Episode::ReleaseStateSubscription() {
+    _client.UnSubscribeFromStream(_subscribed_token);
+    if (_has_state_filter) {
+      _client.CloseFilteredEpisodeStream(_subscribed_token);
+    }
+  }
+
+  void Episode::SubscribeToState(const streaming::Token &token) {
+    // 换流之后的第一帧可能是基于另一个流的增量帧，必须等待关键帧
+    _wait_for_keyframe = true;
+    _subscribed_token = token;
     std::weak_ptr<Episode> weak = shared_from_this();
-    _client.SubscribeToStream(_token, [weak](auto buffer) {
+    _client.SubscribeToStream(token, [weak](auto buffer) {
       auto self = weak.lock();
       if (self != nullptr) {
         // 反序列化数据
         auto data = sensor::Deserializer::Deserialize(std::move(buffer));
-        auto next = std::make_shared<const EpisodeState>(CastData(*data));
+        auto raw_state = CastData(std::move(data));
+        // 先缓存服务器推送的新参与者描述，即使这一帧随后被丢弃
+        if (raw_state->HasActorDescriptions()) {
+          try {
+            self->_actors.InsertRange(MsgPack::UnPack<std::vector<rpc::Actor>>(
+                raw_state->GetActorDescriptionsData(),
+                raw_state->GetActorDescriptionsSize()));
+          } catch (const std::exception &e) {
+            log_error("failed to read the actor descriptions of frame", raw_state->GetFrame(), ':', e.what());
+          }
+        }
         auto prev = self->GetState();
+        std::shared_ptr<const EpisodeState> next;
+        if (raw_state->IsDelta()) {
+          // 增量帧只能应用在其基准帧之上；订阅之后或丢帧时等待下一个关键帧
+          if (self->_wait_for_keyframe ||
+              raw_state->GetEpisodeId() != prev->GetEpisodeId() ||
+              raw_state->GetBaseFrame() != prev->GetFrame()) {
+            log_debug("episode state delta for frame", raw_state->GetFrame(),
+                "does not match the current frame", prev->GetFrame(), ", waiting for a keyframe");
+            return;
+          }
+          next = std::make_shared<const EpisodeState>(std::move(raw_state), *prev);
+        } else {
+          next = std::make_shared<const EpisodeState>(std::move(raw_state));
+          self->_wait_for_keyframe = false;
+        }
 
         // TODO: 更新地图变化的检测方式
         bool HasMapChanged = next->HasMapChanged();
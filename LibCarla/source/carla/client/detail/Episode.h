@@ -16,7 +16,10 @@
 #include "carla/client/detail/EpisodeState.h" // 引入剧集状态
 #include "carla/client/detail/EpisodeProxy.h" // 引入剧集代理
 #include "carla/rpc/EpisodeInfo.h" // 引入剧集信息
+#include "carla/rpc/EpisodeStateFilter.h" // 引入世界状态过滤条件
 
+#include <atomic>
+#include <mutex>
 #include <vector> // 引入向量类
 
 namespace carla {
@@ -41,6 +44,13 @@ namespace detail {
 
     void Listen(); // 监听事件
 
+    /// 改为订阅只包含满足 @a filter 的参与者的世界状态流。
+    /// 之后的快照（以及 GetActors）只包含这些参与者。
+    void SetStateFilter(const rpc::EpisodeStateFilter &filter);
+
+    /// 恢复订阅完整的世界状态流。
+    void ClearStateFilter();
+
     auto GetId() const { // 获取剧集 ID
       return GetState()->GetEpisodeId();
     }
@@ -108,6 +118,12 @@ namespace detail {
 
     void OnEpisodeChanged(); // 处理剧集变化事件
 
+    /// 订阅 @a token 对应的世界状态流，调用者必须持有 _subscription_mutex
+    void SubscribeToState(const streaming::Token &token);
+
+    /// 取消当前的世界状态订阅，调用者必须持有 _subscription_mutex
+    void ReleaseStateSubscription();
+
     Client &_client; // 引用客户端
 
     AtomicSharedPtr<const EpisodeState> _state; // 原子共享指针指向剧集状态
@@ -128,6 +144,14 @@ namespace detail {
 
     const streaming::Token _token; // 令牌
 
+    std::mutex _subscription_mutex; // 保护当前订阅的世界状态流
+
+    streaming::Token _subscribed_token; // 当前订阅的世界状态流令牌
+
+    bool _has_state_filter = false; // 当前订阅是否为过滤后的流
+
+    std::atomic_bool _wait_for_keyframe{true}; // 丢弃增量帧直到收到关键帧
+
     bool _pending_exceptions = false; // 是否有待处理异常
 
     bool _should_update_map = true; // 是否应该更新地图
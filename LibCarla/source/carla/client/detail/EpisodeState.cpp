@@ -6,45 +6,153 @@
 // 引入必要的头文件
 #include "carla/client/detail/EpisodeState.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace carla {
 namespace client {
 namespace detail {
 
 // EpisodeState类的构造函数，用于初始化一个EpisodeState对象
-  // 参数：state - 一个const引用，指向sensor::data::RawEpisodeState类型的数据，包含了当前模拟场景的状态信息
-  EpisodeState::EpisodeState(const sensor::data::RawEpisodeState &state)
+  // 参数：state - 指向sensor::data::RawEpisodeState类型的数据，包含了当前模拟场景的状态信息
+  EpisodeState::EpisodeState(SharedPtr<const RawState> state)
  // 使用传入的RawEpisodeState对象中的数据来初始化EpisodeState对象的成员变量
-    : _episode_id(state.GetEpisodeId()),// 初始化_episode_id，表示当前模拟场景的ID
+    : _episode_id(state->GetEpisodeId()),// 初始化_episode_id，表示当前模拟场景的ID
       _timestamp(// 初始化_timestamp，包含帧信息、游戏时间戳、时间差、平台时间戳
-          state.GetFrame(),
-          state.GetGameTimeStamp(),
-          state.GetDeltaSeconds(),
-          state.GetPlatformTimeStamp()),
-      _map_origin(state.GetMapOrigin()),// 初始化_map_origin，表示地图的原点
-      _simulation_state(state.GetSimulationState()) {// 初始化_simulation_state，表示当前的模拟状态
-    // 预留空间以存储所有的Actor快照
-    _actors.reserve(state.size());
-// 遍历RawEpisodeState中的所有Actor，并为每个Actor创建一个ActorSnapshot对象
-    for (auto &&actor : state) {
- // 使用emplace方法将ActorSnapshot对象插入到_actors映射中
-      // 键是Actor的ID，值是ActorSnapshot对象
-      // DEBUG_ONLY(auto result = ) 这部分代码用于调试，用于检查插入操作是否成功
-      DEBUG_ONLY(auto result = )
-      _actors.emplace(
-          actor.id,
-          ActorSnapshot{// 初始化ActorSnapshot对象
-              actor.id,         // Actor的ID
-              actor.actor_state, // Actor的状态
-              actor.transform,// Actor的变换（位置和方向）
-              actor.velocity,// Actor的速度
-              actor.angular_velocity,// Actor的角速度
-              actor.acceleration,// Actor的加速度
-              actor.state});// Actor的附加状态信息
-      DEBUG_ASSERT(result.second);
- // DEBUG_ASSERT(result.second); 这部分代码用于调试，确保emplace操作成功，即没有重复键
+          state->GetFrame(),
+          state->GetGameTimeStamp(),
+          state->GetDeltaSeconds(),
+          state->GetPlatformTimeStamp()),
+      _map_origin(state->GetMapOrigin()),// 初始化_map_origin，表示地图的原点
+      // 初始化_simulation_state，表示当前的模拟状态；传输相关的标志不对外暴露
+      _simulation_state(static_cast<SimulationState>(
+          state->GetSimulationState() &
+          ~(SimulationState::ActorDescriptions | SimulationState::FilteredOutActors))) {
+    DEBUG_ASSERT(!state->IsDelta());
+    // 被过滤掉的参与者没有状态，只记录它们的 ID
+    const ActorId *filtered_out = state->GetFilteredOutActorIds();
+    _filtered_out_ids.assign(filtered_out, filtered_out + state->GetFilteredOutActorCount());
+    std::sort(_filtered_out_ids.begin(), _filtered_out_ids.end());
+    // 只记录每个参与者在缓冲区中的位置，然后按 ID 排序
+    _actors.reserve(state->size());
+    for (auto &&actor : *state) {
+      _actors.push_back(ActorEntry{actor.id, 0u, &actor});
+    }
+    std::sort(_actors.begin(), _actors.end(), [](const ActorEntry &lhs, const ActorEntry &rhs) {
+      return lhs.id < rhs.id;
+    });
+    // 确保没有重复的参与者ID
+    DEBUG_ASSERT(std::adjacent_find(_actors.begin(), _actors.end(),
+        [](const ActorEntry &lhs, const ActorEntry &rhs) { return lhs.id == rhs.id; }) == _actors.end());
+    _buffers.emplace_back(std::move(state));
+  }
+
+  EpisodeState::EpisodeState(
+      SharedPtr<const RawState> state,
+      const EpisodeState &previous)
+    : _episode_id(state->GetEpisodeId()),
+      _timestamp(
+          state->GetFrame(),
+          state->GetGameTimeStamp(),
+          state->GetDeltaSeconds(),
+          state->GetPlatformTimeStamp()),
+      _map_origin(state->GetMapOrigin()),
+      // 增量和描述标志只描述传输方式，不对外暴露
+      _simulation_state(static_cast<SimulationState>(
+          state->GetSimulationState() &
+          ~(SimulationState::Delta | SimulationState::ActorDescriptions))) {
+    DEBUG_ASSERT(state->IsDelta());
+    DEBUG_ASSERT(previous.GetFrame() == state->GetBaseFrame());
+    // 按过滤条件生成的消息总是关键帧
+    DEBUG_ASSERT(state->GetFilteredOutActorCount() == 0u);
+
+    // 新缓冲区中的参与者先用占位位置标记，合并后再确定
+    constexpr uint32_t NewBuffer = std::numeric_limits<uint32_t>::max();
+    std::vector<ActorEntry> changed;
+    changed.reserve(state->size());
+    for (auto &&actor : *state) {
+      changed.push_back(ActorEntry{actor.id, NewBuffer, &actor});
+    }
+    std::sort(changed.begin(), changed.end(), [](const ActorEntry &lhs, const ActorEntry &rhs) {
+      return lhs.id < rhs.id;
+    });
+    const ActorId *removed_begin = state->GetRemovedActorIds();
+    std::vector<ActorId> removed(removed_begin, removed_begin + state->GetRemovedActorCount());
+    std::sort(removed.begin(), removed.end());
+
+    // 合并两个有序序列：变化的参与者覆盖旧状态，已销毁的参与者被跳过；
+    // 同时记录基准帧的每个缓冲区是否仍被引用
+    const auto &base = previous._actors;
+    std::vector<uint8_t> used(previous._buffers.size(), 0u);
+    _actors.reserve(base.size() + changed.size());
+    auto it = base.begin();
+    auto jt = changed.begin();
+    while (it != base.end() || jt != changed.end()) {
+      if (jt == changed.end() || (it != base.end() && it->id < jt->id)) {
+        if (!std::binary_search(removed.begin(), removed.end(), it->id)) {
+          _actors.push_back(*it);
+          used[it->buffer] = 1u;
+        }
+        ++it;
+      } else {
+        if (it != base.end() && it->id == jt->id) {
+          ++it;
+        }
+        _actors.push_back(*jt);
+        ++jt;
+      }
+    }
+
+    // 只保留仍被引用的缓冲区，不再需要的增量帧缓冲区随基准帧一起释放
+    std::vector<uint32_t> remap(previous._buffers.size(), NewBuffer);
+    _buffers.reserve(previous._buffers.size() + 1u);
+    for (size_t i = 0u; i < previous._buffers.size(); ++i) {
+      if (used[i] != 0u) {
+        remap[i] = static_cast<uint32_t>(_buffers.size());
+        _buffers.push_back(previous._buffers[i]);
+      }
+    }
+    const auto own = static_cast<uint32_t>(_buffers.size());
+    if (!changed.empty()) {
+      _buffers.emplace_back(std::move(state));
+    }
+    for (auto &entry : _actors) {
+      entry.buffer = (entry.buffer == NewBuffer) ? own : remap[entry.buffer];
     }
   }
 
+  ActorStateArrays EpisodeState::GetActorStateArrays() const {
+    ActorStateArrays arrays;
+    arrays.Reserve(_actors.size());
+    for (const auto &entry : _actors) {
+      arrays.Append(*entry.state);
+    }
+    return arrays;
+  }
+
+  ActorStateArrays EpisodeState::GetActorStateArrays(const std::vector<ActorId> &ids) const {
+    ActorStateArrays arrays;
+    arrays.Reserve(ids.size());
+    for (const ActorId id : ids) {
+      auto it = FindActorEntry(id);
+      if (it != _actors.end()) {
+        arrays.Append(*it->state);
+      }
+    }
+    return arrays;
+  }
+
+  bool EpisodeState::ContainsActor(ActorId actor_id) const {
+    return ContainsActorSnapshot(actor_id) ||
+        std::binary_search(_filtered_out_ids.begin(), _filtered_out_ids.end(), actor_id);
+  }
+
+  std::vector<EpisodeState::ActorEntry>::const_iterator EpisodeState::FindActorEntry(ActorId id) const {
+    auto it = std::lower_bound(_actors.begin(), _actors.end(), id,
+        [](const ActorEntry &entry, ActorId value) { return entry.id < value; });
+    return (it != _actors.end() && it->id == id) ? it : _actors.end();
+  }
+
 } // namespace detail
 } // namespace client
 } // namespace carla
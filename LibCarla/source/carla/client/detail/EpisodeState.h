@@ -6,37 +6,77 @@
 
 #pragma once // 防止头文件被重复包含
 
-#include "carla/Iterator.h" // 引入迭代器头文件
 #include "carla/ListView.h" // 引入列表视图头文件
+#include "carla/Memory.h" // 引入智能指针头文件
 #include "carla/NonCopyable.h" // 引入不可复制类的头文件
 #include "carla/client/ActorSnapshot.h" // 引入参与者快照头文件
+#include "carla/client/ActorStateArrays.h" // 引入批量状态数组头文件
 #include "carla/client/Timestamp.h" // 引入时间戳头文件
 #include "carla/geom/Vector3DInt.h" // 引入三维整数向量头文件
 #include "carla/sensor/data/RawEpisodeState.h" // 引入原始剧集状态数据头文件
 
+#include <boost/iterator/transform_iterator.hpp> // 引入Boost变换迭代器头文件
 #include <boost/optional.hpp> // 引入Boost可选类型头文件
 
 #include <memory> // 引入智能指针头文件
-#include <unordered_map> // 引入无序映射头文件
+#include <vector>
 
 namespace carla { // 定义carla命名空间
 namespace client { // 定义client子命名空间
 namespace detail { // 定义detail子命名空间
 
-  /// 表示某一帧的所有参与者的状态
+  /// 表示某一帧的所有参与者的状态。
+  ///
+  /// 不复制接收到的数据：保留原始缓冲区，并维护一个按参与者 ID 排序的
+  /// 紧凑索引，查找为 O(log n)，遍历按 ID 顺序线性扫描该索引。
+  /// 快照在访问时才从缓冲区中的打包状态转换为 ActorSnapshot。
   class EpisodeState
     : public std::enable_shared_from_this<EpisodeState>, // 允许共享自身指针
       private NonCopyable { // 禁止复制
 
       using SimulationState = sensor::s11n::EpisodeStateSerializer::SimulationState; // 定义模拟状态类型
 
+      using RawState = sensor::data::RawEpisodeState;
+
+      /// 有序索引中的一项，指向某个原始缓冲区中的参与者状态
+      struct ActorEntry {
+        ActorId id;
+        uint32_t buffer; // 状态所在缓冲区在 _buffers 中的位置
+        const sensor::data::ActorDynamicState *state;
+      };
+
+      struct GetEntryId {
+        ActorId operator()(const ActorEntry &entry) const {
+          return entry.id;
+        }
+      };
+
+      struct MakeActorSnapshot {
+        ActorSnapshot operator()(const ActorEntry &entry) const {
+          const auto &actor = *entry.state;
+          return ActorSnapshot{
+              actor.id,
+              actor.actor_state,
+              actor.transform,
+              actor.velocity,
+              actor.angular_velocity,
+              actor.acceleration,
+              actor.state};
+        }
+      };
+
   public:
 
     // 构造函数，接受剧集ID
     explicit EpisodeState(uint64_t episode_id) : _episode_id(episode_id) {}
 
-    // 构造函数，接受原始剧集状态
-    explicit EpisodeState(const sensor::data::RawEpisodeState &state);
+    // 构造函数，接受原始剧集状态，并保持其缓冲区有效
+    explicit EpisodeState(SharedPtr<const RawState> state);
+
+    // 构造函数，将增量帧应用在基准帧 @a previous 的状态之上。
+    // @a previous 必须是增量帧所基于的帧；未变化的参与者继续引用
+    // 之前的缓冲区，直到下一个关键帧为止。
+    EpisodeState(SharedPtr<const RawState> state, const EpisodeState &previous);
 
     // 获取剧集ID
     auto GetEpisodeId() const {
@@ -70,7 +110,16 @@ namespace detail { // 定义detail子命名空间
 
     // 检查是否包含指定的参与者快照
     bool ContainsActorSnapshot(ActorId actor_id) const {
-      return _actors.find(actor_id) != _actors.end();
+      return FindActorEntry(actor_id) != _actors.end();
+    }
+
+    // 检查参与者是否存在。设置了状态过滤时，被过滤掉的参与者没有快照，
+    // 但仍然存在
+    bool ContainsActor(ActorId actor_id) const;
+
+    // 被过滤掉、但仍然存在的参与者 ID，按升序排列
+    const std::vector<ActorId> &GetFilteredOutActorIds() const {
+      return _filtered_out_ids;
     }
 
     // 获取指定参与者的快照
@@ -90,8 +139,8 @@ namespace detail { // 定义detail子命名空间
     // 获取所有参与者ID
     auto GetActorIds() const {
       return MakeListView( // 创建列表视图
-          iterator::make_map_keys_const_iterator(_actors.begin()), // 获取参与者ID迭代器
-          iterator::make_map_keys_const_iterator(_actors.end())); // 获取参与者ID迭代器
+          boost::make_transform_iterator(_actors.begin(), GetEntryId{}), // 获取参与者ID迭代器
+          boost::make_transform_iterator(_actors.end(), GetEntryId{})); // 获取参与者ID迭代器
     }
 
     // 获取参与者数量
@@ -99,24 +148,34 @@ namespace detail { // 定义detail子命名空间
       return _actors.size(); // 返回参与者数量
     }
 
-    // 返回参与者快照的开始迭代器
+    // 以紧凑数组的形式返回所有参与者的状态，按参与者 ID 升序
+    ActorStateArrays GetActorStateArrays() const;
+
+    // 以紧凑数组的形式返回 @a ids 中参与者的状态，保持 @a ids 的顺序，
+    // 跳过本帧中不存在的参与者
+    ActorStateArrays GetActorStateArrays(const std::vector<ActorId> &ids) const;
+
+    // 返回参与者快照的开始迭代器，按参与者 ID 升序，解引用时返回快照的值
     auto begin() const {
-      return iterator::make_map_values_const_iterator(_actors.begin()); // 返回参与者快照值的开始迭代器
+      return boost::make_transform_iterator(_actors.begin(), MakeActorSnapshot{});
     }
 
     // 返回参与者快照的结束迭代器
     auto end() const {
-      return iterator::make_map_values_const_iterator(_actors.end()); // 返回参与者快照值的结束迭代器
+      return boost::make_transform_iterator(_actors.end(), MakeActorSnapshot{});
     }
 
   private:
 
     // 复制指定参与者的快照（如果存在）
+    // 在有序索引中二分查找参与者，不存在时返回 end()
+    std::vector<ActorEntry>::const_iterator FindActorEntry(ActorId id) const;
+
     template <typename T>
     void CopyActorSnapshotIfPresent(ActorId id, T &value) const {
-      auto it = _actors.find(id); // 查找参与者
+      auto it = FindActorEntry(id); // 查找参与者
       if (it != _actors.end()) { // 如果找到了
-        value = it->second; // 复制快照
+        value = MakeActorSnapshot{}(*it); // 复制快照
       }
     }
 
@@ -128,7 +187,13 @@ namespace detail { // 定义detail子命名空间
 
     SimulationState _simulation_state; // 存储模拟状态
 
-    std::unordered_map<ActorId, ActorSnapshot> _actors; // 存储参与者快照的无序映射
+    /// 索引中的状态所在的原始缓冲区。关键帧只有一个；增量帧只保留
+    /// 仍有参与者引用的基准帧缓冲区，所有参与者都已更新的缓冲区会被释放。
+    std::vector<SharedPtr<const RawState>> _buffers;
+
+    std::vector<ActorEntry> _actors; // 按参与者 ID 排序的状态索引
+
+    std::vector<ActorId> _filtered_out_ids; // 被过滤掉的参与者 ID，已排序
   };
 
 } // namespace detail
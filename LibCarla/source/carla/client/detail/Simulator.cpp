@@ -15,6 +15,7 @@
 #include "carla/client/Map.h"
 #include "carla/client/Sensor.h"
 #include "carla/client/TimeoutException.h"
+#include "carla/profiler/Tracer.h"
 #include "carla/client/WalkerAIController.h"
 #include "carla/client/detail/ActorFactory.h"
 #include "carla/client/detail/WalkerNavigation.h"
@@ -47,6 +48,7 @@ namespace detail {
   }
 
   static bool SynchronizeFrame(uint64_t frame, const Episode &episode, time_duration timeout) {
+    CARLA_TRACE_SCOPE(client, SynchronizeFrame);
     bool result = true;//初始化结果为true，表示默认同步成功
     auto start = std::chrono::system_clock::now();//获取当前时间点作为开始时间
     while (frame > episode.GetState()->GetTimestamp().frame) {//当当前帧大于episode中的状态时，循环等待
@@ -59,6 +61,7 @@ namespace detail {
       }
     }
     if(result) {//如果成功同步，则调用TrafficManager的Tick方法
+      CARLA_TRACE_SCOPE(client, TrafficManagerTick);
       carla::traffic_manager::TrafficManager::Tick();
     }
 
@@ -141,6 +144,10 @@ namespace detail {
       ValidateVersions(_client);//如果没有，则首先验证客户端的版本兼容性
       _episode = std::make_shared<Episode>(_client, std::weak_ptr<Simulator>(shared_from_this()));//创建一个新的_episode实例，使用智能指针管理内存
       _episode->Listen();//开始监听_episode相关事件或状态变化
+      if (_state_filter.has_value()) {
+        // 加载新地图后继续使用之前设置的过滤条件
+        _episode->SetStateFilter(*_state_filter);
+      }
       if (!GetEpisodeSettings().synchronous_mode) {//检查当前_episode的设置是否为非同步模式
         WaitForTick(_client.GetTimeout());//使用客户端设置的超时时间作为等待时长
       }
@@ -215,6 +222,7 @@ EpisodeProxy Simulator::GetCurrentEpisode() {
   // ===========================================================================
 
   WorldSnapshot Simulator::WaitForTick(time_duration timeout) {
+    CARLA_TRACE_SCOPE(client, WaitForTick);
     DEBUG_ASSERT(_episode != nullptr);
 
     // 发出行人导航节拍
@@ -228,13 +236,17 @@ EpisodeProxy Simulator::GetCurrentEpisode() {
   }
 
   uint64_t Simulator::Tick(time_duration timeout) {
+    CARLA_TRACE_SCOPE(client, Tick);
     DEBUG_ASSERT(_episode != nullptr);
 
     // 发出行人导航节拍
     NavigationTick();
 
     // 发送节拍命令
-    const auto frame = _client.SendTickCue();
+    const auto frame = [&]() {
+      CARLA_TRACE_SCOPE(client, SendTickCue);
+      return _client.SendTickCue();
+    }();
 
     // 等待，直到收到新的场景
     bool result = SynchronizeFrame(frame, *_episode, timeout);
@@ -356,6 +368,18 @@ EpisodeProxy Simulator::GetCurrentEpisode() {
     nav->SetPedestriansSeed(seed);// 设置行人种子值，用于随机生成行人的位置等
   }
 
+  bool Simulator::SetPedestriansTileSize(float tile_size) {
+    DEBUG_ASSERT(_episode != nullptr);
+    auto nav = _episode->CreateNavigationIfMissing();
+    return nav->SetPedestriansTileSize(tile_size);// 设置人群方格的边长
+  }
+
+  nav::CrowdTickStats Simulator::GetPedestriansTickStats() {
+    DEBUG_ASSERT(_episode != nullptr);
+    auto nav = _episode->CreateNavigationIfMissing();
+    return nav->GetCrowdTickStats();
+  }
+
   // ===========================================================================
   // -- 参与者的一般操作 --------------------------------------------------------
   // ===========================================================================
@@ -132,6 +132,20 @@ namespace detail {
       return WorldSnapshot{_episode->GetState()};
     }
 
+    // 只接收满足过滤条件的参与者的世界状态，加载新的地图后继续生效
+    void SetStateFilter(const rpc::EpisodeStateFilter &filter) {
+      DEBUG_ASSERT(_episode != nullptr);
+      _episode->SetStateFilter(filter);
+      _state_filter = filter;
+    }
+
+    // 恢复接收完整的世界状态
+    void ClearStateFilter() {
+      DEBUG_ASSERT(_episode != nullptr);
+      _episode->ClearStateFilter();
+      _state_filter.reset();
+    }
+
     /// @}
     // =========================================================================
     /// @name 地图相关的方法
@@ -350,6 +364,10 @@ namespace detail {
     void SetPedestriansCrossFactor(float percentage);
     // 设置行人行为的随机种子，可能影响行人生成或路径选择的随机性
     void SetPedestriansSeed(unsigned int seed);
+    // 设置行人人群按方格划分的边长，每个方格的人群并行更新
+    bool SetPedestriansTileSize(float tile_size);
+    // 返回行人导航节拍的累计耗时统计
+    nav::CrowdTickStats GetPedestriansTickStats();
 
     /// @}
     // =========================================================================
@@ -902,6 +920,9 @@ namespace detail {
     // 任务场景的 Episode（任务执行环境）
     std::shared_ptr<Episode> _episode;
 
+    // 世界状态的过滤条件，创建新的 Episode 时重新应用
+    boost::optional<rpc::EpisodeStateFilter> _state_filter;
+
     // 垃圾回收策略
     const GarbageCollectionPolicy _gc_policy;
 
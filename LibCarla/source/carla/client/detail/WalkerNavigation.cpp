@@ -6,6 +6,7 @@
 
 #include "carla/client/detail/WalkerNavigation.h"
 
+#include "carla/StopWatch.h"
 #include "carla/client/detail/Client.h"
 #include "carla/client/detail/Episode.h"
 #include "carla/client/detail/EpisodeState.h"
@@ -36,6 +37,8 @@ namespace detail {
       return;
     }
 
+    StopWatch tick_watch;
+
     // 获取当前状态
     std::shared_ptr<const EpisodeState> state = episode->GetState();
 
@@ -48,36 +51,46 @@ namespace detail {
     // 更新导航模块中的人群
     _nav.UpdateCrowd(*state);
 
-    carla::geom::Transform trans;
+    // 一次性从人群快照中取得所有行人的变换与状态
+    std::vector<ActorId> ids;
+    ids.reserve(walkers->size());
+    for (auto handle : *walkers) {
+      ids.push_back(handle.walker);
+    }
+    std::vector<carla::nav::WalkerSnapshot> snapshots = _nav.GetWalkerSnapshots(ids);
+
     using Cmd = rpc::Command;
     std::vector<Cmd> commands;
-    commands.reserve(walkers->size());
-    for (auto handle : *walkers) {
-      // 获取行人的变换
-      if (_nav.GetWalkerTransform(handle.walker, trans)) {
-        float speed = _nav.GetWalkerSpeed(handle.walker);
-        commands.emplace_back(Cmd::ApplyWalkerState{ handle.walker, trans, speed });
+    commands.reserve(snapshots.size());
+    for (auto &walker : snapshots) {
+      if (walker.active) {
+        commands.emplace_back(Cmd::ApplyWalkerState{ walker.id, walker.transform, walker.speed });
       }
     }
-    _simulator.lock()->ApplyBatchSync(std::move(commands), false);
-
-    // 检查是否所有代理已被杀死
-    bool alive;
-    for (auto handle : *walkers) {
-      // 获取代理状态
-      if (_nav.IsWalkerAlive(handle.walker, alive)) {
-        if (!alive) {
-          _simulator.lock()->SetActorCollisions(handle.walker, true);
-          _simulator.lock()->SetActorDead(handle.walker);
-          // 从人群中移除
-          _nav.RemoveAgent(handle.walker);
-          // 销毁控制器
-          _simulator.lock()->DestroyActor(handle.controller);
-          // 从列表中取消注册
-          UnregisterWalker(handle.walker, handle.controller);
-        }
+    // 异步发送，不再等待服务器逐条返回结果
+    _simulator.lock()->ApplyBatch(std::move(commands), false);
+
+    // 检查是否所有代理已被杀死（快照与行人列表顺序一致）
+    size_t index = 0u;
+    for (auto &walker : snapshots) {
+      while ((*walkers)[index].walker != walker.id) {
+        ++index;
+      }
+      const WalkerHandle handle = (*walkers)[index];
+      if (!walker.alive) {
+        _simulator.lock()->SetActorCollisions(handle.walker, true);
+        _simulator.lock()->SetActorDead(handle.walker);
+        // 从人群中移除
+        _nav.RemoveAgent(handle.walker);
+        // 销毁控制器
+        _simulator.lock()->DestroyActor(handle.controller);
+        // 从列表中取消注册
+        UnregisterWalker(handle.walker, handle.controller);
       }
     }
+
+    _tick_us += tick_watch.GetElapsedTime<std::chrono::microseconds>();
+    ++_tick_count;
   }
 
   void WalkerNavigation::CheckIfWalkerExist(std::vector<WalkerHandle> walkers, const EpisodeState &state) {
@@ -86,8 +99,8 @@ namespace detail {
     if (_next_check_index >= walkers.size())
       _next_check_index = 0;
 
-    // 检查存在
-    if (!state.ContainsActorSnapshot(walkers[_next_check_index].walker)) {
+    // 检查存在；设置了状态过滤时，过滤范围之外的行人没有快照，但仍然存在
+    if (!state.ContainsActor(walkers[_next_check_index].walker)) {
       // 从人群中移除
       _nav.RemoveAgent(walkers[_next_check_index].walker);
       // 销毁控制器
@@ -111,10 +124,13 @@ namespace detail {
     for (auto &&actor : episode->GetActors()) {
       // 仅限车辆
       if (actor.description.id.rfind("vehicle.", 0) == 0) {
-        // 获取快照
-        ActorSnapshot snapshot = state->GetActorSnapshot(actor.id);
+        // 获取快照；被状态过滤掉的车辆没有位置，不加入人群
+        auto snapshot = state->GetActorSnapshotIfPresent(actor.id);
+        if (!snapshot) {
+          continue;
+        }
         // 添加到向量
-        vehicles.emplace_back(carla::nav::VehicleCollisionInfo{actor.id, snapshot.transform, actor.bounding_box});
+        vehicles.emplace_back(carla::nav::VehicleCollisionInfo{actor.id, snapshot->transform, actor.bounding_box});
       }
     }
 
@@ -123,65 +139,66 @@ namespace detail {
 
     // 可选的调试信息
     if (show_debug) {
-      if (_nav.GetCrowd() == nullptr) return;
-
-      // 绘制边界框以进行调试
-      for (int i = 0; i < _nav.GetCrowd()->getAgentCount(); ++i) {
-        // 获取代理
-        const dtCrowdAgent *agent = _nav.GetCrowd()->getAgent(i);
-        if (agent && agent->params.useObb) {
-          // 为了调试进行绘制
-          carla::geom::Location p1, p2, p3, p4;
-          p1.x = agent->params.obb[0];
-          p1.z = agent->params.obb[1];
-          p1.y = agent->params.obb[2];
-          p2.x = agent->params.obb[3];
-          p2.z = agent->params.obb[4];
-          p2.y = agent->params.obb[5];
-          p3.x = agent->params.obb[6];
-          p3.z = agent->params.obb[7];
-          p3.y = agent->params.obb[8];
-          p4.x = agent->params.obb[9];
-          p4.z = agent->params.obb[10];
-          p4.y = agent->params.obb[11];
-          carla::rpc::DebugShape line1;
-          line1.life_time = 0.01f;
-          line1.persistent_lines = false;
-          // line 1
-          line1.primitive = carla::rpc::DebugShape::Line {p1, p2, 0.2f};
-          line1.color = { 0, 255, 0 };
-          _simulator.lock()->DrawDebugShape(line1);
-          // line 2
-          line1.primitive = carla::rpc::DebugShape::Line {p2, p3, 0.2f};
-          line1.color = { 255, 0, 0 };
-          _simulator.lock()->DrawDebugShape(line1);
-          // line 3
-          line1.primitive = carla::rpc::DebugShape::Line {p3, p4, 0.2f};
-          line1.color = { 0, 0, 255 };
-          _simulator.lock()->DrawDebugShape(line1);
-          // line 4
-          line1.primitive = carla::rpc::DebugShape::Line {p4, p1, 0.2f};
-          line1.color = { 255, 255, 0 };
-          _simulator.lock()->DrawDebugShape(line1);
+      // 每个方格都有自己的人群
+      for (dtCrowd *crowd : _nav.GetCrowds()) {
+        // 绘制边界框以进行调试
+        for (int i = 0; i < crowd->getAgentCount(); ++i) {
+          // 获取代理
+          const dtCrowdAgent *agent = crowd->getAgent(i);
+          if (agent && agent->params.useObb) {
+            // 为了调试进行绘制
+            carla::geom::Location p1, p2, p3, p4;
+            p1.x = agent->params.obb[0];
+            p1.z = agent->params.obb[1];
+            p1.y = agent->params.obb[2];
+            p2.x = agent->params.obb[3];
+            p2.z = agent->params.obb[4];
+            p2.y = agent->params.obb[5];
+            p3.x = agent->params.obb[6];
+            p3.z = agent->params.obb[7];
+            p3.y = agent->params.obb[8];
+            p4.x = agent->params.obb[9];
+            p4.z = agent->params.obb[10];
+            p4.y = agent->params.obb[11];
+            carla::rpc::DebugShape line1;
+            line1.life_time = 0.01f;
+            line1.persistent_lines = false;
+            // line 1
+            line1.primitive = carla::rpc::DebugShape::Line {p1, p2, 0.2f};
+            line1.color = { 0, 255, 0 };
+            _simulator.lock()->DrawDebugShape(line1);
+            // line 2
+            line1.primitive = carla::rpc::DebugShape::Line {p2, p3, 0.2f};
+            line1.color = { 255, 0, 0 };
+            _simulator.lock()->DrawDebugShape(line1);
+            // line 3
+            line1.primitive = carla::rpc::DebugShape::Line {p3, p4, 0.2f};
+            line1.color = { 0, 0, 255 };
+            _simulator.lock()->DrawDebugShape(line1);
+            // line 4
+            line1.primitive = carla::rpc::DebugShape::Line {p4, p1, 0.2f};
+            line1.color = { 255, 255, 0 };
+            _simulator.lock()->DrawDebugShape(line1);
+          }
         }
-      }
 
-      // 为了调试绘制一些文本
-      for (int i = 0; i < _nav.GetCrowd()->getAgentCount(); ++i) {
-        // 获得智能体
-        const dtCrowdAgent *agent = _nav.GetCrowd()->getAgent(i);
-        if (agent) {
-          // 为了调试进行绘制
-          carla::geom::Location p1(agent->npos[0], agent->npos[2], agent->npos[1] + 1);
-          if (agent->params.userData) {
-            std::ostringstream out;
-            out << *(reinterpret_cast<const float *>(agent->params.userData));
-            carla::rpc::DebugShape text;
-            text.life_time = 0.01f;
-            text.persistent_lines = false;
-            text.primitive = carla::rpc::DebugShape::String {p1, out.str(), false};
-            text.color = { 0, 255, 0 };
-            _simulator.lock()->DrawDebugShape(text);
+        // 为了调试绘制一些文本
+        for (int i = 0; i < crowd->getAgentCount(); ++i) {
+          // 获得智能体
+          const dtCrowdAgent *agent = crowd->getAgent(i);
+          if (agent) {
+            // 为了调试进行绘制
+            carla::geom::Location p1(agent->npos[0], agent->npos[2], agent->npos[1] + 1);
+            if (agent->params.userData) {
+              std::ostringstream out;
+              out << *(reinterpret_cast<const float *>(agent->params.userData));
+              carla::rpc::DebugShape text;
+              text.life_time = 0.01f;
+              text.persistent_lines = false;
+              text.primitive = carla::rpc::DebugShape::String {p1, out.str(), false};
+              text.color = { 0, 255, 0 };
+              _simulator.lock()->DrawDebugShape(text);
+            }
           }
         }
       }
@@ -12,6 +12,7 @@
 #include "carla/client/Timestamp.h" // 引入时间戳头文件
 #include "carla/rpc/ActorId.h" // 引入参与者ID头文件
 
+#include <atomic> // 引入原子类型头文件
 #include <memory> // 引入智能指针头文件
 
 namespace carla { // 定义carla命名空间
@@ -85,12 +86,29 @@ namespace detail { // 定义detail子命名空间
       _nav.SetSeed(seed); // 设置随机种子
     }
 
+    // 设置行人人群划分方格的边长（米）
+    bool SetPedestriansTileSize(float tile_size) {
+      return _nav.SetCrowdTileSize(tile_size);
+    }
+
+    /// 人群更新各阶段以及整个导航节拍（包括发送行人命令）的累计耗时（微秒）
+    carla::nav::CrowdTickStats GetCrowdTickStats() const {
+      carla::nav::CrowdTickStats stats = _nav.GetTickStats();
+      stats.navigation_ticks = _tick_count;
+      stats.navigation_us = _tick_us;
+      return stats;
+    }
+
   private:
 
     std::weak_ptr<Simulator> _simulator; // 存储弱指针模拟器
 
     unsigned long _next_check_index; // 存储下一个检查索引
 
+    std::atomic<uint64_t> _tick_count { 0u }; // Tick 调用次数
+
+    std::atomic<uint64_t> _tick_us { 0u }; // Tick 累计耗时（微秒）
+
     carla::nav::Navigation _nav; // 存储导航对象
 
     struct WalkerHandle { // 定义WalkerHandle结构
@@ -6,6 +6,7 @@
 
 #include <carla/geom/Mesh.h>
 
+#include <algorithm>
 #include <string>
 #include <sstream>
 #include <ios>
@@ -57,6 +58,10 @@ void Mesh::AddTriangleStrip(const std::vector<Mesh::vertex_type> &vertices) {
     // 使用DEBUG_ASSERT进行调试断言，确保传入的顶点数量至少为3个
     // 因为三角形条带至少需要3个顶点才能构成最基本的图形结构，否则不符合逻辑
     DEBUG_ASSERT(vertices.size() >= 3);
+    // 发布版本中断言不生效，不足3个顶点时同样直接返回
+    if (vertices.size() < 3) {
+      return;
+    }
 
     // 获取当前Mesh对象已有的顶点数量，然后在此基础上加2，用于后续构建三角形条带索引时的起始位置计算
     // 这个起始位置的计算方式是基于Mesh对象内部存储顶点和索引的机制来确定的
@@ -122,7 +127,14 @@ void Mesh::AddTriangleStrip(const std::vector<Mesh::vertex_type> &vertices) {
   }
 
   void Mesh::AddVertices(const std::vector<Mesh::vertex_type> &vertices) {
-    std::copy(vertices.begin(), vertices.end(), std::back_inserter(_vertices));
+    _vertices.insert(_vertices.end(), vertices.begin(), vertices.end());
+  }
+
+  void Mesh::Reserve(size_t vertices, size_t indexes, size_t normals, size_t uvs) {
+    _vertices.reserve(vertices);
+    _indexes.reserve(indexes);
+    _normals.reserve(normals);
+    _uvs.reserve(uvs);
   }
 
   void Mesh::AddNormal(normal_type normal) {
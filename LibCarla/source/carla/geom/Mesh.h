@@ -97,6 +97,9 @@ namespace geom {
     /// 添加纹理映射坐标(Texture-Mapping Coordinates, UV)
     void AddUVs(const std::vector<uv_type> & uv);
 
+    /// 预先为顶点、索引、法线和纹理坐标分配空间，避免逐个添加时反复扩容。
+    void Reserve(size_t vertices, size_t indexes, size_t normals = 0u, size_t uvs = 0u);
+
     /// 开始将新材质应用到新添加的三角形。
     void AddMaterial(const std::string &material_name);
 
@@ -7,6 +7,7 @@
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
 #include "carla/geom/Simplification.h"
+#include "carla/ParallelFor.h"
 #include "simplify/Simplify.h"
 
 // 定义在carla和geom命名空间下，这里应该是实现与几何图形简化相关的功能模块
@@ -16,6 +17,8 @@ namespace geom {
   void Simplification::Simplificate(const std::unique_ptr<geom::Mesh>& pmesh){
   	// 创建一个简化对象
     Simplify::SimplificationObject Simplification;
+    Simplification.vertices.reserve(pmesh->GetVerticesNum()); // 预先分配顶点和三角形的空间
+    Simplification.triangles.reserve(pmesh->GetIndexesNum() / 3u);
     // 将输入网格的顶点转换为简化对象的顶点格式，并添加到简化对象中
     for (carla::geom::Vector3D& current_vertex : pmesh->GetVertices()) {
       Simplify::Vertex v;
@@ -30,7 +33,7 @@ namespace geom {
       Simplify::Triangle t;
       t.material = 0;
       // 获取输入网格的索引列表，以便后续构建三角形的顶点索引关系。
-      auto indices = pmesh->GetIndexes();
+      const auto &indices = pmesh->GetIndexes(); // 使用引用，避免每个三角形都复制整个索引数组
       // 根据索引确定三角形的第一个顶点在顶点列表中的位置，注意这里减 1 可能是因为索引的计数方式在不同数据结构中的差异（比如从 0 开始还是从 1 开始等）。
       t.v[0] = (indices[i]) - 1;
       t.v[1] = (indices[i + 1]) - 1;
@@ -67,5 +70,19 @@ namespace geom {
     }
   }
 
+  // 并行简化多个网格
+  void Simplification::Simplificate(const std::vector<std::unique_ptr<geom::Mesh>>& meshes) {
+    ParallelFor(meshes.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const auto &mesh = meshes[i];
+        // 跳过没有三角形或索引不完整的网格
+        if (mesh != nullptr && !mesh->GetVertices().empty() &&
+            mesh->GetIndexesNum() >= 3u && mesh->GetIndexesNum() % 3u == 0u) {
+          Simplificate(meshes[i]);
+        }
+      }
+    });
+  }
+
 } // namespace geom
 } // namespace carla
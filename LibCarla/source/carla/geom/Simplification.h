@@ -8,6 +8,9 @@
 
 #include "carla/geom/Mesh.h" // 包含Mesh类的定义
 
+#include <memory>
+#include <vector>
+
 namespace carla {
 namespace geom {
 
@@ -23,6 +26,10 @@ namespace geom {
     float simplification_percentage; // 存储简化率
 
     void Simplificate(const std::unique_ptr<geom::Mesh>& pmesh); // 声明简化函数
+
+    /// 在共享线程池上并行简化 @a meshes 中的每个网格。每个网格的简化
+    /// 相互独立，因此结果与线程数量无关。
+    void Simplificate(const std::vector<std::unique_ptr<geom::Mesh>>& meshes);
   };
 
 } // namespace geom
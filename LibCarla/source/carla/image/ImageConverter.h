@@ -7,6 +7,9 @@
 #pragma once // 确保头文件只被包含一次
 
 #include "carla/image/ImageView.h" // 引入ImageView头文件
+#include "carla/image/VectorizedColorConverter.h" // BGRA8 图像的向量化转换
+
+#include <cstdint>
 
 namespace carla { // carla命名空间
 namespace image { // image子命名空间
@@ -28,6 +31,44 @@ namespace image { // image子命名空间
           ImageView::MakeColorConvertedView<MutableImageView, DstPixelT>(image_view, converter), // 创建颜色转换后的视图
           image_view); // 目标为原始图像视图
     }
+
+    // BGRA8 图像（传感器图像的视图）使用向量化实现，结果与上面的逐像素转换相同
+    static void ConvertInPlace(boost::gil::bgra8_view_t &image_view, ColorConverter::Depth) {
+      ForEachRow(image_view, [](uint8_t *data, size_t count) {
+        VectorizedColorConverter::Depth(data, count);
+      });
+    }
+
+    static void ConvertInPlace(boost::gil::bgra8_view_t &image_view, ColorConverter::LogarithmicDepth) {
+      ForEachRow(image_view, [](uint8_t *data, size_t count) {
+        VectorizedColorConverter::LogarithmicDepth(data, count);
+      });
+    }
+
+    static void ConvertInPlace(boost::gil::bgra8_view_t &image_view, ColorConverter::CityScapesPalette) {
+      ForEachRow(image_view, [](uint8_t *data, size_t count) {
+        VectorizedColorConverter::CityScapesPalette(data, count);
+      });
+    }
+
+  private:
+
+    /// 连续存储的视图一次处理全部像素，否则逐行处理。
+    template <typename FunctorT>
+    static void ForEachRow(boost::gil::bgra8_view_t &image_view, FunctorT &&functor) {
+      const auto width = static_cast<size_t>(image_view.width());
+      const auto height = static_cast<size_t>(image_view.height());
+      if (width == 0u || height == 0u) {
+        return;
+      }
+      if (image_view.is_1d_traversable()) {
+        functor(reinterpret_cast<uint8_t *>(&image_view(0, 0)), width * height);
+        return;
+      }
+      for (size_t y = 0u; y < height; ++y) {
+        functor(reinterpret_cast<uint8_t *>(image_view.row_begin(static_cast<std::ptrdiff_t>(y))), width);
+      }
+    }
   };
 
 } // namespace image
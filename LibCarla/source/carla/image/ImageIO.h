@@ -6,8 +6,16 @@
 
 #pragma once  // 确保该头文件只被包含一次
 
+#include "carla/Exception.h"
 #include "carla/image/ImageIOConfig.h"  // 包含图像输入输出配置的头文件
 
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace carla {  // 定义命名空间 carla
 namespace image {  // 定义命名空间 image
 
@@ -26,6 +34,75 @@ namespace image {  // 定义命名空间 image
       IO::write_view(out_filename, image_view);  // 调用 IO 类的 write_view 方法写入图像视图
       return out_filename;  // 返回输出文件名
     }
+
+    /// 以指定的 zlib 压缩级别写入 PNG。级别越低编码越快，文件越大。没有编译
+    /// PNG 支持时与 WriteView 相同，忽略压缩级别。
+    template <typename ViewT>
+    static std::string WritePngView(std::string out_filename, const ViewT &image_view, int compression_level) {
+      if (!io::png::is_supported) {
+        return WriteView(std::move(out_filename), image_view);
+      }
+      io::png::write_view(out_filename, image_view, compression_level);
+      return out_filename;
+    }
+
+    /// 不做编码，将像素按行连续写入文件，每个通道一个字节。@a numpy_header
+    /// 为 true 时在数据前写入 NumPy .npy 头，可直接用 numpy.load 读取，
+    /// 数组形状为 (高, 宽, 通道)，单通道时为 (高, 宽)。
+    template <typename ViewT>
+    static std::string WriteRawView(std::string out_filename, const ViewT &image_view, bool numpy_header) {
+      using ChannelT = typename boost::gil::channel_type<ViewT>::type;
+      static_assert(sizeof(ChannelT) == 1u, "Only 8-bit channels can be written as raw data");
+      constexpr size_t channels = boost::gil::num_channels<ViewT>::value;
+      const size_t width = static_cast<size_t>(image_view.width());
+      const size_t height = static_cast<size_t>(image_view.height());
+
+      FileSystem::ValidateFilePath(out_filename, numpy_header ? ".npy" : ".raw");
+      std::ofstream out(out_filename, std::ios::binary);
+      if (!out.good()) {
+        throw_exception(std::runtime_error("cannot open " + out_filename + " for writing"));
+      }
+      if (numpy_header) {
+        WriteNumPyHeader(out, height, width, channels);
+      }
+
+      std::vector<uint8_t> row(width * channels);
+      for (size_t y = 0u; y < height; ++y) {
+        auto it = image_view.row_begin(static_cast<std::ptrdiff_t>(y));
+        uint8_t *dst = row.data();
+        for (size_t x = 0u; x < width; ++x, ++it) {
+          const auto pixel = *it;
+          for (size_t c = 0u; c < channels; ++c) {
+            *dst++ = static_cast<uint8_t>(pixel[c]);
+          }
+        }
+        out.write(reinterpret_cast<const char *>(row.data()), static_cast<std::streamsize>(row.size()));
+      }
+      return out_filename;
+    }
+
+  private:
+
+    /// NumPy 1.0 格式头：魔数、版本、头长度以及描述 uint8 数组的字典，
+    /// 用空格补齐使数据按 64 字节对齐。
+    static void WriteNumPyHeader(std::ostream &out, size_t height, size_t width, size_t channels) {
+      std::string dict = "{'descr': '|u1', 'fortran_order': False, 'shape': (" +
+          std::to_string(height) + ", " + std::to_string(width);
+      if (channels > 1u) {
+        dict += ", " + std::to_string(channels);
+      }
+      dict += "), }";
+      constexpr size_t preamble = 10u; // 魔数 6 字节、版本 2 字节、头长度 2 字节
+      const size_t total = preamble + dict.size() + 1u;
+      dict.append((64u - total % 64u) % 64u, ' ');
+      dict += '\n';
+      const uint16_t length = static_cast<uint16_t>(dict.size());
+      const char magic[] = {'\x93', 'N', 'U', 'M', 'P', 'Y', '\x01', '\x00'};
+      out.write(magic, sizeof(magic));
+      const char length_le[] = {static_cast<char>(length & 0xFF), static_cast<char>(length >> 8)};
+      out.write(length_le, sizeof(length_le));
+      out.write(dict.data(), static_cast<std::streamsize>(dict.size()));
+    }
   };
 
 } // namespace image
@@ -6,6 +6,7 @@
 
 #pragma once  // 确保头文件只被包含一次
 
+#include "carla/Debug.h"       // 引入断言宏
 #include "carla/FileSystem.h"  // 引入文件系统相关的头文件
 #include "carla/Logging.h"     // 引入日志记录相关的头文件
 #include "carla/StringUtil.h"  // 引入字符串工具相关的头文件
@@ -102,6 +103,9 @@ namespace detail {  // 定义命名空间detail
   };
 
   struct io_png {  // 定义PNG输入输出结构体
+
+    static constexpr bool is_supported = has_png_support(); // 检查是否支持PNG格式
+
 #if LIBCARLA_IMAGE_WITH_PNG_SUPPORT // 如果支持PNG格式
 
     static constexpr const char *get_default_extension() { // 获取默认扩展名
@@ -123,6 +127,16 @@ namespace detail {  // 定义命名空间detail
       boost::gil::write_view(std::forward<Str>(out_filename), view, boost::gil::png_tag()); // 使用boost库写入PNG视图
     }
 
+    /// 以指定的 zlib 压缩级别写入（0 不压缩，9 最高压缩，-1 使用默认级别）
+    template <typename Str, typename ViewT>
+    static void write_view(Str &&out_filename, const ViewT &view, int compression_level) {
+      using namespace boost::gil;
+      boost::gil::write_view(
+          std::forward<Str>(out_filename),
+          view,
+          image_write_info<png_tag>(png_compression_type::default_value, compression_level));
+    }
+
 #endif // LIBCARLA_IMAGE_WITH_PNG_SUPPORT // 结束PNG支持条件编译
 
   };
@@ -163,6 +177,7 @@ namespace detail {  // 定义命名空间detail
           boost::gil::jpeg_tag()); // 使用boost库写入JPEG视图
     }
 #endif // LIBCARLA_IMAGE_WITH_JPEG_SUPPORT // 结束JPEG支持的条件编译
+  };
 
 struct io_tiff { // 定义一个io_tiff结构体
 
@@ -0,0 +1,139 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/BoundedWorkQueue.h" // 后台编码线程和有界队列
+#include "carla/Exception.h"
+#include "carla/FileSystem.h"
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/StringUtil.h"
+#include "carla/image/ImageIO.h"
+#include "carla/image/ImageView.h"
+#include "carla/sensor/data/Image.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace carla {
+namespace image {
+
+  /// 写入前对图像做的颜色转换，与 Python 的 carla.ColorConverter 一致。
+  enum class ImageColorConversion : uint8_t {
+    Raw,
+    Depth,
+    LogarithmicDepth,
+    CityScapesPalette
+  };
+
+  struct ImageWriteOptions {
+    ImageColorConversion color_conversion = ImageColorConversion::Raw;
+    /// PNG 的 zlib 压缩级别（0-9），负数表示使用 ImageIO 的默认设置。
+    int png_compression_level = -1;
+  };
+
+  /// 在线程池中对图像做颜色转换、编码并写入磁盘，传感器回调只需把
+  /// 图像放入队列。
+  ///
+  /// 队列中保存图像的共享指针，不复制像素缓冲区。队列满时根据构造参数
+  /// 阻塞调用者或丢弃该帧，可通过 GetStats() 观察。输出格式由扩展名决定：
+  /// ".npy" 写入 NumPy 数组，".raw" 或 ".bin" 写入未编码的像素，其余交给
+  /// ImageIO（PNG、JPEG、TIFF）。
+  class ImageWriter : private NonCopyable {
+  public:
+
+    using Stats = BoundedWorkQueue::Stats;
+
+    using ColorConversion = ImageColorConversion;
+
+    using Options = ImageWriteOptions;
+
+    /// @a number_of_threads 为 0 时使用硬件线程数。
+    explicit ImageWriter(
+        size_t number_of_threads = 0u,
+        size_t max_queue_size = 32u,
+        bool block_when_full = true)
+      : _queue(
+            number_of_threads > 0u ? number_of_threads : std::thread::hardware_concurrency(),
+            max_queue_size,
+            block_when_full) {}
+
+    /// 将 @a image 放入写入队列，返回最终写入的文件路径。没有扩展名时
+    /// 写入 PNG。目录在调用线程中创建，返回的路径即最终路径。
+    std::string Save(
+        std::string path,
+        SharedPtr<sensor::data::Image> image,
+        const Options &options = Options{}) {
+      DEBUG_ASSERT(image != nullptr);
+      if (options.color_conversion > ColorConversion::CityScapesPalette) {
+        throw_exception(std::invalid_argument("invalid color converter!"));
+      }
+      FileSystem::ValidateFilePath(path, ".png");
+      _queue.Push([path, image, options]() {
+        WriteImage(path, *image, options);
+      });
+      return path;
+    }
+
+    /// 阻塞直到队列中的图像全部写入磁盘。
+    void Flush() {
+      _queue.Flush();
+    }
+
+    Stats GetStats() const {
+      return _queue.GetStats();
+    }
+
+    size_t GetNumberOfThreads() const {
+      return _queue.GetNumberOfThreads();
+    }
+
+    /// 同步地转换并写入一张图像，由工作线程调用。
+    static std::string WriteImage(
+        const std::string &path,
+        const sensor::data::Image &image,
+        const Options &options) {
+      auto view = ImageView::MakeView(image);
+      const int level = options.png_compression_level;
+      switch (options.color_conversion) {
+        case ColorConversion::Raw:
+          return WriteView(path, view, level);
+        case ColorConversion::Depth:
+          return WriteView(path, ImageView::MakeColorConvertedView(view, ColorConverter::Depth()), level);
+        case ColorConversion::LogarithmicDepth:
+          return WriteView(path, ImageView::MakeColorConvertedView(view, ColorConverter::LogarithmicDepth()), level);
+        case ColorConversion::CityScapesPalette:
+          return WriteView(path, ImageView::MakeColorConvertedView(view, ColorConverter::CityScapesPalette()), level);
+        default:
+          throw_exception(std::invalid_argument("invalid color converter!"));
+      }
+      return path;
+    }
+
+  private:
+
+    template <typename ViewT>
+    static std::string WriteView(const std::string &path, const ViewT &view, int png_compression_level) {
+      if (StringUtil::EndsWith(path, ".npy")) {
+        return ImageIO::WriteRawView(path, view, true);
+      }
+      if (StringUtil::EndsWith(path, ".raw") || StringUtil::EndsWith(path, ".bin")) {
+        return ImageIO::WriteRawView(path, view, false);
+      }
+      if (png_compression_level >= 0 && StringUtil::EndsWith(path, ".png")) {
+        return ImageIO::WritePngView(path, view, png_compression_level);
+      }
+      return ImageIO::WriteView(path, view);
+    }
+
+    BoundedWorkQueue _queue;
+  };
+
+} // namespace image
+} // namespace carla
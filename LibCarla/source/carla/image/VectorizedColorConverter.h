@@ -0,0 +1,439 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/image/CityScapesPalette.h" // 调色板颜色表
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define LIBCARLA_IMAGE_WITH_X86_SIMD 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  endif
+#else
+#  define LIBCARLA_IMAGE_WITH_X86_SIMD 0
+#endif
+
+// GCC 和 Clang 需要为使用 SSE4.1/AVX2 指令的函数单独指定目标指令集，
+// 这样库本身不必使用 -mavx2 编译，在运行时根据 CPU 选择实现。
+#if LIBCARLA_IMAGE_WITH_X86_SIMD && (defined(__GNUC__) || defined(__clang__))
+#  define LIBCARLA_SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#  define LIBCARLA_SIMD_TARGET(isa)
+#endif
+
+namespace carla {
+namespace image {
+
+  /// 颜色转换使用的指令集，数值越大越快。
+  enum class SimdLevel : uint8_t {
+    Scalar,
+    SSE41,
+    AVX2
+  };
+
+namespace detail {
+
+  /// 24 位深度编码的最大值，256 * 256 * 256 - 1。
+  static constexpr float DEPTH_NORMALIZER = 16777215.0f;
+
+  /// 将 [0, 255] 的灰度级打包为 BGRA 像素（不透明）。
+  inline uint32_t PackGray(uint32_t level) {
+    return level * 0x00010101u | 0xFF000000u;
+  }
+
+  /// BGRA 像素中 R + G * 256 + B * 65536 编码的深度。
+  inline uint32_t DecodeDepth(uint32_t bgra) {
+    return ((bgra >> 16u) & 0xFFu) | (bgra & 0xFF00u) | ((bgra & 0xFFu) << 16u);
+  }
+
+  /// 与 ColorConverter::Depth 写入 8 位通道时完全相同的浮点运算。
+  inline uint32_t DepthLevel(uint32_t depth) {
+    const float normalized = static_cast<float>(depth) / DEPTH_NORMALIZER;
+    return static_cast<uint32_t>(normalized * 255.0f + 0.5f);
+  }
+
+  /// 与 ColorConverter::LogarithmicDepth 写入 8 位通道时完全相同的浮点运算。
+  inline uint32_t LogarithmicDepthLevel(uint32_t depth) {
+    const float normalized = static_cast<float>(depth) / DEPTH_NORMALIZER;
+    const float value = 1.0f + std::log(normalized) / 5.70378f;
+    const float clamped = std::max(std::min(value, 1.0f), 0.005f);
+    return static_cast<uint32_t>(clamped * 255.0f + 0.5f);
+  }
+
+  /// 对数深度的查找表。按深度的浮点指数和最高 7 位尾数分桶，每个桶跨越
+  /// 不到 0.4 个输出级，所以桶内最多出现一次级数变化：
+  /// level = base[bucket] + (depth >= threshold[bucket])。
+  /// 表由 LogarithmicDepthLevel 生成，结果与逐像素计算完全一致。
+  struct LogarithmicDepthTable {
+
+    static constexpr uint32_t MANTISSA_BITS = 7u;
+
+    static constexpr uint32_t NUMBER_OF_BUCKETS = 24u << MANTISSA_BITS;
+
+    static constexpr int32_t NO_THRESHOLD = std::numeric_limits<int32_t>::max();
+
+    static uint32_t GetBucket(uint32_t depth) {
+      const float value = static_cast<float>(std::max(depth, 1u));
+      uint32_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      return (bits >> (23u - MANTISSA_BITS)) - (127u << MANTISSA_BITS);
+    }
+
+    /// 桶中的最小深度，深度 0 归入第一个桶。
+    static uint32_t GetBucketBegin(uint32_t bucket) {
+      if (bucket == 0u) {
+        return 0u;
+      }
+      if (bucket >= NUMBER_OF_BUCKETS) {
+        return 1u << 24u;
+      }
+      const uint32_t bits = (bucket + (127u << MANTISSA_BITS)) << (23u - MANTISSA_BITS);
+      float value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return static_cast<uint32_t>(std::ceil(value));
+    }
+
+    LogarithmicDepthTable() {
+      for (uint32_t bucket = 0u; bucket < NUMBER_OF_BUCKETS; ++bucket) {
+        const uint32_t begin = GetBucketBegin(bucket);
+        const uint32_t end = GetBucketBegin(bucket + 1u);
+        threshold[bucket] = NO_THRESHOLD;
+        if (begin >= end) {
+          base[bucket] = 0; // 空桶，不会被访问
+          continue;
+        }
+        const uint32_t first = LogarithmicDepthLevel(begin);
+        const uint32_t last = LogarithmicDepthLevel(end - 1u);
+        DEBUG_ASSERT(last <= first + 1u);
+        base[bucket] = static_cast<int32_t>(first);
+        if (last != first) {
+          // 二分查找级数变化的第一个深度
+          uint32_t low = begin;
+          uint32_t high = end - 1u;
+          while (high - low > 1u) {
+            const uint32_t middle = low + (high - low) / 2u;
+            if (LogarithmicDepthLevel(middle) == first) {
+              low = middle;
+            } else {
+              high = middle;
+            }
+          }
+          threshold[bucket] = static_cast<int32_t>(high);
+        }
+      }
+    }
+
+    uint32_t GetLevel(uint32_t depth) const {
+      const uint32_t bucket = GetBucket(depth);
+      return static_cast<uint32_t>(base[bucket]) +
+          (static_cast<int32_t>(depth) >= threshold[bucket] ? 1u : 0u);
+    }
+
+    alignas(32) int32_t base[NUMBER_OF_BUCKETS];
+
+    alignas(32) int32_t threshold[NUMBER_OF_BUCKETS];
+  };
+
+  inline const LogarithmicDepthTable &GetLogarithmicDepthTable() {
+    static const LogarithmicDepthTable table;
+    return table;
+  }
+
+  /// 以 R 通道的语义标签为索引的 BGRA 调色板。
+  struct CityScapesPaletteTable {
+    CityScapesPaletteTable() {
+      for (uint32_t tag = 0u; tag < 256u; ++tag) {
+        const auto color = CityScapesPalette::GetColor(static_cast<uint8_t>(tag));
+        const uint32_t bgra =
+            static_cast<uint32_t>(color[2u]) |
+            (static_cast<uint32_t>(color[1u]) << 8u) |
+            (static_cast<uint32_t>(color[0u]) << 16u) |
+            0xFF000000u;
+        std::memcpy(&color_of_tag[tag], &bgra, sizeof(bgra));
+      }
+    }
+
+    alignas(32) int32_t color_of_tag[256u];
+  };
+
+  inline const CityScapesPaletteTable &GetCityScapesPaletteTable() {
+    static const CityScapesPaletteTable table;
+    return table;
+  }
+
+} // namespace detail
+
+  /// 在 BGRA8 像素缓冲区上原地执行 ColorConverter 的深度、对数深度和
+  /// CityScapes 调色板转换，结果与逐像素的 ColorConverter 逐字节相同。
+  ///
+  /// 根据运行时检测到的 CPU 特性在 AVX2、SSE4.1 和标量实现之间选择；
+  /// 也可以显式指定指令集（高于 CPU 支持的级别时自动降级）。
+  class VectorizedColorConverter {
+  public:
+
+    /// 当前 CPU 支持的最高指令集。
+    static SimdLevel GetSupportedSimdLevel() {
+      static const SimdLevel level = DetectSimdLevel();
+      return level;
+    }
+
+    static void Depth(uint8_t *bgra, size_t number_of_pixels, SimdLevel level = GetSupportedSimdLevel()) {
+      switch (ClampSimdLevel(level)) {
+#if LIBCARLA_IMAGE_WITH_X86_SIMD
+        case SimdLevel::AVX2:
+          return DepthAVX2(bgra, number_of_pixels);
+        case SimdLevel::SSE41:
+          return DepthSSE41(bgra, number_of_pixels);
+#endif
+        default:
+          return DepthScalar(bgra, number_of_pixels);
+      }
+    }
+
+    static void LogarithmicDepth(uint8_t *bgra, size_t number_of_pixels, SimdLevel level = GetSupportedSimdLevel()) {
+      switch (ClampSimdLevel(level)) {
+#if LIBCARLA_IMAGE_WITH_X86_SIMD
+        case SimdLevel::AVX2:
+          return LogarithmicDepthAVX2(bgra, number_of_pixels);
+        case SimdLevel::SSE41:
+          return LogarithmicDepthSSE41(bgra, number_of_pixels);
+#endif
+        default:
+          return LogarithmicDepthScalar(bgra, number_of_pixels);
+      }
+    }
+
+    /// SSE4.1 没有 gather 指令，此时使用标量查表。
+    static void CityScapesPalette(uint8_t *bgra, size_t number_of_pixels, SimdLevel level = GetSupportedSimdLevel()) {
+      switch (ClampSimdLevel(level)) {
+#if LIBCARLA_IMAGE_WITH_X86_SIMD
+        case SimdLevel::AVX2:
+          return CityScapesPaletteAVX2(bgra, number_of_pixels);
+#endif
+        default:
+          return CityScapesPaletteScalar(bgra, number_of_pixels);
+      }
+    }
+
+  private:
+
+    static SimdLevel ClampSimdLevel(SimdLevel level) {
+      return std::min(level, GetSupportedSimdLevel());
+    }
+
+    static SimdLevel DetectSimdLevel() {
+#if LIBCARLA_IMAGE_WITH_X86_SIMD && (defined(__GNUC__) || defined(__clang__))
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+      }
+      if (__builtin_cpu_supports("sse4.1")) {
+        return SimdLevel::SSE41;
+      }
+#elif LIBCARLA_IMAGE_WITH_X86_SIMD && defined(_MSC_VER)
+      int info[4];
+      __cpuid(info, 0);
+      const int max_leaf = info[0];
+      __cpuid(info, 1);
+      const bool sse41 = (info[2] & (1 << 19)) != 0;
+      const bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+      if (max_leaf >= 7 && os_saves_ymm) {
+        __cpuidex(info, 7, 0);
+        if ((info[1] & (1 << 5)) != 0) {
+          return SimdLevel::AVX2;
+        }
+      }
+      if (sse41) {
+        return SimdLevel::SSE41;
+      }
+#endif
+      return SimdLevel::Scalar;
+    }
+
+    static uint32_t LoadPixel(const uint8_t *bgra) {
+      uint32_t pixel;
+      std::memcpy(&pixel, bgra, sizeof(pixel));
+      return pixel;
+    }
+
+    static void StorePixel(uint8_t *bgra, uint32_t pixel) {
+      std::memcpy(bgra, &pixel, sizeof(pixel));
+    }
+
+    // =========================================================================
+    // -- 标量实现 -------------------------------------------------------------
+    // =========================================================================
+
+    static void DepthScalar(uint8_t *bgra, size_t number_of_pixels) {
+      for (size_t i = 0u; i < number_of_pixels; ++i, bgra += 4u) {
+        const uint32_t depth = detail::DecodeDepth(LoadPixel(bgra));
+        StorePixel(bgra, detail::PackGray(detail::DepthLevel(depth)));
+      }
+    }
+
+    static void LogarithmicDepthScalar(uint8_t *bgra, size_t number_of_pixels) {
+      const auto &table = detail::GetLogarithmicDepthTable();
+      for (size_t i = 0u; i < number_of_pixels; ++i, bgra += 4u) {
+        const uint32_t depth = detail::DecodeDepth(LoadPixel(bgra));
+        StorePixel(bgra, detail::PackGray(table.GetLevel(depth)));
+      }
+    }
+
+    static void CityScapesPaletteScalar(uint8_t *bgra, size_t number_of_pixels) {
+      const auto &table = detail::GetCityScapesPaletteTable();
+      for (size_t i = 0u; i < number_of_pixels; ++i, bgra += 4u) {
+        StorePixel(bgra, static_cast<uint32_t>(table.color_of_tag[bgra[2u]]));
+      }
+    }
+
+#if LIBCARLA_IMAGE_WITH_X86_SIMD
+
+    // =========================================================================
+    // -- SSE4.1 实现，每次处理 4 个像素 ---------------------------------------
+    // =========================================================================
+
+    LIBCARLA_SIMD_TARGET("sse4.1")
+    static __m128i DecodeDepthSSE41(__m128i pixels) {
+      const __m128i shuffle = _mm_setr_epi8(
+          2, 1, 0, -128, 6, 5, 4, -128, 10, 9, 8, -128, 14, 13, 12, -128);
+      return _mm_shuffle_epi8(pixels, shuffle);
+    }
+
+    LIBCARLA_SIMD_TARGET("sse4.1")
+    static __m128i PackGraySSE41(__m128i level) {
+      return _mm_or_si128(
+          _mm_mullo_epi32(level, _mm_set1_epi32(0x00010101)),
+          _mm_set1_epi32(static_cast<int32_t>(0xFF000000u)));
+    }
+
+    LIBCARLA_SIMD_TARGET("sse4.1")
+    static void DepthSSE41(uint8_t *bgra, size_t number_of_pixels) {
+      const __m128 normalizer = _mm_set1_ps(detail::DEPTH_NORMALIZER);
+      const __m128 scale = _mm_set1_ps(255.0f);
+      const __m128 half = _mm_set1_ps(0.5f);
+      size_t i = 0u;
+      for (; i + 4u <= number_of_pixels; i += 4u) {
+        auto *data = reinterpret_cast<__m128i *>(bgra + 4u * i);
+        const __m128i depth = DecodeDepthSSE41(_mm_loadu_si128(data));
+        const __m128 normalized = _mm_div_ps(_mm_cvtepi32_ps(depth), normalizer);
+        const __m128i level = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(normalized, scale), half));
+        _mm_storeu_si128(data, PackGraySSE41(level));
+      }
+      DepthScalar(bgra + 4u * i, number_of_pixels - i);
+    }
+
+    LIBCARLA_SIMD_TARGET("sse4.1")
+    static void LogarithmicDepthSSE41(uint8_t *bgra, size_t number_of_pixels) {
+      using Table = detail::LogarithmicDepthTable;
+      const auto &table = detail::GetLogarithmicDepthTable();
+      const __m128i one = _mm_set1_epi32(1);
+      const __m128i bias = _mm_set1_epi32(127 << Table::MANTISSA_BITS);
+      alignas(16) int32_t bucket[4u];
+      size_t i = 0u;
+      for (; i + 4u <= number_of_pixels; i += 4u) {
+        auto *data = reinterpret_cast<__m128i *>(bgra + 4u * i);
+        const __m128i depth = DecodeDepthSSE41(_mm_loadu_si128(data));
+        const __m128i bits = _mm_castps_si128(_mm_cvtepi32_ps(_mm_max_epi32(depth, one)));
+        _mm_store_si128(
+            reinterpret_cast<__m128i *>(bucket),
+            _mm_sub_epi32(_mm_srli_epi32(bits, 23 - Table::MANTISSA_BITS), bias));
+        const __m128i base = _mm_setr_epi32(
+            table.base[bucket[0u]], table.base[bucket[1u]],
+            table.base[bucket[2u]], table.base[bucket[3u]]);
+        const __m128i threshold = _mm_setr_epi32(
+            table.threshold[bucket[0u]], table.threshold[bucket[1u]],
+            table.threshold[bucket[2u]], table.threshold[bucket[3u]]);
+        // depth >= threshold 时比较结果为 -1，减去即加一级
+        const __m128i level = _mm_sub_epi32(base, _mm_cmpgt_epi32(_mm_add_epi32(depth, one), threshold));
+        _mm_storeu_si128(data, PackGraySSE41(level));
+      }
+      LogarithmicDepthScalar(bgra + 4u * i, number_of_pixels - i);
+    }
+
+    // =========================================================================
+    // -- AVX2 实现，每次处理 8 个像素 -----------------------------------------
+    // =========================================================================
+
+    LIBCARLA_SIMD_TARGET("avx2")
+    static __m256i DecodeDepthAVX2(__m256i pixels) {
+      const __m256i shuffle = _mm256_setr_epi8(
+          2, 1, 0, -128, 6, 5, 4, -128, 10, 9, 8, -128, 14, 13, 12, -128,
+          2, 1, 0, -128, 6, 5, 4, -128, 10, 9, 8, -128, 14, 13, 12, -128);
+      return _mm256_shuffle_epi8(pixels, shuffle);
+    }
+
+    LIBCARLA_SIMD_TARGET("avx2")
+    static __m256i PackGrayAVX2(__m256i level) {
+      return _mm256_or_si256(
+          _mm256_mullo_epi32(level, _mm256_set1_epi32(0x00010101)),
+          _mm256_set1_epi32(static_cast<int32_t>(0xFF000000u)));
+    }
+
+    LIBCARLA_SIMD_TARGET("avx2")
+    static void DepthAVX2(uint8_t *bgra, size_t number_of_pixels) {
+      const __m256 normalizer = _mm256_set1_ps(detail::DEPTH_NORMALIZER);
+      const __m256 scale = _mm256_set1_ps(255.0f);
+      const __m256 half = _mm256_set1_ps(0.5f);
+      size_t i = 0u;
+      for (; i + 8u <= number_of_pixels; i += 8u) {
+        auto *data = reinterpret_cast<__m256i *>(bgra + 4u * i);
+        const __m256i depth = DecodeDepthAVX2(_mm256_loadu_si256(data));
+        const __m256 normalized = _mm256_div_ps(_mm256_cvtepi32_ps(depth), normalizer);
+        const __m256i level = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(normalized, scale), half));
+        _mm256_storeu_si256(data, PackGrayAVX2(level));
+      }
+      DepthScalar(bgra + 4u * i, number_of_pixels - i);
+    }
+
+    LIBCARLA_SIMD_TARGET("avx2")
+    static void LogarithmicDepthAVX2(uint8_t *bgra, size_t number_of_pixels) {
+      using Table = detail::LogarithmicDepthTable;
+      const auto &table = detail::GetLogarithmicDepthTable();
+      const __m256i one = _mm256_set1_epi32(1);
+      const __m256i bias = _mm256_set1_epi32(127 << Table::MANTISSA_BITS);
+      size_t i = 0u;
+      for (; i + 8u <= number_of_pixels; i += 8u) {
+        auto *data = reinterpret_cast<__m256i *>(bgra + 4u * i);
+        const __m256i depth = DecodeDepthAVX2(_mm256_loadu_si256(data));
+        const __m256i bits = _mm256_castps_si256(_mm256_cvtepi32_ps(_mm256_max_epi32(depth, one)));
+        const __m256i bucket = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23 - Table::MANTISSA_BITS), bias);
+        const __m256i base = _mm256_i32gather_epi32(table.base, bucket, 4);
+        const __m256i threshold = _mm256_i32gather_epi32(table.threshold, bucket, 4);
+        // depth >= threshold 时比较结果为 -1，减去即加一级
+        const __m256i level = _mm256_sub_epi32(base, _mm256_cmpgt_epi32(_mm256_add_epi32(depth, one), threshold));
+        _mm256_storeu_si256(data, PackGrayAVX2(level));
+      }
+      LogarithmicDepthScalar(bgra + 4u * i, number_of_pixels - i);
+    }
+
+    LIBCARLA_SIMD_TARGET("avx2")
+    static void CityScapesPaletteAVX2(uint8_t *bgra, size_t number_of_pixels) {
+      const auto &table = detail::GetCityScapesPaletteTable();
+      const __m256i mask = _mm256_set1_epi32(0xFF);
+      size_t i = 0u;
+      for (; i + 8u <= number_of_pixels; i += 8u) {
+        auto *data = reinterpret_cast<__m256i *>(bgra + 4u * i);
+        const __m256i tag = _mm256_and_si256(_mm256_srli_epi32(_mm256_loadu_si256(data), 16), mask);
+        _mm256_storeu_si256(data, _mm256_i32gather_epi32(table.color_of_tag, tag, 4));
+      }
+      CityScapesPaletteScalar(bgra + 4u * i, number_of_pixels - i);
+    }
+
+#endif // LIBCARLA_IMAGE_WITH_X86_SIMD
+  };
+
+} // namespace image
+} // namespace carla
@@ -18,14 +18,24 @@ enum MultiGPUCommand : uint32_t {
   ENABLE_ROS,  // 启用ROS（Robot Operating System）集成，ROS是一个用于机器人开发的灵活框架
   DISABLE_ROS, // 禁用ROS集成
   IS_ENABLED_ROS, // 查询ROS集成是否启用
-  YOU_ALIVE // 一种心跳或存活检查命令，用于确认接收方是否在线或响应
+  YOU_ALIVE, // 一种心跳或存活检查命令，用于确认接收方是否在线或响应
+  LOAD_REPORT // 辅助服务器主动发给主服务器的负载报告（见 SecondaryLoad）
 };
 // 定义一个结构体CommandHeader，用于表示命令的头部信息  
 // 头部信息通常包括命令的标识符和后续数据的大小
+// 辅助服务器发给主服务器的消息同样以命令头开头：命令的应答带有所应答命令
+// 的标识符，负载报告带有 LOAD_REPORT
 struct CommandHeader {
   MultiGPUCommand id; // 命令的标识符，从MultiGPUCommand枚举中选择
   uint32_t size; // 跟随此头部之后的数据的大小（以字节为单位
 };
 
+// 辅助服务器每处理完一帧主动发给主服务器的负载报告
+struct SecondaryLoad {
+  uint64_t frame = 0u; // 报告对应的帧
+  uint32_t pending_frames = 0u; // 已收到但尚未处理的帧数
+  float frame_time_ms = 0.0f; // 处理该帧（包括传感器）所用的时间
+};
+
 }  // namespace multigpu 结束multigpu命名空间的定义
 } // namespace carla 结束carla命名空间的定义
@@ -0,0 +1,342 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace carla {
+namespace multigpu {
+
+  /// 编码后的帧数据以该头部开始，没有该头部的帧数据按原样处理。
+  constexpr uint32_t FRAME_CODEC_MAGIC = 0x444D5246u; // "FRMD"
+
+  struct FrameCodecHeader {
+    enum Flags : uint32_t {
+      KEYFRAME   = 1u << 0, ///< 负载是完整的帧而不是相对上一帧的差异
+      COMPRESSED = 1u << 1  ///< 负载经过游程编码压缩
+    };
+    uint32_t magic = FRAME_CODEC_MAGIC;
+    uint32_t flags = 0u;
+    uint64_t sequence = 0u;      ///< 帧的序号
+    uint64_t base_sequence = 0u; ///< 差异所基于的帧的序号
+    uint32_t raw_size = 0u;      ///< 解码后帧的大小
+    uint32_t payload_size = 0u;  ///< 头部之后负载的大小
+  };
+
+  namespace detail {
+
+    /// 差异和压缩共用的字节操作。
+    class FrameCodecDetail {
+    public:
+
+      static void WriteVarint(std::vector<unsigned char> &out, size_t value) {
+        while (value >= 0x80u) {
+          out.push_back(static_cast<unsigned char>(value | 0x80u));
+          value >>= 7u;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+      }
+
+      static bool ReadVarint(const unsigned char *&it, const unsigned char *end, size_t &value) {
+        value = 0u;
+        for (unsigned shift = 0u; it != end && shift < 64u; shift += 7u) {
+          const unsigned char byte = *it++;
+          value |= static_cast<size_t>(byte & 0x7Fu) << shift;
+          if ((byte & 0x80u) == 0u) {
+            return true;
+          }
+        }
+        return false;
+      }
+
+      /// 相对 @a base 的差异：依次为「与上一帧相同的字节数」「变化的字节数」
+      /// 和变化的字节。短的相同片段并入变化的片段，以免编码长度的开销。
+      static void Diff(
+          const unsigned char *data, size_t size,
+          const std::vector<unsigned char> &base,
+          std::vector<unsigned char> &out) {
+        constexpr size_t MIN_COPY = 8u;
+        const size_t common = std::min(size, base.size());
+        size_t i = 0u;
+        while (i < size) {
+          size_t copy = 0u;
+          while (i + copy < common && data[i + copy] == base[i + copy]) {
+            ++copy;
+          }
+          if (copy < MIN_COPY && i + copy < size) {
+            copy = 0u;
+          }
+          // 变化的片段延续到下一段足够长的相同片段之前
+          size_t literal = 0u;
+          size_t run = 0u;
+          for (size_t j = i + copy; j < size && run < MIN_COPY; ++j, ++literal) {
+            const bool same = j < common && data[j] == base[j];
+            run = same ? run + 1u : 0u;
+          }
+          if (run == MIN_COPY) {
+            literal -= MIN_COPY;
+          }
+          WriteVarint(out, copy);
+          WriteVarint(out, literal);
+          out.insert(out.end(), data + i + copy, data + i + copy + literal);
+          i += copy + literal;
+        }
+      }
+
+      static bool Patch(
+          const unsigned char *it, const unsigned char *end,
+          const std::vector<unsigned char> &base,
+          std::vector<unsigned char> &out) {
+        const size_t size = out.size();
+        size_t i = 0u;
+        while (i < size) {
+          size_t copy, literal;
+          if (!ReadVarint(it, end, copy) || !ReadVarint(it, end, literal) ||
+              i + copy > base.size() ||
+              i + copy + literal > size ||
+              literal > static_cast<size_t>(end - it)) {
+            return false;
+          }
+          std::memcpy(out.data() + i, base.data() + i, copy);
+          std::memcpy(out.data() + i + copy, it, literal);
+          it += literal;
+          i += copy + literal;
+        }
+        return it == end;
+      }
+
+      /// PackBits 游程编码：控制字节 0-127 后跟 n+1 个原样的字节，128-255
+      /// 后跟一个重复 n-126 次的字节。
+      static void Compress(const unsigned char *data, size_t size, std::vector<unsigned char> &out) {
+        size_t i = 0u;
+        while (i < size) {
+          size_t run = 1u;
+          while (i + run < size && run < 129u && data[i + run] == data[i]) {
+            ++run;
+          }
+          if (run >= 2u) {
+            out.push_back(static_cast<unsigned char>(run + 126u));
+            out.push_back(data[i]);
+            i += run;
+            continue;
+          }
+          size_t literal = 1u;
+          while (i + literal < size && literal < 128u &&
+                 !(i + literal + 1u < size && data[i + literal] == data[i + literal + 1u])) {
+            ++literal;
+          }
+          out.push_back(static_cast<unsigned char>(literal - 1u));
+          out.insert(out.end(), data + i, data + i + literal);
+          i += literal;
+        }
+      }
+
+      static bool Decompress(const unsigned char *it, const unsigned char *end, std::vector<unsigned char> &out) {
+        while (it != end) {
+          const unsigned char control = *it++;
+          if (control < 128u) {
+            const size_t literal = control + 1u;
+            if (literal > static_cast<size_t>(end - it)) {
+              return false;
+            }
+            out.insert(out.end(), it, it + literal);
+            it += literal;
+          } else {
+            if (it == end) {
+              return false;
+            }
+            out.insert(out.end(), control - 126u, *it++);
+          }
+        }
+        return true;
+      }
+    };
+
+  } // namespace detail
+
+  /// 主服务器端的帧数据编码器。
+  ///
+  /// 每帧记录下来作为下一帧的基准，之后的帧只发送与上一帧不同的字节（同一
+  /// actor 的记录在相邻帧中位于相同的偏移，没有变化的 actor 不占带宽）。差异
+  /// 不比完整的帧小时（例如 actor 增减导致记录整体移动）改发关键帧。负载可以
+  /// 再用游程编码压缩，只有压缩后更小时才使用。
+  ///
+  /// 解码器需要按顺序收到每一帧，新的辅助服务器连接时应强制发送关键帧。
+  class FrameEncoder {
+  public:
+
+    struct Settings {
+      /// 是否发送相对上一帧的差异。
+      bool delta = true;
+      /// 是否压缩负载。
+      bool compress = true;
+      /// 每隔多少帧强制发送一个关键帧，0 表示只在需要时发送。
+      uint32_t keyframe_interval = 120u;
+    };
+
+    FrameEncoder() = default;
+
+    explicit FrameEncoder(Settings settings) : _settings(settings) {}
+
+    void SetSettings(const Settings &settings) {
+      _settings = settings;
+    }
+
+    const Settings &GetSettings() const {
+      return _settings;
+    }
+
+    /// 编码 @a data，@a force_keyframe 为 true 时发送完整的帧。
+    Buffer Encode(const unsigned char *data, size_t size, bool force_keyframe = false) {
+      FrameCodecHeader header;
+      header.sequence = ++_sequence;
+      header.raw_size = static_cast<uint32_t>(size);
+
+      _payload.clear();
+      const bool keyframe_due = _settings.keyframe_interval > 0u &&
+          _frames_since_keyframe + 1u >= _settings.keyframe_interval;
+      if (_settings.delta && _has_base && !force_keyframe && !keyframe_due) {
+        detail::FrameCodecDetail::Diff(data, size, _base, _payload);
+        header.base_sequence = header.sequence - 1u;
+      }
+      const unsigned char *payload = _payload.data();
+      size_t payload_size = _payload.size();
+      if (header.base_sequence == 0u || payload_size >= size) {
+        header.flags |= FrameCodecHeader::KEYFRAME;
+        header.base_sequence = 0u;
+        payload = data;
+        payload_size = size;
+      }
+      if (_settings.compress) {
+        _compressed.clear();
+        detail::FrameCodecDetail::Compress(payload, payload_size, _compressed);
+        if (_compressed.size() < payload_size) {
+          header.flags |= FrameCodecHeader::COMPRESSED;
+          payload = _compressed.data();
+          payload_size = _compressed.size();
+        }
+      }
+      header.payload_size = static_cast<uint32_t>(payload_size);
+
+      Buffer buffer(sizeof(header) + payload_size);
+      std::memcpy(buffer.data(), &header, sizeof(header));
+      if (payload_size > 0u) {
+        std::memcpy(buffer.data() + sizeof(header), payload, payload_size);
+      }
+
+      const bool keyframe = (header.flags & FrameCodecHeader::KEYFRAME) != 0u;
+      _frames_since_keyframe = keyframe ? 0u : _frames_since_keyframe + 1u;
+      _base.assign(data, data + size);
+      _has_base = true;
+      return buffer;
+    }
+
+    /// 下一帧强制发送关键帧。
+    void Reset() {
+      _has_base = false;
+    }
+
+  private:
+
+    Settings _settings;
+
+    uint64_t _sequence = 0u;
+
+    uint32_t _frames_since_keyframe = 0u;
+
+    bool _has_base = false;
+
+    std::vector<unsigned char> _base;
+
+    std::vector<unsigned char> _payload;
+
+    std::vector<unsigned char> _compressed;
+  };
+
+  /// 辅助服务器端的帧数据解码器，保存上一帧作为差异的基准。
+  class FrameDecoder {
+  public:
+
+    /// @a data 是否是 FrameEncoder 编码的帧。
+    static bool IsEncoded(const unsigned char *data, size_t size) {
+      uint32_t magic;
+      if (data == nullptr || size < sizeof(FrameCodecHeader)) {
+        return false;
+      }
+      std::memcpy(&magic, data, sizeof(magic));
+      return magic == FRAME_CODEC_MAGIC;
+    }
+
+    /// 解码 @a data 到 @a frame。差异所基于的帧没有收到（例如刚连接上）或
+    /// 数据损坏时返回 false，之后的差异帧都会失败直到收到下一个关键帧。
+    bool Decode(const unsigned char *data, size_t size, Buffer &frame) {
+      FrameCodecHeader header;
+      if (!IsEncoded(data, size)) {
+        return false;
+      }
+      std::memcpy(&header, data, sizeof(header));
+      const unsigned char *payload = data + sizeof(header);
+      const unsigned char *end = payload + header.payload_size;
+      if (header.payload_size != size - sizeof(header)) {
+        return Fail();
+      }
+      if ((header.flags & FrameCodecHeader::COMPRESSED) != 0u) {
+        _decompressed.clear();
+        if (!detail::FrameCodecDetail::Decompress(payload, end, _decompressed)) {
+          return Fail();
+        }
+        payload = _decompressed.data();
+        end = payload + _decompressed.size();
+      }
+      _frame.resize(header.raw_size);
+      if ((header.flags & FrameCodecHeader::KEYFRAME) != 0u) {
+        if (static_cast<size_t>(end - payload) != _frame.size()) {
+          return Fail();
+        }
+        std::copy(payload, end, _frame.begin());
+      } else if (!_has_base || header.base_sequence != _sequence ||
+                 !detail::FrameCodecDetail::Patch(payload, end, _base, _frame)) {
+        return Fail();
+      }
+      _base.swap(_frame);
+      _sequence = header.sequence;
+      _has_base = true;
+      frame.copy_from(_base.data(), static_cast<Buffer::size_type>(_base.size()));
+      return true;
+    }
+
+    /// 最近成功解码的帧的序号。
+    uint64_t GetSequence() const {
+      return _sequence;
+    }
+
+  private:
+
+    bool Fail() {
+      _has_base = false;
+      return false;
+    }
+
+    uint64_t _sequence = 0u;
+
+    bool _has_base = false;
+
+    std::vector<unsigned char> _base;
+
+    std::vector<unsigned char> _frame;
+
+    std::vector<unsigned char> _decompressed;
+  };
+
+} // namespace multigpu
+} // namespace carla
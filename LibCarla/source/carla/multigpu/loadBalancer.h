@@ -0,0 +1,247 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/multigpu/commands.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace carla {
+namespace multigpu {
+
+  /// 根据辅助服务器报告的负载决定新传感器放在哪个辅助服务器上。
+  ///
+  /// 每个服务器记录已分配传感器的代价之和（例如相机比 IMU 贵得多）和最近
+  /// 报告的帧时间。分配的代价变化前后帧时间的差给出该服务器每
+  /// 单位代价的帧时间（不含与传感器无关的固定开销），新传感器放在加入后预计
+  /// 帧时间最短的服务器上，上次报告之后放置的传感器也计入预计。落后的服务器
+  /// （排队的帧太多或超出帧时间预算）不再接收新的传感器，除非所有服务器都落后。
+  ///
+  /// 不是线程安全的，由 Router 在持有其互斥锁时调用。
+  class LoadBalancer {
+  public:
+
+    using key_type = const void *;
+
+    struct Settings {
+      /// 排队的帧数超过该值时认为服务器落后。
+      uint32_t max_pending_frames = 2u;
+      /// 帧时间预算（毫秒），超出时认为服务器落后，0 表示不限制。
+      float max_frame_time_ms = 0.0f;
+      /// 帧时间指数平滑的系数，取值 (0, 1]，越大越偏向最新的报告。
+      float smoothing = 0.25f;
+    };
+
+    struct ServerLoad {
+      float assigned_cost = 0.0f;   ///< 已分配传感器的代价之和
+      uint32_t sensors = 0u;        ///< 已分配的传感器数量
+      float frame_time_ms = 0.0f;   ///< 平滑后的帧时间，用于判断是否落后
+      uint32_t pending_frames = 0u; ///< 最近报告的排队帧数
+      uint64_t frame = 0u;          ///< 最近报告的帧
+      uint64_t reports = 0u;        ///< 收到的报告数
+      float ms_per_cost = 0.0f;     ///< 估计的每单位代价的帧时间，0 表示未知
+      bool overloaded = false;      ///< 是否落后
+    };
+
+    LoadBalancer() = default;
+
+    explicit LoadBalancer(Settings settings) : _settings(settings) {}
+
+    void SetSettings(const Settings &settings) {
+      _settings = settings;
+      for (auto &server : _servers) {
+        server.load.overloaded = IsOverloaded(server.load);
+      }
+    }
+
+    const Settings &GetSettings() const {
+      return _settings;
+    }
+
+    void AddServer(key_type server) {
+      if (Find(server) == nullptr) {
+        _servers.emplace_back();
+        _servers.back().key = server;
+      }
+    }
+
+    void RemoveServer(key_type server) {
+      _servers.erase(
+          std::remove_if(_servers.begin(), _servers.end(), [=](const Entry &entry) {
+            return entry.key == server;
+          }),
+          _servers.end());
+    }
+
+    void Clear() {
+      _servers.clear();
+    }
+
+    /// 记录 @a server 的负载报告，返回服务器是否改变了落后状态。
+    bool Report(key_type server, const SecondaryLoad &report) {
+      Entry *entry = Find(server);
+      if (entry == nullptr) {
+        return false;
+      }
+      ServerLoad &load = entry->load;
+      const float alpha = std::min(std::max(_settings.smoothing, 0.0f), 1.0f);
+      if (load.reports > 0u && load.assigned_cost != entry->reported_cost) {
+        // 代价变化前后的帧时间差，用未平滑的报告以免低估
+        const float unit = (report.frame_time_ms - entry->reported_time_ms) /
+            (load.assigned_cost - entry->reported_cost);
+        if (unit > 0.0f) {
+          load.ms_per_cost = load.ms_per_cost > 0.0f ?
+              alpha * unit + (1.0f - alpha) * load.ms_per_cost :
+              unit;
+        }
+      }
+      load.frame_time_ms = load.reports == 0u ?
+          report.frame_time_ms :
+          alpha * report.frame_time_ms + (1.0f - alpha) * load.frame_time_ms;
+      load.pending_frames = report.pending_frames;
+      load.frame = report.frame;
+      ++load.reports;
+      entry->reported_cost = load.assigned_cost;
+      entry->reported_time_ms = report.frame_time_ms;
+      const bool was_overloaded = load.overloaded;
+      load.overloaded = IsOverloaded(load);
+      return was_overloaded != load.overloaded;
+    }
+
+    /// 选择放置代价为 @a cost 的传感器的服务器并记入其负载，没有服务器时
+    /// 返回 nullptr。
+    key_type Place(float cost) {
+      Entry *best = nullptr;
+      float best_time = std::numeric_limits<float>::infinity();
+      const float default_unit_time = GetAverageUnitTime();
+      for (auto &server : _servers) {
+        const float time = PredictFrameTime(server, cost, default_unit_time);
+        if (best == nullptr ||
+            (best->load.overloaded && !server.load.overloaded) ||
+            (best->load.overloaded == server.load.overloaded && time < best_time)) {
+          best = &server;
+          best_time = time;
+        }
+      }
+      if (best == nullptr) {
+        return nullptr;
+      }
+      best->load.assigned_cost += cost;
+      ++best->load.sensors;
+      return best->key;
+    }
+
+    /// 从 @a server 的负载中减去一个代价为 @a cost 的传感器（由 Place 放置，
+    /// 现已销毁）。
+    void Release(key_type server, float cost) {
+      Entry *entry = Find(server);
+      if (entry == nullptr) {
+        return;
+      }
+      ServerLoad &load = entry->load;
+      load.assigned_cost = std::max(load.assigned_cost - cost, 0.0f);
+      if (load.sensors > 0u) {
+        --load.sensors;
+      }
+    }
+
+    /// 服务器的负载，未知的服务器返回默认值。
+    ServerLoad GetLoad(key_type server) const {
+      for (auto &entry : _servers) {
+        if (entry.key == server) {
+          return entry.load;
+        }
+      }
+      return ServerLoad{};
+    }
+
+    /// 按连接顺序返回所有服务器的负载。
+    std::vector<ServerLoad> GetLoads() const {
+      std::vector<ServerLoad> result;
+      result.reserve(_servers.size());
+      for (auto &entry : _servers) {
+        result.push_back(entry.load);
+      }
+      return result;
+    }
+
+    size_t size() const {
+      return _servers.size();
+    }
+
+    /// 如果 @a data 是负载报告（带有 LOAD_REPORT 命令头的消息）则解析到
+    /// @a report。
+    static bool ReadReport(const unsigned char *data, size_t size, SecondaryLoad &report) {
+      if (data == nullptr || size != sizeof(CommandHeader) + sizeof(SecondaryLoad)) {
+        return false;
+      }
+      CommandHeader header;
+      std::memcpy(&header, data, sizeof(CommandHeader));
+      if (header.id != MultiGPUCommand::LOAD_REPORT || header.size != sizeof(SecondaryLoad)) {
+        return false;
+      }
+      std::memcpy(&report, data + sizeof(CommandHeader), sizeof(SecondaryLoad));
+      return true;
+    }
+
+  private:
+
+    struct Entry {
+      key_type key = nullptr;
+      ServerLoad load;
+      /// 上次报告时的分配代价和（未平滑的）帧时间
+      float reported_cost = 0.0f;
+      float reported_time_ms = 0.0f;
+    };
+
+    Entry *Find(key_type server) {
+      for (auto &entry : _servers) {
+        if (entry.key == server) {
+          return &entry;
+        }
+      }
+      return nullptr;
+    }
+
+    bool IsOverloaded(const ServerLoad &load) const {
+      return load.reports > 0u &&
+          (load.pending_frames > _settings.max_pending_frames ||
+           (_settings.max_frame_time_ms > 0.0f && load.frame_time_ms > _settings.max_frame_time_ms));
+    }
+
+    /// 已估计出的每单位代价帧时间的平均值，用于还没有估计的服务器。
+    float GetAverageUnitTime() const {
+      float sum = 0.0f;
+      size_t count = 0u;
+      for (auto &entry : _servers) {
+        if (entry.load.ms_per_cost > 0.0f) {
+          sum += entry.load.ms_per_cost;
+          ++count;
+        }
+      }
+      return count > 0u ? sum / static_cast<float>(count) : 1.0f;
+    }
+
+    /// 放置 @a cost 后预计的帧时间：最近一次报告的帧时间加上尚未反映在报告
+    /// 中的代价。用未平滑的报告，平滑值在分配变化后要过几帧才跟上。
+    static float PredictFrameTime(const Entry &entry, float cost, float default_unit_time) {
+      const ServerLoad &load = entry.load;
+      const float unit_time = load.ms_per_cost > 0.0f ? load.ms_per_cost : default_unit_time;
+      return entry.reported_time_ms + (load.assigned_cost - entry.reported_cost + cost) * unit_time;
+    }
+
+    Settings _settings;
+
+    std::vector<Entry> _servers;
+  };
+
+} // namespace multigpu
+} // namespace carla
@@ -35,11 +35,38 @@ void PrimaryCommands::set_router(std::shared_ptr<Router> router) {
 }
 
 // 向所有辅助服务器广播帧数据的函数
-// 参数buffer: 包含帧数据的carla::Buffer类型对象，会将此数据通过路由器发送给所有辅助服务器
-// 实现方式是调用_router的Write方法，传递对应的命令类型（MultiGPUCommand::SEND_FRAME）和要发送的数据（移动语义传递buffer）
-void PrimaryCommands::SendFrameData(carla::Buffer buffer) {
-  _router->Write(MultiGPUCommand::SEND_FRAME, std::move(buffer));
+// 参数buffer: 包含帧数据的carla::Buffer类型对象，编码后通过路由器发送给所有辅助服务器
+// 参数keyframe: 为true时发送完整的帧，而不是相对上一帧的差异
+// 编码后的缓冲区只有一份，_router的Write方法把同一条消息写入所有会话
+void PrimaryCommands::SendFrameData(carla::Buffer buffer, bool keyframe) {
+  std::lock_guard<std::mutex> lock(_frame_mutex);
+  const size_t raw_size = buffer.size();
+  auto encoded = _frame_encoder.Encode(buffer.data(), raw_size, keyframe);
+  const size_t encoded_size = encoded.size();
+  const bool is_keyframe = (reinterpret_cast<const FrameCodecHeader *>(encoded.data())->flags &
+      FrameCodecHeader::KEYFRAME) != 0u;
+  const size_t sessions = _router->Write(MultiGPUCommand::SEND_FRAME, std::move(encoded));
   // log_info("sending frame command");  // 此处原代码有日志输出，可能用于调试等记录发送帧命令的操作，当前被注释掉了
+
+  const size_t bytes_sent = (sizeof(CommandHeader) + encoded_size) * sessions;
+  ++_frame_stats.frames;
+  _frame_stats.keyframes += is_keyframe ? 1u : 0u;
+  _frame_stats.raw_bytes += raw_size;
+  _frame_stats.encoded_bytes += encoded_size;
+  _frame_stats.bytes_sent += bytes_sent;
+  _frame_stats.last_raw_bytes = raw_size;
+  _frame_stats.last_bytes_sent = bytes_sent;
+}
+
+void PrimaryCommands::SetFrameEncoderSettings(const FrameEncoder::Settings &settings) {
+  std::lock_guard<std::mutex> lock(_frame_mutex);
+  _frame_encoder.SetSettings(settings);
+  _frame_encoder.Reset();
+}
+
+PrimaryCommands::FrameDataStats PrimaryCommands::GetFrameDataStats() const {
+  std::lock_guard<std::mutex> lock(_frame_mutex);
+  return _frame_stats;
 }
 
 // 向所有辅助服务器广播要加载的地图的函数
@@ -53,16 +80,17 @@ void PrimaryCommands::SendLoadMap(std::string map) {
 
 // 向路由器需要令牌的人员发送请求的函数，用于获取令牌（token）
 // 参数sensor_id: 传感器的ID，用于标识请求令牌对应的传感器
-// 函数先记录请求令牌的日志信息（log_info），然后将sensor_id放入carla::Buffer中，通过路由器的WriteToNext方法异步发送请求（命令类型为MultiGPUCommand::GET_TOKEN）
+// 参数server: 放置该传感器的辅助服务器
+// 函数先记录请求令牌的日志信息（log_info），然后将sensor_id放入carla::Buffer中，通过路由器的WriteToOne方法异步发送请求（命令类型为MultiGPUCommand::GET_TOKEN）
 // 接着等待异步操作完成（fut.get()）获取响应，从响应中解析出新的令牌（token_type），并记录获取到的令牌信息，最后返回该令牌
-token_type PrimaryCommands::SendGetToken(stream_id sensor_id) {
+token_type PrimaryCommands::SendGetToken(std::weak_ptr<Primary> server, stream_id sensor_id) {
     // 记录请求令牌的日志信息
   log_info("asking for a token");
    // 将 sensor_id 放入 carla::Buffer 中
   carla::Buffer buf((carla::Buffer::value_type *) &sensor_id,
                     (size_t) sizeof(stream_id));
-   // 使用 _router->WriteToNext() 异步向下游发送请求，命令类型为 MultiGPUCommand::GET_TOKEN
-  auto fut = _router->WriteToNext(MultiGPUCommand::GET_TOKEN, std::move(buf));
+   // 使用 _router->WriteToOne() 异步向选定的服务器发送请求，命令类型为 MultiGPUCommand::GET_TOKEN
+  auto fut = _router->WriteToOne(server, MultiGPUCommand::GET_TOKEN, std::move(buf));
 // 阻塞当前线程，等待异步响应完成
   auto response = fut.get();
   // 记录令牌信息
@@ -157,10 +185,10 @@ bool PrimaryCommands::SendIsEnabledForROS(stream_id sensor_id) {
 // 参数sensor_id: 传感器的ID，首先在已记录的令牌列表（_tokens）中查找该传感器是否已有对应的令牌，如果有：
 //   - 直接返回已有的令牌（从记录中获取并返回，同时记录日志信息表明使用已激活传感器的令牌）
 // 如果没有找到对应的令牌，则执行以下操作：
-//   - 通过路由器获取下一个可用的服务器（_router->GetNextServer()）
+//   - 通过路由器选择负载最低的服务器（_router->GetLeastLoadedServer(cost)）
 //   - 调用SendGetToken函数向该服务器请求获取令牌
 //   - 将获取到的令牌添加到令牌列表（_tokens）和服务器列表（_servers）中，记录日志信息表明使用新激活传感器的令牌，最后返回该令牌
-token_type PrimaryCommands::GetToken(stream_id sensor_id) {
+token_type PrimaryCommands::GetToken(stream_id sensor_id, float cost) {
   // 搜索传感器是否已在任何辅助服务器中激活
   auto it = _tokens.find(sensor_id);
   if (it!= _tokens.end()) {
@@ -170,13 +198,14 @@ token_type PrimaryCommands::GetToken(stream_id sensor_id) {
   }
   else {
     // 在一台辅助服务器上启用传感器
-    auto server = _router->GetNextServer();
+    auto server = _router->GetLeastLoadedServer(cost);
      //  向该服务器请求获取令牌
-    auto token = SendGetToken(sensor_id);
+    auto token = SendGetToken(server, sensor_id);
     // add to the maps
     // 将获取到的令牌和服务器添加到令牌列表（_tokens）和服务器列表（_servers）中
     _tokens[sensor_id] = token;
     _servers[sensor_id] = server;
+    _costs[sensor_id] = cost;
     //记录日志，表示新激活传感器的令牌
     log_debug("Using token from new activated sensor: ", token.get_stream_id(), ", ", token.get_port());
      // 返回新的令牌
@@ -184,6 +213,18 @@ token_type PrimaryCommands::GetToken(stream_id sensor_id) {
   }
 }
 
+// 传感器销毁后从其所在辅助服务器的负载中减去其代价，并忘记其令牌
+void PrimaryCommands::ReleaseToken(stream_id sensor_id) {
+  auto it = _servers.find(sensor_id);
+  if (it == _servers.end()) {
+    return;
+  }
+  _router->ReleaseLoad(it->second, _costs[sensor_id]);
+  _servers.erase(it);
+  _tokens.erase(sensor_id);
+  _costs.erase(sensor_id);
+}
+
 // 启用特定传感器的ROS相关功能的函数
 // 参数sensor_id: 传感器的ID，首先在服务器列表（_servers）中查找该传感器是否已在某个辅助服务器中激活，如果找到：
 //   - 直接调用SendEnableForROS函数发送启用命令
@@ -218,7 +259,6 @@ bool PrimaryCommands::IsEnabledForROS(stream_id sensor_id) {
   if (it!= _servers.end()) {  // 如果在服务器中找到了对应的传感器
     return SendIsEnabledForROS(sensor_id);  // 查询该传感器是否启用了ROS功能
   }
-  }
   return false; // 如果没有找到传感器，则返回false，表示未启用
 }
 
@@ -8,11 +8,15 @@
 
 // #include "carla/Logging.h" // 原本可能计划包含用于日志记录相关功能的头文件，但目前被注释掉了，也许后续根据需求会添加进来用于记录相关操作的日志信息
 // 包含多GPU相关命令定义的头文件，里面应该定义了在多GPU环境下涉及的各种操作命令相关的数据结构、函数等内容
-#include "carla/multigpu/commands.h" // 包含多GPU环境中主节点相关功能的头文件，可能定义了主节点相关的类、接口等，用于处理主节点的操作逻辑
+#include "carla/multigpu/commands.h"
+#include "carla/multigpu/frameCodec.h" // 包含多GPU环境中主节点相关功能的头文件，可能定义了主节点相关的类、接口等，用于处理主节点的操作逻辑
 #include "carla/multigpu/primary.h" // 包含流媒体相关的TCP消息定义的头文件，用于处理在网络传输中基于TCP协议的消息相关操作和数据结构
 #include "carla/streaming/detail/tcp/Message.h" // 包含流媒体相关的令牌（Token）定义的头文件，Token可能用于标识不同的流媒体会话、资源等，方便进行相关管理和操作
 #include "carla/streaming/detail/Token.h" // 包含流媒体相关的类型定义的头文件，里面定义了在流媒体处理过程中用到的各种自定义类型，便于统一类型管理和代码的清晰性
 #include "carla/streaming/detail/Types.h"
+
+#include <mutex>
+#include <unordered_map>
 // 定义在carla命名空间下的multigpu命名空间中，用于组织和限定多GPU相关代码的作用域，避免命名冲突
 namespace carla {
 namespace multigpu {
@@ -27,14 +31,30 @@ class Router;
 class PrimaryCommands {
   public:
 
+    /// 广播帧数据的字节数统计。
+    struct FrameDataStats {
+      uint64_t frames = 0u;         ///< 广播的帧数
+      uint64_t keyframes = 0u;      ///< 其中的关键帧数
+      uint64_t raw_bytes = 0u;      ///< 编码前的字节数
+      uint64_t encoded_bytes = 0u;  ///< 编码后的字节数（每帧只编码一次）
+      uint64_t bytes_sent = 0u;     ///< 发给所有辅助服务器的字节数
+      size_t last_raw_bytes = 0u;   ///< 最近一帧编码前的字节数
+      size_t last_bytes_sent = 0u;  ///< 最近一帧发给所有辅助服务器的字节数
+    };
 
     PrimaryCommands();
     PrimaryCommands(std::shared_ptr<Router> router);
 
     void set_router(std::shared_ptr<Router> router);
 
-    // 向所有辅助服务器广播帧数据
-    void SendFrameData(carla::Buffer buffer);
+    // 向所有辅助服务器广播帧数据。帧数据编码为相对上一帧的差异（见
+    // FrameEncoder），只编码一次，所有会话共享同一条消息；keyframe 为 true
+    // 时发送完整的帧（例如有新的辅助服务器连接时）
+    void SendFrameData(carla::Buffer buffer, bool keyframe = false);
+
+    void SetFrameEncoderSettings(const FrameEncoder::Settings &settings);
+
+    FrameDataStats GetFrameDataStats() const;
 
     // 向所有辅助服务器广播要加载的地图
     void SendLoadMap(std::string map);
@@ -42,7 +62,12 @@ class PrimaryCommands {
     // 发送以了解连接是否处于活动状态
     void SendIsAlive();
 
-    token_type GetToken(stream_id sensor_id);
+    // 获取传感器的令牌，新传感器放在负载最低的辅助服务器上；cost 为传感器的
+    // 相对渲染代价（例如相机比 IMU 大得多）
+    token_type GetToken(stream_id sensor_id, float cost = 1.0f);
+
+    // 传感器销毁时调用，从其所在辅助服务器的负载中减去其代价
+    void ReleaseToken(stream_id sensor_id);
 
     void EnableForROS(stream_id sensor_id);
 
@@ -53,7 +78,7 @@ class PrimaryCommands {
   private:
 
     // 发送到一个辅助节点以获取传感器的令牌
-    token_type SendGetToken(carla::streaming::detail::stream_id_type sensor_id);
+    token_type SendGetToken(std::weak_ptr<Primary> server, carla::streaming::detail::stream_id_type sensor_id);
 
     // 管理 ROS 传感器的启用/禁用
     void SendEnableForROS(stream_id sensor_id); // 与SendEnableForROS函数类似，用于向相关节点发送禁用ROS传感器的消息，是DisableForROS函数的底层实现逻辑的一部分，实现关闭ROS相关功能的具体网络通信操作
@@ -62,8 +87,12 @@ class PrimaryCommands {
 
 
     std::shared_ptr<Router> _router;
+    mutable std::mutex _frame_mutex;
+    FrameEncoder _frame_encoder;
+    FrameDataStats _frame_stats;
     std::unordered_map<stream_id, token_type> _tokens;// 成员变量，使用无序映射（unordered_map）存储传感器流标识（stream_id）与指向Primary类的弱智能指针（std::weak_ptr<Primary>）之间的映射关系，用于关联传感器流和对应的主节点相关信息，弱智能指针可以避免循环引用等问题
     std::unordered_map<stream_id, std::weak_ptr<Primary>> _servers;
+    std::unordered_map<stream_id, float> _costs; // 传感器放置时的代价
 };
 
 } // namespace multigpu
@@ -8,6 +8,8 @@
 #include "carla/multigpu/listener.h"
 #include "carla/streaming/EndPoint.h"
 
+#include <cstring>
+
 namespace carla {
 namespace multigpu {
 
@@ -75,14 +77,36 @@ void Router::SetCallbacks() {
     [=](std::shared_ptr<carla::multigpu::Primary> session, carla::Buffer buffer) {
       auto self = weak.lock();
       if (!self) return;
+      if (buffer.size() < sizeof(CommandHeader)) {
+        log_error("Got a message without command header from secondary: ", buffer.size());
+        return;
+      }
+      CommandHeader header;
+      std::memcpy(&header, buffer.data(), sizeof(CommandHeader));
       std::lock_guard<std::mutex> lock(self->_mutex);
+      // 负载报告不是命令的应答，不能用来兑现承诺
+      if (header.id == MultiGPUCommand::LOAD_REPORT) {
+        SecondaryLoad report;
+        if (LoadBalancer::ReadReport(buffer.data(), buffer.size(), report)) {
+          self->UpdateLoad(session, report);
+        } else {
+          log_error("Got a malformed load report from secondary: ", buffer.size());
+        }
+        return;
+      }
+      // 去掉命令头，承诺收到的只是应答的数据
+      if (header.size > buffer.size() - sizeof(CommandHeader)) {
+        log_error("Got a truncated response from secondary: ", buffer.size());
+        return;
+      }
+      Buffer data(buffer.data() + sizeof(CommandHeader), header.size);
       auto prom =self-> _promises.find(session.get());
       if (prom!= self->_promises.end()) {
-        log_info("Got data from secondary (with promise): ", buffer.size());
-        prom->second->set_value({session, std::move(buffer)});
+        log_info("Got data from secondary (with promise): ", data.size());
+        prom->second->set_value({session, std::move(data)});
         self->_promises.erase(prom);
       } else {
-        log_info("Got data from secondary (without promise): ", buffer.size());
+        log_info("Got data from secondary (without promise): ", data.size());
       }
     };
 
@@ -118,6 +142,7 @@ boost::asio::ip::tcp::endpoint Router::GetLocalEndpoint() const {
 void Router::ConnectSession(std::shared_ptr<Primary> session) {
   DEBUG_ASSERT(session!= nullptr);
   std::lock_guard<std::mutex> lock(_mutex);
+  _balancer.AddServer(session.get());
   _sessions.emplace_back(std::move(session));
   log_info("Connected secondary servers:", _sessions.size());
   // 对新连接运行外部回调
@@ -134,6 +159,7 @@ void Router::DisconnectSession(std::shared_ptr<Primary> session) {
   DEBUG_ASSERT(session!= nullptr);
   std::lock_guard<std::mutex> lock(_mutex);
   if (_sessions.size() == 0) return;
+  _balancer.RemoveServer(session.get());
   _sessions.erase(
       std::remove(_sessions.begin(), _sessions.end(), session),
       _sessions.end());
@@ -145,6 +171,7 @@ void Router::DisconnectSession(std::shared_ptr<Primary> session) {
 void Router::ClearSessions() {
   std::lock_guard<std::mutex> lock(_mutex);
   _sessions.clear();
+  _balancer.Clear();
   log_info("Disconnecting all secondary servers");
 }
 
@@ -158,7 +185,8 @@ void Router::ClearSessions() {
 //    再利用Primary的MakeMessage函数将这两个视图组合成一个完整的消息（message）。
 // 3. 使用互斥锁（_mutex）保护共享资源（_sessions列表），遍历所有活动会话（_sessions），
 //    对于每个不为空的会话对象，调用其Write函数将消息发送出去，实现向所有辅助服务器广播消息的功能。
-void Router::Write(MultiGPUCommand id, Buffer &&buffer) {
+//    消息只创建一次，所有会话共享同一份数据。返回写入的会话数。
+size_t Router::Write(MultiGPUCommand id, Buffer &&buffer) {
   // 定义命令头
   CommandHeader header;
   header.id = id;
@@ -171,11 +199,14 @@ void Router::Write(MultiGPUCommand id, Buffer &&buffer) {
 
   // 写入多个服务器
   std::lock_guard<std::mutex> lock(_mutex);
+  size_t count = 0u;
   for (auto &s : _sessions) {
     if (s!= nullptr) {
       s->Write(message);
+      ++count;
     }
   }
+  return count;
 }
 
 // 向特定的下一个活动会话（辅助服务器）写入消息，并返回一个表示异步操作结果的未来对象（std::future），用于获取后续的响应信息
@@ -273,5 +304,59 @@ std::weak_ptr<Primary> Router::GetNextServer() {
   }
 }
 
+// 按负载选择放置新传感器的服务器，并把传感器的代价记入该服务器。
+// 代价是相对值（例如相机比 IMU 大得多），详见 LoadBalancer。
+// 没有连接的服务器时返回空的弱指针。
+std::weak_ptr<Primary> Router::GetLeastLoadedServer(float cost) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto key = _balancer.Place(cost);
+  for (auto &s : _sessions) {
+    if (s.get() == key) {
+      const auto load = _balancer.GetLoad(key);
+      log_debug("Placing sensor with cost", cost, "on a secondary with", load.sensors, "sensors, cost", load.assigned_cost);
+      return std::weak_ptr<Primary>(s);
+    }
+  }
+  return std::weak_ptr<Primary>();
+}
+
+void Router::ReleaseLoad(std::weak_ptr<Primary> server, float cost) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto s = server.lock();
+  if (s) {
+    _balancer.Release(s.get(), cost);
+  }
+}
+
+LoadBalancer::ServerLoad Router::GetServerLoad(std::weak_ptr<Primary> server) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto s = server.lock();
+  return s ? _balancer.GetLoad(s.get()) : LoadBalancer::ServerLoad{};
+}
+
+std::vector<LoadBalancer::ServerLoad> Router::GetServerLoads() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _balancer.GetLoads();
+}
+
+void Router::SetLoadBalancerSettings(const LoadBalancer::Settings &settings) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _balancer.SetSettings(settings);
+}
+
+// 记录辅助服务器的负载报告；服务器开始落后时不再向其放置新的传感器，并记录警告。
+void Router::UpdateLoad(std::shared_ptr<Primary> session, const SecondaryLoad &report) {
+  if (_balancer.Report(session.get(), report)) {
+    const auto load = _balancer.GetLoad(session.get());
+    if (load.overloaded) {
+      log_warning("secondary server is falling behind at frame", report.frame,
+          ": frame time", load.frame_time_ms, "ms,", load.pending_frames,
+          "pending frames; new sensors will be placed on other servers");
+    } else {
+      log_info("secondary server caught up at frame", report.frame);
+    }
+  }
+}
+
 } // 名称空间 multigpu
 } // 名称空间 carla
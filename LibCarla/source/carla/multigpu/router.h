@@ -17,6 +17,8 @@
 
 #include "carla/multigpu/commands.h" // 包含Carla多GPU处理框架中通用命令定义的头文件，这些命令可能用于多GPU之间的通信或任务同步。
 
+#include "carla/multigpu/loadBalancer.h" // 根据辅助服务器的负载放置传感器
+
 #include <boost/asio/io_context.hpp> // 包含Boost.Asio库中IO上下文定义的头文件，IO上下文是异步IO操作的核心组件。
 
 #include <boost/asio/ip/tcp.hpp> // 包含Boost.Asio库中TCP网络通信相关的定义和类，用于实现TCP客户端和服务器。
@@ -39,12 +41,6 @@ namespace multigpu {
     std::shared_ptr<Primary> session; // 成员变量，指向Primary对象的智能指针，用于管理会话中的Primary对象。
     carla::Buffer buffer; // 成员变量，用于存储数据的缓冲区，Buffer可能是Carla定义的一种数据结构。
   };
-} // namespace multigpu
-} // namespace carla
-  struct SessionInfo { // 定义一个结构体来保存会话信息
-    std::shared_ptr<Primary>  session; // 指向Primary对象的智能指针
-    carla::Buffer             buffer; // 用于存储数据的缓冲区
-  };
 
   class Router : public std::enable_shared_from_this<Router> { // 定义Router类，继承自std::enable_shared_from_this
   public:
@@ -53,7 +49,7 @@ namespace multigpu {
     explicit Router(uint16_t port); // 带端口参数的构造函数
     ~Router(); // 析构函数
 
-    void Write(MultiGPUCommand id, Buffer &&buffer); // 写入命令到下一个可用的GPU
+    size_t Write(MultiGPUCommand id, Buffer &&buffer); // 向所有辅助服务器广播命令，返回写入的会话数
     std::future<SessionInfo> WriteToNext(MultiGPUCommand id, Buffer &&buffer); // 写入命令到下一个可用的GPU并返回一个future对象
     std::future<SessionInfo> WriteToOne(std::weak_ptr<Primary> server, MultiGPUCommand id, Buffer &&buffer); // 写入命令到指定的GPU并返回一个future对象
     void Stop(); // 停止Router
@@ -75,10 +71,20 @@ namespace multigpu {
 
     std::weak_ptr<Primary> GetNextServer();  // 获取下一个服务器的弱引用
 
+    std::weak_ptr<Primary> GetLeastLoadedServer(float cost); // 选择放置代价为 cost 的传感器的服务器并记入其负载
+    void ReleaseLoad(std::weak_ptr<Primary> server, float cost); // 传感器销毁后从服务器的负载中减去其代价
+
+    LoadBalancer::ServerLoad GetServerLoad(std::weak_ptr<Primary> server); // 获取一个服务器报告的负载
+
+    std::vector<LoadBalancer::ServerLoad> GetServerLoads(); // 按连接顺序获取所有服务器的负载
+
+    void SetLoadBalancerSettings(const LoadBalancer::Settings &settings); // 设置判断服务器落后的阈值
+
   private:
     void ConnectSession(std::shared_ptr<Primary> session); // 连接会话
     void DisconnectSession(std::shared_ptr<Primary> session); // 断开会话
     void ClearSessions(); // 清除会话
+    void UpdateLoad(std::shared_ptr<Primary> session, const SecondaryLoad &report); // 记录负载报告，需持有 _mutex
 
     // 互斥锁和线程池必须放在开始位置，以确保最后被销毁
     std::mutex                              _mutex; // 互斥锁
@@ -90,6 +96,7 @@ namespace multigpu {
     std::unordered_map<Primary *, std::shared_ptr<std::promise<SessionInfo>>> _promises;  // 用于异步操作的承诺映射
     PrimaryCommands                         _commander; // 命令对象
     std::function<void(void)>               _callback; // 回调函数
+    LoadBalancer                            _balancer; // 各服务器的负载
   };
 
 } // namespace multigpu
@@ -4,8 +4,9 @@
 // This work is licensed under the terms of the MIT license.
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
-// #include "carla/Logging.h"
+#include "carla/Logging.h"
 #include "carla/multigpu/secondaryCommands.h"
+#include "carla/multigpu/secondary.h"
 // #include "carla/streaming/detail/tcp/Message.h"
 
 namespace carla {
@@ -35,6 +36,18 @@ void SecondaryCommands::process_command(Buffer buffer) {
   // 创建一个新的Buffer对象，用于存储命令数据（不包括命令头）
   // 如果header->size确实包含了命令头的大小，那么下面的代码将正确地跳过命令头
   Buffer data(buffer.data() + sizeof(CommandHeader), header->size);
+
+  // 帧数据可能是相对上一帧的差异，还原成完整的帧。缺少差异的基准时（例如
+  // 刚连接上）丢弃该帧，直到收到下一个关键帧
+  if (header->id == MultiGPUCommand::SEND_FRAME &&
+      FrameDecoder::IsEncoded(data.data(), data.size())) {
+    Buffer frame;
+    if (!_frame_decoder.Decode(data.data(), data.size(), frame)) {
+      log_warning("Secondary dropped a frame: waiting for a key frame from the primary server");
+      return;
+    }
+    data = std::move(frame);
+  }
   
   // 调用之前设置的回调函数，传递命令ID和命令数据
   _callback(header->id, std::move(data));  // 使用std::move是为了避免不必要的拷贝
@@ -44,6 +57,31 @@ void SecondaryCommands::process_command(Buffer buffer) {
 }
 // 这些类型和类可能是在其他地方定义的，用于支持SecondaryCommands类的功能
 
+// 发送应答，与主服务器发来的命令一样以命令头开头
+void SecondaryCommands::send_response(MultiGPUCommand id, Buffer buffer) {
+  if (!_secondary) {
+    return;
+  }
+  CommandHeader header;
+  header.id = id;
+  header.size = static_cast<uint32_t>(buffer.size());
+  Buffer buf_header(reinterpret_cast<const unsigned char *>(&header), sizeof(header));
+
+  auto view_header = BufferView::CreateFrom(std::move(buf_header));
+  auto view_data = BufferView::CreateFrom(std::move(buffer));
+  _secondary->Write(Secondary::MakeMessage(view_header, view_data));
+}
+
+// 发送负载报告，主服务器通过命令头中的 LOAD_REPORT 将其与应答区分
+void SecondaryCommands::send_load_report(uint64_t frame, float frame_time_ms, uint32_t pending_frames) {
+  SecondaryLoad report;
+  report.pending_frames = pending_frames;
+  report.frame = frame;
+  report.frame_time_ms = frame_time_ms;
+  send_response(MultiGPUCommand::LOAD_REPORT,
+      Buffer(reinterpret_cast<const unsigned char *>(&report), sizeof(report)));
+}
+
 
 }
 }  // 命名空间结束
@@ -9,7 +9,9 @@
 // #include "carla/Logging.h" // 引入CARLA的日志模块（暂时注释掉） 
 #include "carla/Buffer.h" // 引入CARLA的缓冲区模块
 #include "carla/multigpu/commands.h" // 引入多GPU命令模块
+#include "carla/multigpu/frameCodec.h" // 解码主服务器发来的帧数据
 #include <functional> // 引入函数对象的头文件
+#include <memory> // 引入智能指针的头文件
 
 namespace carla { // CARLA项目的顶级命名空间
 namespace multigpu { // CARLA项目中与多GPU相关功能的子命名空间
@@ -36,8 +38,16 @@ class SecondaryCommands {
 
     // 处理从Secondary接收到的命令
     // 这个方法接受一个包含命令数据的缓冲区作为参数，并解析命令，然后根据需要调用设置的回调函数
+    // 编码过的帧数据（见 FrameEncoder）先解码，回调收到的总是完整的帧
     void process_command(carla::Buffer buffer);
 
+    // 向主服务器应答命令 id，数据前加上命令头
+    void send_response(MultiGPUCommand id, carla::Buffer buffer);
+
+    // 向主服务器报告处理第 frame 帧所用的时间和尚未处理的帧数，主服务器
+    // 据此决定新传感器的放置位置（见 LoadBalancer）
+    void send_load_report(uint64_t frame, float frame_time_ms, uint32_t pending_frames);
+
   private:
     // 存储Secondary对象的共享指针，以便在处理命令时访问Secondary类的实例
     std::shared_ptr<Secondary> _secondary;
@@ -45,6 +55,9 @@ class SecondaryCommands {
     // 存储回调函数，以便在处理完命令后调用它
     // 回调函数将使用从命令中解析出的数据和命令类型作为参数进行调用
     callback_type _callback;
+
+    // 保存上一帧，用于还原相对上一帧的差异
+    FrameDecoder _frame_decoder;
 };
 
 // 注意：MultiGPUCommand枚举类型和carla::Buffer类的定义没有在这个代码片段中给出，
@@ -0,0 +1,30 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstdint>
+
+namespace carla {
+namespace nav {
+
+  /// 行人导航节拍的累计耗时统计（微秒）
+  struct CrowdTickStats {
+    /// UpdateCrowd 的调用次数
+    uint64_t ticks { 0u };
+    uint64_t crowd_update_us { 0u };
+    uint64_t unblock_check_us { 0u };
+    uint64_t walker_manager_us { 0u };
+    uint64_t snapshot_us { 0u };
+    /// 最后一次 UpdateCrowd 的总耗时
+    uint64_t last_tick_us { 0u };
+    /// 客户端导航节拍的调用次数与累计耗时，包括向服务器发送行人命令
+    uint64_t navigation_ticks { 0u };
+    uint64_t navigation_us { 0u };
+  };
+
+} // namespace nav
+} // namespace carla
@@ -0,0 +1,76 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace nav {
+
+  /// 人群方格的坐标（Recast 坐标中 x/z 平面上的方格编号）
+  using CrowdTileCoord = std::pair<int, int>;
+
+  /// 人群按方格划分时的几何计算。
+  ///
+  /// 方格边长小于等于 0 时不划分，所有位置都属于方格 (0, 0)。
+  class CrowdTileGrid {
+  public:
+
+    explicit CrowdTileGrid(float tile_size = 0.0f) : _tile_size(tile_size) {}
+
+    float GetTileSize() const {
+      return _tile_size;
+    }
+
+    bool IsTiled() const {
+      return _tile_size > 0.0f;
+    }
+
+    /// 返回 Recast 坐标 (@a x, @a z) 所在的方格
+    CrowdTileCoord GetTileOf(float x, float z) const {
+      if (!IsTiled()) {
+        return std::make_pair(0, 0);
+      }
+      return std::make_pair(
+          static_cast<int>(std::floor(x / _tile_size)),
+          static_cast<int>(std::floor(z / _tile_size)));
+    }
+
+    /// 位置是否离开方格 @a tile 超过 @a margin，超过时需要移交到新方格
+    bool IsOutside(const CrowdTileCoord &tile, float x, float z, float margin) const {
+      if (!IsTiled()) {
+        return false;
+      }
+      const float min_x = static_cast<float>(tile.first) * _tile_size - margin;
+      const float min_z = static_cast<float>(tile.second) * _tile_size - margin;
+      const float max_x = min_x + _tile_size + 2.0f * margin;
+      const float max_z = min_z + _tile_size + 2.0f * margin;
+      return x < min_x || x >= max_x || z < min_z || z >= max_z;
+    }
+
+    /// 返回与以 (@a x, @a z) 为中心、半边长为 @a margin 的正方形相交的所有方格
+    std::vector<CrowdTileCoord> GetTilesAround(float x, float z, float margin) const {
+      std::vector<CrowdTileCoord> result;
+      const auto first = GetTileOf(x - margin, z - margin);
+      const auto last = GetTileOf(x + margin, z + margin);
+      for (int i = first.first; i <= last.first; ++i) {
+        for (int j = first.second; j <= last.second; ++j) {
+          result.emplace_back(i, j);
+        }
+      }
+      return result;
+    }
+
+  private:
+
+    float _tile_size;
+  };
+
+} // namespace nav
+} // namespace carla
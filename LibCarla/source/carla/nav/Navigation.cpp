@@ -9,10 +9,13 @@
 #include <cmath>
 
 #include "carla/Logging.h"
+#include "carla/ParallelFor.h"
+#include "carla/StopWatch.h"
 #include "carla/nav/Navigation.h"
 #include "carla/nav/WalkerManager.h"
 #include "carla/geom/Math.h"
 
+#include <algorithm>
 #include <iterator>
 #include <fstream>
 #include <mutex>
@@ -41,6 +44,22 @@ namespace nav {
 
   static const float AREA_GRASS_COST =  1.0f; // 定义草地区域的成本为1.0，用于路径规划时的权重计算
   static const float AREA_ROAD_COST  = 10.0f; // 定义道路区域的成本为10.0，用于路径规划时的权重计算，通常道路的成本高于草地
+  static const float CROWD_TILE_HANDOVER_MARGIN = 2.0f; // 行人越过方格边界超过该距离才移交，避免在边界上来回切换
+  static const float CROWD_TILE_VEHICLE_MARGIN = 12.0f; // 车辆会被复制到该距离内的相邻方格，使边界附近的行人也能避让
+  static const float CROWD_TILE_WALKER_MARGIN = 3.0f; // 行人会被复制到该距离内的相邻方格，使两侧的行人互相避让
+
+  // 全局代理索引 = 方格槽位 * MAX_AGENTS + 人群内索引
+  static inline int LocalAgentIndex(int index) {
+    return index % MAX_AGENTS;
+  }
+
+  static inline size_t TileSlotOf(int index) {
+    return static_cast<size_t>(index / MAX_AGENTS);
+  }
+
+  static inline int GlobalAgentIndex(size_t slot, int local) {
+    return static_cast<int>(slot) * MAX_AGENTS + local;
+  }
 
   // 返回一个随机的浮点数 float
   static float frand() {
@@ -58,10 +77,15 @@ namespace nav {
     _mapped_walkers_id.clear(); // 清空_mapped_walkers_id列表，该列表存储了映射的步行者ID
     _mapped_vehicles_id.clear(); // 清空_mapped_vehicles_id列表，该列表存储了映射的车辆ID
     _mapped_by_index.clear(); // 清空_mapped_by_index列表，该列表可能存储了按索引映射的对象
+    _walker_ghosts.clear();
     _walkers_blocked_position.clear(); // 清空_walkers_blocked_position列表，该列表存储了被阻塞步行者的位置
     _yaw_walkers.clear(); // 清空_yaw_walkers列表，该列表可能存储了步行者的朝向信息
     _binary_mesh.clear(); // 清空_binary_mesh，该变量可能存储了二进制网格数据
-    dtFreeCrowd(_crowd); // 释放_crowd资源，_crowd是用于人群模拟的动态组件
+    for (auto &tile : _crowds) {
+      dtFreeCrowd(tile.crowd); // 释放每个方格的人群资源
+    }
+    _crowds.clear();
+    _crowd_by_tile.clear();
     dtFreeNavMeshQuery(_nav_query); // 释放_nav_query资源，_nav_query是用于路径查询的组件
     dtFreeNavMesh(_nav_mesh); // 释放_nav_mesh资源，_nav_mesh是用于路径规划的导航网格
   }
@@ -224,55 +248,64 @@ namespace nav {
       return;
     }
 
-    DEBUG_ASSERT(_crowd == nullptr);// 断言_crowd成员变量为nullptr，确保未重复初始化
+    DEBUG_ASSERT(_crowds.empty());// 断言人群为空，确保未重复初始化
+
+    // 创建原点所在方格的人群，其余方格在需要时创建
+    std::lock_guard<std::mutex> lock(_mutex);
+    GetOrCreateCrowdTile(std::make_pair(0, 0));
+  }
+
+  // 分配并配置一个新的人群
+  dtCrowd *Navigation::AllocCrowd() {
 
     // 创建并初始化
-    _crowd = dtAllocCrowd();
+    dtCrowd *crowd = dtAllocCrowd();
     // 这些半径应该是车辆的最大尺寸 (CarlaCola for Carla)
     const float max_agent_radius = AGENT_RADIUS * 20;
-    if (!_crowd->init(MAX_AGENTS, max_agent_radius, _nav_mesh)) {
+    if (!crowd->init(MAX_AGENTS, max_agent_radius, _nav_mesh)) {
        // 如果初始化失败，记录日志并返回
       logging::log("Nav: failed to create crowd");
-      return;
+      dtFreeCrowd(crowd);
+      return nullptr;
     }
 
     // 设置不同的过滤器
     // 过滤器 0 不能在道路上行走
-    _crowd->getEditableFilter(0)->setIncludeFlags(CARLA_TYPE_WALKABLE);
-    _crowd->getEditableFilter(0)->setExcludeFlags(CARLA_TYPE_ROAD);
-    _crowd->getEditableFilter(0)->setAreaCost(CARLA_AREA_ROAD, AREA_ROAD_COST);
-    _crowd->getEditableFilter(0)->setAreaCost(CARLA_AREA_GRASS, AREA_GRASS_COST);
+    crowd->getEditableFilter(0)->setIncludeFlags(CARLA_TYPE_WALKABLE);
+    crowd->getEditableFilter(0)->setExcludeFlags(CARLA_TYPE_ROAD);
+    crowd->getEditableFilter(0)->setAreaCost(CARLA_AREA_ROAD, AREA_ROAD_COST);
+    crowd->getEditableFilter(0)->setAreaCost(CARLA_AREA_GRASS, AREA_GRASS_COST);
     // 过滤器 1 可以在道路上行走
-    _crowd->getEditableFilter(1)->setIncludeFlags(CARLA_TYPE_WALKABLE);
-    _crowd->getEditableFilter(1)->setExcludeFlags(CARLA_TYPE_NONE);
-    _crowd->getEditableFilter(1)->setAreaCost(CARLA_AREA_ROAD, AREA_ROAD_COST);
-    _crowd->getEditableFilter(1)->setAreaCost(CARLA_AREA_GRASS, AREA_GRASS_COST);
+    crowd->getEditableFilter(1)->setIncludeFlags(CARLA_TYPE_WALKABLE);
+    crowd->getEditableFilter(1)->setExcludeFlags(CARLA_TYPE_NONE);
+    crowd->getEditableFilter(1)->setAreaCost(CARLA_AREA_ROAD, AREA_ROAD_COST);
+    crowd->getEditableFilter(1)->setAreaCost(CARLA_AREA_GRASS, AREA_GRASS_COST);
 
     // 设置不同品质的局部避让参数。
     dtObstacleAvoidanceParams params;
     // 主要使用默认设置，从 dtCrowd 复制。
-    memcpy(&params, _crowd->getObstacleAvoidanceParams(0), sizeof(dtObstacleAvoidanceParams));
+    memcpy(&params, crowd->getObstacleAvoidanceParams(0), sizeof(dtObstacleAvoidanceParams));
 
     // Low (11)
     params.velBias = 0.5f;
     params.adaptiveDivs = 5;
     params.adaptiveRings = 2;
     params.adaptiveDepth = 1;
-    _crowd->setObstacleAvoidanceParams(0, &params);
+    crowd->setObstacleAvoidanceParams(0, &params);
 
     // Medium (22)
     params.velBias = 0.5f;
     params.adaptiveDivs = 5;
     params.adaptiveRings = 2;
     params.adaptiveDepth = 2;
-    _crowd->setObstacleAvoidanceParams(1, &params);
+    crowd->setObstacleAvoidanceParams(1, &params);
 
     // Good (45)
     params.velBias = 0.5f;
     params.adaptiveDivs = 7;
     params.adaptiveRings = 2;
     params.adaptiveDepth = 3;
-    _crowd->setObstacleAvoidanceParams(2, &params);
+    crowd->setObstacleAvoidanceParams(2, &params);
 
     // High (66)
     params.velBias = 0.5f;
@@ -280,7 +313,65 @@ namespace nav {
     params.adaptiveRings = 3;
     params.adaptiveDepth = 3;
 
-    _crowd->setObstacleAvoidanceParams(3, &params);
+    crowd->setObstacleAvoidanceParams(3, &params);
+
+    return crowd;
+  }
+
+  std::pair<int, int> Navigation::GetTileOf(const float *position) const {
+    // Recast 坐标中 y 轴竖直向上，按 x/z 平面划分
+    return _tile_grid.GetTileOf(position[0], position[2]);
+  }
+
+  int Navigation::GetOrCreateCrowdTile(std::pair<int, int> tile) {
+    auto it = _crowd_by_tile.find(tile);
+    if (it != _crowd_by_tile.end()) {
+      return static_cast<int>(it->second);
+    }
+    dtCrowd *crowd = AllocCrowd();
+    if (crowd == nullptr) {
+      return -1;
+    }
+    const size_t slot = _crowds.size();
+    _crowds.push_back(CrowdTile{crowd, tile.first, tile.second});
+    _crowd_by_tile.emplace(tile, slot);
+    return static_cast<int>(slot);
+  }
+
+  dtCrowd *Navigation::GetCrowdOf(int index) const {
+    DEBUG_ASSERT(index >= 0 && TileSlotOf(index) < _crowds.size());
+    return _crowds[TileSlotOf(index)].crowd;
+  }
+
+  std::vector<dtCrowd *> Navigation::GetCrowds() const {
+    std::vector<dtCrowd *> result;
+    result.reserve(_crowds.size());
+    for (auto &tile : _crowds) {
+      result.push_back(tile.crowd);
+    }
+    return result;
+  }
+
+  int Navigation::FindAgentIndex(ActorId id) const {
+    auto walker = _mapped_walkers_id.find(id);
+    if (walker != _mapped_walkers_id.end()) {
+      return walker->second;
+    }
+    auto vehicle = _mapped_vehicles_id.find(id);
+    if (vehicle != _mapped_vehicles_id.end() && !vehicle->second.empty()) {
+      return vehicle->second.front();
+    }
+    return -1;
+  }
+
+  bool Navigation::SetCrowdTileSize(float tile_size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_mapped_walkers_id.empty() || !_mapped_vehicles_id.empty()) {
+      logging::log("Nav: the crowd tile size must be set before adding any agent");
+      return false;
+    }
+    _tile_grid = CrowdTileGrid(tile_size);
+    return true;
   }
 
   // 返回从一个位置到另一个位置的路径点
@@ -425,7 +516,8 @@ namespace nav {
       // 关键部分，强制单线程运行这里
       std::lock_guard<std::mutex> lock(_mutex);
        // 根据代理的参数获取对应的过滤器。
-      filter = _crowd->getFilter(_crowd->getAgent(it->second)->params.queryFilterType);
+      dtCrowd *crowd = GetCrowdOf(it->second);
+      filter = crowd->getFilter(crowd->getAgent(LocalAgentIndex(it->second))->params.queryFilterType);
     }
 
     // 设置点
@@ -508,7 +600,7 @@ namespace nav {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    DEBUG_ASSERT(!_crowds.empty());
 
     // 设置参数
     memset(&params, 0, sizeof(params));
@@ -540,15 +632,21 @@ namespace nav {
     {
       // 关键部分，强制单线程运行这里
       std::lock_guard<std::mutex> lock(_mutex);
-      index = _crowd->addAgent(point_from, &params);
-      if (index == -1) {
+      // 添加到起点所在方格的人群中
+      const int slot = GetOrCreateCrowdTile(GetTileOf(point_from));
+      if (slot == -1) {
         return false;
       }
-    }
+      const int local = _crowds[static_cast<size_t>(slot)].crowd->addAgent(point_from, &params);
+      if (local == -1) {
+        return false;
+      }
+      index = GlobalAgentIndex(static_cast<size_t>(slot), local);
 
-    // 保存 id
-    _mapped_walkers_id[id] = index;
-    _mapped_by_index[index] = id;
+      // 保存 id（方格移交会在同一把锁内修改映射）
+      _mapped_walkers_id[id] = index;
+      _mapped_by_index[index] = id;
+    }
 
     // 初始化偏航角
     _yaw_walkers[id] = 0.0f;
@@ -569,7 +667,7 @@ namespace nav {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    DEBUG_ASSERT(!_crowds.empty());
 
     // 获取边界框扩展以及周围的一些空间
     float marge = 0.8f;
@@ -592,40 +690,69 @@ namespace nav {
     box_corner3 += vehicle.transform.location;
     box_corner4 += vehicle.transform.location;
 
+    // 从虚幻坐标（垂直为 Z）到 Recast 坐标（垂直为 Y，右手坐标系）
+    float point_from[3] = { vehicle.transform.location.x,
+                            vehicle.transform.location.z,
+                            vehicle.transform.location.y };
+
+    // 车辆需要出现在其周围所有已存在方格的人群中（只有一个人群时即为该人群）
+    std::vector<size_t> slots;
+    {
+      // 关键部分，强制单线程运行这里
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_tile_grid.IsTiled()) {
+        slots.push_back(0u);
+      } else {
+        for (auto &coord : _tile_grid.GetTilesAround(point_from[0], point_from[2], CROWD_TILE_VEHICLE_MARGIN)) {
+          auto tile = _crowd_by_tile.find(coord);
+          if (tile != _crowd_by_tile.end()) {
+            slots.push_back(tile->second);
+          }
+        }
+        std::sort(slots.begin(), slots.end());
+      }
+    }
+
+    // 更新代理的位置和朝向的边界框
+    auto update_agent = [&](dtCrowdAgent *agent) {
+      agent->npos[0] = vehicle.transform.location.x;
+      agent->npos[1] = vehicle.transform.location.z;
+      agent->npos[2] = vehicle.transform.location.y;
+      agent->params.obb[0]  = box_corner1.x;
+      agent->params.obb[1]  = box_corner1.z;
+      agent->params.obb[2]  = box_corner1.y;
+      agent->params.obb[3]  = box_corner2.x;
+      agent->params.obb[4]  = box_corner2.z;
+      agent->params.obb[5]  = box_corner2.y;
+      agent->params.obb[6]  = box_corner3.x;
+      agent->params.obb[7]  = box_corner3.z;
+      agent->params.obb[8]  = box_corner3.y;
+      agent->params.obb[9]  = box_corner4.x;
+      agent->params.obb[10] = box_corner4.z;
+      agent->params.obb[11] = box_corner4.y;
+    };
+
     // 检查该参与者是否存在
     auto it = _mapped_vehicles_id.find(vehicle.id);
     if (it != _mapped_vehicles_id.end()) {
-      // 获得找到的索引
-      int index = it->second;
-      if (index != -1) {
-        // 获得智能体
-        dtCrowdAgent *agent;
-        {
-          // 关键部分，强制单线程运行这里
-          std::lock_guard<std::mutex> lock(_mutex);
-          agent = _crowd->getEditableAgent(index);
-        }
-        if (agent) {
-          // 更新它的位置
-          agent->npos[0] = vehicle.transform.location.x;
-          agent->npos[1] = vehicle.transform.location.z;
-          agent->npos[2] = vehicle.transform.location.y;
-          // 更新其朝向的边界框
-          agent->params.obb[0]  = box_corner1.x;
-          agent->params.obb[1]  = box_corner1.z;
-          agent->params.obb[2]  = box_corner1.y;
-          agent->params.obb[3]  = box_corner2.x;
-          agent->params.obb[4]  = box_corner2.z;
-          agent->params.obb[5]  = box_corner2.y;
-          agent->params.obb[6]  = box_corner3.x;
-          agent->params.obb[7]  = box_corner3.z;
-          agent->params.obb[8]  = box_corner3.y;
-          agent->params.obb[9]  = box_corner4.x;
-          agent->params.obb[10] = box_corner4.z;
-          agent->params.obb[11] = box_corner4.y;
+      // 所在的方格没有变化时只更新位置
+      bool same_tiles = (it->second.size() == slots.size());
+      for (size_t i = 0u; same_tiles && i < slots.size(); ++i) {
+        same_tiles = (TileSlotOf(it->second[i]) == slots[i]);
+      }
+      if (same_tiles) {
+        // 关键部分，强制单线程运行这里
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (int index : it->second) {
+          dtCrowdAgent *agent = GetCrowdOf(index)->getEditableAgent(LocalAgentIndex(index));
+          if (agent) {
+            update_agent(agent);
+          }
         }
         return true;
       }
+      // 否则从原来的方格中移除后重新添加
+      RemoveAgent(vehicle.id);
     }
 
     // 设置参数
@@ -658,34 +785,37 @@ namespace nav {
     params.obb[10] = box_corner4.z;
     params.obb[11] = box_corner4.y;
 
-    // 从虚幻坐标（垂直为 Z）到 Recast 坐标（垂直为 Y，右手坐标系）
-    float point_from[3] = { vehicle.transform.location.x,
-                            vehicle.transform.location.z,
-                            vehicle.transform.location.y };
-
-    // 添加行人
-    int index;
+    // 添加到每个方格的人群中
+    std::vector<int> indices;
+    indices.reserve(slots.size());
     {
       // 关键部分，强制单线程运行这里
       std::lock_guard<std::mutex> lock(_mutex); // 锁定互斥量，确保代码块在多线程环境下是安全的
-      index = _crowd->addAgent(point_from, &params);  // 向人群添加代理，并返回代理的索引
-      if (index == -1) {
-        logging::log("Vehicle agent not added to the crowd by some problem!");
-        return false;
-      }
+      for (size_t slot : slots) {
+        dtCrowd *crowd = _crowds[slot].crowd;
+        const int local = crowd->addAgent(point_from, &params);  // 向人群添加代理，并返回代理的索引
+        if (local == -1) {
+          logging::log("Vehicle agent not added to the crowd by some problem!");
+          continue;
+        }
 
-      // 标记为有效
-      dtCrowdAgent *agent = _crowd->getEditableAgent(index);  // 获取代理对象
-      if (agent) {
-        agent->state = DT_CROWDAGENT_STATE_WALKING;   // 将代理的状态设为“行走”
+        // 标记为有效
+        dtCrowdAgent *agent = crowd->getEditableAgent(local);  // 获取代理对象
+        if (agent) {
+          agent->state = DT_CROWDAGENT_STATE_WALKING;   // 将代理的状态设为“行走”
+        }
+        indices.push_back(GlobalAgentIndex(slot, local));
       }
     }
 
-    // 保存 id
-    _mapped_vehicles_id[vehicle.id] = index;  // 将车辆 ID 映射到代理的索引
-    _mapped_by_index[index] = vehicle.id; // 将代理索引映射到车辆 ID
+    // 保存 id（附近没有方格时也记录，下一帧再检查）
+    for (int index : indices) {
+      _mapped_by_index[index] = vehicle.id; // 将代理索引映射到车辆 ID
+    }
+    const bool added = (indices.size() == slots.size());
+    _mapped_vehicles_id[vehicle.id] = std::move(indices);  // 将车辆 ID 映射到代理的索引
 
-    return true;
+    return added;
   }
 
   // 移除代理
@@ -696,37 +826,46 @@ namespace nav {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);  // 确保 _crowd 非空
+    DEBUG_ASSERT(!_crowds.empty());  // 确保 _crowd 非空
 
     // 获取内部行人索引
-    auto it = _mapped_walkers_id.find(id);  // 在映射表中查找行人 ID
-    if (it != _mapped_walkers_id.end()) {
-      // 从人群中移除
-      {
-        // 关键部分，强制单线程运行这里
-        std::lock_guard<std::mutex> lock(_mutex);
-        _crowd->removeAgent(it->second); // 从人群中移除对应的代理
+    bool is_walker = false;
+    {
+      // 关键部分，强制单线程运行这里（方格移交会在同一把锁内修改映射）
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto it = _mapped_walkers_id.find(id);  // 在映射表中查找行人 ID
+      if (it != _mapped_walkers_id.end()) {
+        // 从人群中移除
+        const int index = it->second;
+        GetCrowdOf(index)->removeAgent(LocalAgentIndex(index)); // 从人群中移除对应的代理
+        RemoveWalkerGhosts(id);
+        // remove from mapping
+        _mapped_walkers_id.erase(it);
+        _mapped_by_index.erase(index);
+        is_walker = true;
       }
+    }
+    if (is_walker) {
       _walker_manager.RemoveWalker(id);  // 从其他管理系统中移除行人
-      // remove from mapping
-      _mapped_walkers_id.erase(it);
-      _mapped_by_index.erase(it->second);
-
       return true;
     }
 
     // get the internal vehicle index
-    it = _mapped_vehicles_id.find(id);  // 查找车辆 ID
-    if (it != _mapped_vehicles_id.end()) {
-      // 从人群中移除
+    auto vehicle = _mapped_vehicles_id.find(id);  // 查找车辆 ID
+    if (vehicle != _mapped_vehicles_id.end()) {
+      // 从所有方格的人群中移除
       {
         // 关键部分，强制单线程运行这里
         std::lock_guard<std::mutex> lock(_mutex); // 锁定互斥量
-        _crowd->removeAgent(it->second);  // 从人群中移除对应的代理
-      }  
+        for (int index : vehicle->second) {
+          GetCrowdOf(index)->removeAgent(LocalAgentIndex(index));  // 从人群中移除对应的代理
+        }
+      }
       // 从映射中移除
-      _mapped_vehicles_id.erase(it);
-      _mapped_by_index.erase(it->second);
+      for (int index : vehicle->second) {
+        _mapped_by_index.erase(index);
+      }
+      _mapped_vehicles_id.erase(vehicle);
 
       return true;
     }
@@ -768,7 +907,7 @@ namespace nav {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    DEBUG_ASSERT(!_crowds.empty());
 
     // 获取内部索引
     auto it = _mapped_walkers_id.find(id);
@@ -780,7 +919,7 @@ namespace nav {
     {
       // 关键部分，强制单线程运行这里
       std::lock_guard<std::mutex> lock(_mutex); // 锁定互斥量，确保单线程安全
-      dtCrowdAgent *agent = _crowd->getEditableAgent(it->second); // 获取代理
+      dtCrowdAgent *agent = GetCrowdOf(it->second)->getEditableAgent(LocalAgentIndex(it->second)); // 获取代理
       if (agent) {
         agent->params.maxSpeed = max_speed;  // 设置最大速度
         return true;
@@ -832,7 +971,7 @@ namespace nav {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    DEBUG_ASSERT(!_crowds.empty());
     DEBUG_ASSERT(_nav_query != nullptr);
 
     if (index == -1) {
@@ -846,14 +985,15 @@ namespace nav {
     {
       // 关键部分，强制单线程运行这里
       std::lock_guard<std::mutex> lock(_mutex);
-      const dtQueryFilter *filter = _crowd->getFilter(0);
+      dtCrowd *crowd = GetCrowdOf(index);
+      const dtQueryFilter *filter = crowd->getFilter(0);
       dtPolyRef target_ref;
-      _nav_query->findNearestPoly(point_to, _crowd->getQueryHalfExtents(), filter, &target_ref, nearest);
+      _nav_query->findNearestPoly(point_to, crowd->getQueryHalfExtents(), filter, &target_ref, nearest);
       if (!target_ref) {
         return false;
       }
 
-      res = _crowd->requestMoveTarget(index, target_ref, point_to);
+      res = crowd->requestMoveTarget(LocalAgentIndex(index), target_ref, point_to);
     }
 
     return res;
@@ -861,91 +1001,401 @@ namespace nav {
 
   // 更新人群中的所有行人
   void Navigation::UpdateCrowd(const client::detail::EpisodeState &state) {
+    UpdateCrowd(state.GetTimestamp().delta_seconds);
+  }
+
+  // 按给定的时间步长更新人群中的所有行人
+  void Navigation::UpdateCrowd(double delta_seconds) {
 
     // 检查是否一切就绪
     if (!_ready) {
       return;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    DEBUG_ASSERT(!_crowds.empty());
+
+    StopWatch total_watch;
 
-    // 更新人群代理
-    _delta_seconds = state.GetTimestamp().delta_seconds;
+    // 更新人群代理，并在同一次加锁内复制所有代理的状态，
+    // 之后的检查都只读取快照，不再为每个代理单独加锁
+    _delta_seconds = delta_seconds;
     {
       // 关键部分，强制单线程运行这里
       std::lock_guard<std::mutex> lock(_mutex);
-      _crowd->update(static_cast<float>(_delta_seconds), nullptr);
+      StopWatch watch;
+      // 各方格的人群互不相关，并行更新
+      const float delta_seconds = static_cast<float>(_delta_seconds);
+      ParallelFor(_crowds.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          _crowds[i].crowd->update(delta_seconds, nullptr);
+        }
+      });
+      watch.Stop();
+      _tick_stats.crowd_update_us += watch.GetElapsedTime<std::chrono::microseconds>();
+
+      watch.Restart();
+      _agents_snapshot.assign(_crowds.size() * static_cast<size_t>(MAX_AGENTS), AgentSnapshot{});
+      ParallelFor(_crowds.size(), [&](size_t begin, size_t end) {
+        for (size_t slot = begin; slot < end; ++slot) {
+          dtCrowd *crowd = _crowds[slot].crowd;
+          for (int i = 0; i < crowd->getAgentCount(); ++i) {
+            const dtCrowdAgent *ag = crowd->getAgent(i);
+            AgentSnapshot &snapshot = _agents_snapshot[static_cast<size_t>(GlobalAgentIndex(slot, i))];
+            snapshot.active = ag->active;
+            snapshot.paused = ag->paused;
+            snapshot.dead = ag->dead;
+            snapshot.is_walker = !ag->params.useObb;
+            snapshot.position = carla::geom::Vector3D(ag->npos[0], ag->npos[1], ag->npos[2]);
+            snapshot.velocity = carla::geom::Vector3D(ag->vel[0], ag->vel[1], ag->vel[2]);
+            snapshot.desired_velocity = carla::geom::Vector3D(ag->dvel[0], ag->dvel[1], ag->dvel[2]);
+          }
+        }
+      });
+      // 相邻方格中的行人副本不参与堵塞检查
+      for (auto &ghosts : _walker_ghosts) {
+        for (int index : ghosts.second) {
+          _agents_snapshot[static_cast<size_t>(index)].is_walker = false;
+        }
+      }
+      watch.Stop();
+      _tick_stats.snapshot_us += watch.GetElapsedTime<std::chrono::microseconds>();
+    }
+
+    // 将越过方格边界的行人移交到相邻方格，并更新边界附近行人的副本
+    if (_tile_grid.IsTiled()) {
+      HandoverAgents();
+      ReplicateBorderWalkers();
     }
+    const int total_agents = static_cast<int>(_agents_snapshot.size());
 
     // 更新行人路线
-    _walker_manager.Update(_delta_seconds);
+    {
+      StopWatch watch;
+      _walker_manager.Update(_delta_seconds);
+      watch.Stop();
+      _tick_stats.walker_manager_us += watch.GetElapsedTime<std::chrono::microseconds>();
+    }
 
     // 更新检查被堵塞代理的时间
     _time_to_unblock += _delta_seconds;
 
-    // 查看所有活跃代理
-    int total_unblocked = 0;
-    int total_agents;
+    // 检查参与者是否解除堵塞
+    if (_time_to_unblock >= AGENT_UNBLOCK_TIME) {
+      StopWatch watch;
+      _walkers_blocked_position.resize(static_cast<size_t>(total_agents));
+
+      // 并行比较每个行人的移动距离，每个代理只写入自己的槽位
+      std::vector<uint8_t> blocked(static_cast<size_t>(total_agents), 0u);
+      ParallelFor(static_cast<size_t>(total_agents), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          const AgentSnapshot &ag = _agents_snapshot[i];
+          // 仅检查未暂停的行人，不检查车辆
+          if (!ag.active || ag.paused || ag.dead || !ag.is_walker) {
+            continue;
+          }
+          carla::geom::Vector3D distance = ag.position - _walkers_blocked_position[i];
+          if (distance.SquaredLength() < AGENT_UNBLOCK_DISTANCE_SQUARED) {
+            blocked[i] = 1u;
+          }
+          // 更新当前位置
+          _walkers_blocked_position[i] = ag.position;
+        }
+      }, ComputeGrainSize(static_cast<size_t>(total_agents)));
+
+      // 为被堵塞的行人设置新的随机目标（随机数与路线规划不是线程安全的，保持串行）
+      for (int i = 0; i < total_agents; ++i) {
+        if (blocked[static_cast<size_t>(i)] == 0u) {
+          continue;
+        }
+        carla::geom::Location location;
+        GetRandomLocation(location, nullptr);
+        _walker_manager.SetWalkerRoute(_mapped_by_index[i], location);
+      }
+      watch.Stop();
+      _tick_stats.unblock_check_us += watch.GetElapsedTime<std::chrono::microseconds>();
+
+      // 重置时间
+      _time_to_unblock = 0.0f;
+    }
+
+    total_watch.Stop();
+    _tick_stats.last_tick_us = total_watch.GetElapsedTime<std::chrono::microseconds>();
+    ++_tick_stats.ticks;
+  }
+
+  // 将离开所在方格的行人移交到新方格的人群中
+  void Navigation::HandoverAgents() {
+    // 移交后需要重新设置目标点的行人
+    std::vector<std::pair<int, carla::geom::Location>> targets;
     {
-      // 关键部分，强制单线程运行这里
+      // 关键部分：整个移交过程都持有锁，AddWalker 可能同时创建方格（_crowds 扩容）或修改映射
       std::lock_guard<std::mutex> lock(_mutex);
-      total_agents = _crowd->getAgentCount();
-    }
-    const dtCrowdAgent *ag;
-    for (int i = 0; i < total_agents; ++i) {
-      {
-        // 关键部分，强制单线程运行这里
-        std::lock_guard<std::mutex> lock(_mutex);
-        ag = _crowd->getAgent(i);
+      for (auto &entry : _mapped_walkers_id) {
+        const int old_index = entry.second;
+        if (old_index < 0 || static_cast<size_t>(old_index) >= _agents_snapshot.size()) {
+          continue;
+        }
+        // 复制一份，创建方格时快照会扩容
+        const AgentSnapshot agent = _agents_snapshot[static_cast<size_t>(old_index)];
+        if (!agent.active || agent.dead) {
+          continue;
+        }
+        // 只有越过方格边界（加上余量）的行人才移交
+        const CrowdTile &current = _crowds[TileSlotOf(old_index)];
+        if (!_tile_grid.IsOutside(std::make_pair(current.x, current.y),
+                                  agent.position.x, agent.position.z, CROWD_TILE_HANDOVER_MARGIN)) {
+          continue;
+        }
+        const int slot = GetOrCreateCrowdTile(_tile_grid.GetTileOf(agent.position.x, agent.position.z));
+        if (slot == -1) {
+          continue;
+        }
+        // 新创建的方格需要快照空间
+        const size_t size = _crowds.size() * static_cast<size_t>(MAX_AGENTS);
+        _agents_snapshot.resize(size, AgentSnapshot{});
+        _walkers_blocked_position.resize(size);
+
+        dtCrowd *from = GetCrowdOf(old_index);
+        dtCrowd *to = _crowds[static_cast<size_t>(slot)].crowd;
+        const dtCrowdAgent *source = from->getAgent(LocalAgentIndex(old_index));
+        // 新人群已满时留在原来的人群中
+        const int local = to->addAgent(source->npos, &source->params);
+        if (local == -1) {
+          continue;
+        }
+        dtCrowdAgent *copy = to->getEditableAgent(local);
+        copy->paused = source->paused;
+        dtVcopy(copy->vel, source->vel);
+        dtVcopy(copy->dvel, source->dvel);
+        dtVcopy(copy->nvel, source->nvel);
+        // 直接设置的目标点不在行人路线中，需要从原来的代理中复制
+        const bool direct_target = (source->targetState == DT_CROWDAGENT_TARGET_VALID);
+        carla::geom::Location target(source->targetPos[0], source->targetPos[2], source->targetPos[1]);
+        from->removeAgent(LocalAgentIndex(old_index));
+
+        // 更新映射和快照
+        const int new_index = GlobalAgentIndex(static_cast<size_t>(slot), local);
+        entry.second = new_index;
+        _mapped_by_index.erase(old_index);
+        _mapped_by_index[new_index] = entry.first;
+        _agents_snapshot[static_cast<size_t>(new_index)] = agent;
+        _agents_snapshot[static_cast<size_t>(old_index)] = AgentSnapshot{};
+        _walkers_blocked_position[static_cast<size_t>(new_index)] = _walkers_blocked_position[static_cast<size_t>(old_index)];
+
+        // 优先使用路线中的下一个点
+        if (!agent.paused &&
+            (_walker_manager.GetWalkerNextPoint(entry.first, target) || direct_target)) {
+          targets.emplace_back(new_index, target);
+        }
       }
+    }
+
+    // 在新的人群中恢复当前的目标点（会再次加锁）
+    for (auto &target : targets) {
+      SetWalkerDirectTargetIndex(target.first, target.second);
+    }
+  }
 
-      if (!ag->active || ag->paused || ag->dead) {
+  // 将靠近方格边界的行人复制到相邻方格的人群中。副本不会移动，每个节拍
+  // 从原行人复制位置和速度，使另一侧的行人能够避让
+  void Navigation::ReplicateBorderWalkers() {
+    // 关键部分，强制单线程运行这里
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::unordered_map<ActorId, std::vector<int>> ghosts;
+    for (auto &entry : _mapped_walkers_id) {
+      const int index = entry.second;
+      if (index < 0 || static_cast<size_t>(index) >= _agents_snapshot.size()) {
         continue;
       }
-
-      // 仅检查未暂停的行人，不检查车辆
-      if (!ag->params.useObb && !ag->paused) {
-        bool reset_target_pos = false;
-        bool use_same_filter = false;
-
-        // 检查参与者是否解除堵塞
-        if (_time_to_unblock >= AGENT_UNBLOCK_TIME) {
-          // 获取每个参与者移动的距离
-          carla::geom::Vector3D previous = _walkers_blocked_position[i];
-          carla::geom::Vector3D current = carla::geom::Vector3D(ag->npos[0], ag->npos[1], ag->npos[2]);
-          carla::geom::Vector3D distance = current - previous;
-          float d = distance.SquaredLength();
-          if (d < AGENT_UNBLOCK_DISTANCE_SQUARED) {
-            ++total_unblocked;
-            reset_target_pos = true;
-            use_same_filter = true;
-          }
-          // 更新当前位置
-          _walkers_blocked_position[i] = current;
-
-          // check to assign a new target position
-          if (reset_target_pos) {
-            // set if the agent can cross roads or not
-            if (!use_same_filter) {
-              if (frand() <= _probability_crossing) {
-                SetAgentFilter(i, 1);
-              } else {
-                SetAgentFilter(i, 0);
-              }
+      const AgentSnapshot &agent = _agents_snapshot[static_cast<size_t>(index)];
+      if (!agent.active || agent.dead) {
+        continue;
+      }
+      const size_t own_slot = TileSlotOf(index);
+      const dtCrowdAgent *source = GetCrowdOf(index)->getAgent(LocalAgentIndex(index));
+      auto previous = _walker_ghosts.find(entry.first);
+      std::vector<int> current;
+      for (auto &coord : _tile_grid.GetTilesAround(agent.position.x, agent.position.z, CROWD_TILE_WALKER_MARGIN)) {
+        auto tile = _crowd_by_tile.find(coord);
+        if (tile == _crowd_by_tile.end() || tile->second == own_slot) {
+          continue;
+        }
+        const size_t slot = tile->second;
+        dtCrowd *crowd = _crowds[slot].crowd;
+        // 优先复用该方格中已有的副本
+        int ghost = -1;
+        if (previous != _walker_ghosts.end()) {
+          for (int &existing : previous->second) {
+            if (existing != -1 && TileSlotOf(existing) == slot) {
+              ghost = existing;
+              existing = -1;
+              break;
             }
-            // 设置新的随机目标
-            carla::geom::Location location;
-            GetRandomLocation(location, nullptr);
-            _walker_manager.SetWalkerRoute(_mapped_by_index[i], location);
           }
         }
+        if (ghost == -1) {
+          dtCrowdAgentParams params;
+          memset(&params, 0, sizeof(params));
+          params.radius = source->params.radius;
+          params.height = source->params.height;
+          params.maxAcceleration = 0.0f;
+          params.maxSpeed = source->params.maxSpeed;
+          params.separationWeight = source->params.separationWeight;
+          params.queryFilterType = source->params.queryFilterType;
+          const int local = crowd->addAgent(source->npos, &params);
+          if (local == -1) {
+            continue;
+          }
+          ghost = GlobalAgentIndex(slot, local);
+        }
+        dtCrowdAgent *copy = crowd->getEditableAgent(LocalAgentIndex(ghost));
+        copy->state = DT_CROWDAGENT_STATE_WALKING;
+        dtVcopy(copy->npos, source->npos);
+        dtVcopy(copy->vel, source->vel);
+        current.push_back(ghost);
+      }
+      if (!current.empty()) {
+        ghosts.emplace(entry.first, std::move(current));
       }
     }
 
-    // 检查重置时间
-    if (_time_to_unblock >= AGENT_UNBLOCK_TIME) {
-      _time_to_unblock = 0.0f;
+    // 移除不再需要的副本
+    for (auto &entry : _walker_ghosts) {
+      for (int index : entry.second) {
+        if (index != -1) {
+          GetCrowdOf(index)->removeAgent(LocalAgentIndex(index));
+        }
+      }
     }
+    _walker_ghosts = std::move(ghosts);
+  }
+
+  // 移除行人的所有副本
+  void Navigation::RemoveWalkerGhosts(ActorId id) {
+    auto it = _walker_ghosts.find(id);
+    if (it == _walker_ghosts.end()) {
+      return;
+    }
+    for (int index : it->second) {
+      GetCrowdOf(index)->removeAgent(LocalAgentIndex(index));
+    }
+    _walker_ghosts.erase(it);
+  }
+
+  // 根据快照批量获取行人的变换、速度和存活状态
+  std::vector<WalkerSnapshot> Navigation::GetWalkerSnapshots(const std::vector<ActorId> &ids) {
+    std::vector<WalkerSnapshot> result;
+
+    // 检查是否一切就绪
+    if (!_ready) {
+      return result;
+    }
+
+    // 先串行解析索引和偏航角的存储位置（可能向 _yaw_walkers 中插入元素）
+    std::vector<std::pair<size_t, float *>> slots;
+    slots.reserve(ids.size());
+    result.reserve(ids.size());
+    for (ActorId id : ids) {
+      auto it = _mapped_walkers_id.find(id);
+      if (it == _mapped_walkers_id.end() || it->second < 0 ||
+          static_cast<size_t>(it->second) >= _agents_snapshot.size()) {
+        continue;
+      }
+      slots.emplace_back(static_cast<size_t>(it->second), &_yaw_walkers[id]);
+      result.push_back(WalkerSnapshot{id, false, true, carla::geom::Transform(), 0.0f});
+    }
+
+    // 并行计算每个行人的变换，每个行人只修改自己的结果与偏航角
+    const float delta_seconds = static_cast<float>(_delta_seconds);
+    ParallelFor(result.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const AgentSnapshot &agent = _agents_snapshot[slots[i].first];
+        float &last_yaw = *slots[i].second;
+        WalkerSnapshot &walker = result[i];
+        walker.alive = !agent.dead;
+        walker.speed = agent.velocity.Length();
+        walker.active = agent.active;
+        if (!agent.active) {
+          continue;
+        }
+
+        // 在虚幻坐标中设置其位置
+        walker.transform.location.x = agent.position.x;
+        walker.transform.location.y = agent.position.z;
+        walker.transform.location.z = agent.position.y;
+
+        // 设置其旋转（与 GetWalkerTransform 相同的插值）
+        const float min = 0.1f;
+        const carla::geom::Vector3D &vel =
+            (agent.velocity.x < -min || agent.velocity.x > min ||
+             agent.velocity.z < -min || agent.velocity.z > min) ?
+            agent.velocity : agent.desired_velocity;
+        const float yaw = atan2f(vel.z, vel.x) * (180.0f / static_cast<float>(M_PI));
+        const float speed = vel.Length();
+        float shortest_angle = fmod(yaw - last_yaw + 540.0f, 360.0f) - 180.0f;
+        float per = (speed / 1.5f);
+        if (per > 1.0f) per = 1.0f;
+        float rotation_speed = per * 6.0f;
+        walker.transform.rotation.yaw = last_yaw + (shortest_angle * rotation_speed * delta_seconds);
+        last_yaw = walker.transform.rotation.yaw;
+      }
+    }, ComputeGrainSize(result.size()));
+
+    return result;
+  }
+
+  // 从快照中读取行人位置
+  bool Navigation::GetWalkerSnapshotPosition(ActorId id, carla::geom::Location &location) const {
+    auto it = _mapped_walkers_id.find(id);
+    if (it == _mapped_walkers_id.end() || it->second < 0 ||
+        static_cast<size_t>(it->second) >= _agents_snapshot.size()) {
+      return false;
+    }
+    const AgentSnapshot &agent = _agents_snapshot[static_cast<size_t>(it->second)];
+    if (!agent.active) {
+      return false;
+    }
+    // 在虚幻坐标中设置其位置
+    location.x = agent.position.x;
+    location.y = agent.position.z;
+    location.z = agent.position.y;
+    return true;
+  }
+
+  bool Navigation::GetWalkerTile(ActorId id, CrowdTileCoord &tile) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _mapped_walkers_id.find(id);
+    if (it == _mapped_walkers_id.end() || it->second < 0) {
+      return false;
+    }
+    const CrowdTile &current = _crowds[TileSlotOf(it->second)];
+    tile = std::make_pair(current.x, current.y);
+    return true;
+  }
+
+  std::vector<CrowdTileCoord> Navigation::GetWalkerGhostTiles(ActorId id) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<CrowdTileCoord> result;
+    auto it = _walker_ghosts.find(id);
+    if (it == _walker_ghosts.end()) {
+      return result;
+    }
+    for (int index : it->second) {
+      const CrowdTile &tile = _crowds[TileSlotOf(index)];
+      result.emplace_back(tile.x, tile.y);
+    }
+    return result;
+  }
+
+  CrowdTickStats Navigation::GetTickStats() const {
+    CrowdTickStats stats;
+    stats.ticks = _tick_stats.ticks;
+    stats.crowd_update_us = _tick_stats.crowd_update_us;
+    stats.unblock_check_us = _tick_stats.unblock_check_us;
+    stats.walker_manager_us = _tick_stats.walker_manager_us;
+    stats.snapshot_us = _tick_stats.snapshot_us;
+    stats.last_tick_us = _tick_stats.last_tick_us;
+    return stats;
   }
 
   // 获取行人当前变换
@@ -956,7 +1406,7 @@ namespace nav {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    DEBUG_ASSERT(!_crowds.empty());
 
     // 获取内部索引
     auto it = _mapped_walkers_id.find(id);
@@ -975,7 +1425,7 @@ namespace nav {
     {
       // 关键部分，强制单线程运行这里
       std::lock_guard<std::mutex> lock(_mutex);
-      agent = _crowd->getAgent(index);
+      agent = GetCrowdOf(index)->getAgent(LocalAgentIndex(index));
     }
 
     if (!agent->active) {
@@ -1020,7 +1470,7 @@ namespace nav {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    DEBUG_ASSERT(!_crowds.empty());
 
     // 获取内部索引
     auto it = _mapped_walkers_id.find(id);
@@ -1039,7 +1489,7 @@ namespace nav {
     {
       // 关键部分，强制单线程运行这里
       std::lock_guard<std::mutex> lock(_mutex);
-      agent = _crowd->getAgent(index);
+      agent = GetCrowdOf(index)->getAgent(LocalAgentIndex(index));
     }
 
     if (!agent->active) {
@@ -1061,7 +1511,7 @@ namespace nav {
       return 0.0f;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    DEBUG_ASSERT(!_crowds.empty());
 
     // 获取内部索引
     auto it = _mapped_walkers_id.find(id);
@@ -1080,7 +1530,7 @@ namespace nav {
     {
       // 关键部分，强制单线程运行这里
       std::lock_guard<std::mutex> lock(_mutex);
-      agent = _crowd->getAgent(index);
+      agent = GetCrowdOf(index)->getAgent(LocalAgentIndex(index));
     }
 
     return sqrt(agent->vel[0] * agent->vel[0] + agent->vel[1] * agent->vel[1] + agent->vel[2] *
@@ -1136,7 +1586,7 @@ namespace nav {
     {
       // 关键部分，强制单线程运行这里
       std::lock_guard<std::mutex> lock(_mutex);
-      agent = _crowd->getEditableAgent(agent_index);
+      agent = GetCrowdOf(agent_index)->getEditableAgent(LocalAgentIndex(agent_index));
     }
     agent->params.queryFilterType = static_cast<unsigned char>(filter_index);
   }
@@ -1156,7 +1606,7 @@ namespace nav {
       return;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    DEBUG_ASSERT(!_crowds.empty());
 
     // 获取内部索引
     auto it = _mapped_walkers_id.find(id);
@@ -1175,7 +1625,7 @@ namespace nav {
     {
       // 关键部分，强制单线程运行这里
       std::lock_guard<std::mutex> lock(_mutex);
-      agent = _crowd->getEditableAgent(index);
+      agent = GetCrowdOf(index)->getEditableAgent(LocalAgentIndex(index));
     }
 
     // 标记为暂停
@@ -1184,12 +1634,9 @@ namespace nav {
 
   bool Navigation::HasVehicleNear(ActorId id, float distance, carla::geom::Location direction) {
     // 获取内部索引（行人或者车辆）
-    auto it = _mapped_walkers_id.find(id);
-    if (it == _mapped_walkers_id.end()) {
-      it = _mapped_vehicles_id.find(id);
-      if (it == _mapped_vehicles_id.end()) {
-        return false;
-      }
+    const int index = FindAgentIndex(id);
+    if (index == -1) {
+      return false;
     }
 
     float dir[3] = { direction.x, direction.z, direction.y };
@@ -1197,7 +1644,7 @@ namespace nav {
     {
       // 关键部分，强制单线程运行这里
       std::lock_guard<std::mutex> lock(_mutex);
-      result = _crowd->hasVehicleNear(it->second, distance * distance, dir, false);
+      result = GetCrowdOf(index)->hasVehicleNear(LocalAgentIndex(index), distance * distance, dir, false);
     }
     return result;
   }
@@ -1205,19 +1652,16 @@ namespace nav {
   /// 让代理查看某个位置
   bool Navigation::SetWalkerLookAt(ActorId id, carla::geom::Location location) {
     // 获取内部索引（行人或车辆）
-    auto it = _mapped_walkers_id.find(id);
-    if (it == _mapped_walkers_id.end()) {
-      it = _mapped_vehicles_id.find(id);
-      if (it == _mapped_vehicles_id.end()) {
-        return false;
-      }
+    const int index = FindAgentIndex(id);
+    if (index == -1) {
+      return false;
     }
 
     dtCrowdAgent *agent;
     {
       // 关键部分，强制单线程运行这里
       std::lock_guard<std::mutex> lock(_mutex);
-      agent = _crowd->getEditableAgent(it->second);
+      agent = GetCrowdOf(index)->getEditableAgent(LocalAgentIndex(index));
     }
 
     // 获取位置
@@ -1245,7 +1689,7 @@ namespace nav {
       return false;
     }
 
-    DEBUG_ASSERT(_crowd != nullptr);
+    DEBUG_ASSERT(!_crowds.empty());
 
     // 获取内部索引
     auto it = _mapped_walkers_id.find(id);
@@ -1264,7 +1708,7 @@ namespace nav {
     {
       // 关键部分，强制单线程运行这里
       std::lock_guard<std::mutex> lock(_mutex);
-      agent = _crowd->getAgent(index);
+      agent = GetCrowdOf(index)->getAgent(LocalAgentIndex(index));
     }
 
     // 标记
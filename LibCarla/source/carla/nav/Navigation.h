@@ -13,11 +13,19 @@
 // 使用几何库相关功能
 #include "carla/geom/Location.h"
 #include "carla/geom/Transform.h"
+#include "carla/nav/CrowdTileGrid.h"
+#include "carla/nav/CrowdTickStats.h"
 #include "carla/nav/WalkerManager.h" 
 
 // 使用远程过程调用相关功能
 #include "carla/rpc/ActorId.h"
 
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
 #include <recast/Recast.h>
 // 包含Recast/Detour导航网格生成和查询库的头文件
  
@@ -80,6 +88,17 @@ namespace nav {
     carla::geom::BoundingBox bounding;
   };
 
+  /// 一次快照中单个行人的状态，用于批量生成发往服务器的命令
+  struct WalkerSnapshot {
+    carla::rpc::ActorId id;
+    /// 代理是否处于活动状态（只有活动代理的变换有效）
+    bool active;
+    /// 行人是否仍然存活（未被车辆撞倒）
+    bool alive;
+    carla::geom::Transform transform;
+    float speed;
+  };
+
   /// 管理行人导航，使用 Recast & Detour 库进行低层计算。
   ///
   /// 该类从服务器获取地图的二进制内容，这是查找路径所必需的。然后，这个类可以添加或删除行人，并为每个行人设置目标步行点。
@@ -165,6 +184,8 @@ namespace nav {
     float GetWalkerSpeed(ActorId id);
     /// 更新人群中的所有步行者
     void UpdateCrowd(const client::detail::EpisodeState &state);
+    /// 按 @a delta_seconds 秒的时间步长更新人群中的所有步行者
+    void UpdateCrowd(double delta_seconds);
     /// 获取导航的随机位置
     bool GetRandomLocation(carla::geom::Location &location, dtQueryFilter * filter = nullptr) const;
     /// 设置行人代理在路径跟随过程中穿过马路的概率
@@ -178,7 +199,30 @@ namespace nav {
     /// 如果行人代理被车辆撞死，则返回
     bool IsWalkerAlive(ActorId id, bool &alive);
 
-    dtCrowd *GetCrowd() { return _crowd; };
+    /// 根据最近一次 UpdateCrowd 的代理快照，一次性计算 @a ids 中所有行人的
+    /// 变换、速度和存活状态，不再为每个行人单独加锁读取人群。
+    /// 找不到的行人不会出现在结果中。
+    std::vector<WalkerSnapshot> GetWalkerSnapshots(const std::vector<ActorId> &ids);
+    /// 从最近一次 UpdateCrowd 的代理快照中读取行人位置（不加锁），
+    /// 供 WalkerManager 在同一节拍内并行查询。
+    bool GetWalkerSnapshotPosition(ActorId id, carla::geom::Location &location) const;
+    /// 返回人群更新的累计耗时统计
+    CrowdTickStats GetTickStats() const;
+    /// 返回行人当前所属的方格
+    bool GetWalkerTile(ActorId id, CrowdTileCoord &tile) const;
+    /// 返回行人在相邻方格中的副本所在的方格
+    std::vector<CrowdTileCoord> GetWalkerGhostTiles(ActorId id) const;
+
+    /// 将可行走区域按 @a tile_size 米的方格划分，每个方格拥有独立的人群并行更新，
+    /// 行人越过方格边界时会被移交到相邻方格的人群中。小于等于 0 时使用单个人群。
+    /// 只能在添加任何代理之前设置。
+    bool SetCrowdTileSize(float tile_size);
+
+    /// 返回第一个人群（未划分方格时即唯一的人群）
+    dtCrowd *GetCrowd() { return _crowds.empty() ? nullptr : _crowds.front().crowd; };
+
+    /// 返回所有方格的人群
+    std::vector<dtCrowd *> GetCrowds() const;
 
     /// 返回最后增量秒数
     double GetDeltaSeconds() { return _delta_seconds; };
@@ -191,19 +235,53 @@ namespace nav {
     /// 网格
     dtNavMesh *_nav_mesh { nullptr };
     dtNavMeshQuery *_nav_query { nullptr };
-    /// crowd
-    dtCrowd *_crowd { nullptr };
+    /// 人群按方格划分，代理索引编码为 方格槽位 * MAX_AGENTS + 人群内索引
+    struct CrowdTile {
+      dtCrowd *crowd;
+      int x;
+      int y;
+    };
+    std::vector<CrowdTile> _crowds;
+    /// 方格坐标到 _crowds 槽位的映射
+    std::map<std::pair<int, int>, size_t> _crowd_by_tile;
+    /// 方格划分（米），边长小于等于 0 表示不划分
+    CrowdTileGrid _tile_grid;
     /// mapping Id
     std::unordered_map<ActorId, int> _mapped_walkers_id;
-    std::unordered_map<ActorId, int> _mapped_vehicles_id;
+    /// 车辆会被复制到其周围所有已存在方格的人群中，第一个索引为主代理
+    std::unordered_map<ActorId, std::vector<int>> _mapped_vehicles_id;
     // 也可以通过索引进行映射
     std::unordered_map<int, ActorId> _mapped_by_index;
+    /// 靠近方格边界的行人在相邻方格人群中的副本索引，使两侧的行人互相避让
+    std::unordered_map<ActorId, std::vector<int>> _walker_ghosts;
     /// 存储上一个节拍的行人偏航角
     std::unordered_map<ActorId, float> _yaw_walkers;
     /// 每隔一段时间保存每个参与者的位置，并检查是否有参与者被阻挡
-    std::unordered_map<int, carla::geom::Vector3D> _walkers_blocked_position;
+    std::vector<carla::geom::Vector3D> _walkers_blocked_position;
     double _time_to_unblock { 0.0 };
 
+    /// 每个节拍在一次加锁内复制的代理状态（按代理索引）
+    struct AgentSnapshot {
+      bool active;
+      bool paused;
+      bool dead;
+      bool is_walker;
+      /// Recast 坐标系下的位置、速度和期望速度
+      carla::geom::Vector3D position;
+      carla::geom::Vector3D velocity;
+      carla::geom::Vector3D desired_velocity;
+    };
+    std::vector<AgentSnapshot> _agents_snapshot;
+
+    struct {
+      std::atomic<uint64_t> ticks { 0u };
+      std::atomic<uint64_t> crowd_update_us { 0u };
+      std::atomic<uint64_t> unblock_check_us { 0u };
+      std::atomic<uint64_t> walker_manager_us { 0u };
+      std::atomic<uint64_t> snapshot_us { 0u };
+      std::atomic<uint64_t> last_tick_us { 0u };
+    } _tick_stats;
+
     /// 行人管理器负责带事件的路线规划
     WalkerManager _walker_manager;
 
@@ -215,6 +293,23 @@ namespace nav {
 
     /// 为代理分配过滤索引
     void SetAgentFilter(int agent_index, int filter_index);
+
+    /// 分配并配置一个新的人群（过滤器与避让参数）
+    dtCrowd *AllocCrowd();
+    /// 返回 Recast 坐标 @a position 所在的方格坐标
+    std::pair<int, int> GetTileOf(const float *position) const;
+    /// 返回方格的槽位，必要时创建该方格的人群；失败时返回 -1。需要持有 _mutex
+    int GetOrCreateCrowdTile(std::pair<int, int> tile);
+    /// 根据全局代理索引返回所属人群
+    dtCrowd *GetCrowdOf(int index) const;
+    /// 返回行人或车辆（主代理）的全局索引，找不到时返回 -1
+    int FindAgentIndex(ActorId id) const;
+    /// 将离开所在方格的行人移交到新方格的人群中
+    void HandoverAgents();
+    /// 更新靠近方格边界的行人在相邻方格中的副本
+    void ReplicateBorderWalkers();
+    /// 移除行人的所有副本。需要持有 _mutex
+    void RemoveWalkerGhosts(ActorId id);
   };
 
 } // namespace nav
@@ -7,6 +7,7 @@
 #include "carla/nav/WalkerManager.h"
 
 #include "carla/Logging.h"
+#include "carla/ParallelFor.h"
 #include "carla/client/ActorSnapshot.h"
 #include "carla/client/Waypoint.h"
 #include "carla/client/World.h"
@@ -60,49 +61,59 @@ namespace nav {
 	// 更新所有行人路线
     bool WalkerManager::Update(double delta) {
 
-        // 检查所有行人
+        // 记录本节拍开始时每个行人的状态，状态切换只在下一节拍生效
+        _update_list.clear();
+        _update_list.reserve(_walkers.size());
         for (auto &it : _walkers) {
+            _update_list.push_back(UpdateItem{it.first, &it.second, it.second.state});
+        }
 
-            // 获取行人信息
-            WalkerInfo &info = it.second;
-
-            // 根据状态执行不同的操作
-            switch (info.state) {
-                case WALKER_IDLE:
-                    break;// 闲置状态不做任何操作
-
-                case WALKER_WALKING:
-                    {
-                        // 获取目标点
-                        carla::geom::Location &target = info.route[info.currentIndex].location;
-                        // 获取当前位置信息
-                        carla::geom::Location current;
-                        _nav->GetWalkerPosition(it.first, current);
-                        // 计算与目标点的距离v
-                        carla::geom::Vector3D dist(target.x - current.x, target.z - current.z, target.y - current.y);
-                        if (dist.SquaredLength() <= 1) {// 判断是否到达目标点
-                            info.state = WALKER_IN_EVENT;// 状态切换为在事件中
+        // 并行检查行走中的行人是否到达目标点（只读取导航快照，并且只修改自己的信息）
+        ParallelFor(_update_list.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                UpdateItem &item = _update_list[i];
+                WalkerInfo &info = *item.info;
+                switch (item.state) {
+                    case WALKER_WALKING:
+                        {
+                            // 获取目标点
+                            carla::geom::Location &target = info.route[info.currentIndex].location;
+                            // 获取当前位置信息
+                            carla::geom::Location current;
+                            _nav->GetWalkerSnapshotPosition(item.id, current);
+                            // 计算与目标点的距离
+                            carla::geom::Vector3D dist(target.x - current.x, target.z - current.z, target.y - current.y);
+                            if (dist.SquaredLength() <= 1) {// 判断是否到达目标点
+                                info.state = WALKER_IN_EVENT;// 状态切换为在事件中
+                            }
                         }
-                    }
-                    break;
+                        break;
 
-                case WALKER_IN_EVENT:
-                    switch (ExecuteEvent(it.first, it.second, delta)) {
-                        case EventResult::Continue:
-                            break;// 继续事件
-                        case EventResult::End:
-                             // 进入下一个路径点 
-                            SetWalkerNextPoint(it.first);
-                            break;
-                        case EventResult::TimeOut:
-                            // 解锁改变路线的操作
-                            SetWalkerRoute(it.first);
-                            break;
-                    }
-                    break;
+                    case WALKER_STOP:
+                        info.state = WALKER_IDLE;// 停止后切换状态为闲置
+                        break;
 
-                case WALKER_STOP:
-                    info.state = WALKER_IDLE;// 停止后切换状态为闲置
+                    default:
+                        break;
+                }
+            }
+        }, ComputeGrainSize(_update_list.size()));
+
+        // 事件会修改人群和查询模拟器，按原顺序串行执行
+        for (auto &item : _update_list) {
+            if (item.state != WALKER_IN_EVENT) {
+                continue;
+            }
+            switch (ExecuteEvent(item.id, *item.info, delta)) {
+                case EventResult::Continue:
+                    break;// 继续事件
+                case EventResult::End:
+                     // 进入下一个路径点
+                    SetWalkerNextPoint(item.id);
+                    break;
+                case EventResult::TimeOut:
+                    // 解锁改变路线的操作
+                    SetWalkerRoute(item.id);
                     break;
             }
         }
@@ -279,13 +290,17 @@ namespace nav {
         static bool AlreadyCalculated = false;
         if (AlreadyCalculated) return;
 
+        // 没有模拟器时（例如单独使用导航）没有交通灯，下次再计算
+        auto simulator = _simulator.lock();
+        if (simulator == nullptr) return;
+
         // 获取世界对象
-        carla::client::World world = _simulator.lock()->GetWorld();
+        carla::client::World world = simulator->GetWorld();
 
         _traffic_lights.clear();
-        std::vector<carla::rpc::Actor> actors = _simulator.lock()->GetAllTheActorsInTheEpisode();
+        std::vector<carla::rpc::Actor> actors = simulator->GetAllTheActorsInTheEpisode();
         for (auto actor : actors) {
-            carla::client::ActorSnapshot snapshot = _simulator.lock()->GetActorSnapshot(actor.id);
+            carla::client::ActorSnapshot snapshot = simulator->GetActorSnapshot(actor.id);
             // 仅检查交通灯
             if (actor.description.id == "traffic.traffic_light") {
                 // 获取交通灯对象
@@ -143,6 +143,13 @@ namespace nav {
     Navigation *_nav { nullptr };// 使用弱引用（weak_ptr）来存储指向模拟器（Simulator）对象的指针，避免强引用可能导致的循环引用问题，
         // 同时又能通过该弱引用在需要时访问模拟器相关的API函数
     std::weak_ptr<carla::client::detail::Simulator> _simulator;
+    /// Update 中每个节拍复用的行人列表：行人 ID、信息指针以及节拍开始时的状态
+    struct UpdateItem {
+        ActorId id;
+        WalkerInfo *info;
+        WalkerState state;
+    };
+    std::vector<UpdateItem> _update_list;
   };
 
 } // namespace nav
@@ -0,0 +1,285 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/geom/Vector3D.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace carla {
+namespace pointcloud {
+
+  /// 点云过滤的参数，各项过滤按通道抽取、范围裁剪、体素下采样的顺序执行。
+  struct PointCloudFilterSettings {
+    /// 每 @a channel_step 个通道保留一个，从 @a channel_offset 开始。
+    uint32_t channel_step = 1u;
+    uint32_t channel_offset = 0u;
+    /// 到传感器的距离范围（米），max_range 为 0 表示不限制。
+    float min_range = 0.0f;
+    float max_range = 0.0f;
+    /// 为 true 时只保留传感器坐标系下 [box_min, box_max] 内的点。
+    bool crop_to_box = false;
+    geom::Vector3D box_min;
+    geom::Vector3D box_max;
+    /// 体素边长（米），0 表示不做体素下采样。
+    float voxel_size = 0.0f;
+
+    bool IsEnabled() const {
+      return channel_step > 1u || channel_offset > 0u ||
+          min_range > 0.0f || max_range > 0.0f ||
+          crop_to_box || voxel_size > 0.0f;
+    }
+  };
+
+  /// 过滤后的点云。点仍按通道排序，channel_counts 的长度与输入的通道数
+  /// 相同，被抽掉的通道点数为 0。
+  template <typename PointT>
+  struct FilteredPointCloud {
+    std::vector<PointT> points;
+    std::vector<uint32_t> channel_counts;
+  };
+
+  /// 激光雷达点云的通道抽取、范围/ROI 裁剪和体素下采样。
+  ///
+  /// 体素下采样用开放寻址的哈希表把点累加到连续存放的累加器中，每个体素
+  /// 输出一个点：位置为体素内各点的质心，强度（如果有）取平均值，其余属性
+  /// 取体素中的第一个点。体素按第一个点出现的顺序输出并归入该点的通道，
+  /// 所以结果是确定的。哈希表和累加器是线程局部的，在帧之间复用。
+  class PointCloudFilter {
+  public:
+
+    using Settings = PointCloudFilterSettings;
+
+    /// 过滤 @a points，@a channel_counts 为每个通道的点数（与
+    /// LidarHeaderView::GetPointCount 相同）。
+    template <typename PointT>
+    static FilteredPointCloud<PointT> Apply(
+        const PointT *points,
+        const std::vector<uint32_t> &channel_counts,
+        const Settings &settings) {
+      auto result = Crop(points, channel_counts, settings);
+      if (settings.voxel_size > 0.0f) {
+        VoxelDownsample(result, settings.voxel_size);
+      }
+      return result;
+    }
+
+    /// 通道抽取和范围裁剪，保持点的顺序。
+    template <typename PointT>
+    static FilteredPointCloud<PointT> Crop(
+        const PointT *points,
+        const std::vector<uint32_t> &channel_counts,
+        const Settings &settings) {
+      const uint32_t step = std::max(settings.channel_step, 1u);
+      const float min_range_squared = settings.min_range * settings.min_range;
+      const float max_range_squared = settings.max_range > 0.0f ?
+          settings.max_range * settings.max_range :
+          std::numeric_limits<float>::infinity();
+      const bool check_range = settings.min_range > 0.0f || settings.max_range > 0.0f;
+
+      FilteredPointCloud<PointT> result;
+      result.channel_counts.assign(channel_counts.size(), 0u);
+      size_t kept = 0u;
+      for (size_t channel = 0u; channel < channel_counts.size(); ++channel) {
+        kept += IsChannelKept(channel, settings.channel_offset, step) ? channel_counts[channel] : 0u;
+      }
+      result.points.reserve(kept);
+
+      for (size_t channel = 0u; channel < channel_counts.size(); ++channel) {
+        const PointT *begin = points;
+        points += channel_counts[channel];
+        if (!IsChannelKept(channel, settings.channel_offset, step)) {
+          continue;
+        }
+        if (!check_range && !settings.crop_to_box) {
+          // 只做通道抽取时整段复制
+          result.points.insert(result.points.end(), begin, points);
+          result.channel_counts[channel] = channel_counts[channel];
+          continue;
+        }
+        const size_t size_before = result.points.size();
+        for (const PointT *it = begin; it != points; ++it) {
+          const auto &p = it->point;
+          if (check_range) {
+            const float distance_squared = p.x * p.x + p.y * p.y + p.z * p.z;
+            if (distance_squared < min_range_squared || distance_squared > max_range_squared) {
+              continue;
+            }
+          }
+          if (settings.crop_to_box && !IsInsideBox(p, settings.box_min, settings.box_max)) {
+            continue;
+          }
+          result.points.push_back(*it);
+        }
+        result.channel_counts[channel] = static_cast<uint32_t>(result.points.size() - size_before);
+      }
+      return result;
+    }
+
+    /// 边长为 @a voxel_size 的体素网格下采样，原地修改 @a cloud。
+    template <typename PointT>
+    static void VoxelDownsample(FilteredPointCloud<PointT> &cloud, float voxel_size) {
+      DEBUG_ASSERT(voxel_size > 0.0f);
+      const size_t number_of_points = cloud.points.size();
+      if (number_of_points == 0u) {
+        return;
+      }
+      DEBUG_ASSERT(number_of_points <= std::numeric_limits<uint32_t>::max());
+      auto &scratch = GetScratch();
+      scratch.Reset(number_of_points);
+      const float inverse_size = 1.0f / voxel_size;
+
+      const PointT *it = cloud.points.data();
+      for (auto &count : cloud.channel_counts) {
+        const uint32_t points_in_channel = count;
+        count = 0u;
+        for (uint32_t i = 0u; i < points_in_channel; ++i, ++it) {
+          const auto &p = it->point;
+          const uint64_t key = MakeVoxelKey(p.x * inverse_size, p.y * inverse_size, p.z * inverse_size);
+          bool inserted;
+          Accumulator &voxel = scratch.FindOrInsert(key, inserted);
+          if (inserted) {
+            voxel.first = static_cast<uint32_t>(it - cloud.points.data());
+            ++count;
+          }
+          voxel.x += p.x;
+          voxel.y += p.y;
+          voxel.z += p.z;
+          voxel.intensity += GetIntensity(*it, 0);
+          ++voxel.count;
+        }
+      }
+      DEBUG_ASSERT(it == cloud.points.data() + number_of_points);
+
+      std::vector<PointT> points;
+      points.reserve(scratch.accumulators.size());
+      for (const auto &voxel : scratch.accumulators) {
+        const float inverse_count = 1.0f / static_cast<float>(voxel.count);
+        PointT point = cloud.points[voxel.first];
+        point.point.x = voxel.x * inverse_count;
+        point.point.y = voxel.y * inverse_count;
+        point.point.z = voxel.z * inverse_count;
+        SetIntensity(point, voxel.intensity * inverse_count, 0);
+        points.push_back(point);
+      }
+      cloud.points = std::move(points);
+    }
+
+  private:
+
+    static bool IsChannelKept(size_t channel, uint32_t offset, uint32_t step) {
+      return channel >= offset && (channel - offset) % step == 0u;
+    }
+
+    template <typename LocationT>
+    static bool IsInsideBox(const LocationT &p, const geom::Vector3D &min, const geom::Vector3D &max) {
+      return p.x >= min.x && p.y >= min.y && p.z >= min.z &&
+             p.x <= max.x && p.y <= max.y && p.z <= max.z;
+    }
+
+    // 有 intensity 成员的点（LidarDetection）取平均强度，其余类型忽略。
+    template <typename PointT>
+    static auto GetIntensity(const PointT &point, int) -> decltype(static_cast<float>(point.intensity)) {
+      return point.intensity;
+    }
+
+    template <typename PointT>
+    static float GetIntensity(const PointT &, long) {
+      return 0.0f;
+    }
+
+    template <typename PointT>
+    static auto SetIntensity(PointT &point, float intensity, int) -> decltype(void(point.intensity = intensity)) {
+      point.intensity = intensity;
+    }
+
+    template <typename PointT>
+    static void SetIntensity(PointT &, float, long) {}
+
+    /// 每个坐标 21 位（带偏移的体素下标），可表示约 ±100 万个体素。
+    static constexpr uint32_t KEY_BITS = 21u;
+
+    static constexpr uint64_t EMPTY_KEY = std::numeric_limits<uint64_t>::max();
+
+    static uint64_t MakeVoxelCoordinate(float value) {
+      constexpr float limit = static_cast<float>(1u << (KEY_BITS - 1u));
+      const float clamped = std::max(std::min(std::floor(value), limit - 1.0f), -limit);
+      return static_cast<uint64_t>(static_cast<int64_t>(clamped) + static_cast<int64_t>(limit));
+    }
+
+    static uint64_t MakeVoxelKey(float x, float y, float z) {
+      return (MakeVoxelCoordinate(x) << (2u * KEY_BITS)) |
+             (MakeVoxelCoordinate(y) << KEY_BITS) |
+             MakeVoxelCoordinate(z);
+    }
+
+    struct Accumulator {
+      float x = 0.0f;
+      float y = 0.0f;
+      float z = 0.0f;
+      float intensity = 0.0f;
+      uint32_t count = 0u;
+      uint32_t first = 0u;
+    };
+
+    /// 开放寻址（线性探测）哈希表，负载因子不超过 0.5。键和累加器下标
+    /// 分开存放，探测时只访问键数组。
+    struct Scratch {
+      std::vector<uint64_t> keys;
+      std::vector<uint32_t> slots;
+      std::vector<Accumulator> accumulators;
+      uint64_t mask = 0u;
+      uint32_t shift = 0u;
+
+      void Reset(size_t number_of_points) {
+        size_t capacity = 16u;
+        uint32_t bits = 4u;
+        while (capacity < 2u * number_of_points) {
+          capacity *= 2u;
+          ++bits;
+        }
+        keys.assign(capacity, static_cast<uint64_t>(EMPTY_KEY));
+        slots.resize(capacity);
+        accumulators.clear();
+        accumulators.reserve(number_of_points);
+        mask = capacity - 1u;
+        shift = 64u - bits;
+      }
+
+      Accumulator &FindOrInsert(uint64_t key, bool &inserted) {
+        // Fibonacci 散列，取乘积的高位
+        uint64_t index = (key * 0x9E3779B97F4A7C15ull) >> shift;
+        for (;;) {
+          if (keys[index] == key) {
+            inserted = false;
+            return accumulators[slots[index]];
+          }
+          if (keys[index] == EMPTY_KEY) {
+            keys[index] = key;
+            slots[index] = static_cast<uint32_t>(accumulators.size());
+            accumulators.emplace_back();
+            inserted = true;
+            return accumulators.back();
+          }
+          index = (index + 1u) & mask;
+        }
+      }
+    };
+
+    static Scratch &GetScratch() {
+      static thread_local Scratch scratch;
+      return scratch;
+    }
+  };
+
+} // namespace pointcloud
+} // namespace carla
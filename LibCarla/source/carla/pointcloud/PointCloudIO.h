@@ -7,8 +7,10 @@
 //确保头文件只被包含一次
 #pragma once
 
+#include "carla/Debug.h" // DEBUG_ASSERT
 //包含Carla文件系统头文件
 #include "carla/FileSystem.h"
+#include "carla/StringUtil.h" // 根据扩展名选择二进制格式
 
 //包含fstream头文件，用于文件流操作
 #include <fstream>
@@ -16,6 +18,8 @@
 #include <iterator>
 //包含iostream头文件，用于输入输出操作
 #include <iomanip>
+#include <cstdint>
+#include <type_traits>
 
 namespace carla {// 定义命名空间carla，用于组织相关的代码和数据
 namespace pointcloud {// 定义命名空间pointcloud，进一步组织特定于点云处理的代码
@@ -48,7 +52,75 @@ namespace pointcloud {// 定义命名空间pointcloud，进一步组织特定于
       return path;
     }
 
+    /// 以二进制 PLY 格式写入点云。点在内存中连续存放且布局与
+    /// WritePlyHeaderInfo 声明的属性一致，因此整个点缓冲区一次写入。
+    /// 没有点时写入声明了属性、点数为 0 的有效文件。
+    template <typename PointIt>
+    static void DumpBinaryPly(std::ostream &out, PointIt begin, PointIt end) {
+      const size_t count = Count(begin, end);
+      out << "ply\n"
+             "format " << (IsLittleEndian() ? "binary_little_endian" : "binary_big_endian") << " 1.0\n"
+             "element vertex " << std::to_string(count) << "\n";
+      using PointT = typename std::iterator_traits<PointIt>::value_type;
+      PointT{}.WritePlyHeaderInfo(out);
+      out << "\nend_header\n";
+      WriteRaw(out, begin, count);
+    }
+
+    /// 以二进制 PCD（v0.7）格式写入点云，点缓冲区一次写入。
+    /// PCD 头中没有字节序字段，数据按本机字节序写入，与 PCL 相同。
+    template <typename PointIt>
+    static void DumpBinaryPcd(std::ostream &out, PointIt begin, PointIt end) {
+      const size_t count = Count(begin, end);
+      out << "# .PCD v0.7 - Point Cloud Data file format\n"
+             "VERSION 0.7\n";
+      using PointT = typename std::iterator_traits<PointIt>::value_type;
+      PointT{}.WritePcdHeaderInfo(out);
+      out << "\nWIDTH " << std::to_string(count)
+          << "\nHEIGHT 1"
+             "\nVIEWPOINT 0 0 0 1 0 0 0"
+             "\nPOINTS " << std::to_string(count)
+          << "\nDATA binary\n";
+      WriteRaw(out, begin, count);
+    }
+
+    /// 以二进制格式保存点云：扩展名为 ".pcd" 时写入 PCD，否则写入 PLY。
+    template <typename PointIt>
+    static std::string SaveToDiskBinary(std::string path, PointIt begin, PointIt end) {
+      const bool pcd = StringUtil::EndsWith(path, ".pcd");
+      FileSystem::ValidateFilePath(path, pcd ? ".pcd" : ".ply");
+      std::ofstream out(path, std::ios::binary);
+      if (pcd) {
+        DumpBinaryPcd(out, begin, end);
+      } else {
+        DumpBinaryPly(out, begin, end);
+      }
+      return path;
+    }
+
   private:
+
+    static bool IsLittleEndian() {
+      const uint16_t value = 1u;
+      return *reinterpret_cast<const uint8_t *>(&value) == 1u;
+    }
+
+    template <typename PointIt>
+    static size_t Count(PointIt begin, PointIt end) {
+      DEBUG_ASSERT(std::distance(begin, end) >= 0);
+      return static_cast<size_t>(std::distance(begin, end));
+    }
+
+    template <typename PointIt>
+    static void WriteRaw(std::ostream &out, PointIt begin, size_t count) {
+      static_assert(std::is_pointer<PointIt>::value, "Binary point cloud output requires contiguous points");
+      using PointT = typename std::remove_cv<typename std::remove_pointer<PointIt>::type>::type;
+      static_assert(std::is_trivially_copyable<PointT>::value, "Points must be trivially copyable");
+      if (count > 0u) {
+        out.write(reinterpret_cast<const char *>(begin), static_cast<std::streamsize>(count * sizeof(PointT)));
+      }
+    }
+
     template <typename PointIt> static void WriteHeader(std::ostream &out, PointIt begin, PointIt end) {
       // 断言确保点云数据的数量非负
       DEBUG_ASSERT(std::distance(begin, end) >= 0);
@@ -57,8 +129,9 @@ namespace pointcloud {// 定义命名空间pointcloud，进一步组织特定于
            "format ascii 1.0\n"
            // 写入元素(vertex)的数量，即点云中的点数
            "element vertex " << std::to_string(static_cast<size_t>(std::distance(begin, end))) << "\n";
-      // 假设每个点对象都有WritePlyHeaderInfo方法，用于写入特定的头部信息      
-      begin->WritePlyHeaderInfo(out);
+      // 点的类型提供WritePlyHeaderInfo方法，用于写入属性；没有点时也要写入，文件才有效
+      using PointT = typename std::iterator_traits<PointIt>::value_type;
+      PointT{}.WritePlyHeaderInfo(out);
       // 写入PLY文件头部的结束标志
       out << "\nend_header\n";
       // 设置输出流的格式，固定小数点后4位 
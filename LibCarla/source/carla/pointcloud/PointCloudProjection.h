@@ -0,0 +1,220 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+#include "carla/ParallelFor.h" // 多线程处理点云分块
+#include "carla/geom/Math.h"
+#include "carla/geom/Transform.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace carla {
+namespace pointcloud {
+
+  /// 行主序的 4x4 变换矩阵，与 geom::Transform::GetMatrix() 的布局相同。
+  using TransformMatrix = std::array<float, 16>;
+
+  /// 针孔相机内参。
+  struct CameraIntrinsics {
+    uint32_t width = 0u;
+    uint32_t height = 0u;
+    float fx = 0.0f;
+    float fy = 0.0f;
+    float cx = 0.0f;
+    float cy = 0.0f;
+
+    /// 根据图像尺寸和水平视场角（度）计算内参，与 CARLA 相机传感器一致：
+    /// 像素为正方形，主点位于图像中心。视场角须在 (0, 180) 之间。
+    static CameraIntrinsics FromFov(uint32_t width, uint32_t height, float fov) {
+      if (width == 0u || height == 0u) {
+        throw_exception(std::invalid_argument("camera image size must be positive"));
+      }
+      if (!(fov > 0.0f && fov < 180.0f)) {
+        throw_exception(std::invalid_argument("camera fov must be between 0 and 180 degrees"));
+      }
+      CameraIntrinsics intrinsics;
+      intrinsics.width = width;
+      intrinsics.height = height;
+      const float focal = static_cast<float>(width) /
+          (2.0f * std::tan(geom::Math::ToRadians(fov) / 2.0f));
+      intrinsics.fx = focal;
+      intrinsics.fy = focal;
+      intrinsics.cx = static_cast<float>(width) / 2.0f;
+      intrinsics.cy = static_cast<float>(height) / 2.0f;
+      return intrinsics;
+    }
+  };
+
+  /// 点云投影到相机后得到的图像，按行存储。
+  struct ProjectedImage {
+    uint32_t width = 0u;
+    uint32_t height = 0u;
+    /// 每个像素上最近点沿光轴的深度（米），没有点的像素为 0。
+    std::vector<float> depth;
+    /// 每个像素上最近点在点云中的下标，没有点的像素为 -1。
+    std::vector<int32_t> index;
+    /// 落在图像内且位于相机前方的点数，包括被遮挡的点。
+    size_t number_of_points = 0u;
+  };
+
+  /// 点云的坐标变换和针孔相机投影。点云按块分给共享线程池处理，每块先用
+  /// 无分支的循环计算坐标（便于编译器向量化），再写入结果。
+  class PointCloudProjection {
+  public:
+
+    /// 从 @a from 坐标系到 @a to 坐标系的变换，例如从激光雷达到相机。
+    static TransformMatrix MakeRelativeMatrix(const geom::Transform &from, const geom::Transform &to) {
+      return Multiply(to.GetInverseMatrix(), from.GetMatrix());
+    }
+
+    /// 用 @a matrix 变换 [@a begin, @a end) 中每个检测点的 point 成员，
+    /// 返回 N x 3 的 float 数组。
+    template <typename InputIt>
+    static std::vector<float> TransformPoints(InputIt begin, InputIt end, const TransformMatrix &matrix) {
+      const size_t count = static_cast<size_t>(std::distance(begin, end));
+      std::vector<float> result(3u * count);
+      ParallelFor(count, [&](size_t first, size_t last) {
+        float *out = result.data() + 3u * first;
+        auto it = std::next(begin, static_cast<std::ptrdiff_t>(first));
+        for (size_t i = first; i < last; ++i, ++it, out += 3u) {
+          const auto &p = it->point;
+          out[0u] = matrix[0u] * p.x + matrix[1u] * p.y + matrix[2u]  * p.z + matrix[3u];
+          out[1u] = matrix[4u] * p.x + matrix[5u] * p.y + matrix[6u]  * p.z + matrix[7u];
+          out[2u] = matrix[8u] * p.x + matrix[9u] * p.y + matrix[10u] * p.z + matrix[11u];
+        }
+      }, ComputeGrainSize(count));
+      return result;
+    }
+
+    /// 将 [@a begin, @a end) 中的点用 @a sensor_to_camera 变换到相机坐标系
+    /// （UE4 坐标轴，x 朝前），再用 @a intrinsics 投影到图像上。每个像素保留
+    /// 深度最小的点，深度相同时保留下标较小的点，因此结果与线程数无关。
+    template <typename InputIt>
+    static ProjectedImage Project(
+        InputIt begin,
+        InputIt end,
+        const TransformMatrix &sensor_to_camera,
+        const CameraIntrinsics &intrinsics) {
+      const size_t count = static_cast<size_t>(std::distance(begin, end));
+      DEBUG_ASSERT(count <= static_cast<size_t>(std::numeric_limits<int32_t>::max()));
+      const size_t number_of_pixels = static_cast<size_t>(intrinsics.width) * intrinsics.height;
+
+      // 每个像素一个 64 位键：高 32 位为深度的位模式（正浮点数的位模式与
+      // 数值同序），低 32 位为点的下标，原子取最小值即完成深度测试。
+      std::unique_ptr<std::atomic<uint64_t>[]> z_buffer(new std::atomic<uint64_t>[number_of_pixels]);
+      ParallelFor(number_of_pixels, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+          z_buffer[i].store(EMPTY_KEY, std::memory_order_relaxed);
+        }
+      }, ComputeGrainSize(number_of_pixels));
+
+      std::atomic_size_t projected{0u};
+      ParallelFor(count, [&](size_t first, size_t last) {
+        auto it = std::next(begin, static_cast<std::ptrdiff_t>(first));
+        std::array<float, BLOCK_SIZE> u;
+        std::array<float, BLOCK_SIZE> v;
+        std::array<float, BLOCK_SIZE> z;
+        size_t local_projected = 0u;
+        for (size_t block = first; block < last; block += BLOCK_SIZE) {
+          const size_t size = last - block < BLOCK_SIZE ? last - block : BLOCK_SIZE;
+          // 变换与投影，不含分支
+          for (size_t i = 0u; i < size; ++i, ++it) {
+            const auto &p = it->point;
+            const float x = sensor_to_camera[0u] * p.x + sensor_to_camera[1u] * p.y + sensor_to_camera[2u]  * p.z + sensor_to_camera[3u];
+            const float y = sensor_to_camera[4u] * p.x + sensor_to_camera[5u] * p.y + sensor_to_camera[6u]  * p.z + sensor_to_camera[7u];
+            const float h = sensor_to_camera[8u] * p.x + sensor_to_camera[9u] * p.y + sensor_to_camera[10u] * p.z + sensor_to_camera[11u];
+            // UE4 坐标 (x, y, z) 对应相机坐标 (y, -z, x)
+            const float inverse_depth = 1.0f / x;
+            u[i] = intrinsics.fx * y * inverse_depth + intrinsics.cx;
+            v[i] = intrinsics.fy * -h * inverse_depth + intrinsics.cy;
+            z[i] = x;
+          }
+          // 深度测试
+          for (size_t i = 0u; i < size; ++i) {
+            if (!(z[i] > 0.0f && u[i] >= 0.0f && v[i] >= 0.0f &&
+                  u[i] < static_cast<float>(intrinsics.width) &&
+                  v[i] < static_cast<float>(intrinsics.height))) {
+              continue;
+            }
+            const size_t pixel =
+                static_cast<size_t>(v[i]) * intrinsics.width + static_cast<size_t>(u[i]);
+            AtomicMin(z_buffer[pixel], MakeKey(z[i], static_cast<uint32_t>(block + i)));
+            ++local_projected;
+          }
+        }
+        projected.fetch_add(local_projected, std::memory_order_relaxed);
+      }, ComputeGrainSize(count));
+
+      ProjectedImage image;
+      image.width = intrinsics.width;
+      image.height = intrinsics.height;
+      image.depth.resize(number_of_pixels);
+      image.index.resize(number_of_pixels);
+      image.number_of_points = projected.load();
+      ParallelFor(number_of_pixels, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+          const uint64_t key = z_buffer[i].load(std::memory_order_relaxed);
+          if (key == EMPTY_KEY) {
+            image.depth[i] = 0.0f;
+            image.index[i] = -1;
+          } else {
+            const uint32_t bits = static_cast<uint32_t>(key >> 32u);
+            std::memcpy(&image.depth[i], &bits, sizeof(bits));
+            image.index[i] = static_cast<int32_t>(key & 0xFFFFFFFFu);
+          }
+        }
+      }, ComputeGrainSize(number_of_pixels));
+      return image;
+    }
+
+  private:
+
+    static constexpr size_t BLOCK_SIZE = 256u;
+
+    static constexpr uint64_t EMPTY_KEY = std::numeric_limits<uint64_t>::max();
+
+    static uint64_t MakeKey(float depth, uint32_t index) {
+      uint32_t bits;
+      std::memcpy(&bits, &depth, sizeof(bits));
+      return (static_cast<uint64_t>(bits) << 32u) | index;
+    }
+
+    static void AtomicMin(std::atomic<uint64_t> &target, uint64_t value) {
+      uint64_t current = target.load(std::memory_order_relaxed);
+      while (value < current &&
+             !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    static TransformMatrix Multiply(const TransformMatrix &a, const TransformMatrix &b) {
+      TransformMatrix result;
+      for (size_t row = 0u; row < 4u; ++row) {
+        for (size_t column = 0u; column < 4u; ++column) {
+          float sum = 0.0f;
+          for (size_t k = 0u; k < 4u; ++k) {
+            sum += a[4u * row + k] * b[4u * k + column];
+          }
+          result[4u * row + column] = sum;
+        }
+      }
+      return result;
+    }
+  };
+
+} // namespace pointcloud
+} // namespace carla
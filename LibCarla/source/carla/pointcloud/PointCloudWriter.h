@@ -0,0 +1,65 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/BoundedWorkQueue.h" // 后台写入线程和有界队列
+#include "carla/FileSystem.h"
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/StringUtil.h"
+#include "carla/pointcloud/PointCloudIO.h"
+
+#include <string>
+
+namespace carla {
+namespace pointcloud {
+
+  /// 在后台线程中把点云写入磁盘，传感器回调只需把测量数据放入队列。
+  ///
+  /// 队列中保存测量数据的共享指针，不复制点缓冲区。队列满时根据构造
+  /// 参数阻塞调用者或丢弃该帧，可通过 GetStats() 观察。
+  class PointCloudWriter : private NonCopyable {
+  public:
+
+    using Stats = BoundedWorkQueue::Stats;
+
+    explicit PointCloudWriter(size_t max_queue_size = 16u, bool block_when_full = true)
+      : _queue(1u, max_queue_size, block_when_full) {}
+
+    /// 将 @a measurement 放入写入队列，返回最终写入的文件路径。
+    /// @a binary 为 false 时写入 ASCII PLY，否则根据扩展名写入二进制
+    /// PLY 或 PCD。目录在调用线程中创建，返回的路径即最终路径。
+    template <typename MeasurementT>
+    std::string Save(std::string path, SharedPtr<MeasurementT> measurement, bool binary = true) {
+      const bool pcd = binary && StringUtil::EndsWith(path, ".pcd");
+      FileSystem::ValidateFilePath(path, pcd ? ".pcd" : ".ply");
+      _queue.Push([path, measurement, binary]() {
+        if (binary) {
+          PointCloudIO::SaveToDiskBinary(path, measurement->begin(), measurement->end());
+        } else {
+          PointCloudIO::SaveToDisk(path, measurement->begin(), measurement->end());
+        }
+      });
+      return path;
+    }
+
+    /// 阻塞直到队列中的点云全部写入磁盘。
+    void Flush() {
+      _queue.Flush();
+    }
+
+    Stats GetStats() const {
+      return _queue.GetStats();
+    }
+
+  private:
+
+    BoundedWorkQueue _queue;
+  };
+
+} // namespace pointcloud
+} // namespace carla
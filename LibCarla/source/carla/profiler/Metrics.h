@@ -0,0 +1,401 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Exception.h"
+#include "carla/NonCopyable.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace carla {
+namespace profiler {
+
+  /// 只增不减的计数器。
+  class MetricCounter : private NonCopyable {
+  public:
+
+    void Increment(uint64_t value = 1u) {
+      _value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t Get() const {
+      return _value.load(std::memory_order_relaxed);
+    }
+
+  private:
+
+    std::atomic<uint64_t> _value{0u};
+  };
+
+  /// 可增可减的瞬时值。
+  class MetricGauge : private NonCopyable {
+  public:
+
+    void Set(double value) {
+      _value.store(value, std::memory_order_relaxed);
+    }
+
+    void Add(double value) {
+      double current = _value.load(std::memory_order_relaxed);
+      while (!_value.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {}
+    }
+
+    double Get() const {
+      return _value.load(std::memory_order_relaxed);
+    }
+
+  private:
+
+    std::atomic<double> _value{0.0};
+  };
+
+  /// 导出时才计算的瞬时值，例如两个计数器之差；更新时不必修改共享的
+  /// 浮点数。计算函数在注册表的锁内调用，不能访问注册表。
+  class MetricDerivedGauge : private NonCopyable {
+  public:
+
+    explicit MetricDerivedGauge(std::function<double()> value) : _value(std::move(value)) {}
+
+    double Get() const {
+      return _value();
+    }
+
+  private:
+
+    const std::function<double()> _value;
+  };
+
+  /// HDR（高动态范围）直方图：每个 2 的幂区间分成 32 个桶，在整个范围内
+  /// 相对误差不超过约 3%，记录只是一次原子加法。
+  ///
+  /// 记录的是整数（例如微秒），@a scale 把它换算为导出的单位（例如秒）。
+  class MetricHistogram : private NonCopyable {
+  public:
+
+    /// 能区分的最大值，更大的值记入最后一个桶。
+    static constexpr uint64_t MAX_VALUE = (uint64_t(1u) << 40u) - 1u;
+
+    explicit MetricHistogram(double scale = 1.0) : _scale(scale) {
+      for (auto &bucket : _buckets) {
+        bucket.store(0u, std::memory_order_relaxed);
+      }
+    }
+
+    void Record(uint64_t value) {
+      value = std::min(value, static_cast<uint64_t>(MAX_VALUE));
+      _buckets[GetBucketIndex(value)].fetch_add(1u, std::memory_order_relaxed);
+      _count.fetch_add(1u, std::memory_order_relaxed);
+      _sum.fetch_add(value, std::memory_order_relaxed);
+      uint64_t max = _max.load(std::memory_order_relaxed);
+      while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+    }
+
+    uint64_t GetCount() const {
+      return _count.load(std::memory_order_relaxed);
+    }
+
+    /// 所有记录值之和，已换算单位。
+    double GetSum() const {
+      return _scale * static_cast<double>(_sum.load(std::memory_order_relaxed));
+    }
+
+    double GetMax() const {
+      return _scale * static_cast<double>(_max.load(std::memory_order_relaxed));
+    }
+
+    /// 分位数 @a q（0 到 1），已换算单位；没有记录时返回 0。
+    double GetQuantile(double q) const {
+      std::array<uint64_t, BUCKET_COUNT> counts;
+      uint64_t total = 0u;
+      for (size_t i = 0u; i < BUCKET_COUNT; ++i) {
+        counts[i] = _buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+      }
+      if (total == 0u) {
+        return 0.0;
+      }
+      const double clamped = std::min(std::max(q, 0.0), 1.0);
+      const uint64_t rank = std::max<uint64_t>(
+          static_cast<uint64_t>(std::ceil(clamped * static_cast<double>(total))), 1u);
+      uint64_t seen = 0u;
+      for (size_t i = 0u; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+          // 取桶的中点，最大值所在的桶不超过最大值
+          const double middle = 0.5 * static_cast<double>(GetBucketLowerBound(i) + GetBucketUpperBound(i));
+          return _scale * std::min(middle, static_cast<double>(_max.load(std::memory_order_relaxed)));
+        }
+      }
+      return GetMax();
+    }
+
+  private:
+
+    static constexpr uint32_t SUB_BUCKET_BITS = 5u;
+
+    static constexpr uint64_t SUB_BUCKETS = uint64_t(1u) << SUB_BUCKET_BITS;
+
+    /// 小于 2 * SUB_BUCKETS 的值每个值一个桶，之后每个 2 的幂区间 SUB_BUCKETS 个桶。
+    static constexpr size_t BUCKET_COUNT = (40u - SUB_BUCKET_BITS) * SUB_BUCKETS + SUB_BUCKETS;
+
+    static uint32_t Log2(uint64_t value) {
+      uint32_t result = 0u;
+      while (value >>= 1u) {
+        ++result;
+      }
+      return result;
+    }
+
+    static size_t GetBucketIndex(uint64_t value) {
+      if (value < 2u * SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+      }
+      const uint32_t shift = Log2(value) - SUB_BUCKET_BITS;
+      return static_cast<size_t>(shift * SUB_BUCKETS + (value >> shift));
+    }
+
+    static uint64_t GetBucketLowerBound(size_t index) {
+      if (index < 2u * SUB_BUCKETS) {
+        return index;
+      }
+      const uint64_t shift = index / SUB_BUCKETS - 1u;
+      return (index % SUB_BUCKETS + SUB_BUCKETS) << shift;
+    }
+
+    static uint64_t GetBucketUpperBound(size_t index) {
+      if (index < 2u * SUB_BUCKETS) {
+        return index;
+      }
+      const uint64_t shift = index / SUB_BUCKETS - 1u;
+      return ((index % SUB_BUCKETS + SUB_BUCKETS + 1u) << shift) - 1u;
+    }
+
+    const double _scale;
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> _buckets;
+
+    std::atomic<uint64_t> _count{0u};
+
+    std::atomic<uint64_t> _sum{0u};
+
+    std::atomic<uint64_t> _max{0u};
+  };
+
+  /// 在析构时把作用域的耗时（微秒）记入直方图。
+  class ScopedMetricTimer : private NonCopyable {
+  public:
+
+    explicit ScopedMetricTimer(MetricHistogram &histogram)
+      : _histogram(histogram),
+        _start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedMetricTimer() {
+      const auto elapsed = std::chrono::steady_clock::now() - _start;
+      _histogram.Record(static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+
+  private:
+
+    MetricHistogram &_histogram;
+
+    const std::chrono::steady_clock::time_point _start;
+  };
+
+  /// 一个导出的值，直方图展开为分位数、_sum 和 _count。
+  struct MetricSample {
+    std::string name;
+    std::string labels; ///< 例如 stage="collision"，没有标签时为空
+    double value = 0.0;
+  };
+
+  /// 进程内所有指标的注册表，可导出为 Prometheus 文本格式。
+  ///
+  /// 指标按名称和标签创建一次，返回的引用在程序运行期间一直有效，调用者应
+  /// 保存引用而不是每次都查找。更新指标不加锁。
+  class MetricsRegistry : private NonCopyable {
+  public:
+
+    /// 直方图导出的分位数。
+    static std::array<double, 4u> GetQuantiles() {
+      return {{0.5, 0.9, 0.99, 0.999}};
+    }
+
+    /// 不会被销毁：退出时仍在运行的线程可能还在更新指标。
+    static MetricsRegistry &Get() {
+      static MetricsRegistry *registry = new MetricsRegistry;
+      return *registry;
+    }
+
+    /// @a labels 为 Prometheus 格式的标签，例如 function="get_actor"。
+    MetricCounter &GetCounter(const std::string &name, const std::string &help = "", const std::string &labels = "") {
+      return GetMetric<MetricCounter>(Type::Counter, name, help, labels, [](){
+        return std::make_unique<MetricCounter>();
+      });
+    }
+
+    MetricGauge &GetGauge(const std::string &name, const std::string &help = "", const std::string &labels = "") {
+      return GetMetric<MetricGauge>(Type::Gauge, name, help, labels, [](){
+        return std::make_unique<MetricGauge>();
+      });
+    }
+
+    /// 同名同标签的派生值已注册时保留原来的计算函数。
+    MetricDerivedGauge &GetDerivedGauge(
+        const std::string &name,
+        const std::string &help,
+        const std::string &labels,
+        std::function<double()> value) {
+      return GetMetric<MetricDerivedGauge>(Type::DerivedGauge, name, help, labels, [&](){
+        return std::make_unique<MetricDerivedGauge>(std::move(value));
+      });
+    }
+
+    /// @a scale 为记录的整数换算为导出单位的系数，例如记录微秒、导出秒时为 1e-6。
+    MetricHistogram &GetHistogram(
+        const std::string &name,
+        const std::string &help = "",
+        const std::string &labels = "",
+        double scale = 1e-6) {
+      return GetMetric<MetricHistogram>(Type::Histogram, name, help, labels, [=](){
+        return std::make_unique<MetricHistogram>(scale);
+      });
+    }
+
+    /// 当前所有指标的值，按名称和标签排序。
+    std::vector<MetricSample> GetSamples() const {
+      std::vector<MetricSample> samples;
+      std::lock_guard<std::mutex> lock(_mutex);
+      for (auto &family : _families) {
+        for (auto &item : family.second.metrics) {
+          const std::string &labels = item.first;
+          switch (family.second.type) {
+            case Type::Counter:
+              samples.push_back({family.first, labels,
+                  static_cast<double>(static_cast<const MetricCounter *>(item.second.get())->Get())});
+              break;
+            case Type::Gauge:
+              samples.push_back({family.first, labels,
+                  static_cast<const MetricGauge *>(item.second.get())->Get()});
+              break;
+            case Type::DerivedGauge:
+              samples.push_back({family.first, labels,
+                  static_cast<const MetricDerivedGauge *>(item.second.get())->Get()});
+              break;
+            case Type::Histogram: {
+              auto &histogram = *static_cast<const MetricHistogram *>(item.second.get());
+              for (auto q : GetQuantiles()) {
+                std::ostringstream quantile;
+                quantile << (labels.empty() ? "" : labels + ",") << "quantile=\"" << q << "\"";
+                samples.push_back({family.first, quantile.str(), histogram.GetQuantile(q)});
+              }
+              samples.push_back({family.first + "_sum", labels, histogram.GetSum()});
+              samples.push_back({family.first + "_count", labels, static_cast<double>(histogram.GetCount())});
+              break;
+            }
+          }
+        }
+      }
+      return samples;
+    }
+
+    /// Prometheus 文本格式（0.0.4），直方图导出为 summary。
+    void WritePrometheus(std::ostream &out) const {
+      std::map<std::string, std::pair<std::string, const char *>> headers;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto &family : _families) {
+          headers[family.first] = {family.second.help, GetTypeName(family.second.type)};
+        }
+      }
+      const auto precision = out.precision(std::numeric_limits<double>::digits10);
+      std::string current;
+      for (auto &sample : GetSamples()) {
+        auto header = headers.find(sample.name);
+        if (header != headers.end() && sample.name != current) {
+          current = sample.name;
+          if (!header->second.first.empty()) {
+            out << "# HELP " << sample.name << ' ' << header->second.first << '\n';
+          }
+          out << "# TYPE " << sample.name << ' ' << header->second.second << '\n';
+        }
+        out << sample.name;
+        if (!sample.labels.empty()) {
+          out << '{' << sample.labels << '}';
+        }
+        out << ' ' << sample.value << '\n';
+      }
+      out.precision(precision);
+    }
+
+    std::string GetPrometheusText() const {
+      std::ostringstream out;
+      WritePrometheus(out);
+      return out.str();
+    }
+
+  private:
+
+    enum class Type { Counter, Gauge, DerivedGauge, Histogram };
+
+    struct Family {
+      Type type;
+      std::string help;
+      std::map<std::string, std::shared_ptr<void>> metrics;
+    };
+
+    MetricsRegistry() = default;
+
+    static const char *GetTypeName(Type type) {
+      switch (type) {
+        case Type::Counter: return "counter";
+        case Type::Gauge:
+        case Type::DerivedGauge: return "gauge";
+        default: return "summary";
+      }
+    }
+
+    template <typename MetricT, typename FactoryT>
+    MetricT &GetMetric(Type type, const std::string &name, const std::string &help, const std::string &labels, FactoryT &&factory) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto result = _families.emplace(name, Family{type, help, {}});
+      Family &family = result.first->second;
+      if (family.type != type) {
+        throw_exception(std::invalid_argument("metric " + name + " already registered with a different type"));
+      }
+      if (family.help.empty()) {
+        family.help = help;
+      }
+      auto &metric = family.metrics[labels];
+      if (metric == nullptr) {
+        metric = std::shared_ptr<MetricT>(factory());
+      }
+      return *static_cast<MetricT *>(metric.get());
+    }
+
+    mutable std::mutex _mutex;
+
+    std::map<std::string, Family> _families;
+  };
+
+} // namespace profiler
+} // namespace carla
@@ -0,0 +1,130 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Logging.h"
+#include "carla/NonCopyable.h"
+#include "carla/profiler/Metrics.h"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+
+#include <istream>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace carla {
+namespace profiler {
+
+  /// 在本地端口上以 HTTP 提供 MetricsRegistry 的 Prometheus 文本，
+  /// 供 Prometheus 抓取（GET /metrics）。
+  ///
+  /// 在自己的线程中运行，请求很少，每个连接读完请求头后应答并关闭。默认只
+  /// 监听 127.0.0.1。
+  class MetricsServer : private NonCopyable {
+  public:
+
+    /// 在 @a address:@a port 上监听，@a port 为 0 时由系统选择端口。
+    explicit MetricsServer(uint16_t port, const std::string &address = "127.0.0.1")
+      : _acceptor(_io_context, boost::asio::ip::tcp::endpoint(
+            boost::asio::ip::make_address(address), port)) {
+      Accept();
+      _thread = std::thread([this]() { _io_context.run(); });
+      log_info("metrics: serving Prometheus metrics at", GetLocalEndpoint());
+    }
+
+    ~MetricsServer() {
+      _io_context.stop();
+      if (_thread.joinable()) {
+        _thread.join();
+      }
+    }
+
+    boost::asio::ip::tcp::endpoint GetLocalEndpoint() const {
+      return _acceptor.local_endpoint();
+    }
+
+  private:
+
+    /// 请求头的最大长度，超出时不再读取并回复 431。
+    static constexpr size_t MAX_REQUEST_SIZE = 8u * 1024u;
+
+    struct Connection {
+      explicit Connection(boost::asio::io_context &io_context)
+        : socket(io_context),
+          request(MAX_REQUEST_SIZE) {}
+
+      boost::asio::ip::tcp::socket socket;
+      boost::asio::streambuf request;
+      std::string response;
+    };
+
+    void Accept() {
+      auto connection = std::make_shared<Connection>(_io_context);
+      _acceptor.async_accept(connection->socket, [this, connection](const boost::system::error_code &ec) {
+        if (!ec) {
+          Read(connection);
+        }
+        if (_acceptor.is_open()) {
+          Accept();
+        }
+      });
+    }
+
+    static void Read(std::shared_ptr<Connection> connection) {
+      boost::asio::async_read_until(connection->socket, connection->request, "\r\n\r\n",
+          [connection](const boost::system::error_code &ec, size_t) {
+        if (ec == boost::asio::error::not_found) {
+          // 缓冲区已满仍没有读到请求头的结尾
+          connection->response = MakeResponse("431 Request Header Fields Too Large", "text/plain", "request too large\n");
+        } else if (ec) {
+          return;
+        } else {
+          std::istream stream(&connection->request);
+          std::string method, path;
+          stream >> method >> path;
+          if (method == "GET" && (path == "/metrics" || path == "/")) {
+            connection->response = MakeResponse(
+                "200 OK",
+                "text/plain; version=0.0.4; charset=utf-8",
+                MetricsRegistry::Get().GetPrometheusText());
+          } else {
+            connection->response = MakeResponse("404 Not Found", "text/plain", "not found\n");
+          }
+        }
+        boost::asio::async_write(connection->socket, boost::asio::buffer(connection->response),
+            [connection](const boost::system::error_code &, size_t) {
+          boost::system::error_code ignored;
+          connection->socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+        });
+      });
+    }
+
+    static std::string MakeResponse(const char *status, const char *content_type, const std::string &body) {
+      std::string response = "HTTP/1.1 ";
+      response += status;
+      response += "\r\nContent-Type: ";
+      response += content_type;
+      response += "\r\nContent-Length: " + std::to_string(body.size());
+      response += "\r\nConnection: close\r\n\r\n";
+      response += body;
+      return response;
+    }
+
+    boost::asio::io_context _io_context;
+
+    boost::asio::ip::tcp::acceptor _acceptor;
+
+    std::thread _thread;
+  };
+
+} // namespace profiler
+} // namespace carla
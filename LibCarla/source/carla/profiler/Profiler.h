@@ -6,8 +6,10 @@
 
 #pragma once // 防止头文件重复包含
 
+#include "carla/profiler/Tracer.h" // 运行时可开关的分层作用域计时
+
 #ifndef LIBCARLA_ENABLE_PROFILER // 如果没有启用性能分析器
-#  define CARLA_PROFILE_SCOPE(context, profiler_name) // 定义宏，空操作
+#  define CARLA_PROFILE_SCOPE(context, profiler_name) CARLA_TRACE_SCOPE(context, profiler_name) // 只记录到 Tracer
 #  define CARLA_PROFILE_FPS(context, profiler_name) // 定义宏，空操作，这里的代码将用于开始或更新一个性能分析器，与给定的上下文和名称相关，它包括获取当前时间戳，更新帧率统计，或者开始一个新的性能分析区间
 #else
 
@@ -100,25 +102,29 @@ namespace detail { // 开始 detail 命名空间
 #  define LIBCARLA_GTEST_GET_TEST_NAME() std::string("") // 定义一个宏，用于获取当前测试的名称，但当前实现仅返回一个空字符串
 #endif // LIBCARLA_WITH_GTEST
 
-#define CARLA_PROFILE_SCOPE(context, profiler_name) \ // 定义性能分析作用域宏
-    static thread_local ::carla::profiler::detail::ProfilerData carla_profiler_ ## context ## _ ## profiler_name ## _data( \ // 创建性能数据实例
-        LIBCARLA_GTEST_GET_TEST_NAME() + "." #context "." #profiler_name); \ // 初始化性能数据名称
-    ::carla::profiler::detail::ScopedProfiler carla_profiler_ ## context ## _ ## profiler_name ## _scoped_profiler( \ // 创建作用域性能分析器，创建一个 ScopedProfiler实例，用于性能分析
-        carla_profiler_ ## context ## _ ## profiler_name ## _data); // 关联到性能数据
-
-#define CARLA_PROFILE_FPS(context, profiler_name) \ // 定义性能分析FPS宏
-    { \ // 开始代码块
-      static thread_local ::carla::StopWatch stop_watch; \ // 创建计时器实例
-      stop_watch.Stop(); \ // 停止计时器
-      static thread_local bool first_time = true; \ // 首次标志变量
-      if (!first_time) { \ // 如果不是第一次
-        static thread_local ::carla::profiler::detail::ProfilerData profiler_data( \ // 创建性能数据实例
-            LIBCARLA_GTEST_GET_TEST_NAME() + "." #context "." #profiler_name, true); \ // 初始化名称并设置打印FPS为真
-        profiler_data.Annotate(stop_watch); \ // 注解计时器数据
-      } else { \ // 如果是第一次
-        first_time = false; \ // 更新首次标志
+// 定义性能分析作用域宏：统计写入 profiler.csv，同时作为分层作用域记录到
+// Tracer（见 Tracer.h）。宏的续行符之后不能有注释，说明写在这里
+#define CARLA_PROFILE_SCOPE(context, profiler_name) \
+    CARLA_TRACE_SCOPE(context, profiler_name); \
+    static thread_local ::carla::profiler::detail::ProfilerData carla_profiler_ ## context ## _ ## profiler_name ## _data( \
+        LIBCARLA_GTEST_GET_TEST_NAME() + "." #context "." #profiler_name); \
+    ::carla::profiler::detail::ScopedProfiler carla_profiler_ ## context ## _ ## profiler_name ## _scoped_profiler( \
+        carla_profiler_ ## context ## _ ## profiler_name ## _data);
+
+// 定义性能分析FPS宏：记录两次调用之间的间隔，第一次调用只启动计时器
+#define CARLA_PROFILE_FPS(context, profiler_name) \
+    { \
+      static thread_local ::carla::StopWatch stop_watch; \
+      stop_watch.Stop(); \
+      static thread_local bool first_time = true; \
+      if (!first_time) { \
+        static thread_local ::carla::profiler::detail::ProfilerData profiler_data( \
+            LIBCARLA_GTEST_GET_TEST_NAME() + "." #context "." #profiler_name, true); \
+        profiler_data.Annotate(stop_watch); \
+      } else { \
+        first_time = false; \
       } \
-      stop_watch.Restart(); \ // 重新启动计时器
+      stop_watch.Restart(); \
     }
 
 #endif // LIBCARLA_ENABLE_PROFILER 
@@ -0,0 +1,404 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace carla {
+namespace profiler {
+
+  /// 一个已结束的作用域。
+  struct TraceEvent {
+    const char *category = nullptr;
+    const char *name = nullptr;
+    uint32_t thread = 0u;   ///< Tracer 分配的线程序号
+    uint32_t depth = 0u;    ///< 嵌套深度，最外层为 0
+    int64_t begin_ns = 0;   ///< 相对 Tracer 启动时间
+    int64_t duration_ns = 0;
+  };
+
+  /// 同名作用域的统计。self 为减去嵌套在其中的作用域之后的时间。
+  struct TraceScopeStats {
+    std::string category;
+    std::string name;
+    uint64_t count = 0u;
+    double total_ms = 0.0;
+    double self_ms = 0.0;
+    double min_ms = 0.0;
+    double max_ms = 0.0;
+  };
+
+  /// 分层的作用域计时，可在运行时开关并导出为 Chrome trace / Perfetto
+  /// 可以打开的 JSON。
+  ///
+  /// 每个线程把结束的作用域写入自己的环形缓冲区，写入不加锁；缓冲区满时覆盖
+  /// 最旧的事件。线程结束时其中的事件移入一个共享的、同样容量的缓冲区，并
+  /// 释放该线程的环形缓冲区。关闭时每个作用域只有一次原子读取的开销。作用域
+  /// 的名称必须是字符串字面量（只保存指针）。
+  ///
+  /// 设置环境变量 CARLA_TRACE_FILE 时在启动时开启，并在程序退出时把结果
+  /// 写入该文件。
+  class Tracer : private NonCopyable {
+  public:
+
+    using clock = std::chrono::steady_clock;
+
+    /// 每个线程的环形缓冲区能保存的事件数。
+    static constexpr size_t BUFFER_CAPACITY = 1u << 16;
+
+    /// 不会被销毁：退出时仍在运行的线程可能还在写入。
+    static Tracer &Get() {
+      static Tracer *tracer = new Tracer;
+      return *tracer;
+    }
+
+    void Enable() {
+      _enabled.store(true, std::memory_order_relaxed);
+    }
+
+    void Disable() {
+      _enabled.store(false, std::memory_order_relaxed);
+    }
+
+    bool IsEnabled() const {
+      return _enabled.load(std::memory_order_relaxed);
+    }
+
+    /// 丢弃所有线程已记录的事件。
+    void Clear() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _retired.clear();
+      for (auto &buffer : _buffers) {
+        buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+      }
+    }
+
+    /// 所有线程已记录的事件，按线程和结束的先后排列。已结束的线程排在前面。
+    std::vector<TraceEvent> GetEvents() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      std::vector<TraceEvent> events(_retired.begin(), _retired.end());
+      for (auto &buffer : _buffers) {
+        buffer->Read(events);
+      }
+      return events;
+    }
+
+    /// 按名称汇总的统计，按总时间从大到小排列。
+    std::vector<TraceScopeStats> Summarize() const {
+      const auto events = GetEvents();
+      // 同一个字面量在不同的编译单元中可能有不同的地址，按内容合并
+      std::unordered_map<std::string, size_t> index;
+      std::vector<TraceScopeStats> result;
+      // 事件按结束的先后排列，子作用域总在父作用域之前结束
+      std::vector<int64_t> children_ns;
+      uint32_t thread = std::numeric_limits<uint32_t>::max();
+      for (auto &event : events) {
+        if (event.thread != thread) {
+          thread = event.thread;
+          children_ns.clear();
+        }
+        if (children_ns.size() < event.depth + 2u) {
+          children_ns.resize(event.depth + 2u, 0);
+        }
+        const int64_t self_ns = std::max<int64_t>(event.duration_ns - children_ns[event.depth + 1u], 0);
+        children_ns[event.depth + 1u] = 0;
+        children_ns[event.depth] += event.duration_ns;
+
+        std::string key = std::string(event.category) + '.' + event.name;
+        auto it = index.find(key);
+        if (it == index.end()) {
+          it = index.emplace(std::move(key), result.size()).first;
+          result.emplace_back();
+          result.back().category = event.category;
+          result.back().name = event.name;
+          result.back().min_ms = std::numeric_limits<double>::max();
+        }
+        auto &stats = result[it->second];
+        const double ms = 1e-6 * static_cast<double>(event.duration_ns);
+        ++stats.count;
+        stats.total_ms += ms;
+        stats.self_ms += 1e-6 * static_cast<double>(self_ns);
+        stats.min_ms = std::min(stats.min_ms, ms);
+        stats.max_ms = std::max(stats.max_ms, ms);
+      }
+      std::sort(result.begin(), result.end(), [](const TraceScopeStats &lhs, const TraceScopeStats &rhs) {
+        return lhs.total_ms > rhs.total_ms;
+      });
+      return result;
+    }
+
+    /// 以 Chrome trace 事件格式写出所有事件。
+    void WriteChromeTrace(std::ostream &out) const {
+      const auto events = GetEvents();
+      out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+      bool first = true;
+      auto separator = [&]() -> std::ostream & {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        return out;
+      };
+      {
+        std::vector<uint32_t> threads;
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          for (auto &buffer : _buffers) {
+            threads.push_back(buffer->thread);
+          }
+        }
+        // 已结束的线程只剩下事件
+        for (auto &event : events) {
+          if (std::find(threads.begin(), threads.end(), event.thread) == threads.end()) {
+            threads.push_back(event.thread);
+          }
+        }
+        for (const uint32_t thread : threads) {
+          separator() << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << thread
+                      << ",\"args\":{\"name\":\"thread " << thread << "\"}}";
+        }
+      }
+      const auto precision = out.precision(3);
+      const auto flags = out.setf(std::ios::fixed, std::ios::floatfield);
+      for (auto &event : events) {
+        separator() << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread << ",\"cat\":\"";
+        WriteEscaped(out, event.category);
+        out << "\",\"name\":\"";
+        WriteEscaped(out, event.name);
+        out << "\",\"ts\":" << 1e-3 * static_cast<double>(event.begin_ns)
+            << ",\"dur\":" << 1e-3 * static_cast<double>(event.duration_ns) << "}";
+      }
+      out.precision(precision);
+      out.flags(flags);
+      out << "\n]}\n";
+    }
+
+    /// 写入文件，失败时返回 false。
+    bool WriteChromeTrace(const std::string &filename) const {
+      std::ofstream file(filename);
+      if (!file) {
+        return false;
+      }
+      WriteChromeTrace(file);
+      return static_cast<bool>(file);
+    }
+
+  private:
+
+    friend class TraceScope;
+
+    /// 单个线程的环形缓冲区。只有所属线程写入 head 和事件，读取者用 tail
+    /// 和 head 之间的序号判断哪些事件仍然有效。事件的字段是原子的，读取时
+    /// 与覆盖同时发生也不是数据竞争，读完后再检查 head 丢弃被覆盖的事件。
+    struct ThreadBuffer {
+      struct Slot {
+        std::atomic<const char *> category{nullptr};
+        std::atomic<const char *> name{nullptr};
+        std::atomic<int64_t> begin_ns{0};
+        std::atomic<int64_t> duration_ns{0};
+        std::atomic<uint32_t> depth{0u};
+      };
+
+      explicit ThreadBuffer(uint32_t id)
+        : thread(id),
+          slots(new Slot[BUFFER_CAPACITY]) {}
+
+      void Write(const char *category, const char *name, uint32_t depth, int64_t begin_ns, int64_t duration_ns) {
+        const uint64_t position = head.load(std::memory_order_relaxed);
+        Slot &slot = slots[position % BUFFER_CAPACITY];
+        slot.category.store(category, std::memory_order_relaxed);
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+        slot.duration_ns.store(duration_ns, std::memory_order_relaxed);
+        slot.depth.store(depth, std::memory_order_relaxed);
+        head.store(position + 1u, std::memory_order_release);
+      }
+
+      void Read(std::vector<TraceEvent> &events) const {
+        const uint64_t end = head.load(std::memory_order_acquire);
+        const uint64_t begin = std::max(
+            tail.load(std::memory_order_relaxed),
+            end > BUFFER_CAPACITY ? end - BUFFER_CAPACITY : uint64_t(0u));
+        const size_t first = events.size();
+        for (uint64_t position = begin; position < end; ++position) {
+          const Slot &slot = slots[position % BUFFER_CAPACITY];
+          TraceEvent event;
+          event.category = slot.category.load(std::memory_order_relaxed);
+          event.name = slot.name.load(std::memory_order_relaxed);
+          event.thread = thread;
+          event.depth = slot.depth.load(std::memory_order_relaxed);
+          event.begin_ns = slot.begin_ns.load(std::memory_order_relaxed);
+          event.duration_ns = slot.duration_ns.load(std::memory_order_relaxed);
+          events.push_back(event);
+        }
+        // 读取期间被覆盖的事件可能不完整，丢弃
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t now = head.load(std::memory_order_relaxed);
+        if (now > BUFFER_CAPACITY && now - BUFFER_CAPACITY > begin) {
+          const size_t overwritten = static_cast<size_t>(std::min<uint64_t>(now - BUFFER_CAPACITY - begin, end - begin));
+          events.erase(events.begin() + first, events.begin() + first + overwritten);
+        }
+      }
+
+      const uint32_t thread;
+      std::atomic<uint64_t> head{0u};
+      std::atomic<uint64_t> tail{0u};
+      std::unique_ptr<Slot[]> slots;
+      /// 当前线程中打开的作用域数，只由所属线程访问。
+      uint32_t depth = 0u;
+    };
+
+    Tracer() : _start(clock::now()) {
+      const char *filename = std::getenv("CARLA_TRACE_FILE");
+      if (filename != nullptr && filename[0] != '\0') {
+        _output = filename;
+        Enable();
+        std::atexit([]() {
+          auto &tracer = Get();
+          tracer.WriteChromeTrace(tracer._output);
+        });
+      }
+    }
+
+    int64_t Now() const {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - _start).count();
+    }
+
+    /// 线程结束时交还该线程的缓冲区。
+    struct ThreadBufferOwner {
+      ThreadBuffer *buffer = nullptr;
+
+      ~ThreadBufferOwner() {
+        if (buffer != nullptr) {
+          Get().Retire(*buffer);
+        }
+      }
+    };
+
+    /// 当前线程的缓冲区，第一次使用时注册。
+    ThreadBuffer &GetThreadBuffer() {
+      static thread_local ThreadBufferOwner owner;
+      if (owner.buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _buffers.emplace_back(std::make_unique<ThreadBuffer>(++_thread_count));
+        owner.buffer = _buffers.back().get();
+      }
+      return *owner.buffer;
+    }
+
+    /// 把结束的线程的事件移入 _retired，超出容量时丢弃最旧的，然后释放该线程
+    /// 的缓冲区。线程已不再写入，读取不会与覆盖同时发生。
+    void Retire(ThreadBuffer &buffer) {
+      std::vector<TraceEvent> events;
+      buffer.Read(events);
+      std::lock_guard<std::mutex> lock(_mutex);
+      _retired.insert(_retired.end(), events.begin(), events.end());
+      if (_retired.size() > BUFFER_CAPACITY) {
+        _retired.erase(_retired.begin(), _retired.begin() + (_retired.size() - BUFFER_CAPACITY));
+      }
+      _buffers.erase(std::remove_if(_buffers.begin(), _buffers.end(), [&](const std::unique_ptr<ThreadBuffer> &item) {
+        return item.get() == &buffer;
+      }), _buffers.end());
+    }
+
+    static void WriteEscaped(std::ostream &out, const std::string &text) {
+      for (const char c : text) {
+        if (c == '"' || c == '\\') {
+          out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20u) {
+          out << ' ';
+        } else {
+          out << c;
+        }
+      }
+    }
+
+    static void WriteEscaped(std::ostream &out, const char *text) {
+      WriteEscaped(out, std::string(text != nullptr ? text : ""));
+    }
+
+    const clock::time_point _start;
+
+    std::atomic<bool> _enabled{false};
+
+    std::string _output;
+
+    mutable std::mutex _mutex;
+
+    /// 正在运行的线程的缓冲区。
+    std::vector<std::unique_ptr<ThreadBuffer>> _buffers;
+
+    /// 已结束的线程的事件，最多 BUFFER_CAPACITY 个。
+    std::deque<TraceEvent> _retired;
+
+    uint32_t _thread_count = 0u;
+  };
+
+  /// 在析构时记录一个作用域。构造时 Tracer 关闭则什么也不做。
+  class TraceScope : private NonCopyable {
+  public:
+
+    TraceScope(const char *category, const char *name) {
+      Tracer &tracer = Tracer::Get();
+      if (tracer.IsEnabled()) {
+        _buffer = &tracer.GetThreadBuffer();
+        _category = category;
+        _name = name;
+        _depth = _buffer->depth++;
+        _begin_ns = tracer.Now();
+      }
+    }
+
+    ~TraceScope() {
+      if (_buffer != nullptr) {
+        const int64_t end_ns = Tracer::Get().Now();
+        --_buffer->depth;
+        _buffer->Write(_category, _name, _depth, _begin_ns, end_ns - _begin_ns);
+      }
+    }
+
+  private:
+
+    Tracer::ThreadBuffer *_buffer = nullptr;
+
+    const char *_category = nullptr;
+
+    const char *_name = nullptr;
+
+    uint32_t _depth = 0u;
+
+    int64_t _begin_ns = 0;
+  };
+
+} // namespace profiler
+} // namespace carla
+
+#define CARLA_TRACE_CONCAT_IMPL(a, b) a ## b
+#define CARLA_TRACE_CONCAT(a, b) CARLA_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef LIBCARLA_DISABLE_TRACING
+#  define CARLA_TRACE_SCOPE(category, name)
+#else
+/// 记录当前作用域，category 和 name 为标识符，例如
+/// CARLA_TRACE_SCOPE(trafficmanager, localization)。
+#  define CARLA_TRACE_SCOPE(category, name) \
+    ::carla::profiler::TraceScope CARLA_TRACE_CONCAT(carla_trace_scope_, __LINE__)(#category, #name)
+#endif // LIBCARLA_DISABLE_TRACING
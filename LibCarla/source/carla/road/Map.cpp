@@ -6,6 +6,7 @@
 
 #include "carla/road/Map.h" // 导入地图相关的头文件
 #include "carla/Exception.h" // 导入异常处理的头文件
+#include "carla/ParallelFor.h" // 导入并行分块执行的辅助函数
 #include "carla/geom/Math.h" // 导入数学计算相关的头文件
 #include "carla/geom/Vector3D.h" // 导入三维向量相关的头文件
 #include "carla/road/MeshFactory.h" // 导入网格工厂的头文件
@@ -22,6 +23,7 @@
 
 #include "marchingcube/MeshReconstruction.h" // 导入网格重建的头文件
 
+#include <algorithm> // 导入查找算法
 #include <vector> // 导入向量库
 #include <unordered_map> // 导入无序映射库
 #include <stdexcept> // 导入标准异常库
@@ -155,6 +157,64 @@ static void ForEachDrivableLaneAt(const Road &road, double distance, FuncT &&fun
     }
 }
 
+/// 返回在指定距离上每个指定类型车道的一个航点
+template <typename FuncT>
+static void ForEachLaneAt(const Road &road, double distance, Lane::LaneType lane_type, FuncT &&func) {
+    for (const auto &lane_section : road.GetLaneSectionsAt(distance)) { // 遍历指定距离的每个车道段
+        ForEachLaneImpl(
+            road.GetId(), // 获取道路ID
+            lane_section, // 当前车道段
+            distance, // 指定的距离
+            lane_type, // 指定的车道类型
+            std::forward<FuncT>(func)); // 执行提供的函数
+    }
+}
+
+/// 在一条道路上每隔 @a distance 生成指定类型车道的航点
+static void GenerateWaypointsInRoadAt(
+    const Road &road,
+    double distance,
+    Lane::LaneType lane_type,
+    std::vector<Waypoint> &result) {
+    for (double s = EPSILON; s < (road.GetLength() - EPSILON); s += distance) { // 从0到道路长度生成waypoints
+        ForEachLaneAt(road, s, lane_type, [&](auto &&waypoint) { // 对每个指定类型的车道执行操作
+            result.emplace_back(waypoint); // 将waypoint添加到结果中
+        });
+    }
+}
+
+/// 按顺序拼接每条道路各自生成的结果
+template <typename T>
+static std::vector<T> FlattenPerRoad(std::vector<std::vector<T>> &per_road) {
+    size_t total = 0u;
+    for (const auto &items : per_road) {
+        total += items.size();
+    }
+    std::vector<T> result;
+    result.reserve(total); // 一次性分配所需空间
+    for (auto &items : per_road) {
+        result.insert(
+            result.end(),
+            std::make_move_iterator(items.begin()),
+            std::make_move_iterator(items.end()));
+    }
+    return result;
+}
+
+/// 按车道类型分组的网格列表
+using LaneTypeMeshMap = std::map<Lane::LaneType, std::vector<std::unique_ptr<geom::Mesh>>>;
+
+/// 将 @a src 中的网格按顺序移动到 @a dst 对应车道类型的列表末尾
+static void MoveMeshesInto(LaneTypeMeshMap &dst, LaneTypeMeshMap &src) {
+    for (auto &&pair : src) {
+        auto &list = dst[pair.first];
+        list.insert(
+            list.end(),
+            std::make_move_iterator(pair.second.begin()),
+            std::make_move_iterator(pair.second.end()));
+    }
+}
+
 /// 假定 road_id 和 section_id 是有效的
 static bool IsLanePresent(const MapData &data, Waypoint waypoint) {
     const auto &section = data.GetRoad(waypoint.road_id).GetLaneSectionById(waypoint.section_id); // 获取指定的车道段
@@ -233,6 +293,31 @@ boost::optional<Waypoint> Map::GetWaypoint(
     return boost::optional<Waypoint>{}; // 否则返回空
 }
 
+std::vector<boost::optional<Waypoint>> Map::GetClosestWaypointsOnRoad(
+    const std::vector<geom::Location> &locations,
+    int32_t lane_type) const {
+    std::vector<boost::optional<Waypoint>> result(locations.size()); // 结果与输入一一对应
+    // R 树的查询是只读的，可以在多个线程中同时进行
+    ParallelFor(locations.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            result[i] = GetClosestWaypointOnRoad(locations[i], lane_type);
+        }
+    }, ComputeGrainSize(locations.size()));
+    return result;
+}
+
+std::vector<boost::optional<Waypoint>> Map::GetWaypoints(
+    const std::vector<geom::Location> &locations,
+    int32_t lane_type) const {
+    std::vector<boost::optional<Waypoint>> result(locations.size()); // 结果与输入一一对应
+    ParallelFor(locations.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            result[i] = GetWaypoint(locations[i], lane_type);
+        }
+    }, ComputeGrainSize(locations.size()));
+    return result;
+}
+
 boost::optional<Waypoint> Map::GetWaypoint(
     RoadId road_id,
     LaneId lane_id,
@@ -646,18 +731,99 @@ std::vector<Waypoint> Map::GetNext(
     return IsLanePresent(_data, waypoint) ? waypoint : boost::optional<Waypoint>{}; // 检查新车道是否存在
   }
 
-  std::vector<Waypoint> Map::GenerateWaypoints(const double distance) const {
-    RELEASE_ASSERT(distance > 0.0); // 确保距离大于0
-    std::vector<Waypoint> result; // 存储生成的waypoints
+  std::vector<const Road *> Map::GetOrderedRoads() const {
+    std::vector<const Road *> roads; // 道路指针列表
+    roads.reserve(_data.GetRoads().size());
     for (const auto &pair : _data.GetRoads()) { // 遍历所有道路
-      const auto &road = pair.second; // 获取当前道路
-      for (double s = EPSILON; s < (road.GetLength() - EPSILON); s += distance) { // 从0到道路长度生成waypoints
-        ForEachDrivableLaneAt(road, s, [&](auto &&waypoint) { // 对每个可驾驶车道执行操作
-          result.emplace_back(waypoint); // 将waypoint添加到结果中
+      roads.emplace_back(&pair.second);
+    }
+    return roads;
+  }
+
+  std::vector<Waypoint> Map::GenerateWaypoints(
+      const double distance,
+      const Lane::LaneType lane_type) const {
+    RELEASE_ASSERT(distance > 0.0); // 确保距离大于0
+    const auto key = std::make_pair(distance, static_cast<int32_t>(lane_type)); // 缓存键
+    {
+      std::lock_guard<std::mutex> lock(_generation_cache->mutex);
+      auto &entries = _generation_cache->waypoints;
+      auto it = std::find_if(entries.begin(), entries.end(), [&](const auto &entry) {
+        return entry.first == key;
+      });
+      if (it != entries.end()) { // 命中缓存，移到最前并直接复制
+        entries.splice(entries.begin(), entries, it);
+        return *it->second;
+      }
+    }
+    // 每条道路写入自己的输出，拼接后顺序与串行生成一致
+    const auto roads = GetOrderedRoads();
+    std::vector<std::vector<Waypoint>> per_road(roads.size());
+    ParallelFor(roads.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        GenerateWaypointsInRoadAt(*roads[i], distance, lane_type, per_road[i]);
+      }
+    });
+    auto result = std::make_shared<const std::vector<Waypoint>>(FlattenPerRoad(per_road));
+    {
+      std::lock_guard<std::mutex> lock(_generation_cache->mutex);
+      auto &entries = _generation_cache->waypoints;
+      const bool cached = std::any_of(entries.begin(), entries.end(), [&](const auto &entry) {
+        return entry.first == key;
+      });
+      if (!cached) { // 若其他线程已写入则保留已有结果
+        entries.emplace_front(key, result);
+        if (entries.size() > GenerationCache::MAX_WAYPOINT_ENTRIES) {
+          entries.pop_back();
+        }
+      }
+    }
+    return *result; // 返回生成的waypoints
+  }
+
+  Map::WaypointGenerator::WaypointGenerator(
+      const Map &map,
+      const double approx_distance,
+      const Lane::LaneType lane_type)
+    : _map(&map),
+      _distance(approx_distance),
+      _lane_type(lane_type),
+      _roads(map.GetOrderedRoads()),
+      _s(EPSILON) {
+    RELEASE_ASSERT(approx_distance > 0.0); // 确保距离大于0
+  }
+
+  void Map::WaypointGenerator::Refill() {
+    _pending.clear();
+    _pending_index = 0u;
+    while (_pending.empty() && _road_index < _roads.size()) {
+      const Road &road = *_roads[_road_index];
+      if (_s < (road.GetLength() - EPSILON)) {
+        ForEachLaneAt(road, _s, _lane_type, [&](auto &&waypoint) {
+          _pending.emplace_back(waypoint);
         });
+        _s += _distance;
+      } else { // 当前道路已经结束，移动到下一条道路
+        ++_road_index;
+        _s = EPSILON;
+      }
+    }
+  }
+
+  boost::optional<Waypoint> Map::WaypointGenerator::Next() {
+    if (_pending_index >= _pending.size()) {
+      Refill();
+      if (_pending.empty()) { // 所有道路都已生成完毕
+        return boost::optional<Waypoint>{};
       }
     }
-    return result; // 返回生成的waypoints
+    return _pending[_pending_index++];
+  }
+
+  Map::WaypointGenerator Map::GenerateWaypointsLazy(
+      const double approx_distance,
+      const Lane::LaneType lane_type) const {
+    return WaypointGenerator(*this, approx_distance, lane_type);
   }
 
  std::vector<Waypoint> Map::GenerateWaypointsOnRoadEntries(Lane::LaneType lane_type) const {
@@ -723,25 +889,47 @@ std::vector<Waypoint> Map::GenerateWaypointsInRoad(
 }
 
 std::vector<std::pair<Waypoint, Waypoint>> Map::GenerateTopology() const {
-    std::vector<std::pair<Waypoint, Waypoint>> result; // 创建一个空的 Waypoint 对向量来存储结果
-    for (const auto &pair : _data.GetRoads()) { // 遍历所有道路
-        const auto &road = pair.second; // 获取当前道路
-        ForEachDrivableLane(road, [&](auto &&waypoint) { // 对每个可驾驶车道执行操作
-            auto successors = GetSuccessors(waypoint); // 获取当前 waypoint 的后继 waypoint
-            if (successors.size() == 0) { // 如果没有后继
-                auto distance = static_cast<float>(GetDistanceAtEndOfLane(GetLane(waypoint))); // 获取车道末尾的距离
-                auto last_waypoint = GetWaypoint(waypoint.road_id, waypoint.lane_id, distance); // 获取最后一个 waypoint
-                if (last_waypoint.has_value()) { // 如果存在最后一个 waypoint
-                    result.push_back({waypoint, *last_waypoint}); // 添加到结果
-                }
-            } else { // 如果有后继
-                for (auto &&successor : GetSuccessors(waypoint)) { // 遍历所有后继
-                    result.push_back({waypoint, successor}); // 添加到结果
+    {
+        std::lock_guard<std::mutex> lock(_generation_cache->mutex);
+        if (_generation_cache->topology != nullptr) { // 命中缓存，直接复制
+            return *_generation_cache->topology;
+        }
+    }
+    const auto roads = GetOrderedRoads();
+    std::vector<std::vector<std::pair<Waypoint, Waypoint>>> per_road(roads.size()); // 每条道路的结果
+    ParallelFor(roads.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) { // 遍历分配给本分块的道路
+            auto &result = per_road[i];
+            ForEachDrivableLane(*roads[i], [&](auto &&waypoint) { // 对每个可驾驶车道执行操作
+                auto successors = GetSuccessors(waypoint); // 获取当前 waypoint 的后继 waypoint
+                if (successors.size() == 0) { // 如果没有后继
+                    auto distance = static_cast<float>(GetDistanceAtEndOfLane(GetLane(waypoint))); // 获取车道末尾的距离
+                    auto last_waypoint = GetWaypoint(waypoint.road_id, waypoint.lane_id, distance); // 获取最后一个 waypoint
+                    if (last_waypoint.has_value()) { // 如果存在最后一个 waypoint
+                        result.push_back({waypoint, *last_waypoint}); // 添加到结果
+                    }
+                } else { // 如果有后继
+                    for (auto &&successor : successors) { // 遍历所有后继
+                        result.push_back({waypoint, successor}); // 添加到结果
+                    }
                 }
-            }
-        });
+            });
+        }
+    });
+    auto result = std::make_shared<const std::vector<std::pair<Waypoint, Waypoint>>>(FlattenPerRoad(per_road));
+    {
+        std::lock_guard<std::mutex> lock(_generation_cache->mutex);
+        if (_generation_cache->topology == nullptr) {
+            _generation_cache->topology = result;
+        }
     }
-    return result; // 返回生成的 waypoint 对向量
+    return *result; // 返回生成的 waypoint 对向量
+}
+
+void Map::ClearCache() const {
+    std::lock_guard<std::mutex> lock(_generation_cache->mutex);
+    _generation_cache->waypoints.clear();
+    _generation_cache->topology = nullptr;
 }
 
 
@@ -1067,59 +1255,66 @@ geom::Mesh Map::GenerateMesh(
 std::vector<std::unique_ptr<geom::Mesh>> Map::GenerateChunkedMesh(
       const rpc::OpendriveGenerationParameters& params) const {
     geom::MeshFactory mesh_factory(params); // 创建一个网格工厂，用于生成网格
-    std::vector<std::unique_ptr<geom::Mesh>> out_mesh_list; // 定义输出网格列表
 
-    std::unordered_map<JuncId, geom::Mesh> junction_map; // 定义用于存储交叉口网格的哈希映射
-    for (auto &&pair : _data.GetRoads()) { // 遍历所有道路
-      const auto &road = pair.second; // 获取当前道路
-      if (!road.IsJunction()) { // 如果该道路不是交叉口
-        std::vector<std::unique_ptr<geom::Mesh>> road_mesh_list =
-            mesh_factory.GenerateAllWithMaxLen(road); // 生成道路的所有网格
-
-        // 将生成的道路网格添加到输出网格列表中
-        out_mesh_list.insert(
-            out_mesh_list.end(),
-            std::make_move_iterator(road_mesh_list.begin()),
-            std::make_move_iterator(road_mesh_list.end()));
+    // 每条道路在共享线程池上独立生成，结果写入各自的位置，
+    // 拼接顺序与串行生成相同，因此输出与线程数量无关
+    const auto roads = GetOrderedRoads();
+    std::vector<std::vector<std::unique_ptr<geom::Mesh>>> road_meshes(roads.size());
+    ParallelFor(roads.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) { // 遍历分配给本分块的道路
+        if (!roads[i]->IsJunction()) { // 如果该道路不是交叉口
+          road_meshes[i] = mesh_factory.GenerateAllWithMaxLen(*roads[i]); // 生成道路的所有网格
+        }
       }
-    }
+    });
 
-    // 生成交叉口内的道路并进行光滑处理
+    // 生成交叉口内的道路并进行光滑处理，每个交叉口一个任务
+    std::vector<const Junction *> junctions; // 按固定顺序排列的交叉口
+    junctions.reserve(_data.GetJunctions().size());
     for (const auto &junc_pair : _data.GetJunctions()) { // 遍历所有交叉口
-      const auto &junction = junc_pair.second; // 获取当前交叉口
-      std::vector<std::unique_ptr<geom::Mesh>> lane_meshes; // 存储车道网格
-      std::vector<std::unique_ptr<geom::Mesh>> sidewalk_lane_meshes; // 存储人行道网格
-      for(const auto &connection_pair : junction.GetConnections()) { // 遍历交叉口的连接
-        const auto &connection = connection_pair.second; // 获取连接信息
-        const auto &road = _data.GetRoads().at(connection.connecting_road); // 获取连接的道路
-        for (auto &&lane_section : road.GetLaneSections()) { // 遍历道路的车道段
-          for (auto &&lane_pair : lane_section.GetLanes()) { // 遍历车道
-            const auto &lane = lane_pair.second; // 获取当前车道
-            if (lane.GetType() != road::Lane::LaneType::Sidewalk) { // 如果车道不是人行道
-              lane_meshes.push_back(mesh_factory.Generate(lane)); // 生成车道网格并添加
-            } else {
-              sidewalk_lane_meshes.push_back(mesh_factory.Generate(lane)); // 生成人行道网格并添加
+      junctions.emplace_back(&junc_pair.second);
+    }
+    std::vector<std::unique_ptr<geom::Mesh>> junction_meshes(junctions.size());
+    ParallelFor(junctions.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const auto &junction = *junctions[i]; // 获取当前交叉口
+        std::vector<std::unique_ptr<geom::Mesh>> lane_meshes; // 存储车道网格
+        std::vector<std::unique_ptr<geom::Mesh>> sidewalk_lane_meshes; // 存储人行道网格
+        for(const auto &connection_pair : junction.GetConnections()) { // 遍历交叉口的连接
+          const auto &connection = connection_pair.second; // 获取连接信息
+          const auto &road = _data.GetRoads().at(connection.connecting_road); // 获取连接的道路
+          for (auto &&lane_section : road.GetLaneSections()) { // 遍历道路的车道段
+            for (auto &&lane_pair : lane_section.GetLanes()) { // 遍历车道
+              const auto &lane = lane_pair.second; // 获取当前车道
+              if (lane.GetType() != road::Lane::LaneType::Sidewalk) { // 如果车道不是人行道
+                lane_meshes.push_back(mesh_factory.Generate(lane)); // 生成车道网格并添加
+              } else {
+                sidewalk_lane_meshes.push_back(mesh_factory.Generate(lane)); // 生成人行道网格并添加
+              }
             }
           }
         }
-      }
-      if(params.smooth_junctions) { // 如果需要光滑处理交叉口
-        auto merged_mesh = mesh_factory.MergeAndSmooth(lane_meshes); // 合并并光滑车道网格
-        for(auto& lane : sidewalk_lane_meshes) { // 遍历人行道网格
-          *merged_mesh += *lane; // 将人行道网格添加到合并网格中
-        }
-        out_mesh_list.push_back(std::move(merged_mesh)); // 将合并后的网格添加到输出列表
-      } else {
-        std::unique_ptr<geom::Mesh> junction_mesh = std::make_unique<geom::Mesh>(); // 创建新的交叉口网格
-        for(auto& lane : lane_meshes) { // 遍历车道网格
-          *junction_mesh += *lane; // 将车道网格添加到交叉口网格中
+        std::unique_ptr<geom::Mesh> junction_mesh;
+        if(params.smooth_junctions) { // 如果需要光滑处理交叉口
+          junction_mesh = mesh_factory.MergeAndSmooth(lane_meshes); // 合并并光滑车道网格
+        } else {
+          junction_mesh = std::make_unique<geom::Mesh>(); // 创建新的交叉口网格
+          for(auto& lane : lane_meshes) { // 遍历车道网格
+            *junction_mesh += *lane; // 将车道网格添加到交叉口网格中
+          }
         }
         for(auto& lane : sidewalk_lane_meshes) { // 遍历人行道网格
           *junction_mesh += *lane; // 将人行道网格添加到交叉口网格中
         }
-        out_mesh_list.push_back(std::move(junction_mesh)); // 将交叉口网格添加到输出列表
+        junction_meshes[i] = std::move(junction_mesh); // 写入本交叉口对应的位置
       }
-    }
+    });
+
+    std::vector<std::unique_ptr<geom::Mesh>> out_mesh_list = FlattenPerRoad(road_meshes); // 定义输出网格列表
+    out_mesh_list.insert(
+        out_mesh_list.end(),
+        std::make_move_iterator(junction_meshes.begin()),
+        std::make_move_iterator(junction_meshes.end()));
 
     // 找到输出网格的最小和最大位置
     auto min_pos = geom::Vector2D(
@@ -1135,16 +1330,36 @@ std::vector<std::unique_ptr<geom::Mesh>> Map::GenerateChunkedMesh(
     }
     size_t mesh_amount_x = static_cast<size_t>((max_pos.x - min_pos.x)/params.max_road_length) + 1; // 计算x方向的网格数量
     size_t mesh_amount_y = static_cast<size_t>((max_pos.y - min_pos.y)/params.max_road_length) + 1; // 计算y方向的网格数量
+    const size_t chunk_amount = mesh_amount_x * mesh_amount_y; // 分块总数
+    auto chunk_index_of = [&](const geom::Mesh &mesh) { // 计算网格所属分块的索引
+      auto vertex = mesh.GetVertices().front(); // 获取网格的第一个顶点
+      size_t x_pos = static_cast<size_t>((vertex.x - min_pos.x) / params.max_road_length); // 计算x坐标在结果网格中的索引
+      size_t y_pos = static_cast<size_t>((vertex.y - min_pos.y) / params.max_road_length); // 计算y坐标在结果网格中的索引
+      return x_pos + mesh_amount_x * y_pos;
+    };
+    // 先统计每个分块的大小，一次性分配缓冲区，避免合并时反复扩容
+    std::vector<size_t> chunk_vertices(chunk_amount, 0u);
+    std::vector<size_t> chunk_indexes(chunk_amount, 0u);
+    std::vector<size_t> chunk_normals(chunk_amount, 0u);
+    std::vector<size_t> chunk_uvs(chunk_amount, 0u);
+    std::vector<size_t> mesh_chunk(out_mesh_list.size());
+    for (size_t i = 0u; i < out_mesh_list.size(); ++i) { // 遍历所有输出网格
+      const auto &mesh = *out_mesh_list[i];
+      const size_t chunk = chunk_index_of(mesh);
+      mesh_chunk[i] = chunk;
+      chunk_vertices[chunk] += mesh.GetVerticesNum();
+      chunk_indexes[chunk] += mesh.GetIndexesNum();
+      chunk_normals[chunk] += mesh.GetNormals().size();
+      chunk_uvs[chunk] += mesh.GetUVs().size();
+    }
     std::vector<std::unique_ptr<geom::Mesh>> result; // 定义结果网格列表
-    result.reserve(mesh_amount_x*mesh_amount_y); // 预留空间以容纳所有网格
-    for (size_t i = 0; i < mesh_amount_x*mesh_amount_y; ++i) { // 根据网格数量逐个初始化网格
+    result.reserve(chunk_amount); // 预留空间以容纳所有网格
+    for (size_t i = 0; i < chunk_amount; ++i) { // 根据网格数量逐个初始化网格
       result.emplace_back(std::make_unique<geom::Mesh>());
+      result.back()->Reserve(chunk_vertices[i], chunk_indexes[i], chunk_normals[i], chunk_uvs[i]);
     }
-    for (auto & mesh : out_mesh_list) { // 遍历所有输出网格
-      auto vertex = mesh->GetVertices().front(); // 获取网格的第一个顶点
-      size_t x_pos = static_cast<size_t>((vertex.x - min_pos.x) / params.max_road_length); // 计算x坐标在结果网格中的索引
-      size_t y_pos = static_cast<size_t>((vertex.y - min_pos.y) / params.max_road_length); // 计算y坐标在结果网格中的索引
-      *(result[x_pos + mesh_amount_x*y_pos]) += *mesh; // 将当前网格添加到对应的结果网格中
+    for (size_t i = 0u; i < out_mesh_list.size(); ++i) { // 按原有顺序合并，保证输出确定
+      *(result[mesh_chunk[i]]) += *out_mesh_list[i]; // 将当前网格添加到对应的结果网格中
     }
 
     return result; // 返回生成的结果网格列表
@@ -1156,70 +1371,32 @@ Map::GenerateOrderedChunkedMeshInLocations(const rpc::OpendriveGenerationParamet
                                             const geom::Vector3D& maxpos) const
 {
     geom::MeshFactory mesh_factory(params); // 创建一个网格工厂，用于生成网格
-    std::map<road::Lane::LaneType, std::vector<std::unique_ptr<geom::Mesh>>> road_out_mesh_list; // 存储道路类型对应的网格列表
-    std::map<road::Lane::LaneType, std::vector<std::unique_ptr<geom::Mesh>>> junction_out_mesh_list; // 存储交叉口类型对应的网格列表
-
-    // 创建一个线程来生成交叉口的网格
-    std::thread junction_thread(&Map::GenerateJunctions, this, mesh_factory, params,
-                                 minpos, maxpos, &junction_out_mesh_list);
+    LaneTypeMeshMap road_out_mesh_list; // 存储道路类型对应的网格列表
+    LaneTypeMeshMap junction_out_mesh_list; // 存储交叉口类型对应的网格列表
 
     // 根据位置过滤需要生成的道路ID
     const std::vector<RoadId> RoadsIDToGenerate = FilterRoadsByPosition(minpos, maxpos);
 
     size_t num_roads = RoadsIDToGenerate.size(); // 获取需要生成的道路数量
-    size_t num_roads_per_thread = 30; // 每个线程处理的道路数量
-    size_t num_threads = (num_roads / num_roads_per_thread) + 1; // 计算所需线程数
-    num_threads = num_threads > 1 ? num_threads : 1; // 确保至少有一个线程
-    std::vector<std::thread> workers; // 存储工作线程
-    std::mutex write_mutex; // 互斥量，用于保护写操作
     std::cout << "Generating " << std::to_string(num_roads) << " roads" << std::endl; // 输出生成道路数量
 
-    for (size_t i = 0; i < num_threads; ++i) { // 为每个线程创建工作任务
-        std::thread new_worker(
-            [this, &write_mutex, &mesh_factory, &RoadsIDToGenerate, &road_out_mesh_list, i, num_roads_per_thread]() {
-                // 生成当前线程的道路网格
-                std::map<road::Lane::LaneType, std::vector<std::unique_ptr<geom::Mesh>>> Current =
-                    std::move(GenerateRoadsMultithreaded(mesh_factory, RoadsIDToGenerate, i, num_roads_per_thread));
-                
-                std::lock_guard<std::mutex> guard(write_mutex); // 锁住互斥量以进行安全写入
-                
-                for (auto&& pair : Current) { // 遍历当前线程生成的网格
-                    if (road_out_mesh_list.find(pair.first) != road_out_mesh_list.end()) { // 检查类型是否已存在
-                        // 如果已存在，合并网格
-                        road_out_mesh_list[pair.first].insert(road_out_mesh_list[pair.first].end(),
-                                                              std::make_move_iterator(pair.second.begin()),
-                                                              std::make_move_iterator(pair.second.end()));
-                    } else {
-                        // 如果不存在，直接添加
-                        road_out_mesh_list[pair.first] = std::move(pair.second);
-                    }
-                }
-            });
-        workers.push_back(std::move(new_worker)); // 将新线程添加到工作线程列表中
-    }
-
-    for (size_t i = 0; i < workers.size(); ++i) { // 等待所有工作线程完成
-        workers[i].join(); // 加入线程
-    }
-    workers.clear(); // 清空工作线程列表
-    for (size_t i = 0; i < workers.size(); ++i) { // 再次检查线程并确保它们已加入
-        if (workers[i].joinable()) {
-            workers[i].join(); // 如果可加入则加入
+    // 每条道路作为一个任务在共享线程池上生成，空闲线程会领取剩余的道路，
+    // 各道路的结果按道路顺序合并，输出与线程数量无关
+    std::vector<LaneTypeMeshMap> per_road(num_roads);
+    ParallelFor(num_roads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const auto& road = _data.GetRoads().at(RoadsIDToGenerate[i]); // 获取当前道路对象
+            if (!road.IsJunction()) { // 如果当前道路不是交叉口
+                mesh_factory.GenerateAllOrderedWithMaxLen(road, per_road[i]); // 生成该道路的所有网格
+            }
         }
+    });
+    for (auto &road_meshes : per_road) {
+        MoveMeshesInto(road_out_mesh_list, road_meshes);
     }
 
-    junction_thread.join(); // 等待交叉口生成线程完成
-    for (auto&& pair : junction_out_mesh_list) { // 遍历交叉口生成的网格
-        if (road_out_mesh_list.find(pair.first) != road_out_mesh_list.end()) { // 检查类型是否已存在
-            // 如果已存在，合并交叉口网格
-            road_out_mesh_list[pair.first].insert(road_out_mesh_list[pair.first].end(),
-                                                  std::make_move_iterator(pair.second.begin()),
-                                                  std::make_move_iterator(pair.second.end()));
-        } else {
-            // 如果不存在，直接添加
-            road_out_mesh_list[pair.first] = std::move(pair.second);
-        }
-    }
+    GenerateJunctions(mesh_factory, params, minpos, maxpos, &junction_out_mesh_list); // 生成交叉口的网格
+    MoveMeshesInto(road_out_mesh_list, junction_out_mesh_list);
     std::cout << "Generated " << std::to_string(num_roads) << " roads" << std::endl; // 输出生成完成的信息
 
     return road_out_mesh_list; // 返回生成的道路网格列表
@@ -1325,14 +1502,26 @@ std::vector<std::unique_ptr<geom::Mesh>> Map::GenerateLineMarkings(
 
     // 根据位置筛选要生成的道路ID
     const std::vector<RoadId> RoadsIDToGenerate = FilterRoadsByPosition(minpos, maxpos);
-    for ( RoadId id : RoadsIDToGenerate ) { // 遍历每条道路ID
-        const auto& road = _data.GetRoads().at(id); // 获取道路对象
-        if (!road.IsJunction()) { // 如果不是交叉口
-            mesh_factory.GenerateLaneMarkForRoad(road, LineMarks, outinfo); // 生成道路的线标
+    // 每条道路并行生成，再按道路顺序拼接网格和对应的信息
+    std::vector<std::vector<std::unique_ptr<geom::Mesh>>> per_road_marks(RoadsIDToGenerate.size());
+    std::vector<std::vector<std::string>> per_road_info(RoadsIDToGenerate.size());
+    ParallelFor(RoadsIDToGenerate.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) { // 遍历每条道路ID
+            const auto& road = _data.GetRoads().at(RoadsIDToGenerate[i]); // 获取道路对象
+            if (!road.IsJunction()) { // 如果不是交叉口
+                mesh_factory.GenerateLaneMarkForRoad(road, per_road_marks[i], per_road_info[i]); // 生成道路的线标
+            }
         }
+    });
+    LineMarks = FlattenPerRoad(per_road_marks);
+    for (auto &info : per_road_info) {
+        outinfo.insert(
+            outinfo.end(),
+            std::make_move_iterator(info.begin()),
+            std::make_move_iterator(info.end()));
     }
 
-    return std::move(LineMarks); // 移动并返回生成的线标网格
+    return LineMarks; // 返回生成的线标网格
 }
 
 
@@ -1353,27 +1542,6 @@ std::vector<std::unique_ptr<geom::Mesh>> Map::GenerateLineMarkings(
       geom::deformation::GetBumpDeformation(posx,posy);   // 添加隆起变形的值
   }
 
-  std::map<road::Lane::LaneType, std::vector<std::unique_ptr<geom::Mesh>>>
-      Map::GenerateRoadsMultithreaded( const carla::geom::MeshFactory& mesh_factory,   // 定义生成道路的多线程函数
-                                        const std::vector<RoadId>& RoadsId,   // 输入的道路ID向量
-                                        const size_t index, const size_t number_of_roads_per_thread) const
-  {
-    std::map<road::Lane::LaneType, std::vector<std::unique_ptr<geom::Mesh>>> out;   // 输出的道路网格
-
-    size_t start = index * number_of_roads_per_thread;  // 计算当前线程的起始索引
-    size_t endoffset = (index+1) * number_of_roads_per_thread;  // 计算当前线程的结束索引
-    size_t end = RoadsId.size();  // 获取道路ID的总数
-
-    for (int i = start; i < endoffset && i < end; ++i) {   // 遍历当前线程负责的道路
-      const auto& road = _data.GetRoads().at(RoadsId[i]);  // 获取当前道路对象
-      if (!road.IsJunction()) {   // 如果当前道路不是交叉口
-        mesh_factory.GenerateAllOrderedWithMaxLen(road, out);   // 生成该道路的所有网格
-      }
-    }
-    std::cout << "Generated roads from " + std::to_string(index * number_of_roads_per_thread) + " to " + std::to_string((index+1) * number_of_roads_per_thread ) << std::endl;   // 输出生成的道路范围
-    return out;   // 返回生成的道路网格
-  }
-
  void Map::GenerateJunctions(const carla::geom::MeshFactory& mesh_factory, // 生成交叉口的函数，接受网格工厂参数
     const rpc::OpendriveGenerationParameters& params, // Opendrive生成参数
     const geom::Vector3D& minpos, // 最小位置
@@ -1384,57 +1552,18 @@ std::vector<std::unique_ptr<geom::Mesh>> Map::GenerateLineMarkings(
     std::vector<JuncId> JunctionsToGenerate = FilterJunctionsByPosition(minpos, maxpos); // 根据位置过滤交叉口
     size_t num_junctions = JunctionsToGenerate.size(); // 交叉口数量
     std::cout << "Generating " << std::to_string(num_junctions) << " junctions" << std::endl; // 输出生成的交叉口数
-    size_t junctionindex = 0; // 交叉口索引初始化
-    size_t num_junctions_per_thread = 5; // 每个线程处理的交叉口数量
-    size_t num_threads = (num_junctions / num_junctions_per_thread) + 1; // 计算线程数
-    num_threads = num_threads > 1 ? num_threads : 1; // 至少一个线程
-    std::vector<std::thread> workers; // 线程列表
-    std::mutex write_mutex; // 互斥锁用于保护共享资源
-
-    for ( size_t i = 0; i < num_threads; ++i ) { // 创建并启动多个线程
-      std::thread neworker(
-        [this, &write_mutex, &mesh_factory, &junction_out_mesh_list, JunctionsToGenerate, i, num_junctions_per_thread, num_junctions]() {
-        std::map<road::Lane::LaneType, // 本线程内的交叉口列表
-          std::vector<std::unique_ptr<geom::Mesh>>> junctionsofthisthread;
-
-        size_t minimum = 0; // 初始化最小值
-        if( (i + 1) * num_junctions_per_thread < num_junctions ){ // 如果还有交叉口需要处理
-          minimum = (i + 1) * num_junctions_per_thread; // 更新最小值
-        }else{
-          minimum = num_junctions; // 否则设置为总数量
-        }
-        std::cout << "Generating Junctions between  " << std::to_string(i * num_junctions_per_thread) << " and " << std::to_string(minimum) << std::endl; // 输出当前线程处理的交叉口范围
 
-        for ( size_t junctionindex = i * num_junctions_per_thread; // 遍历本线程处理的交叉口
-                        junctionindex < minimum;
-                        ++junctionindex )
-        {
-          GenerateSingleJunction(mesh_factory, JunctionsToGenerate[junctionindex], &junctionsofthisthread); // 生成单个交叉口
-        }
-        std::cout << "Generated Junctions between  " << std::to_string(i * num_junctions_per_thread) << " and " << std::to_string(minimum) << std::endl; // 输出完成的交叉口范围
-        std::lock_guard<std::mutex> guard(write_mutex); // 保护对共享数据的写操作
-        for ( auto&& pair : junctionsofthisthread ) { // 遍历本线程生成的交叉口
-          if ((*junction_out_mesh_list).find(pair.first) != (*junction_out_mesh_list).end()) { // 如果该类型的交叉口已存在
-            (*junction_out_mesh_list)[pair.first].insert((*junction_out_mesh_list)[pair.first].end(),
-              std::make_move_iterator(pair.second.begin()), // 插入新的交叉口网格
-              std::make_move_iterator(pair.second.end()));
-          } else {
-            (*junction_out_mesh_list)[pair.first] = std::move(pair.second); // 否则直接移动到输出列表
-          }
-        }
-      });
-      workers.push_back(std::move(neworker)); // 将新线程添加到线程列表
-    }
-
-    for (size_t i = 0; i < workers.size(); ++i) { // 等待所有线程完成
-      workers[i].join();
-    }
-    workers.clear(); // 清空线程列表
-    for (size_t i = 0; i < workers.size(); ++i) { // 检查并确保所有线程已加入
-      if (workers[i].joinable()) {
-        workers[i].join();
+    // 每个交叉口一个任务，在共享线程池上生成后按交叉口顺序合并
+    std::vector<LaneTypeMeshMap> per_junction(num_junctions);
+    ParallelFor(num_junctions, [&](size_t begin, size_t end) {
+      for (size_t junctionindex = begin; junctionindex < end; ++junctionindex) { // 遍历本分块处理的交叉口
+        GenerateSingleJunction(mesh_factory, JunctionsToGenerate[junctionindex], &per_junction[junctionindex]); // 生成单个交叉口
       }
+    });
+    for (auto &junction_meshes : per_junction) {
+      MoveMeshesInto(*junction_out_mesh_list, junction_meshes);
     }
+    std::cout << "Generated " << std::to_string(num_junctions) << " junctions" << std::endl; // 输出完成的交叉口数
   }
 
   std::vector<JuncId> Map::FilterJunctionsByPosition( const geom::Vector3D& minpos, // 根据位置过滤交叉口的函数
@@ -21,6 +21,10 @@
 
 #include <boost/optional.hpp> // 包含可选类型的定义
 
+#include <list> // 包含链表的定义
+#include <map> // 包含有序映射的定义
+#include <memory> // 包含智能指针的定义
+#include <mutex> // 包含互斥锁的定义
 #include <vector> // 包含向量类的定义
 
 namespace carla {
@@ -59,6 +63,17 @@ namespace road {
         const geom::Location &location, // 输入位置
         int32_t lane_type = static_cast<int32_t>(Lane::LaneType::Driving)) const; // 默认车道类型为驾驶车道
 
+    /// 批量版本的 GetClosestWaypointOnRoad，在共享线程池上并行处理
+    /// @a locations，结果与输入一一对应，顺序与线程数量无关。
+    std::vector<boost::optional<element::Waypoint>> GetClosestWaypointsOnRoad(
+        const std::vector<geom::Location> &locations, // 输入位置列表
+        int32_t lane_type = static_cast<int32_t>(Lane::LaneType::Driving)) const; // 车道类型掩码
+
+    /// 批量版本的 GetWaypoint，位置不在车道内时对应结果为空。
+    std::vector<boost::optional<element::Waypoint>> GetWaypoints(
+        const std::vector<geom::Location> &locations, // 输入位置列表
+        int32_t lane_type = static_cast<int32_t>(Lane::LaneType::Driving)) const; // 车道类型掩码
+
     boost::optional<element::Waypoint> GetWaypoint( // 根据道路ID和车道ID获取路径点
         RoadId road_id, // 道路ID
         LaneId lane_id, // 车道ID
@@ -129,7 +144,51 @@ namespace road {
     boost::optional<Waypoint> GetLeft(Waypoint waypoint) const; // 获取左侧路点
 
     /// 在 @a map 中生成所有路点，路点之间相隔 @a approx_distance。
-    std::vector<Waypoint> GenerateWaypoints(double approx_distance) const; // 生成路点
+    /// 各条道路在共享线程池上并行生成，最近使用的几组 (approx_distance,
+    /// lane_type) 的结果缓存在地图中，重复调用只需复制缓存。
+    std::vector<Waypoint> GenerateWaypoints(
+        double approx_distance,
+        Lane::LaneType lane_type = Lane::LaneType::Driving) const; // 生成路点
+
+    /// 惰性路点生成器，按与 GenerateWaypoints 相同的顺序逐个返回路点，
+    /// 每次只保存当前道路当前 s 处的路点，不会一次性生成全部路点。
+    /// 生成器引用地图，其生命周期不能超过地图本身。
+    class WaypointGenerator {
+    public:
+
+      /// 返回下一个路点，全部生成完毕后返回空。
+      boost::optional<Waypoint> Next();
+
+    private:
+
+      friend Map;
+
+      WaypointGenerator(const Map &map, double approx_distance, Lane::LaneType lane_type);
+
+      /// 当缓冲区为空时，生成下一个 s 处的路点。
+      void Refill();
+
+      const Map *_map; // 所属地图
+
+      double _distance; // 路点间距
+
+      Lane::LaneType _lane_type; // 车道类型掩码
+
+      std::vector<const Road *> _roads; // 按固定顺序排列的道路
+
+      size_t _road_index = 0u; // 当前道路索引
+
+      double _s; // 当前道路上的下一个 s
+
+      std::vector<Waypoint> _pending; // 当前 s 处尚未返回的路点
+
+      size_t _pending_index = 0u; // 下一个要返回的路点索引
+    };
+
+    /// 创建惰性路点生成器，参见 WaypointGenerator。
+    WaypointGenerator GenerateWaypointsLazy(
+        double approx_distance,
+        Lane::LaneType lane_type = Lane::LaneType::Driving) const;
 
     /// 在每个 @a lane 的入口处生成路点，
     /// 默认是行驶车道类型。
@@ -139,9 +198,12 @@ namespace road {
     std::vector<Waypoint> GenerateWaypointsInRoad(RoadId road_id, Lane::LaneType lane_type = Lane::LaneType::Driving) const; // 生成道路上的路点
 
     /// 生成定义 @a map 拓扑结构的最小路点集。
-    /// 路点放置在每个车道入口处。
+    /// 路点放置在每个车道入口处。各条道路并行处理，结果缓存在地图中。
     std::vector<std::pair<Waypoint, Waypoint>> GenerateTopology() const; // 生成拓扑结构
 
+    /// 释放 GenerateWaypoints 和 GenerateTopology 缓存的结果。
+    void ClearCache() const;
+
     /// 生成交叉口的路点。
     std::vector<std::pair<Waypoint, Waypoint>> GetJunctionWaypoints(JuncId id, Lane::LaneType lane_type) const; // 获取交叉口路点
 
@@ -209,6 +271,21 @@ private:
     using Rtree = geom::SegmentCloudRtree<Waypoint>;  // 使用R树结构
     Rtree _rtree;  // R树对象
 
+    /// GenerateWaypoints 和 GenerateTopology 的结果缓存。通过指针持有，
+    /// 使 Map 仍然可以移动。
+    struct GenerationCache {
+      /// 缓存的路点组数上限，超出时丢弃最久未使用的一组。
+      static constexpr size_t MAX_WAYPOINT_ENTRIES = 4u;
+      std::mutex mutex;
+      /// 按最近使用排序，最近使用的在前。
+      std::list<std::pair<std::pair<double, int32_t>, std::shared_ptr<const std::vector<Waypoint>>>> waypoints;
+      std::shared_ptr<const std::vector<std::pair<Waypoint, Waypoint>>> topology;
+    };
+    std::unique_ptr<GenerationCache> _generation_cache = std::make_unique<GenerationCache>();  // 生成结果缓存
+
+    /// 按固定顺序返回所有道路，保证并行生成的结果与串行时一致。
+    std::vector<const Road *> GetOrderedRoads() const;
+
     void CreateRtree();  // 创建R树
 
     // 辅助函数，用于构造R树元素列表
@@ -228,12 +305,6 @@ private:
 public:
     inline float GetZPosInDeformation(float posx, float posy) const;  // 获取变形中的Z轴位置
 
-    std::map<road::Lane::LaneType, std::vector<std::unique_ptr<geom::Mesh>>>  // 多线程生成道路网格
-      GenerateRoadsMultithreaded( const carla::geom::MeshFactory& mesh_factory,  // 网格工厂
-        const std::vector<RoadId>& RoadsID,  // 道路ID列表
-        const size_t index,  // 当前索引
-        const size_t number_of_roads_per_thread) const;  // 每个线程的道路数量
-
     void GenerateJunctions(const carla::geom::MeshFactory& mesh_factory,  // 生成交叉口
       const rpc::OpendriveGenerationParameters& params,  // OpenDRIVE生成参数
       const geom::Vector3D& minpos,  // 最小位置
@@ -37,7 +37,7 @@ namespace geom {
     for (auto &&lane_section : road.GetLaneSections()) { // 遍历所有车道段
       out_mesh += *Generate(lane_section); // 生成每个车道段的网格并添加到输出网格中
     }
-    return std::make_unique<Mesh>(out_mesh); // 返回生成的网格
+    return std::make_unique<Mesh>(std::move(out_mesh)); // 返回生成的网格
   }
 
   // 根据车道段生成网格
@@ -46,7 +46,7 @@ namespace geom {
     for (auto &&lane_pair : lane_section.GetLanes()) { // 遍历车道段中的所有车道
       out_mesh += *Generate(lane_pair.second); // 生成每条车道的网格并添加到输出网格中
     }
-    return std::make_unique<Mesh>(out_mesh); // 返回生成的网格
+    return std::make_unique<Mesh>(std::move(out_mesh)); // 返回生成的网格
   }
 
   // 根据车道生成网格，默认起始点和结束点
@@ -75,12 +75,14 @@ namespace geom {
       // ID为0的车道在OpenDRIVE中没有物理表示
       Mesh out_mesh;
       if (lane.GetId() == 0) {
-          return std::make_unique<Mesh>(out_mesh); // 返回空网格
+          return std::make_unique<Mesh>(std::move(out_mesh)); // 返回空网格
       }
 
       double s_current = s_start; // 当前s值初始化为起始点
 
       std::vector<geom::Vector3D> vertices; // 存储顶点的向量
+      // 预先分配顶点空间，避免逐个添加时反复扩容
+      vertices.reserve(2u * (static_cast<size_t>((s_end - s_start) / road_param.resolution) + 2u));
       if (lane.IsStraight()) { // 如果车道是直的
         // 网格优化：如果车道是直的，只需在开始和结束处添加顶点
           const auto edges = lane.GetCornerPositions(s_current, road_param.extra_lane_width); // 获取当前车道边缘位置
@@ -113,7 +115,7 @@ namespace geom {
           lane.GetType() == road::Lane::LaneType::Sidewalk ? "sidewalk" : "road"); // 根据车道类型选择材质
       out_mesh.AddTriangleStrip(vertices); // 添加三角形带
       out_mesh.EndMaterial(); // 结束材质
-      return std::make_unique<Mesh>(out_mesh); // 返回生成的网格
+      return std::make_unique<Mesh>(std::move(out_mesh)); // 返回生成的网格
   }
 
   std::unique_ptr<Mesh> MeshFactory::GenerateTesselated(
@@ -126,7 +128,7 @@ namespace geom {
     // lane_id为0的车道在OpenDRIVE中没有物理表示
     Mesh out_mesh; // 创建网格对象
     if (lane.GetId() == 0) { // 检查车道ID
-      return std::make_unique<Mesh>(out_mesh); // 如果ID为0，返回空网格
+      return std::make_unique<Mesh>(std::move(out_mesh)); // 如果ID为0，返回空网格
     }
     double s_current = s_start; // 初始化当前s值
 
@@ -194,7 +196,7 @@ namespace geom {
       }
     }
     out_mesh.EndMaterial(); // 结束材质
-    return std::make_unique<Mesh>(out_mesh); // 返回生成的网格
+    return std::make_unique<Mesh>(std::move(out_mesh)); // 返回生成的网格
 }
 
 void MeshFactory::GenerateLaneSectionOrdered(
@@ -251,7 +253,7 @@ std::unique_ptr<Mesh> MeshFactory::GenerateSidewalk(const road::LaneSection &lan
         const double s_end = lane_pair.second.GetDistance() + lane_pair.second.GetLength() - EPSILON; // 计算结束的s参数
         out_mesh += *GenerateSidewalk(lane_pair.second, s_start, s_end); // 生成车道的侧步网格并添加到输出网格
     }
-    return std::make_unique<Mesh>(out_mesh); // 返回创建的网格
+    return std::make_unique<Mesh>(std::move(out_mesh)); // 返回创建的网格
 }
 std::unique_ptr<Mesh> MeshFactory::GenerateSidewalk(const road::Lane &lane) const{ // 定义生成侧步的方法，接受车道作为参数
     const double s_start = lane.GetDistance() + EPSILON; // 计算开始的s参数
@@ -271,7 +273,7 @@ std::unique_ptr<Mesh> MeshFactory::GenerateSidewalk( // 重载方法，接受车
     // lane_id为0的车道在OpenDRIVE中没有物理表示
     Mesh out_mesh; // 创建一个输出网格
     if (lane.GetId() == 0) { // 如果车道ID为0
-        return std::make_unique<Mesh>(out_mesh); // 返回空网格
+        return std::make_unique<Mesh>(std::move(out_mesh)); // 返回空网格
     }
     double s_current = s_start; // 初始化当前s为起始s值
 
@@ -369,7 +371,7 @@ std::unique_ptr<Mesh> MeshFactory::GenerateSidewalk( // 重载方法，接受车
       }
     }
     out_mesh.EndMaterial(); // 结束材料定义
-    return std::make_unique<Mesh>(out_mesh); // 返回创建的网格对象
+    return std::make_unique<Mesh>(std::move(out_mesh)); // 返回创建的网格对象
 }
 std::unique_ptr<Mesh> MeshFactory::GenerateWalls(const road::LaneSection &lane_section) const {
     Mesh out_mesh; // 创建一个输出网格
@@ -392,7 +394,7 @@ std::unique_ptr<Mesh> MeshFactory::GenerateWalls(const road::LaneSection &lane_s
             out_mesh += *GenerateRightWall(lane, s_start, s_end); // 生成右墙并添加到输出网格
         }
     }
-    return std::make_unique<Mesh>(out_mesh); // 返回包含生成墙体的网格
+    return std::make_unique<Mesh>(std::move(out_mesh)); // 返回包含生成墙体的网格
 }
 
 std::unique_ptr<Mesh> MeshFactory::GenerateRightWall(
@@ -405,7 +407,7 @@ std::unique_ptr<Mesh> MeshFactory::GenerateRightWall(
     // ID为0的车道在OpenDRIVE中没有物理表示
     Mesh out_mesh; // 创建输出网格
     if (lane.GetId() == 0) { // 如果车道ID为0
-        return std::make_unique<Mesh>(out_mesh); // 返回空网格
+        return std::make_unique<Mesh>(std::move(out_mesh)); // 返回空网格
     }
     double s_current = s_start; // 当前s值初始化为起始位置
     const geom::Vector3D height_vector = geom::Vector3D(0.f, 0.f, road_param.wall_height); // 墙体高度向量
@@ -442,7 +444,7 @@ std::unique_ptr<Mesh> MeshFactory::GenerateRightWall(
         lane.GetType() == road::Lane::LaneType::Sidewalk ? "sidewalk" : "road"); // 根据车道类型添加材质
     out_mesh.AddTriangleStrip(r_vertices); // 添加三角带
     out_mesh.EndMaterial(); // 结束材质定义
-    return std::make_unique<Mesh>(out_mesh); // 返回包含右墙的网格
+    return std::make_unique<Mesh>(std::move(out_mesh)); // 返回包含右墙的网格
 }
 
 std::unique_ptr<Mesh> MeshFactory::GenerateLeftWall(
@@ -455,7 +457,7 @@ std::unique_ptr<Mesh> MeshFactory::GenerateLeftWall(
     // ID为0的车道在OpenDRIVE中没有物理表示
     Mesh out_mesh; // 创建输出网格
     if (lane.GetId() == 0) { // 如果车道ID为0
-        return std::make_unique<Mesh>(out_mesh); // 返回空网格
+        return std::make_unique<Mesh>(std::move(out_mesh)); // 返回空网格
     }
 
     double s_current = s_start; // 初始化当前的s值为起始位置
@@ -493,7 +495,7 @@ std::unique_ptr<Mesh> MeshFactory::GenerateLeftWall(
         lane.GetType() == road::Lane::LaneType::Sidewalk ? "sidewalk" : "road"); // 根据车道类型添加材质
     out_mesh.AddTriangleStrip(l_vertices); // 添加三角带
     out_mesh.EndMaterial(); // 结束材质定义
-    return std::make_unique<Mesh>(out_mesh); // 返回包含左墙的网格
+    return std::make_unique<Mesh>(std::move(out_mesh)); // 返回包含左墙的网格
   }
 
   std::vector<std::unique_ptr<Mesh>> MeshFactory::GenerateWithMaxLen(
@@ -524,7 +526,7 @@ std::vector<std::unique_ptr<Mesh>> MeshFactory::GenerateWithMaxLen(
         for (auto &&lane_pair : lane_section.GetLanes()) {  // 遍历车道段中的所有车道
           lane_section_mesh += *Generate(lane_pair.second, s_current, s_until);  // 生成车道的Mesh并累加
         }
-        mesh_uptr_list.emplace_back(std::make_unique<Mesh>(lane_section_mesh));  // 将生成的Mesh加入到列表中
+        mesh_uptr_list.emplace_back(std::make_unique<Mesh>(std::move(lane_section_mesh)));  // 将生成的Mesh加入到列表中
         s_current = s_until;  // 更新当前距离为本次生成的终点
       }
       if (s_end - s_current > EPSILON) {  // 如果还有剩余未处理的距离
@@ -532,7 +534,7 @@ std::vector<std::unique_ptr<Mesh>> MeshFactory::GenerateWithMaxLen(
         for (auto &&lane_pair : lane_section.GetLanes()) {  // 遍历车道段中的所有车道
           lane_section_mesh += *Generate(lane_pair.second, s_current, s_end);  // 生成剩余部分的Mesh并累加
         }
-        mesh_uptr_list.emplace_back(std::make_unique<Mesh>(lane_section_mesh));  // 将最后生成的Mesh加入到列表中
+        mesh_uptr_list.emplace_back(std::make_unique<Mesh>(std::move(lane_section_mesh)));  // 将最后生成的Mesh加入到列表中
       }
     }
     return mesh_uptr_list;  // 返回生成的Mesh列表
@@ -694,7 +696,7 @@ std::map<road::Lane::LaneType, std::vector<std::unique_ptr<Mesh>>> MeshFactory::
             lane_section_mesh += *GenerateRightWall(lane, s_current, s_until); // 生成右侧墙体并累加
           }
         }
-        mesh_uptr_list.emplace_back(std::make_unique<Mesh>(lane_section_mesh)); // 将生成的Mesh添加到列表
+        mesh_uptr_list.emplace_back(std::make_unique<Mesh>(std::move(lane_section_mesh))); // 将生成的Mesh添加到列表
         s_current = s_until; // 更新当前距离
       }
       if (s_end - s_current > EPSILON) { // 如果结束距离与当前距离之间的差值大于一个小值
@@ -708,7 +710,7 @@ std::map<road::Lane::LaneType, std::vector<std::unique_ptr<Mesh>>> MeshFactory::
             lane_section_mesh += *GenerateRightWall(lane, s_current, s_end); // 生成右侧墙体并累加
           }
         }
-        mesh_uptr_list.emplace_back(std::make_unique<Mesh>(lane_section_mesh)); // 将生成的Mesh添加到列表
+        mesh_uptr_list.emplace_back(std::make_unique<Mesh>(std::move(lane_section_mesh))); // 将生成的Mesh添加到列表
       }
     }
     return mesh_uptr_list; // 返回生成的Mesh列表
@@ -1177,7 +1179,7 @@ std::unique_ptr<Mesh> MeshFactory::MergeAndSmooth(std::vector<std::unique_ptr<Me
       out_mesh += *mesh;  // 将每个网格添加到输出网格中
     }
 
-    return std::make_unique<Mesh>(out_mesh);  // 返回新的网格对象
+    return std::make_unique<Mesh>(std::move(out_mesh));  // 返回新的网格对象
 }
 
 uint32_t MeshFactory::SelectVerticesInWidth(uint32_t default_num_vertices, road::Lane::LaneType type) {
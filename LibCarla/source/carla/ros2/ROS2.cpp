@@ -39,6 +39,7 @@
 #include "subscribers/CarlaSubscriber.h" // 引入Carla订阅者模块
 #include "subscribers/CarlaEgoVehicleControlSubscriber.h" // 引入自我车辆控制订阅者模块
 
+#include <algorithm> // 引入算法库
 #include <vector> // 引入向量库
 
 namespace carla {
@@ -69,6 +70,17 @@ enum ESensors { // 定义传感器枚举
   CameraGBufferUint8, // 相机G缓冲区（8位无符号整数）
   CameraGBufferFloat // 相机G缓冲区（浮点数）
 };
+
+// 序列化后的激光雷达测量中点数据的偏移：水平角度、通道数和每个通道的点数，
+// 布局与 SemanticLidarData 的头部相同
+static size_t GetLidarPointsOffset(const carla::BufferView &buffer) {
+  constexpr size_t header_size = 2u;
+  if (buffer.size() < header_size * sizeof(uint32_t)) {
+    return buffer.size();
+  }
+  const uint32_t channel_count = reinterpret_cast<const uint32_t *>(buffer.data())[1u];
+  return std::min<size_t>(buffer.size(), (header_size + channel_count) * sizeof(uint32_t));
+}
 // 启动或禁用ROS2系统
 // enabled是一个布尔值，表示是否启用ROS2
 // 设置_enabled 成员变量为传入的enable值
@@ -79,6 +91,38 @@ void ROS2::Enable(bool enable) { // 启用或禁用ROS2
   log_info("ROS2 enabled: ", _enabled); // 记录启用状态
   _clock_publisher = std::make_shared<CarlaClockPublisher>("clock", ""); // 创建时钟发布者
   _clock_publisher->Init(); // 初始化时钟发布者
+  if (_enabled && !_publish_queue) {
+    _publish_queue = std::make_unique<ROS2PublishQueue>(_publish_queue_depth); // 创建发布队列和发布线程
+  }
+}
+
+void ROS2::SetPublishQueueDepth(size_t depth) { // 设置发布队列深度
+  _publish_queue_depth = depth;
+  if (_publish_queue) {
+    _publish_queue->SetMaxQueueDepth(depth);
+  }
+}
+
+ROS2PublishQueue::Stats ROS2::GetPublishStats(void *actor) const { // 获取一个传感器的发布统计
+  return _publish_queue ? _publish_queue->GetStats(actor) : ROS2PublishQueue::Stats{};
+}
+
+ROS2PublishQueue::Stats ROS2::GetPublishStats() const { // 获取所有传感器的发布统计
+  return _publish_queue ? _publish_queue->GetTotalStats() : ROS2PublishQueue::Stats{};
+}
+
+void ROS2::FlushPublishQueue() { // 等待队列中的数据全部发布
+  if (_publish_queue) {
+    _publish_queue->Flush();
+  }
+}
+
+void ROS2::PublishAsync(void *actor, std::function<void()> task) { // 提交发布任务
+  if (_publish_queue) {
+    _publish_queue->Push(actor, std::move(task));
+  } else {
+    task();
+  }
 }
 // 设置当前帧，调用相应的回调函数
 // Frame是一个无符号64位整数，表示新的帧号
@@ -134,6 +178,9 @@ void ROS2::RemoveActorRosName(void *actor) { // 移除操作者的ROS名称
   _actor_ros_name.erase(actor); // 移除ROS名称
   _actor_parent_ros_name.erase(actor); // 移除父ROS名称
 
+  if (_publish_queue) {
+    _publish_queue->Remove(actor); // 丢弃尚未发布的数据
+  }
   _publishers.erase(actor); // 移除发布者
   _transforms.erase(actor); // 移除变换数据
 }
@@ -493,15 +540,45 @@ void ROS2::ProcessDataFromCamera(
     int W, int H, float Fov, // 宽度、高度、视场角
     const carla::SharedBufferView buffer,// 数据缓冲区
     void *actor) { // 操作者
+  // 发布者在调用线程中创建，发布在发布线程中进行；buffer 是共享的视图，不复制图像
+  std::pair<std::shared_ptr<CarlaPublisher>, std::shared_ptr<CarlaTransformPublisher>> sensors;
+  switch (sensor_type) {
+    case ESensors::DepthCamera:
+    case ESensors::NormalsCamera:
+    case ESensors::LaneInvasionSensor:
+    case ESensors::OpticalFlowCamera:
+    case ESensors::SceneCaptureCamera:
+    case ESensors::SemanticSegmentationCamera:
+    case ESensors::InstanceSegmentationCamera:
+      sensors = GetOrCreateSensor(static_cast<int>(sensor_type), stream_id, actor);
+      break;
+    default:
+      break;
+  }
+  const uint64_t frame = _frame;
+  const int32_t seconds = _seconds;
+  const uint32_t nanoseconds = _nanoseconds;
+  PublishAsync(actor, [=]() {
+    PublishCameraData(sensors, frame, seconds, nanoseconds, sensor_type, stream_id, sensor_transform, W, H, Fov, buffer);
+  });
+}
+
+void ROS2::PublishCameraData(
+    std::pair<std::shared_ptr<CarlaPublisher>, std::shared_ptr<CarlaTransformPublisher>> sensors,// 发布者和变换发布者
+    uint64_t frame, int32_t seconds, uint32_t nanoseconds,// 提交时的帧和时间戳
+    uint64_t sensor_type,// 传感器类型
+    carla::streaming::detail::stream_id_type stream_id,// 流ID
+    const carla::geom::Transform sensor_transform,// 传感器变换
+    int W, int H, float Fov, // 宽度、高度、视场角
+    const carla::SharedBufferView buffer) {// 数据缓冲区
 
   switch (sensor_type) { // 根据传感器类型进行处理
     case ESensors::CollisionSensor:// 碰撞传感器
-      log_info("Sensor Collision to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录碰撞传感器数据
+      log_info("Sensor Collision to ROS data: frame.", frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录碰撞传感器数据
       break;
     case ESensors::DepthCamera:// 深度相机
       {
-        log_info("Sensor DepthCamera to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录深度相机数据
-        auto sensors = GetOrCreateSensor(ESensors::DepthCamera, stream_id, actor);
+        log_info("Sensor DepthCamera to ROS data: frame.", frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录深度相机数据
         if (sensors.first) {// 如果存在第一个传感器
           std::shared_ptr<CarlaDepthCameraPublisher> publisher = std::dynamic_pointer_cast<CarlaDepthCameraPublisher>(sensors.first); // 转换为深度相机发布者
           const carla::sensor::s11n::ImageSerializer::ImageHeader *header =// 获取图像头信息
@@ -510,21 +587,20 @@ void ROS2::ProcessDataFromCamera(
             return;// 返回
           if (!publisher->HasBeenInitialized())// 如果发布者未初始化
             publisher->InitInfoData(0, 0, H, W, Fov, true); // 初始化信息数据
-          publisher->SetImageData(_seconds, _nanoseconds, header->height, header->width, (const uint8_t*) (buffer->data() + carla::sensor::s11n::ImageSerializer::header_offset));// 设置图像数据
-          publisher->SetCameraInfoData(_seconds, _nanoseconds);// 设置相机信息数据
+          publisher->SetImageData(seconds, nanoseconds, header->height, header->width, (const uint8_t*) (buffer->data() + carla::sensor::s11n::ImageSerializer::header_offset));// 设置图像数据
+          publisher->SetCameraInfoData(seconds, nanoseconds);// 设置相机信息数据
           publisher->Publish();// 发布数据
         }
         if (sensors.second) {// 如果存在第二个传感器
           std::shared_ptr<CarlaTransformPublisher> publisher = std::dynamic_pointer_cast<CarlaTransformPublisher>(sensors.second); // 转换为变换发布者
-          publisher->SetData(_seconds, _nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation);// 设置位置信息和旋转信息
+          publisher->SetData(seconds, nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation);// 设置位置信息和旋转信息
           publisher->Publish();// 发布数据
         }
       }
       break;
     case ESensors::NormalsCamera: // 法线相机
-      log_info("Sensor NormalsCamera to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录法线相机数据
+      log_info("Sensor NormalsCamera to ROS data: frame.", frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录法线相机数据
       {
-        auto sensors = GetOrCreateSensor(ESensors::NormalsCamera, stream_id, actor); // 获取或创建传感器
         if (sensors.first) { // 如果存在第一个传感器
           std::shared_ptr<CarlaNormalsCameraPublisher> publisher = std::dynamic_pointer_cast<CarlaNormalsCameraPublisher>(sensors.first);// 转换为法线相机发布者
           const carla::sensor::s11n::ImageSerializer::ImageHeader *header =// 获取图像头信息
@@ -533,37 +609,35 @@ void ROS2::ProcessDataFromCamera(
             return;// 返回
           if (!publisher->HasBeenInitialized())// 如果发布者未初始化
             publisher->InitInfoData(0, 0, H, W, Fov, true);// 初始化信息数据
-          publisher->SetImageData(_seconds, _nanoseconds, header->height, header->width, (const uint8_t*) (buffer->data() + carla::sensor::s11n::ImageSerializer::header_offset));// 设置图像数据
-          publisher->SetCameraInfoData(_seconds, _nanoseconds);// 设置相机信息数据
+          publisher->SetImageData(seconds, nanoseconds, header->height, header->width, (const uint8_t*) (buffer->data() + carla::sensor::s11n::ImageSerializer::header_offset));// 设置图像数据
+          publisher->SetCameraInfoData(seconds, nanoseconds);// 设置相机信息数据
           publisher->Publish();// 发布数据
         }
         if (sensors.second) {// 如果存在第二个传感器
           std::shared_ptr<CarlaTransformPublisher> publisher = std::dynamic_pointer_cast<CarlaTransformPublisher>(sensors.second); // 转换为变换发布者
-          publisher->SetData(_seconds, _nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation);// 设置位置信息和旋转信息
+          publisher->SetData(seconds, nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation);// 设置位置信息和旋转信息
           publisher->Publish(); // 发布数据
         }
       }
       break;
     case ESensors::LaneInvasionSensor:// 压线传感器
-      log_info("Sensor LaneInvasionSensor to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录压线传感器的数据到ROS，输出帧、传感器类型、流ID和缓冲区大小
+      log_info("Sensor LaneInvasionSensor to ROS data: frame.", frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录压线传感器的数据到ROS，输出帧、传感器类型、流ID和缓冲区大小
       {
-        auto sensors = GetOrCreateSensor(ESensors::LaneInvasionSensor, stream_id, actor);// 获取或创建压线传感器
         if (sensors.first) {// 如果第一个传感器存在
           std::shared_ptr<CarlaLineInvasionPublisher> publisher = std::dynamic_pointer_cast<CarlaLineInvasionPublisher>(sensors.first); // 转换为压线发布者
-          publisher->SetData(_seconds, _nanoseconds, (const int32_t*) buffer->data());// 设置数据
+          publisher->SetData(seconds, nanoseconds, (const int32_t*) buffer->data());// 设置数据
           publisher->Publish();// 发布数据
         }
         if (sensors.second) {// 如果第二个传感器存在
           std::shared_ptr<CarlaTransformPublisher> publisher = std::dynamic_pointer_cast<CarlaTransformPublisher>(sensors.second);// 转换为变换发布者
-          publisher->SetData(_seconds, _nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation);// 设置位置信息和旋转信息
+          publisher->SetData(seconds, nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation);// 设置位置信息和旋转信息
           publisher->Publish();// 发布数据
         }
       }
       break;
     case ESensors::OpticalFlowCamera:// 光流相机传感器
-      log_info("Sensor OpticalFlowCamera to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录光流相机的数据到ROS，输出帧、传感器类型、流ID和缓冲区大小
+      log_info("Sensor OpticalFlowCamera to ROS data: frame.", frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录光流相机的数据到ROS，输出帧、传感器类型、流ID和缓冲区大小
       {
-        auto sensors = GetOrCreateSensor(ESensors::OpticalFlowCamera, stream_id, actor);// 获取或创建光流相机传感器
         if (sensors.first) { // 如果第一个传感器存在
           std::shared_ptr<CarlaOpticalFlowCameraPublisher> publisher = std::dynamic_pointer_cast<CarlaOpticalFlowCameraPublisher>(sensors.first);// 转换为光流相机发布者
           const carla::sensor::s11n::OpticalFlowImageSerializer::ImageHeader *header =// 获取图像头信息
@@ -572,25 +646,24 @@ void ROS2::ProcessDataFromCamera(
             return;
           if (!publisher->HasBeenInitialized())// 如果发布者尚未初始化
             publisher->InitInfoData(0, 0, H, W, Fov, true);// 初始化信息数据
-          publisher->SetImageData(_seconds, _nanoseconds, header->height, header->width, (const float*) (buffer->data() + carla::sensor::s11n::OpticalFlowImageSerializer::header_offset));// 设置图像数据
-          publisher->SetCameraInfoData(_seconds, _nanoseconds);
+          publisher->SetImageData(seconds, nanoseconds, header->height, header->width, (const float*) (buffer->data() + carla::sensor::s11n::OpticalFlowImageSerializer::header_offset));// 设置图像数据
+          publisher->SetCameraInfoData(seconds, nanoseconds);
           publisher->Publish();// 发布数据
         }
         if (sensors.second) {// 如果第二个传感器存在
           std::shared_ptr<CarlaTransformPublisher> publisher = std::dynamic_pointer_cast<CarlaTransformPublisher>(sensors.second);// 转换为变换发布者
-          publisher->SetData(_seconds, _nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation);// 设置位置信息和旋转信息
+          publisher->SetData(seconds, nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation);// 设置位置信息和旋转信息
           publisher->Publish();// 发布数据
         }
       }
       break;
     case ESensors::RssSensor:// RSS传感器
-      log_info("Sensor RssSensor to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size()); // 记录RSS传感器的数据到ROS，输出帧、传感器类型、流ID和缓冲区大小
+      log_info("Sensor RssSensor to ROS data: frame.", frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size()); // 记录RSS传感器的数据到ROS，输出帧、传感器类型、流ID和缓冲区大小
       break;
     case ESensors::SceneCaptureCamera:// 场景捕捉相机传感器
     {
-      log_info("Sensor SceneCaptureCamera to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录场景捕捉相机的数据到ROS，输出帧、传感器类型、流ID和缓冲区大小
+      log_info("Sensor SceneCaptureCamera to ROS data: frame.", frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录场景捕捉相机的数据到ROS，输出帧、传感器类型、流ID和缓冲区大小
       {
-        auto sensors = GetOrCreateSensor(ESensors::SceneCaptureCamera, stream_id, actor);// 获取或创建场景捕捉相机传感器
         if (sensors.first) {// 如果第一个传感器存在
           std::shared_ptr<CarlaRGBCameraPublisher> publisher = std::dynamic_pointer_cast<CarlaRGBCameraPublisher>(sensors.first);// 设置图像数据
           const carla::sensor::s11n::ImageSerializer::ImageHeader *header =// 获取图像头信息
@@ -599,22 +672,21 @@ void ROS2::ProcessDataFromCamera(
             return;
           if (!publisher->HasBeenInitialized())// 如果发布者尚未初始化
             publisher->InitInfoData(0, 0, H, W, Fov, true);// 初始化信息数据
-          publisher->SetImageData(_seconds, _nanoseconds, header->height, header->width, (const uint8_t*) (buffer->data() + carla::sensor::s11n::ImageSerializer::header_offset));// 设置图像数据
-          publisher->SetCameraInfoData(_seconds, _nanoseconds);
+          publisher->SetImageData(seconds, nanoseconds, header->height, header->width, (const uint8_t*) (buffer->data() + carla::sensor::s11n::ImageSerializer::header_offset));// 设置图像数据
+          publisher->SetCameraInfoData(seconds, nanoseconds);
           publisher->Publish();// 发布数据
         }
         if (sensors.second) {// 如果第二个传感器存在
           std::shared_ptr<CarlaTransformPublisher> publisher = std::dynamic_pointer_cast<CarlaTransformPublisher>(sensors.second);// 转换为变换发布者
-          publisher->SetData(_seconds, _nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation); // 设置位置信息和旋转信息
+          publisher->SetData(seconds, nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation); // 设置位置信息和旋转信息
           publisher->Publish();// 发布数据
         }
       }
       break;
     }
     case ESensors::SemanticSegmentationCamera:// 语义分割相机
-      log_info("Sensor SemanticSegmentationCamera to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录信息：语义分割相机到ROS数据
+      log_info("Sensor SemanticSegmentationCamera to ROS data: frame.", frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录信息：语义分割相机到ROS数据
       {
-        auto sensors = GetOrCreateSensor(ESensors::SemanticSegmentationCamera, stream_id, actor);// 获取或创建传感器
         if (sensors.first) {// 如果第一个传感器存在
           std::shared_ptr<CarlaSSCameraPublisher> publisher = std::dynamic_pointer_cast<CarlaSSCameraPublisher>(sensors.first);// 转换为语义分割相机发布者
           const carla::sensor::s11n::ImageSerializer::ImageHeader *header =// 获取图像头信息
@@ -623,21 +695,20 @@ void ROS2::ProcessDataFromCamera(
             return;// 返回
           if (!publisher->HasBeenInitialized())// 如果发布者尚未初始化
             publisher->InitInfoData(0, 0, H, W, Fov, true);// 初始化信息数据
-          publisher->SetImageData(_seconds, _nanoseconds, header->height, header->width, (const uint8_t*) (buffer->data() + carla::sensor::s11n::ImageSerializer::header_offset));// 设置图像数据
-          publisher->SetCameraInfoData(_seconds, _nanoseconds); // 设置相机信息数据
+          publisher->SetImageData(seconds, nanoseconds, header->height, header->width, (const uint8_t*) (buffer->data() + carla::sensor::s11n::ImageSerializer::header_offset));// 设置图像数据
+          publisher->SetCameraInfoData(seconds, nanoseconds); // 设置相机信息数据
           publisher->Publish();// 发布数据
         }
         if (sensors.second) {// 如果第二个传感器存在
           std::shared_ptr<CarlaTransformPublisher> publisher = std::dynamic_pointer_cast<CarlaTransformPublisher>(sensors.second);// 转换为变换发布者
-          publisher->SetData(_seconds, _nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation);// 设置位置信息和旋转信息
+          publisher->SetData(seconds, nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation);// 设置位置信息和旋转信息
           publisher->Publish();// 发布数据
         }
       }
       break;// 结束该case
     case ESensors::InstanceSegmentationCamera:// 实例分割相机
-      log_info("Sensor InstanceSegmentationCamera to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录信息：实例分割相机到ROS数据
+      log_info("Sensor InstanceSegmentationCamera to ROS data: frame.", frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录信息：实例分割相机到ROS数据
       {
-        auto sensors = GetOrCreateSensor(ESensors::InstanceSegmentationCamera, stream_id, actor);// 获取或创建传感器
         if (sensors.first) { // 如果第一个传感器存在
           std::shared_ptr<CarlaISCameraPublisher> publisher = std::dynamic_pointer_cast<CarlaISCameraPublisher>(sensors.first);// 转换为实例分割相机发布者
           const carla::sensor::s11n::ImageSerializer::ImageHeader *header =// 获取图像头信息
@@ -646,28 +717,28 @@ void ROS2::ProcessDataFromCamera(
             return;// 返回
           if (!publisher->HasBeenInitialized())// 如果发布者尚未初始化
             publisher->InitInfoData(0, 0, H, W, Fov, true);// 初始化信息数据
-          publisher->SetImageData(_seconds, _nanoseconds, header->height, header->width, (const uint8_t*) (buffer->data() + carla::sensor::s11n::ImageSerializer::header_offset));// 设置图像数据
-          publisher->SetCameraInfoData(_seconds, _nanoseconds);// 设置相机信息数据
+          publisher->SetImageData(seconds, nanoseconds, header->height, header->width, (const uint8_t*) (buffer->data() + carla::sensor::s11n::ImageSerializer::header_offset));// 设置图像数据
+          publisher->SetCameraInfoData(seconds, nanoseconds);// 设置相机信息数据
           publisher->Publish();// 发布数据
         }
         if (sensors.second) { // 如果第二个传感器存在
           std::shared_ptr<CarlaTransformPublisher> publisher = std::dynamic_pointer_cast<CarlaTransformPublisher>(sensors.second);// 转换为变换发布者
-          publisher->SetData(_seconds, _nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation);// 设置位置信息和旋转信息
+          publisher->SetData(seconds, nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation);// 设置位置信息和旋转信息
           publisher->Publish();// 发布数据
         }
       }
       break;// 结束该case
     case ESensors::WorldObserver:// 世界观察者
-      log_info("Sensor WorldObserver to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录信息：世界观察者到ROS数据
+      log_info("Sensor WorldObserver to ROS data: frame.", frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录信息：世界观察者到ROS数据
       break;// 结束该case
     case ESensors::CameraGBufferUint8:// 相机G缓冲区（无符号8位）
-      log_info("Sensor CameraGBufferUint8 to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size()); // 记录信息：相机G缓冲区（无符号8位）到ROS数据
+      log_info("Sensor CameraGBufferUint8 to ROS data: frame.", frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size()); // 记录信息：相机G缓冲区（无符号8位）到ROS数据
       break;// 结束该case
     case ESensors::CameraGBufferFloat:// 相机G缓冲区（浮点型）
-      log_info("Sensor CameraGBufferFloat to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录信息：相机G缓冲区（浮点型）到ROS数据
+      log_info("Sensor CameraGBufferFloat to ROS data: frame.", frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录信息：相机G缓冲区（浮点型）到ROS数据
       break;// 结束该case
     default:// 默认情况
-      log_info("Sensor to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录信息：传感器到ROS数据
+      log_info("Sensor to ROS data: frame.", frame, "sensor.", sensor_type, "stream.", stream_id, "buffer.", buffer->size());// 记录信息：传感器到ROS数据
   }
 }
 
@@ -747,45 +818,56 @@ void ROS2::ProcessDataFromLidar(
     uint64_t sensor_type,// 传感器类型
     carla::streaming::detail::stream_id_type stream_id,// 数据流ID
     const carla::geom::Transform sensor_transform, // 传感器变换
-    carla::sensor::data::LidarData &data, // 激光雷达数据
+    const carla::SharedBufferView buffer, // 序列化后的激光雷达测量
     void *actor) {// 操作者
-  log_info("Sensor Lidar to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "points.", data._points.size());// 记录激光雷达传感器数据
+  const size_t offset = GetLidarPointsOffset(*buffer);// 跳过激光雷达头部
+  const size_t width = (buffer->size() - offset) / sizeof(float);// float 的个数，每个点 4 个
+  log_info("Sensor Lidar to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "points.", width / 4u);// 记录激光雷达传感器数据
   auto sensors = GetOrCreateSensor(ESensors::RayCastLidar, stream_id, actor);// 获取或创建传感器
-  if (sensors.first) {// 如果存在第一个传感器
-    std::shared_ptr<CarlaLidarPublisher> publisher = std::dynamic_pointer_cast<CarlaLidarPublisher>(sensors.first);// 将传感器转换为激光雷达发布者
-    size_t width = data._points.size();// 获取点云宽度
-    size_t height = 1;// 设置高度为1
-    publisher->SetData(_seconds, _nanoseconds, height, width, (float*)data._points.data());// 设置数据
-    publisher->Publish();// 发布数据
-  }
-  if (sensors.second) {// 如果存在第二个传感器
-    std::shared_ptr<CarlaTransformPublisher> publisher = std::dynamic_pointer_cast<CarlaTransformPublisher>(sensors.second);// 将传感器转换为变换发布者
-    publisher->SetData(_seconds, _nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation);// 设置变换数据
-    publisher->Publish();// 发布变换数据
-  }
+  const int32_t seconds = _seconds;
+  const uint32_t nanoseconds = _nanoseconds;
+  PublishAsync(actor, [=]() {
+    if (sensors.first) {// 如果存在第一个传感器
+      std::shared_ptr<CarlaLidarPublisher> publisher = std::dynamic_pointer_cast<CarlaLidarPublisher>(sensors.first);// 将传感器转换为激光雷达发布者
+      const size_t height = 1;// 设置高度为1
+      publisher->SetData(seconds, nanoseconds, height, width, reinterpret_cast<const float*>(buffer->data() + offset));// 设置数据
+      publisher->Publish();// 发布数据
+    }
+    if (sensors.second) {// 如果存在第二个传感器
+      std::shared_ptr<CarlaTransformPublisher> publisher = std::dynamic_pointer_cast<CarlaTransformPublisher>(sensors.second);// 将传感器转换为变换发布者
+      publisher->SetData(seconds, nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation);// 设置变换数据
+      publisher->Publish();// 发布变换数据
+    }
+  });
 }
 
 void ROS2::ProcessDataFromSemanticLidar(
     uint64_t sensor_type,// 传感器类型
     carla::streaming::detail::stream_id_type stream_id,// 流ID
     const carla::geom::Transform sensor_transform,// 传感器变换
-    carla::sensor::data::SemanticLidarData &data,// 语义激光雷达数据
+    const carla::SharedBufferView buffer,// 序列化后的语义激光雷达测量
     void *actor) {// 操作者
   static_assert(sizeof(float) == sizeof(uint32_t), "Invalid float size");// 确保float和uint32_t大小一致
-  log_info("Sensor SemanticLidar to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "points.", data._ser_points.size());// 记录日志：传感器语义激光雷达到ROS数据
+  static_assert(sizeof(carla::sensor::data::SemanticLidarDetection) == 6u * sizeof(float), "Invalid detection size");
+  const size_t offset = GetLidarPointsOffset(*buffer);// 跳过激光雷达头部
+  const size_t width = (buffer->size() - offset) / sizeof(carla::sensor::data::SemanticLidarDetection);// 点的数量
+  log_info("Sensor SemanticLidar to ROS data: frame.", _frame, "sensor.", sensor_type, "stream.", stream_id, "points.", width);// 记录日志：传感器语义激光雷达到ROS数据
   auto sensors = GetOrCreateSensor(ESensors::RayCastSemanticLidar, stream_id, actor);// 获取或创建传感器
-  if (sensors.first) {// 如果传感器存在
-    std::shared_ptr<CarlaSemanticLidarPublisher> publisher = std::dynamic_pointer_cast<CarlaSemanticLidarPublisher>(sensors.first);// 动态转换到CarlaSemanticLidarPublisher
-    size_t width = data._ser_points.size();// 点的数量
-    size_t height = 1; // 高度设为1
-    publisher->SetData(_seconds, _nanoseconds, 6, height, width, (float*)data._ser_points.data());// 设置数据
-    publisher->Publish();// 发布数据
-  }
-  if (sensors.second) {// 如果第二个传感器存在
-    std::shared_ptr<CarlaTransformPublisher> publisher = std::dynamic_pointer_cast<CarlaTransformPublisher>(sensors.second);// 动态转换到CarlaTransformPublisher
-    publisher->SetData(_seconds, _nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation); // 设置变换数据
-    publisher->Publish();// 发布变换数据
-  }
+  const int32_t seconds = _seconds;
+  const uint32_t nanoseconds = _nanoseconds;
+  PublishAsync(actor, [=]() {
+    if (sensors.first) {// 如果传感器存在
+      std::shared_ptr<CarlaSemanticLidarPublisher> publisher = std::dynamic_pointer_cast<CarlaSemanticLidarPublisher>(sensors.first);// 动态转换到CarlaSemanticLidarPublisher
+      const size_t height = 1; // 高度设为1
+      publisher->SetData(seconds, nanoseconds, 6, height, width, reinterpret_cast<const float*>(buffer->data() + offset));// 设置数据
+      publisher->Publish();// 发布数据
+    }
+    if (sensors.second) {// 如果第二个传感器存在
+      std::shared_ptr<CarlaTransformPublisher> publisher = std::dynamic_pointer_cast<CarlaTransformPublisher>(sensors.second);// 动态转换到CarlaTransformPublisher
+      publisher->SetData(seconds, nanoseconds, (const float*)&sensor_transform.location, (const float*)&sensor_transform.rotation); // 设置变换数据
+      publisher->Publish();// 发布变换数据
+    }
+  });
 }
 
 void ROS2::ProcessDataFromRadar(
@@ -851,6 +933,7 @@ void ROS2::ProcessDataFromCollisionSensor(
 // 重置时钟发布者和控制器
 // 将_enabled设置为false
 void ROS2::Shutdown() {// 关闭
+  _publish_queue.reset();// 发布剩余的数据并结束发布线程
   for (auto& element : _publishers) {// 遍历发布者
     element.second.reset();// 重置发布者
   }
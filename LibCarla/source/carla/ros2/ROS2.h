@@ -10,8 +10,10 @@
 #include "carla/BufferView.h" // 引入 Carla 缓冲区视图头文件
 #include "carla/geom/Transform.h" // 引入 Carla 变换几何头文件
 #include "carla/ros2/ROS2CallbackData.h" // 引入 ROS2 回调数据头文件
+#include "carla/ros2/ROS2PublishQueue.h" // 引入 ROS2 发布队列头文件
 #include "carla/streaming/detail/Types.h" // 引入 Carla 流媒体类型头文件
 
+#include <functional> // 引入函数对象头文件
 #include <unordered_set> // 引入无序集合头文件
 #include <unordered_map> // 引入无序映射头文件
 #include <memory> // 引入智能指针头文件
@@ -27,8 +29,6 @@ namespace carla {
   namespace sensor {
     namespace data {
       struct DVSEvent; // 声明 DVSEvent 结构
-      class LidarData; // 声明 LidarData 类
-      class SemanticLidarData; // 声明 SemanticLidarData 类
       class RadarData; // 声明 RadarData 类
     }
   }
@@ -78,6 +78,12 @@ class ROS2
   bool IsStreamEnabled(carla::streaming::detail::stream_id_type id) { return _publish_stream.count(id) > 0; } // 检查流是否启用
   void ResetStreams() { _publish_stream.clear(); } // 重置流
 
+  // 发布队列：相机和激光雷达数据在专用线程中发布
+  void SetPublishQueueDepth(size_t depth); // 设置每个发布者最多排队的帧数，超出时丢弃最旧的帧
+  ROS2PublishQueue::Stats GetPublishStats(void *actor) const; // 获取一个传感器的发布统计
+  ROS2PublishQueue::Stats GetPublishStats() const; // 获取所有传感器的发布统计
+  void FlushPublishQueue(); // 阻塞直到已提交的数据全部发布
+
   // 接收要发布的数据
   void ProcessDataFromCamera(
       uint64_t sensor_type,
@@ -111,14 +117,14 @@ class ROS2
       uint64_t sensor_type,
       carla::streaming::detail::stream_id_type stream_id,
       const carla::geom::Transform sensor_transform,
-      carla::sensor::data::LidarData &data,
-      void *actor = nullptr); // 处理来自激光雷达的数据
+      const carla::SharedBufferView buffer,
+      void *actor = nullptr); // 处理来自激光雷达的数据（序列化后的测量）
   void ProcessDataFromSemanticLidar(
       uint64_t sensor_type,
       carla::streaming::detail::stream_id_type stream_id,
       const carla::geom::Transform sensor_transform,
-      carla::sensor::data::SemanticLidarData &data,
-      void *actor = nullptr); // 处理来自语义激光雷达的数据
+      const carla::SharedBufferView buffer,
+      void *actor = nullptr); // 处理来自语义激光雷达的数据（序列化后的测量）
   void ProcessDataFromRadar(
       uint64_t sensor_type,
       carla::streaming::detail::stream_id_type stream_id,
@@ -143,6 +149,15 @@ class ROS2
 
  private: // 私有成员
  std::pair<std::shared_ptr<CarlaPublisher>, std::shared_ptr<CarlaTransformPublisher>> GetOrCreateSensor(int type, carla::streaming::detail::stream_id_type id, void* actor); // 获取或创建传感器
+ void PublishAsync(void *actor, std::function<void()> task); // 把发布任务放入发布队列，未启用时直接执行
+ void PublishCameraData(
+     std::pair<std::shared_ptr<CarlaPublisher>, std::shared_ptr<CarlaTransformPublisher>> sensors,
+     uint64_t frame, int32_t seconds, uint32_t nanoseconds,
+     uint64_t sensor_type,
+     carla::streaming::detail::stream_id_type stream_id,
+     const carla::geom::Transform sensor_transform,
+     int W, int H, float Fov,
+     const carla::SharedBufferView buffer); // 在发布线程中发布相机数据
 
 // 单例
 ROS2() {}; // 构造函数
@@ -161,6 +176,8 @@ std::unordered_map<void *, std::shared_ptr<CarlaPublisher>> _publishers; // 发
 std::unordered_map<void *, std::shared_ptr<CarlaTransformPublisher>> _transforms; // 变换发布者映射
 std::unordered_set<carla::streaming::detail::stream_id_type> _publish_stream; // 发布流集合
 std::unordered_map<void *, ActorCallback> _actor_callbacks; // Actor 回调映射
+size_t _publish_queue_depth { 2u }; // 每个发布者最多排队的帧数
+std::unique_ptr<ROS2PublishQueue> _publish_queue; // 发布队列，最后声明以便最先析构
 };
 
 } // namespace ros2
@@ -0,0 +1,232 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Logging.h" // 记录发布任务中抛出的异常
+#include "carla/NonCopyable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace carla {
+namespace ros2 {
+
+  /// 在专用线程中执行 ROS2 发布任务，传感器线程只需把任务放入队列。
+  ///
+  /// 每个发布者（以传感器 actor 为键）有一个有界队列，队列满时丢弃该发布者
+  /// 最旧的一帧：ROS2 订阅者只关心最新的数据，调用者永远不会阻塞。发布线程
+  /// 在有数据的发布者之间轮转，一个慢的发布者不会饿死其他发布者；同一发布者
+  /// 的任务按提交顺序执行。
+  class ROS2PublishQueue : private NonCopyable {
+  public:
+
+    using Clock = std::chrono::steady_clock;
+
+    /// 一个发布者（或全部发布者）的统计信息。
+    struct Stats {
+      size_t submitted = 0u;           ///< 放入队列的帧数
+      size_t published = 0u;           ///< 已发布的帧数（包括失败的）
+      size_t failed = 0u;              ///< 发布时抛出异常的帧数
+      size_t dropped = 0u;             ///< 因队列已满被丢弃的帧数
+      size_t depth = 0u;               ///< 当前排队的帧数
+      size_t max_depth = 0u;           ///< 同时排队的最大帧数
+      double average_latency_ms = 0.0; ///< 从入队到发布完成的平均时间
+      double max_latency_ms = 0.0;     ///< 从入队到发布完成的最长时间
+    };
+
+    explicit ROS2PublishQueue(size_t max_queue_depth = 2u)
+      : _max_queue_depth(std::max<size_t>(max_queue_depth, 1u)),
+        _thread([this]() { Run(); }) {}
+
+    /// 发布完队列中剩余的帧后结束线程。
+    ~ROS2PublishQueue() {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done = true;
+      }
+      _not_empty.notify_all();
+      if (_thread.joinable()) {
+        _thread.join();
+      }
+    }
+
+    /// 为 @a publisher 提交一个发布任务。
+    void Push(const void *publisher, std::function<void()> task) {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto &entry = _publishers[publisher];
+        if (entry.queue.empty()) {
+          _ready.push_back(publisher);
+        }
+        while (entry.queue.size() >= _max_queue_depth) {
+          entry.queue.pop_front();
+          ++entry.stats.dropped;
+        }
+        entry.queue.push_back({std::move(task), Clock::now()});
+        ++entry.stats.submitted;
+        entry.stats.max_depth = std::max(entry.stats.max_depth, entry.queue.size());
+      }
+      _not_empty.notify_one();
+    }
+
+    /// 丢弃 @a publisher 尚未发布的帧并删除其统计信息，在传感器销毁时调用。
+    void Remove(const void *publisher) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _publishers.erase(publisher);
+      _ready.erase(std::remove(_ready.begin(), _ready.end(), publisher), _ready.end());
+      NotifyIfIdle();
+    }
+
+    /// 阻塞直到已提交的帧全部发布。
+    void Flush() {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _idle.wait(lock, [this]() { return _ready.empty() && !_running; });
+    }
+
+    void SetMaxQueueDepth(size_t max_queue_depth) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _max_queue_depth = std::max<size_t>(max_queue_depth, 1u);
+    }
+
+    size_t GetMaxQueueDepth() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _max_queue_depth;
+    }
+
+    Stats GetStats(const void *publisher) const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto it = _publishers.find(publisher);
+      return it != _publishers.end() ? MakeStats(it->second) : Stats{};
+    }
+
+    /// 所有发布者的统计信息之和，最大值取各发布者中的最大值。
+    Stats GetTotalStats() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      Stats total;
+      double total_latency_ms = 0.0;
+      for (const auto &item : _publishers) {
+        const auto stats = MakeStats(item.second);
+        total.submitted += stats.submitted;
+        total.published += stats.published;
+        total.failed += stats.failed;
+        total.dropped += stats.dropped;
+        total.depth += stats.depth;
+        total.max_depth = std::max(total.max_depth, stats.max_depth);
+        total.max_latency_ms = std::max(total.max_latency_ms, stats.max_latency_ms);
+        total_latency_ms += item.second.total_latency_ms;
+      }
+      if (total.published > 0u) {
+        total.average_latency_ms = total_latency_ms / static_cast<double>(total.published);
+      }
+      return total;
+    }
+
+  private:
+
+    struct Task {
+      std::function<void()> function;
+      Clock::time_point enqueued;
+    };
+
+    struct Entry {
+      std::deque<Task> queue;
+      Stats stats;
+      double total_latency_ms = 0.0;
+    };
+
+    static Stats MakeStats(const Entry &entry) {
+      Stats stats = entry.stats;
+      stats.depth = entry.queue.size();
+      if (stats.published > 0u) {
+        stats.average_latency_ms = entry.total_latency_ms / static_cast<double>(stats.published);
+      }
+      return stats;
+    }
+
+    void NotifyIfIdle() {
+      if (_ready.empty() && !_running) {
+        _idle.notify_all();
+      }
+    }
+
+    void Run() {
+      for (;;) {
+        const void *publisher;
+        Task task;
+        {
+          std::unique_lock<std::mutex> lock(_mutex);
+          _not_empty.wait(lock, [this]() { return !_ready.empty() || _done; });
+          if (_ready.empty()) {
+            return; // _done 且没有剩余的帧
+          }
+          publisher = _ready.front();
+          _ready.pop_front();
+          auto &entry = _publishers[publisher];
+          task = std::move(entry.queue.front());
+          entry.queue.pop_front();
+          if (!entry.queue.empty()) {
+            _ready.push_back(publisher); // 轮到下一个发布者
+          }
+          _running = true;
+        }
+        bool failed = false;
+        try {
+          task.function();
+        } catch (const std::exception &e) {
+          log_error("ROS2PublishQueue: publish failed:", e.what());
+          failed = true;
+        } catch (...) {
+          log_error("ROS2PublishQueue: publish failed with unknown exception");
+          failed = true;
+        }
+        const std::chrono::duration<double, std::milli> latency = Clock::now() - task.enqueued;
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _running = false;
+          auto it = _publishers.find(publisher);
+          if (it != _publishers.end()) {
+            auto &stats = it->second.stats;
+            ++stats.published;
+            stats.failed += failed ? 1u : 0u;
+            stats.max_latency_ms = std::max(stats.max_latency_ms, latency.count());
+            it->second.total_latency_ms += latency.count();
+          }
+          NotifyIfIdle();
+        }
+      }
+    }
+
+    mutable std::mutex _mutex;
+
+    std::condition_variable _not_empty;
+
+    std::condition_variable _idle;
+
+    size_t _max_queue_depth;
+
+    std::unordered_map<const void *, Entry> _publishers;
+
+    /// 有待发布帧的发布者，每个发布者最多出现一次。
+    std::deque<const void *> _ready;
+
+    bool _running = false;
+
+    bool _done = false;
+
+    std::thread _thread;
+  };
+
+} // namespace ros2
+} // namespace carla
@@ -3,6 +3,7 @@
 #include "CarlaLidarPublisher.h"// 包含 CarlaLidarPublisher 类的声明
 
 #include <string>// 包含字符串处理功能
+#include <cstring>
 // 包含 CARLA ROS2 桥接所需的类型定义和监听器类
 #include "carla/ros2/types/PointCloud2PubSubTypes.h"
 #include "carla/ros2/listeners/CarlaListener.h"
@@ -217,43 +218,37 @@ namespace ros2 {
   }
 
   /**
- * @brief 设置激光雷达数据，处理并转换数据类型
+ * @brief 设置激光雷达数据
  *
- * 该函数接收激光雷达的原始浮点数据，将其中的某些值取反，然后转换为字节向量，
- * 并调用另一个重载的 SetData 函数来设置激光雷达数据。
+ * 一次遍历把点写入 DDS 消息自身的缓冲区，同时将 y 取反（UE4 使用左手坐标系），
+ * 不修改源数据，也不再为每帧分配临时的字节向量；消息缓冲区的容量在帧之间复用。
  *
  * @param seconds 时间戳的秒部分
  * @param nanoseconds 时间戳的纳秒部分
  * @param height 数据的高度（行数）
- * @param width 数据的宽度（列数），假设每个点包含4个浮数值（x, y, z, intensity）
+ * @param width 数据的宽度（float 个数），每个点包含4个浮点数值（x, y, z, intensity）
  * @param data 指向浮点数据数组的指针
  */
-void CarlaLidarPublisher::SetData(int32_t seconds, uint32_t nanoseconds, size_t height, size_t width, float* data) {
-    float* it = data;
-    float* end = &data[height * width];
-    for (++it; it < end; it += 4) {
-        *it *= -1.0f;// 将y值取反（假设data[1]是y值）
+void CarlaLidarPublisher::SetData(int32_t seconds, uint32_t nanoseconds, size_t height, size_t width, const float* data) {
+    SetMessageInfo(seconds, nanoseconds, height, width);
+    const size_t count = height * width;
+    std::vector<uint8_t>& message_data = _impl->_lidar.data();
+    message_data.resize(count * sizeof(float));
+    uint8_t* out = message_data.data();
+    for (size_t i = 0; i + 4 <= count; i += 4, out += 4 * sizeof(float)) {
+        const float point[4] = {data[i], -data[i + 1], data[i + 2], data[i + 3]};
+        std::memcpy(out, point, sizeof(point));
     }
-    std::vector<uint8_t> vector_data;
-    const size_t size = height * width * sizeof(float);
-    vector_data.resize(size);
-    std::memcpy(&vector_data[0], &data[0], size);// 将浮点数据复制到字节向量中
-    // 调用重载的SetData函数来设置处理后的数据
-    SetData(seconds, nanoseconds, height, width, std::move(vector_data));
   }
 /**
- * @brief 设置激光雷达数据
- *
- * 该函数接收时间戳、数据的高度和宽度，以及处理后的字节数据，
- * 然后设置激光雷达消息的各个字段。
+ * @brief 设置激光雷达消息的头部、点字段描述和尺寸
  *
  * @param seconds 时间戳的秒部分
  * @param nanoseconds 时间戳的纳秒部分
  * @param height 数据的高度（行数）
- * @param width 数据的宽度（每行点数），注意这里已经是处理后的宽度（原始宽度的1/4）
- * @param data 包含处理后的激光雷达数据的字节向量，按点（x, y, z, intensity）组织
+ * @param width 数据的宽度（float 个数），消息的宽度为其1/4
  */
-  void CarlaLidarPublisher::SetData(int32_t seconds, uint32_t nanoseconds, size_t height, size_t width, std::vector<uint8_t>&& data) {
+  void CarlaLidarPublisher::SetMessageInfo(int32_t seconds, uint32_t nanoseconds, size_t height, size_t width) {
     builtin_interfaces::msg::Time time;
     time.sec(seconds);
     time.nanosec(nanoseconds);
@@ -292,7 +287,6 @@ void CarlaLidarPublisher::SetData(int32_t seconds, uint32_t nanoseconds, size_t
     _impl->_lidar.point_step(point_size);// 设置每个点的步长
     _impl->_lidar.row_step(width * sizeof(float));// 设置每行的步长
     _impl->_lidar.is_dense(false); // 设置是否稠密（True表示没有无效点）
-    _impl->_lidar.data(std::move(data));// 设置点云数据
   }
   /**
  * @brief CarlaLidarPublisher 类的构造函数
@@ -40,14 +40,14 @@ namespace ros2 {
       bool Init();
       // ݵĺزֵָʾǷɹ
       bool Publish();
-      // ü״ݵĺʱ߶ȡȺָ
-      void SetData(int32_t seconds, uint32_t nanoseconds, size_t height, size_t width, float* data);
+      // ü״ݵĺʱ߶ȡȣfloat ָ룬޸Դ
+      void SetData(int32_t seconds, uint32_t nanoseconds, size_t height, size_t width, const float* data);
       // ǻ type() ش
       const char* type() const override { return "lidar"; }
 
     private:
-        // ˽ݵĺʱ߶ȡȺ rvalue ÷ʽݵ
-      void SetData(int32_t seconds, uint32_t nanoseconds, size_t height, size_t width, std::vector<uint8_t>&& data);
+        // Ϣͷֶͳߴ磬 SetData ֱдϢ
+      void SetMessageInfo(int32_t seconds, uint32_t nanoseconds, size_t height, size_t width);
 
     private:
         // ʹָ CarlaLidarPublisherImpl ʵ
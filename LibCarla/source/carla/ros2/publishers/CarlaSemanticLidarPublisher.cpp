@@ -3,6 +3,7 @@
 #include "CarlaSemanticLidarPublisher.h"// 引入Carla语义激光雷达发布者类的声明
 
 #include <string>// 引入字符串处理相关的标准库
+#include <cstring>
 // 引入CARLA ROS2桥接库中的点云数据类型和监听器类
 #include "carla/ros2/types/PointCloud2PubSubTypes.h"
 #include "carla/ros2/listeners/CarlaListener.h"
@@ -191,51 +192,42 @@ namespace ros2 {
     return false;
   }
   /**
- * @brief 设置激光雷达数据，包括时间戳、数据尺寸以及浮点数据数组，并对数据进行预处理。
+ * @brief 设置激光雷达数据，包括时间戳、数据尺寸以及浮点数据数组。
  *
- * 此函数首先遍历浮点数据数组（除了第一个元素），将其中的每个元素乘以-1（即取反）。
- * 然后，它将浮点数数据转换为字节序列，并调用另一个重载的SetData函数来设置处理后的数据。
+ * 一次遍历把每个点复制到 DDS 消息自身的缓冲区，同时将 y 取反（UE4 使用左手坐标系），
+ * 不修改源数据，也不再为每帧分配临时的字节向量。
  *
  * @param seconds 时间戳的秒部分
  * @param nanoseconds 时间戳的纳秒部分
  * @param elements 每个点的数据元素数量（例如，一个点可能包含x, y, z坐标等）
  * @param height 数据的高度（行数）
  * @param width 数据的宽度（列数）
- * @param data 指向浮点数据数组的指针，这些数据将被处理并用于设置激光雷达数据
+ * @param data 指向浮点数据数组的指针
  */
-void CarlaSemanticLidarPublisher::SetData(int32_t seconds, uint32_t nanoseconds, size_t elements, size_t height, size_t width, float* data) {
-    // 指向数据起始位置的迭代器
-    float* it = data;
-    // 指向数据结束位置的迭代器
-    float* end = &data[height * width * elements];
-    // 遍历数据（除了第一个元素），将每个元素乘以-1
-    for (++it; it < end; it += elements) {
-        *it *= -1.0f;
+void CarlaSemanticLidarPublisher::SetData(int32_t seconds, uint32_t nanoseconds, size_t elements, size_t height, size_t width, const float* data) {
+    SetMessageInfo(seconds, nanoseconds, height, width);
+    const size_t count = height * width * elements;
+    std::vector<uint8_t>& message_data = _impl->_lidar.data();
+    message_data.resize(count * sizeof(float));
+    uint8_t* out = message_data.data();
+    for (size_t i = 0; i + elements <= count; i += elements, out += elements * sizeof(float)) {
+        std::memcpy(out, data + i, elements * sizeof(float));
+        const float y = -data[i + 1];
+        std::memcpy(out + sizeof(float), &y, sizeof(y));
     }
-    // 用于存储转换后的字节数据的向量
-    std::vector<uint8_t> vector_data;
-    // 计算需要存储的字节数据的大小
-    const size_t size = height * width * sizeof(float) * elements;
-    // 调整向量的大小以匹配数据大小
-    vector_data.resize(size);
-    // 将浮点数据复制到字节数据向量中
-    std::memcpy(&vector_data[0], &data[0], size);
-    // 调用另一个重载的SetData函数来设置处理后的数据
-    SetData(seconds, nanoseconds, height, width, std::move(vector_data));
 }
 /**
- * @brief 设置激光雷达数据，包括时间戳、数据尺寸以及字节数据。
+ * @brief 设置激光雷达消息的头部和尺寸。
  *
- * 此函数创建并设置ROS消息头（Header）、点字段描述符（PointField）以及激光雷达数据（Lidar）的相关属性。
- * 它使用提供的时间戳、高度、宽度和字节数据来填充这些属性，并准备激光雷达数据以供发布。
+ * 此函数创建并设置ROS消息头（Header）、点字段描述符（PointField）以及激光雷达数据（Lidar）的相关属性，
+ * 点数据由 SetData 直接写入消息。
  *
  * @param seconds 时间戳的秒部分
  * @param nanoseconds 时间戳的纳秒部分
  * @param height 数据的高度（行数）
  * @param width 数据的宽度（点数/列数）
- * @param data 包含激光雷达点数据的字节向量，这些数据将被直接用于设置激光雷达消息的数据部分
  */
-void CarlaSemanticLidarPublisher::SetData(int32_t seconds, uint32_t nanoseconds, size_t height, size_t width, std::vector<uint8_t>&& data) {
+void CarlaSemanticLidarPublisher::SetMessageInfo(int32_t seconds, uint32_t nanoseconds, size_t height, size_t width) {
     // 创建并设置时间戳消息
     builtin_interfaces::msg::Time time;
     time.sec(seconds);
@@ -286,7 +278,6 @@ void CarlaSemanticLidarPublisher::SetData(int32_t seconds, uint32_t nanoseconds,
     _impl->_lidar.point_step(point_size);// 设置每个点的步长（即每个点的大小）
     _impl->_lidar.row_step(width * point_size);// 设置每行的步长（即每行的总大小）
     _impl->_lidar.is_dense(false); // 设置是否稠密，false表示可能存在无效点
-    _impl->_lidar.data(std::move(data));// 设置激光雷达数据
   }
 /**
  * @brief CarlaSemanticLidarPublisher类的构造函数。
@@ -26,11 +26,11 @@ namespace ros2 {
 
       bool Init();// 初始化方法，准备发布数据。
       bool Publish();// 发布数据的方法。
-      void SetData(int32_t seconds, uint32_t nanoseconds, size_t elements, size_t height, size_t width, float* data); // 设置数据，包括时间戳和点云数据。
+      void SetData(int32_t seconds, uint32_t nanoseconds, size_t elements, size_t height, size_t width, const float* data); // 设置数据，包括时间戳和点云数据，不修改源数据。
       const char* type() const override { return "semantic lidar"; } // 返回发布数据的类型。
 
     private:
-      void SetData(int32_t seconds, uint32_t nanoseconds, size_t height, size_t width, std::vector<uint8_t>&& data);// 私有方法，设置数据，包括时间戳和点云数据的另一种形式。
+      void SetMessageInfo(int32_t seconds, uint32_t nanoseconds, size_t height, size_t width);// 设置消息头、点字段描述和尺寸，点数据由 SetData 直接写入消息。
 
     private:
       std::shared_ptr<CarlaSemanticLidarPublisherImpl> _impl;// 一个指向内部实现类的智能指针。
@@ -12,11 +12,16 @@
 // 包含 "carla/rpc/Metadata.h" 头文件，推测这个头文件中定义了和元数据（Metadata）相关的类型、函数等，
 // 可能在后续的远程过程调用（RPC）操作中用于传递额外的描述信息、控制调用行为等。
 #include "carla/rpc/Metadata.h"
+#include "carla/profiler/Metrics.h"
 
 // 包含 <rpc/client.h> 头文件，应该是引入了一个基础的RPC客户端相关的库，
 // 提供了诸如建立连接、发送请求、接收响应等与远程服务交互的底层功能。
 #include <rpc/client.h>
 
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 // 定义了名为carla的命名空间，用于将整个Carla项目相关的代码在逻辑上进行统一组织，
 // 这样可以有效避免代码中的命名冲突，使代码结构更清晰，便于代码的维护和扩展。
 namespace carla {
@@ -56,9 +61,18 @@ namespace carla {
             // 在调用底层 _client 的 call 方法时，除了传入函数名和转发的参数外，还传入了 Metadata::MakeSync()，
             // 推测是告知底层此次调用是同步的，并传递一些相关的元数据信息用于控制调用过程，
             // 最后返回远程调用的结果，结果类型由底层的RPC调用返回类型决定。
+            // 每次调用的耗时记入 carla_rpc_call_duration_seconds，抛出异常的调用
+            // 记入 carla_rpc_call_errors_total，两者都以函数名为标签。
             template <typename... Args>
             auto call(const std::string &function, Args &&... args) {
-                return _client.call(function, Metadata::MakeSync(), std::forward<Args>(args)...);
+                auto &metrics = GetCallMetrics(function);
+                profiler::ScopedMetricTimer timer(metrics.duration);
+                try {
+                    return _client.call(function, Metadata::MakeSync(), std::forward<Args>(args)...);
+                } catch (...) {
+                    metrics.errors.Increment();
+                    throw;
+                }
             }
 
             // 此方法用于发起一个异步的远程过程调用（RPC）。
@@ -67,14 +81,59 @@ namespace carla {
             // 和转发的参数，以此实现异步调用的发起，而该方法本身无返回值，因为异步调用结果通常需要通过其他方式（比如回调函数等）来获取。
             template <typename... Args>
             void async_call(const std::string &function, Args &&... args) {
+                GetAsyncCallCounter(function).Increment();
                 _client.async_call(function, Metadata::MakeAsync(), std::forward<Args>(args)...);
             }
 
         private:
+
+            // 一个函数的同步调用指标。
+            struct CallMetrics {
+                profiler::MetricHistogram &duration;
+                profiler::MetricCounter &errors;
+            };
+
+            static std::string MakeLabels(const std::string &function) {
+                return "function=\"" + function + "\"";
+            }
+
+            // 指标按函数名缓存在本客户端中，只有每个函数第一次调用时才查找
+            // 全局的注册表
+            CallMetrics &GetCallMetrics(const std::string &function) {
+                std::lock_guard<std::mutex> lock(_metrics_mutex);
+                auto it = _call_metrics.find(function);
+                if (it == _call_metrics.end()) {
+                    auto &registry = profiler::MetricsRegistry::Get();
+                    const auto labels = MakeLabels(function);
+                    it = _call_metrics.emplace(function, CallMetrics{
+                        registry.GetHistogram(
+                            "carla_rpc_call_duration_seconds", "Duration of synchronous RPC calls.", labels),
+                        registry.GetCounter(
+                            "carla_rpc_call_errors_total", "Synchronous RPC calls that failed.", labels)}).first;
+                }
+                return it->second;
+            }
+
+            profiler::MetricCounter &GetAsyncCallCounter(const std::string &function) {
+                std::lock_guard<std::mutex> lock(_metrics_mutex);
+                auto it = _async_call_counters.find(function);
+                if (it == _async_call_counters.end()) {
+                    it = _async_call_counters.emplace(function, &profiler::MetricsRegistry::Get().GetCounter(
+                        "carla_rpc_async_calls_total", "Asynchronous RPC calls sent.", MakeLabels(function))).first;
+                }
+                return *it->second;
+            }
+
             // 定义了一个私有成员变量 _client，类型为 ::rpc::client，
             // 它是底层实际用于和远程服务进行交互的RPC客户端对象，
             // 本类（Client）中的各种方法基本都是围绕对这个底层客户端对象的操作来实现与远程服务通信功能的。
             ::rpc::client _client;
+
+            std::mutex _metrics_mutex;
+
+            std::unordered_map<std::string, CallMetrics> _call_metrics;
+
+            std::unordered_map<std::string, profiler::MetricCounter *> _async_call_counters;
         };
 
     } // namespace rpc
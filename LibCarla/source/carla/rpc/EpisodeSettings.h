@@ -60,10 +60,14 @@ namespace rpc {
     // 是否将观众视为自我，默认为 true
     bool spectator_as_ego = true;
 
+    // 世界状态流的关键帧间隔（帧数），0 表示每帧发送完整状态；
+    // 大于 0 时两个关键帧之间只发送发生变化的参与者
+    uint32_t state_keyframe_interval = 0u;
+
     // 使用 MSGPACK_DEFINE_ARRAY 宏将类的成员变量按顺序打包到 msgpack 中，用于序列化
     MSGPACK_DEFINE_ARRAY(synchronous_mode, no_rendering_mode, fixed_delta_seconds, substepping,
         max_substep_delta_time, max_substeps, max_culling_distance, deterministic_ragdolls,
-        tile_stream_distance, actor_active_distance, spectator_as_ego);
+        tile_stream_distance, actor_active_distance, spectator_as_ego, state_keyframe_interval);
 
     // =========================================================================
     // -- 构造函数 --------------------------------------------------------------
@@ -84,7 +88,8 @@ namespace rpc {
         bool deterministic_ragdolls = true,
         float tile_stream_distance = 3000.f,
         float actor_active_distance = 2000.f,
-        bool spectator_as_ego = true)
+        bool spectator_as_ego = true,
+        uint32_t state_keyframe_interval = 0u)
       : synchronous_mode(synchronous_mode),
         no_rendering_mode(no_rendering_mode),
         fixed_delta_seconds(
@@ -96,7 +101,8 @@ namespace rpc {
         deterministic_ragdolls(deterministic_ragdolls),
         tile_stream_distance(tile_stream_distance),
         actor_active_distance(actor_active_distance),
-        spectator_as_ego(spectator_as_ego) {}
+        spectator_as_ego(spectator_as_ego),
+        state_keyframe_interval(state_keyframe_interval) {}
 
     // =========================================================================
     // -- 比较操作符 ------------------------------------------------------------
@@ -115,7 +121,8 @@ namespace rpc {
           (deterministic_ragdolls == rhs.deterministic_ragdolls) &&
           (tile_stream_distance == rhs.tile_stream_distance) &&
           (actor_active_distance == rhs.actor_active_distance) &&
-          (spectator_as_ego == rhs.spectator_as_ego);
+          (spectator_as_ego == rhs.spectator_as_ego) &&
+          (state_keyframe_interval == rhs.state_keyframe_interval);
     }
 
     // 重载!= 操作符，使用 == 操作符的结果取反
@@ -141,7 +148,8 @@ namespace rpc {
             Settings.bDeterministicRagdolls,
             Settings.TileStreamingDistance,
             Settings.ActorActiveDistance,
-            Settings.SpectatorAsEgo) {
+            Settings.SpectatorAsEgo,
+            Settings.StateKeyframeInterval) {
       constexpr float CMTOM = 1.f/100.f;
       tile_stream_distance = CMTOM * Settings.TileStreamingDistance;
       actor_active_distance = CMTOM * Settings.ActorActiveDistance;
@@ -164,6 +172,7 @@ namespace rpc {
       Settings.TileStreamingDistance = MTOCM * tile_stream_distance;
       Settings.ActorActiveDistance = MTOCM * actor_active_distance;
       Settings.SpectatorAsEgo = spectator_as_ego;
+      Settings.StateKeyframeInterval = state_keyframe_interval;
 
       return Settings;
     }
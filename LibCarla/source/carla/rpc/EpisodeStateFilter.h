@@ -0,0 +1,62 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/MsgPack.h" // 过滤条件需要通过 RPC 发送给服务器
+#include "carla/rpc/ActorId.h"
+
+#include <cstdint>
+
+namespace carla {
+namespace rpc {
+
+  /// 世界状态过滤使用的参与者类型掩码，可以按位组合
+  enum class ActorTypeMask : uint8_t {
+    None         = 0u,
+    Vehicle      = (0x1 << 0),
+    Walker       = (0x1 << 1),
+    TrafficLight = (0x1 << 2),
+    TrafficSign  = (0x1 << 3),
+    Sensor       = (0x1 << 4),
+    Other        = (0x1 << 5),
+    All          = 0xFF
+  };
+
+  /// 单个订阅的世界状态兴趣区域。服务器在序列化之前应用过滤，
+  /// 订阅者只接收满足条件的参与者；自我参与者总是包含在内。
+  class EpisodeStateFilter {
+  public:
+
+    EpisodeStateFilter() = default;
+
+    EpisodeStateFilter(ActorId in_ego_id, float in_radius, uint8_t in_type_mask)
+      : ego_id(in_ego_id),
+        radius(in_radius),
+        type_mask(in_type_mask) {}
+
+    /// 距离过滤的中心参与者，0 表示不按距离过滤
+    ActorId ego_id = 0u;
+
+    /// 距离自我参与者的最大距离（米），小于等于 0 表示不按距离过滤
+    float radius = 0.0f;
+
+    /// 允许的参与者类型，ActorTypeMask 的按位组合
+    uint8_t type_mask = static_cast<uint8_t>(ActorTypeMask::All);
+
+    bool HasRadius() const {
+      return ego_id != 0u && radius > 0.0f;
+    }
+
+    bool IsTypeAllowed(ActorTypeMask type) const {
+      return (type_mask & static_cast<uint8_t>(type)) != 0u;
+    }
+
+    MSGPACK_DEFINE_ARRAY(ego_id, radius, type_mask);
+  };
+
+} // namespace rpc
+} // namespace carla
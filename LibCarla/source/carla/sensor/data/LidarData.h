@@ -82,6 +82,14 @@ public:
         << "property float32 I";
   }
 
+  // 向输出流写入PCD文件头中的字段描述
+  void WritePcdHeaderInfo(std::ostream& out) const {
+    out << "FIELDS x y z intensity\n"
+        << "SIZE 4 4 4 4\n"
+        << "TYPE F F F F\n"
+        << "COUNT 1 1 1 1";
+  }
+
       void WriteDetection(std::ostream& out) const{
       // 写入检测点的x, y, z坐标和强度，以空格分隔
         out << point.x << ' ' << point.y << ' ' << point.z << ' ' << intensity;
@@ -149,3 +157,7 @@ private:
   friend class s11n::LidarHeaderView;
   friend class carla::ros2::ROS2;
 };
+
+} // namespace data
+} // namespace sensor
+} // namespace carla
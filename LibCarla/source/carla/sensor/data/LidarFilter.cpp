@@ -0,0 +1,95 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/sensor/data/LidarFilter.h"
+
+#include "carla/Buffer.h"
+#include "carla/sensor/Deserializer.h" // 由过滤后的缓冲区重新构造测量
+#include "carla/sensor/data/LidarMeasurement.h"
+#include "carla/sensor/data/SemanticLidarMeasurement.h"
+#include "carla/sensor/s11n/SensorHeaderSerializer.h"
+
+#include <boost/asio/buffer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace carla {
+namespace sensor {
+namespace data {
+
+  /// 过滤 @a measurement 的点，并按传感器序列化的布局（传感器头部、
+  /// 激光雷达头部、点）写入新的缓冲区后反序列化。
+  template <typename MeasurementT>
+  static SharedPtr<MeasurementT> FilterMeasurement(
+      const RawData &raw_data,
+      const MeasurementT &measurement,
+      const pointcloud::PointCloudFilterSettings &settings) {
+    // 激光雷达头部的布局：水平角度、通道数、每个通道的点数，见 SemanticLidarData
+    constexpr size_t HORIZONTAL_ANGLE = 0u;
+    constexpr size_t CHANNEL_COUNT = 1u;
+    constexpr size_t HEADER_SIZE = 2u;
+    const size_t channel_count = measurement.GetChannelCount();
+    std::vector<uint32_t> channel_counts(channel_count);
+    for (size_t channel = 0u; channel < channel_count; ++channel) {
+      channel_counts[channel] = measurement.GetPointCount(channel);
+    }
+    const auto filtered = pointcloud::PointCloudFilter::Apply(
+        measurement.data(), channel_counts, settings);
+
+    std::vector<uint32_t> lidar_header(HEADER_SIZE + channel_count);
+    const float horizontal_angle = measurement.GetHorizontalAngle();
+    std::memcpy(&lidar_header[HORIZONTAL_ANGLE], &horizontal_angle, sizeof(horizontal_angle));
+    lidar_header[CHANNEL_COUNT] = static_cast<uint32_t>(channel_count);
+    std::copy(
+        filtered.channel_counts.begin(),
+        filtered.channel_counts.end(),
+        lidar_header.begin() + HEADER_SIZE);
+
+    const auto sensor_header = s11n::SensorHeaderSerializer::Serialize(
+        raw_data.GetSensorTypeId(),
+        raw_data.GetFrame(),
+        raw_data.GetTimestamp(),
+        raw_data.GetSensorTransform());
+    std::array<boost::asio::const_buffer, 3u> sequence = {
+        sensor_header.cbuffer(),
+        boost::asio::buffer(lidar_header),
+        boost::asio::buffer(filtered.points)};
+    Buffer buffer;
+    buffer.copy_from(sequence);
+    return boost::static_pointer_cast<MeasurementT>(Deserializer::Deserialize(std::move(buffer)));
+  }
+
+  SharedPtr<LidarMeasurement> LidarMeasurement::Filter(
+      const pointcloud::PointCloudFilterSettings &settings) const {
+    return FilterMeasurement(GetRawData(), *this, settings);
+  }
+
+  SharedPtr<SemanticLidarMeasurement> SemanticLidarMeasurement::Filter(
+      const pointcloud::PointCloudFilterSettings &settings) const {
+    return FilterMeasurement(GetRawData(), *this, settings);
+  }
+
+  SharedPtr<SensorData> FilterPointCloud(
+      SharedPtr<SensorData> data,
+      const pointcloud::PointCloudFilterSettings &settings) {
+    if (!settings.IsEnabled()) {
+      return data;
+    }
+    if (auto lidar = boost::dynamic_pointer_cast<LidarMeasurement>(data)) {
+      return lidar->Filter(settings);
+    }
+    if (auto semantic_lidar = boost::dynamic_pointer_cast<SemanticLidarMeasurement>(data)) {
+      return semantic_lidar->Filter(settings);
+    }
+    return data;
+  }
+
+} // namespace data
+} // namespace sensor
+} // namespace carla
@@ -0,0 +1,27 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+#include "carla/pointcloud/PointCloudFilter.h"
+
+namespace carla {
+namespace sensor {
+
+  class SensorData;
+
+namespace data {
+
+  /// 如果 @a data 是激光雷达或语义激光雷达的测量，返回按 @a settings
+  /// 过滤后的测量，否则原样返回。用于在反序列化之后、用户回调之前过滤。
+  SharedPtr<SensorData> FilterPointCloud(
+      SharedPtr<SensorData> data,
+      const pointcloud::PointCloudFilterSettings &settings);
+
+} // namespace data
+} // namespace sensor
+} // namespace carla
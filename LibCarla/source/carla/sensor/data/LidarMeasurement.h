@@ -8,6 +8,8 @@
 // 预处理指令，确保该头文件在整个项目编译过程中只会被包含一次
 #include "carla/Debug.h"
 // 引入carla项目中与调试相关的头文件
+#include "carla/Memory.h"
+#include "carla/pointcloud/PointCloudFilter.h" // 点云过滤参数
 #include "carla/rpc/Location.h"
 // 引入carla项目里rpc模块下关于Location（通常用于表示位置信息）的头文件
 #include "carla/sensor/data/Array.h"
@@ -76,6 +78,10 @@ namespace data {
  // 还是先获取头部信息，然后调用头部信息对象的GetPointCount函数，并传入指定的通道索引（channel）来获取对应通道的点数并返回
  // 由于点是按照通道进行排序的，所以这个函数可以帮助确定每个点是由哪个通道生成的。
 
+    /// 按 @a settings 过滤点云，返回新的测量。帧、时间戳、传感器变换和
+    /// 水平角度不变，各通道的点数按过滤结果更新。
+    SharedPtr<LidarMeasurement> Filter(const pointcloud::PointCloudFilterSettings &settings) const;
+
   };
 
 } // namespace data
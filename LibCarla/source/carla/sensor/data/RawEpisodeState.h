@@ -11,6 +11,8 @@
 #include "carla/sensor/data/Array.h"
 #include "carla/sensor/s11n/EpisodeStateSerializer.h"
 
+#include <cstdint>
+
 // 定义在carla命名空间下的sensor命名空间，再嵌套一个data命名空间，用于对传感器相关数据结构等进行更细分的组织
 namespace carla {
 namespace sensor {
@@ -29,7 +31,9 @@ namespace data {
 
 // 显式构造函数，接受一个右值引用的RawData类型参数，用于初始化基类Array，通过调用Serializer的header_offset和移动传入的数据来完成初始化
     explicit RawEpisodeState(RawData &&data)
-      : Super(Serializer::header_offset, std::move(data)) {}
+      : Super(std::move(data), [](const RawData &d) {
+          return Serializer::GetActorStatesOffset(d);
+        }) {}
 
   private:
 
@@ -69,6 +73,58 @@ namespace data {
       return GetHeader().simulation_state;
     }
 
+    /// 是否为增量帧。增量帧只包含自基准帧以来发生变化的参与者，
+    /// 需要在基准帧的状态之上应用。
+    bool IsDelta() const {
+      return Serializer::IsDelta(Super::GetRawData());
+    }
+
+    /// 增量帧所基于的帧编号，仅在 IsDelta 为真时有效。
+    uint64_t GetBaseFrame() const {
+      return Serializer::DeserializeDeltaHeader(Super::GetRawData()).base_frame;
+    }
+
+    /// 自基准帧以来被销毁的参与者数量，仅在 IsDelta 为真时有效。
+    size_t GetRemovedActorCount() const {
+      return IsDelta() ? Serializer::DeserializeDeltaHeader(Super::GetRawData()).removed_count : 0u;
+    }
+
+    /// 消息是否携带新生成的参与者的描述。
+    bool HasActorDescriptions() const {
+      return Serializer::HasActorDescriptions(Super::GetRawData());
+    }
+
+    /// 以 MsgPack 编码的新生成参与者描述（std::vector<rpc::Actor>），
+    /// 长度为 GetActorDescriptionsSize()。
+    const unsigned char *GetActorDescriptionsData() const {
+      return Super::GetRawData().begin() +
+          Serializer::GetActorDescriptionsOffset(Super::GetRawData()) +
+          sizeof(Serializer::DescriptionsHeader);
+    }
+
+    size_t GetActorDescriptionsSize() const {
+      return Serializer::GetActorDescriptionsSize(Super::GetRawData());
+    }
+
+    /// 自基准帧以来被销毁的参与者 ID 数组，长度为 GetRemovedActorCount()。
+    const ActorId *GetRemovedActorIds() const {
+      return reinterpret_cast<const ActorId *>(
+          Super::GetRawData().begin() + Serializer::delta_header_offset);
+    }
+
+    /// 按过滤条件被过滤掉、但仍然存在的参与者数量。
+    size_t GetFilteredOutActorCount() const {
+      return Serializer::GetFilteredOutActorCount(Super::GetRawData());
+    }
+
+    /// 被过滤掉的参与者 ID 数组，长度为 GetFilteredOutActorCount()。
+    const ActorId *GetFilteredOutActorIds() const {
+      return reinterpret_cast<const ActorId *>(
+          Super::GetRawData().begin() +
+          Serializer::GetFilteredOutActorsOffset(Super::GetRawData()) +
+          sizeof(Serializer::FilteredOutHeader));
+    }
+
   };
 
 } // namespace data
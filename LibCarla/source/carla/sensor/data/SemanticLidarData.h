@@ -88,6 +88,14 @@ namespace data {
            "property uint32 ObjIdx\n" \
            "property uint32 ObjTag";
       }
+/// @brief 将该检测点的字段描述以PCD文件头的形式写入到给定的输出流中。
+/// @param out 指向输出流对象的引用，用于写入数据
+      void WritePcdHeaderInfo(std::ostream& out) const{
+        out << "FIELDS x y z CosAngle ObjIdx ObjTag\n" \
+           "SIZE 4 4 4 4 4 4\n" \
+           "TYPE F F F F U U\n" \
+           "COUNT 1 1 1 1 1 1";
+      }
 /// @brief 将该检测点的具体数据（坐标、夹角余弦值、物体索引和语义标签）写入到给定的输出流中，用于将单个检测点的数据输出到流中，可能用于保存数据或者传输等操作。
  /// @param out 指向输出流对象（例如文件输出流等）的引用，用于写入数据     
       void WriteDetection(std::ostream& out) const{
@@ -7,6 +7,8 @@
 #pragma once // 指示这个头文件只应该被包含一次
 
 #include "carla/Debug.h" // 包含CARLA的调试功能
+#include "carla/Memory.h"
+#include "carla/pointcloud/PointCloudFilter.h" // 点云过滤参数
 #include "carla/rpc/Location.h" // 包含CARLA的RPC位置定义
 #include "carla/sensor/data/Array.h" // 包含CARLA传感器数据数组定义
 #include "carla/sensor/s11n/SemanticLidarSerializer.h"
@@ -53,6 +55,10 @@ namespace data {
     auto GetPointCount(size_t channel) const { // 获取特定通道生成的点的数量
       return GetHeader().GetPointCount(channel); // 从头部信息中获取特定通道的点的数量
     }
+
+    /// 按 @a settings 过滤点云，返回新的测量。帧、时间戳、传感器变换和
+    /// 水平角度不变，各通道的点数按过滤结果更新。
+    SharedPtr<SemanticLidarMeasurement> Filter(const pointcloud::PointCloudFilterSettings &settings) const;
   };
 
 } // namespace data
@@ -11,10 +11,13 @@
 #include "carla/Memory.h"  // 包含智能指针和内存管理工具
 #include "carla/geom/Transform.h"  // 包含几何变换工具，例如位姿和旋转
 #include "carla/geom/Vector3DInt.h"  // 包含整数三维向量定义
+#include "carla/rpc/EpisodeStateFilter.h"  // 参与者类型掩码，决定类型相关状态中有效的成员
 #include "carla/sensor/RawData.h"// 包含传感器原始数据的相关定义
 #include "carla/sensor/data/ActorDynamicState.h"  // 包含动态对象状态的定义
 
+#include <cmath> // std::abs
 #include <cstdint>// 标准库，用于固定宽度的整数类型
+#include <cstring> // std::strncmp
 
 namespace carla {
 namespace sensor {
@@ -30,7 +33,10 @@ namespace s11n {
     enum SimulationState {  //枚举类，用于表示模拟状态的类型
       None               = (0x0 << 0),  // 默认状态，无特定更新
       MapChange          = (0x1 << 0),  // 表示地图变更的状态
-      PendingLightUpdate = (0x1 << 1)  // 表示待处理的交通信号灯更新
+      PendingLightUpdate = (0x1 << 1),  // 表示待处理的交通信号灯更新
+      Delta              = (0x1 << 2),  // 表示增量帧，只包含发生变化的参与者
+      ActorDescriptions  = (0x1 << 3),  // 消息中包含新生成的参与者的描述
+      FilteredOutActors  = (0x1 << 4)   // 消息中包含被过滤掉、但仍然存在的参与者 ID
     };
 
 #pragma pack(push, 1)
@@ -43,13 +49,175 @@ namespace s11n {
     };
 #pragma pack(pop)
 
+#pragma pack(push, 1)
+    /// 增量帧在 Header 之后附加的头部。消息布局为
+    /// Header | DeltaHeader | ActorId[removed_count] | [描述] | ActorDynamicState[...]。
+    struct DeltaHeader {
+      uint64_t base_frame;     // 增量所基于的帧，客户端必须持有该帧的状态
+      uint32_t removed_count;  // 自基准帧以来被销毁的参与者数量
+    };
+#pragma pack(pop)
+
+#pragma pack(push, 1)
+    /// 带有 ActorDescriptions 标志的消息在参与者状态之前附加新生成参与者的
+    /// 描述：DescriptionsHeader | 以 MsgPack 编码的 std::vector<rpc::Actor>。
+    struct DescriptionsHeader {
+      uint32_t size;  // 编码后描述的字节数
+    };
+#pragma pack(pop)
+
+#pragma pack(push, 1)
+    /// 按过滤条件生成的消息在描述之前附加被过滤掉的参与者：
+    /// FilteredOutHeader | ActorId[count]。这些参与者没有状态，但仍然存在。
+    struct FilteredOutHeader {
+      uint32_t count;  // 被过滤掉的参与者数量
+    };
+#pragma pack(pop)
+
     constexpr static auto header_offset = sizeof(Header);  // 数据头部的偏移量，用于快速定位数据正文
 
+    constexpr static auto delta_header_offset = sizeof(Header) + sizeof(DeltaHeader);  // 增量帧中被移除参与者 ID 的起始偏移量
+
+    /// 比较类型相关状态中 @a type 对应的成员。只逐字段比较有效的成员，
+    /// 不比较填充字节和联合体中未使用的部分。
+    static bool HasTypeStateChanged(
+        const data::ActorDynamicState::TypeDependentState &previous,
+        const data::ActorDynamicState::TypeDependentState &current,
+        rpc::ActorTypeMask type) {
+      switch (type) {
+        case rpc::ActorTypeMask::Vehicle: {
+          const auto &p = previous.vehicle_data;
+          const auto &c = current.vehicle_data;
+          return (static_cast<rpc::VehicleControl>(p.control) != static_cast<rpc::VehicleControl>(c.control)) ||
+              (p.speed_limit != c.speed_limit) ||
+              (p.traffic_light_state != c.traffic_light_state) ||
+              (p.has_traffic_light != c.has_traffic_light) ||
+              // 没有交通灯时不写入交通灯 ID
+              (p.has_traffic_light && (p.traffic_light_id != c.traffic_light_id)) ||
+              (p.failure_state != c.failure_state);
+        }
+        case rpc::ActorTypeMask::Walker:
+          return static_cast<rpc::WalkerControl>(previous.walker_control) !=
+              static_cast<rpc::WalkerControl>(current.walker_control);
+        case rpc::ActorTypeMask::TrafficLight: {
+          const auto &p = previous.traffic_light_data;
+          const auto &c = current.traffic_light_data;
+          return (std::strncmp(p.sign_id, c.sign_id, sizeof(p.sign_id)) != 0) ||
+              (p.green_time != c.green_time) ||
+              (p.yellow_time != c.yellow_time) ||
+              (p.red_time != c.red_time) ||
+              (p.elapsed_time != c.elapsed_time) ||
+              (p.pole_index != c.pole_index) ||
+              (p.time_is_frozen != c.time_is_frozen) ||
+              (p.state != c.state);
+        }
+        case rpc::ActorTypeMask::TrafficSign:
+          return std::strncmp(
+              previous.traffic_sign_data.sign_id,
+              current.traffic_sign_data.sign_id,
+              sizeof(current.traffic_sign_data.sign_id)) != 0;
+        default:
+          // 其他参与者没有类型相关状态
+          return false;
+      }
+    }
+
+    /// 判断两次参与者状态之间的差别是否需要在增量帧中发送。
+    /// 位置精度 1 毫米，旋转精度 0.01 度，速度精度 1 毫米/秒；
+    /// 参与者状态以及 @a type 对应的类型相关状态逐字段比较。
+    static bool HasChanged(
+        const data::ActorDynamicState &previous,
+        const data::ActorDynamicState &current,
+        rpc::ActorTypeMask type) {
+      constexpr float LocationThreshold = 1e-3f;
+      constexpr float RotationThreshold = 1e-2f;
+      constexpr float VelocityThreshold = 1e-3f;
+      auto differs = [](const geom::Vector3D &a, const geom::Vector3D &b, float threshold) {
+        return (std::abs(a.x - b.x) > threshold) ||
+               (std::abs(a.y - b.y) > threshold) ||
+               (std::abs(a.z - b.z) > threshold);
+      };
+      const auto &pr = previous.transform.rotation;
+      const auto &cr = current.transform.rotation;
+      return (previous.actor_state != current.actor_state) ||
+          differs(previous.transform.location, current.transform.location, LocationThreshold) ||
+          (std::abs(pr.pitch - cr.pitch) > RotationThreshold) ||
+          (std::abs(pr.yaw - cr.yaw) > RotationThreshold) ||
+          (std::abs(pr.roll - cr.roll) > RotationThreshold) ||
+          differs(previous.velocity, current.velocity, VelocityThreshold) ||
+          differs(previous.angular_velocity, current.angular_velocity, VelocityThreshold) ||
+          differs(previous.acceleration, current.acceleration, VelocityThreshold) ||
+          HasTypeStateChanged(previous.state, current.state, type);
+    }
+
     //反序列化数据包头部
     static const Header &DeserializeHeader(const RawData &message) {  // 反序列化数据包头部
       return *reinterpret_cast<const Header *>(message.begin());  // 返回解析后的'Header'结构体的引用
     }
 
+    static bool IsDelta(const RawData &message) {
+      return (DeserializeHeader(message).simulation_state & SimulationState::Delta) != 0;
+    }
+
+    /// 反序列化增量帧头部，仅在 IsDelta 为真时有效。
+    static const DeltaHeader &DeserializeDeltaHeader(const RawData &message) {
+      return *reinterpret_cast<const DeltaHeader *>(message.begin() + header_offset);
+    }
+
+    static bool HasActorDescriptions(const RawData &message) {
+      return (DeserializeHeader(message).simulation_state & SimulationState::ActorDescriptions) != 0;
+    }
+
+    static bool HasFilteredOutActors(const RawData &message) {
+      return (DeserializeHeader(message).simulation_state & SimulationState::FilteredOutActors) != 0;
+    }
+
+    /// 被过滤掉的参与者部分相对于消息起始处的偏移量，仅在 HasFilteredOutActors 为真时有效。
+    static size_t GetFilteredOutActorsOffset(const RawData &message) {
+      if (!IsDelta(message)) {
+        return header_offset;
+      }
+      return delta_header_offset +
+          sizeof(ActorId) * DeserializeDeltaHeader(message).removed_count;
+    }
+
+    /// 被过滤掉的参与者数量，没有时为 0。
+    static size_t GetFilteredOutActorCount(const RawData &message) {
+      if (!HasFilteredOutActors(message)) {
+        return 0u;
+      }
+      return reinterpret_cast<const FilteredOutHeader *>(
+          message.begin() + GetFilteredOutActorsOffset(message))->count;
+    }
+
+    /// 参与者描述部分相对于消息起始处的偏移量，仅在 HasActorDescriptions 为真时有效。
+    static size_t GetActorDescriptionsOffset(const RawData &message) {
+      const size_t offset = GetFilteredOutActorsOffset(message);
+      if (!HasFilteredOutActors(message)) {
+        return offset;
+      }
+      return offset + sizeof(FilteredOutHeader) +
+          sizeof(ActorId) * GetFilteredOutActorCount(message);
+    }
+
+    /// 编码后参与者描述的字节数，没有描述时为 0。
+    static size_t GetActorDescriptionsSize(const RawData &message) {
+      if (!HasActorDescriptions(message)) {
+        return 0u;
+      }
+      return reinterpret_cast<const DescriptionsHeader *>(
+          message.begin() + GetActorDescriptionsOffset(message))->size;
+    }
+
+    /// 参与者状态数组相对于消息起始处的偏移量。
+    static size_t GetActorStatesOffset(const RawData &message) {
+      const size_t offset = GetActorDescriptionsOffset(message);
+      if (!HasActorDescriptions(message)) {
+        return offset;
+      }
+      return offset + sizeof(DescriptionsHeader) + GetActorDescriptionsSize(message);
+    }
+
     template <typename SensorT>//序列化传感器数据
     static Buffer Serialize(const SensorT &, Buffer &&buffer) { // Sensor为输入的传感器对像，buffer为输入的缓冲区数据
       return std::move(buffer); // 直接返回传入的缓冲区数据
@@ -82,12 +82,17 @@ namespace detail {
     bool AreClientsListening() {
       return (_sessions.size() > 0 || _force_active || _enabled_for_ros);
     }
+ // 返回连接过该流的会话总数，每有一个客户端订阅就增加一次
+    uint64_t GetSessionConnections() const {
+      return _session_connections.load();
+    }
 // 连接一个新的会话
     void ConnectSession(std::shared_ptr<Session> session) final {
       DEBUG_ASSERT(session != nullptr);
       std::lock_guard<std::mutex> lock(_mutex);
 	  // 将新会话添加到会话列表中
       _sessions.emplace_back(std::move(session));
+      ++_session_connections;
       log_debug("Connecting multistream sessions:", _sessions.size());
       if (_sessions.size() == 1) {
 		  // 如果只有一个会话，设置 _session 指向这个会话
@@ -164,6 +169,8 @@ namespace detail {
     // _sessions 是一个向量（动态数组），存储了多个指向 Session 对象的智能指针
     // 这些智能指针是 std::shared_ptr 类型，它们自动管理 Session 对象的生命周期
     // 当没有任何 std::shared_ptr 指向一个 Session 对象时，该对象会被自动删除
+    std::atomic<uint64_t> _session_connections {0u};
+    // 连接过的会话总数，用于发现新订阅的客户端
     bool _force_active {false};   // _force_active 是一个布尔变量，用于指示是否存在一个或多个会话被强制标记为活动状态
     // 如果为 true，则可能表示有会话需要被特别处理，即使按照正常逻辑它们可能不应该处于活动状态
     // 初始化为 false，表示默认没有会话被强制标记为活动状态
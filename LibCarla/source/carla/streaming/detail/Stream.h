@@ -63,6 +63,11 @@ namespace detail {  // 定义 detail 子命名空间
       return _shared_state ? _shared_state->AreClientsListening() : false;  // 返回共享状态的监听状态
     }
 
+    /// 返回连接过该流的会话总数，有新客户端订阅时增加
+    uint64_t GetSessionConnections() const {
+      return _shared_state ? _shared_state->GetSessionConnections() : 0u;
+    }
+
   private:
 
     friend class detail::Dispatcher;  // 声明 Dispatcher 为友元类，允许其访问私有成员
@@ -11,6 +11,8 @@
 #include "carla/Exception.h"
 #include "carla/Logging.h"
 #include "carla/Time.h"
+#include "carla/profiler/Metrics.h"
+#include "carla/profiler/Tracer.h"
 
 // C++ Boost Asio是一个基于事件驱动的网络编程库，提供了异步的、非阻塞的网络编程接口。
 #include <boost/asio/connect.hpp>
@@ -193,9 +195,18 @@ namespace tcp {
         if (!ec) {
           DEBUG_ASSERT_EQ(bytes, message->size());
           DEBUG_ASSERT_NE(bytes, 0u);
+          static auto &messages_received = profiler::MetricsRegistry::Get().GetCounter(
+              "carla_streaming_messages_received_total", "Streaming messages received from the server.");
+          static auto &bytes_received = profiler::MetricsRegistry::Get().GetCounter(
+              "carla_streaming_bytes_received_total", "Streaming payload bytes received from the server.");
+          messages_received.Increment();
+          bytes_received.Increment(message->size());
           // 将缓冲区移动到回调函数并开始读取下一块数据。
           // log_debug("streaming client: success reading data, calling the callback");
-          self->_callback(message->pop());
+          {
+            CARLA_TRACE_SCOPE(streaming, ClientCallback);
+            self->_callback(message->pop());
+          }
           ReadData();
         } else {
           // 像往常一样，如果出了什么问题，就从头再来。
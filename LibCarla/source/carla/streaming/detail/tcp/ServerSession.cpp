@@ -9,6 +9,8 @@
 
 #include "carla/Debug.h"
 #include "carla/Logging.h"
+#include "carla/profiler/Metrics.h"
+#include "carla/profiler/Tracer.h"
 
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
@@ -24,6 +26,22 @@ namespace detail {
 namespace tcp {
 // 用于统计服务器会话的数量
   static std::atomic_size_t SESSION_COUNTER{0u};
+
+  /// 所有会话共用的发送指标。
+  struct ServerSessionMetrics {
+    profiler::MetricCounter &messages_sent;
+    profiler::MetricCounter &bytes_sent;
+    profiler::MetricCounter &messages_dropped;
+  };
+
+  static ServerSessionMetrics &GetMetrics() {
+    auto &registry = profiler::MetricsRegistry::Get();
+    static ServerSessionMetrics metrics{
+        registry.GetCounter("carla_streaming_messages_sent_total", "Streaming messages sent to clients."),
+        registry.GetCounter("carla_streaming_bytes_sent_total", "Streaming payload bytes sent to clients."),
+        registry.GetCounter("carla_streaming_messages_dropped_total", "Streaming messages discarded because the connection was too slow.")};
+    return metrics;
+  }
 // ServerSession类的构造函数
   // @param io_context boost::asio的I/O上下文对象
   // @param timeout 会话超时时间
@@ -90,6 +108,7 @@ namespace tcp {
 // 向客户端写入消息的函数
   // @param message 要写入的消息指针
   void ServerSession::Write(std::shared_ptr<const Message> message) {
+    CARLA_TRACE_SCOPE(streaming, ServerSessionWrite);
   	// 断言消息不为空且消息内容不为空
     DEBUG_ASSERT(message != nullptr);
     DEBUG_ASSERT(!message->empty());
@@ -106,6 +125,7 @@ namespace tcp {
         } else {
           // 忽略该消息
           log_debug("session", _session_id, ": connection too slow: message discarded");
+          GetMetrics().messages_dropped.Increment();
           return;
         }
       }
@@ -121,6 +141,9 @@ namespace tcp {
         	// 如果发送成功，打印调试信息（可选）并断言发送的字节数正确
           DEBUG_ONLY(log_debug("session", _session_id, ": successfully sent", bytes, "bytes"));
           DEBUG_ASSERT_EQ(bytes, sizeof(message_size_type) + message->size());
+          auto &metrics = GetMetrics();
+          metrics.messages_sent.Increment();
+          metrics.bytes_sent.Increment(message->size());
         }
       };
 // 打印调试信息，表示要发送的消息大小
@@ -1,9 +1,13 @@
 
 #include "boost/pointer_cast.hpp"
 
+#include <algorithm>
+#include <iterator>
+
 #include "carla/client/Actor.h" //导入 Actor 类
 #include "carla/client/Vehicle.h" //导入 Vehicle (车辆)类
 #include "carla/client/Walker.h" //导入 Walker (行人)类
+#include "carla/Debug.h"
 
 #include "carla/trafficmanager/Constants.h" //导入交通管理中的常量定义
 #include "carla/trafficmanager/LocalizationUtils.h" //导入定义相关的工具
@@ -44,54 +48,84 @@ ALSM::ALSM(
     vehicle_light_stage(vehicle_light_stage) {} //初始化车辆灯光控制模块
 
 void ALSM::Update() {
+  // 每个节拍只获取一次世界快照，之后的状态读取都不再经过客户端
+  Update(world.GetSnapshot());
+}
+
+void ALSM::Update(const cc::WorldSnapshot &world_snapshot) {
   //获取是否启用混合物理模式参数
   bool hybrid_physics_mode = parameters.GetHybridPhysicsMode();
-  //定义两个集合用于存储世界中的车辆 ID 和行人 ID
-  std::set<ActorId> world_vehicle_ids;
-  std::set<ActorId> world_pedestrian_ids;
-  //存储待删除的未注册参与者的 ID 列表
-  std::vector<ActorId> unregistered_list_to_be_deleted;
 
-  current_timestamp = world.GetSnapshot().GetTimestamp(); //获取当前时间截
-  ActorList world_actors = world.GetActors();//获取当前世界中的所有参与者列表
+  current_timestamp = world_snapshot.GetTimestamp(); //获取当前时间截
+  simulation_state.SetTimestamp(current_timestamp); // 各阶段在本节拍内使用同一时间戳
+
+  // 快照按 ID 有序遍历，一次遍历即可建立有序的 ID 数组和对应的状态
+  std::vector<ActorId> current_actor_ids;
+  current_actor_ids.reserve(world_snapshot.size());
+  world_actor_states.clear();
+  world_actor_states.reserve(world_snapshot.size());
+  for (const cc::ActorSnapshot actor_state : world_snapshot) {
+    current_actor_ids.push_back(actor_state.id);
+    world_actor_states.push_back(actor_state);
+  }
+  DEBUG_ASSERT(std::is_sorted(current_actor_ids.begin(), current_actor_ids.end()));
+
+  // 已注册车辆的 ID，AtomicActorSet 内部为有序映射，因此结果有序
+  const std::vector<ActorId> registered_ids = registered_vehicles.GetIDList();
+
+  // 设置了状态过滤时，过滤范围之外的参与者不在快照中，但仍然存在，不能当作已销毁
+  const std::vector<ActorId> &filtered_out_ids = world_snapshot.GetFilteredOutActorIds();
+  std::vector<ActorId> existing_actor_ids;
+  if (!filtered_out_ids.empty()) {
+    existing_actor_ids.reserve(current_actor_ids.size() + filtered_out_ids.size());
+    std::set_union(current_actor_ids.begin(), current_actor_ids.end(),
+                   filtered_out_ids.begin(), filtered_out_ids.end(),
+                   std::back_inserter(existing_actor_ids));
+  }
 
   // 找到已经销毁的参与者并进行清理
-  const ALSM::DestroyeddActors destroyed_actors = IdentifyDestroyedActors(world_actors);
-  
+  const ALSM::DestroyedActors destroyed_actors = IdentifyDestroyedActors(
+      current_actor_ids,
+      filtered_out_ids.empty() ? current_actor_ids : existing_actor_ids,
+      registered_ids);
+
   //处理已注册的被销毁的参与者
-  const ActorIdSet &destroyed_registered = destroyed_actors.first;
-  for (const auto &deletion_id: destroyed_registered) {
+  for (const auto &deletion_id: destroyed_actors.first) {
     RemoveActor(deletion_id, true); //删除角色并标记为注册参与者
   }
   //处理未注册的被销毁参与者
-  const ActorIdSet &destroyed_unregistered = destroyed_actors.second;
-  for (auto deletion_id : destroyed_unregistered) {
+  for (const auto &deletion_id : destroyed_actors.second) {
     RemoveActor(deletion_id, false);
   }
 
-  // 检查英雄参与者是否存活，如果英雄参与者已被销毁，则将其从英雄列表中移除
+  // 从世界中消失的英雄参与者从英雄列表中移除
   if (hero_actors.size() != 0u) {
-    ActorIdSet hero_actors_to_delete;
-    //遍历英雄参与者，查看它们是否已被销毁
-    for (auto &hero_actor_info: hero_actors) { 
-    //如果在未注册销毁列表中找到英雄参与者，则标记其删除
-      if (destroyed_unregistered.find(hero_actor_info.first) != destroyed_unregistered.end()) {
-        hero_actors_to_delete.insert(hero_actor_info.first);
-      }
-      //如果在已注册销毁列表中找到英雄参与者，则标记其删除
-      if (destroyed_registered.find(hero_actor_info.first) != destroyed_registered.end()) {
-        hero_actors_to_delete.insert(hero_actor_info.first);
-      }
-    }
-    
-    //删除所有已标记的英雄参与者
-    for (auto &deletion_id: hero_actors_to_delete) {
+    for (const auto &deletion_id : destroyed_actors.first) {
       hero_actors.erase(deletion_id);
     }
   }
 
+  // 新生成的参与者，以及在两个节拍之间被取消注册、但仍在世界中的车辆
+  std::vector<ActorId> spawned_ids;
+  std::set_difference(current_actor_ids.begin(), current_actor_ids.end(),
+                      world_actor_ids.begin(), world_actor_ids.end(),
+                      std::back_inserter(spawned_ids));
+  world_actor_ids = std::move(current_actor_ids);
+
+  std::vector<ActorId> released_ids;
+  std::set_difference(known_registered_ids.begin(), known_registered_ids.end(),
+                      registered_ids.begin(), registered_ids.end(),
+                      std::back_inserter(released_ids));
+  std::vector<ActorId> new_actor_ids;
+  std::set_union(spawned_ids.begin(), spawned_ids.end(),
+                 released_ids.begin(), released_ids.end(),
+                 std::back_inserter(new_actor_ids));
+  new_actor_ids.erase(std::remove_if(new_actor_ids.begin(), new_actor_ids.end(),
+      [this](const ActorId actor_id) { return FindActorState(actor_id) == nullptr; }),
+      new_actor_ids.end());
+
   // 扫描并识别新的未注册参与者
-  IdentifyNewActors(world_actors);
+  IdentifyNewActors(new_actor_ids);
 
   // 更新所有已注册的车辆的动态状态和静态属性
   ALSM::IdleInfo max_idle_time = std::make_pair(0u, current_timestamp.elapsed_seconds);
@@ -102,7 +136,7 @@ void ALSM::Update() {
       && (current_timestamp.elapsed_seconds - elapsed_last_actor_destruction) > DELTA_TIME_BETWEEN_DESTRUCTIONS
       && hero_actors.find(max_idle_time.first) == hero_actors.end()) {
     // 如果车辆被卡住，且它不是英雄参与者，并且距离上次销毁的时间超过了预设的时间间隔，则销毁该车辆。
-    
+
 	registered_vehicles.Destroy(max_idle_time.first); // 销毁长时间停滞不动的车辆
     RemoveActor(max_idle_time.first, true); //从已注册的参与者中移除该辆车
     elapsed_last_actor_destruction = current_timestamp.elapsed_seconds;//更新上一次销毁的时间
@@ -120,18 +154,35 @@ void ALSM::Update() {
 
   // 更新未注册参与者的动态状态和静态属性
   UpdateUnregisteredActorsData();
+
+  // 记录本节拍结束时的注册状态；快照状态在此之后失效
+  known_registered_ids = registered_vehicles.GetIDList();
+  world_actor_states.clear();
+}
+
+const cc::ActorSnapshot *ALSM::FindActorState(const ActorId actor_id) const {
+  // world_actor_ids 在 Update 期间保存当前节拍的有序 ID
+  auto it = std::lower_bound(world_actor_ids.begin(), world_actor_ids.end(), actor_id);
+  if (it == world_actor_ids.end() || *it != actor_id || world_actor_states.empty()) {
+    return nullptr;
+  }
+  return &world_actor_states[static_cast<size_t>(it - world_actor_ids.begin())];
 }
 
 //识别新的参与者
-void ALSM::IdentifyNewActors(const ActorList &actor_list) {
-    //遍历传入的参与者列表
+void ALSM::IdentifyNewActors(const std::vector<ActorId> &new_actor_ids) {
+  if (new_actor_ids.empty()) {
+    return;
+  }
+  // 只为新参与者查询一次类型与属性
+  ActorList actor_list = world.GetActors(new_actor_ids);
+  //遍历新参与者列表
   for (auto iter = actor_list->begin(); iter != actor_list->end(); ++iter) {
     ActorPtr actor = *iter; //获取当前的参与者对象
     ActorId actor_id = actor->GetId(); //获取当前参与者的唯一标识符（ID）
+    const char type = actor->GetTypeId().front();
     // 识别新的英雄车辆
-    if (actor->GetTypeId().front() == 'v') { //通过其类型（ID）判断当前参与者
-     //如果没有任何已识别的英雄车辆，或者该参与者不在英雄参与者列表中
-     if (hero_actors.size() == 0u || hero_actors.find(actor_id) == hero_actors.end()) {
+    if (type == 'v' && hero_actors.find(actor_id) == hero_actors.end()) {
       //遍历该参与者的所有属性
       for (auto&& attribute: actor->GetAttributes()) {
         //如果属性的 ID 是 "role_name"，并且其值是 "hero"
@@ -141,47 +192,61 @@ void ALSM::IdentifyNewActors(const ActorList &actor_list) {
         }
       }
     }
-  }
+    // 只有车辆和行人会影响交通管理器，其他参与者不需要跟踪
+    if (type != 'v' && type != 'w') {
+      continue;
+    }
     //如果该参与者不在已注册车辆列表中，且不在未注册的参与者列表中
     if (!registered_vehicles.Contains(actor_id)
         && unregistered_actors.find(actor_id) == unregistered_actors.end()) {
       //将该参与者添加到未注册参与者中
-      unregistered_actors.insert({actor_id, actor});
+      const ActorType actor_type = type == 'v' ? ActorType::Vehicle : ActorType::Pedestrian;
+      unregistered_actors.insert({actor_id, UnregisteredActor{actor, actor_type}});
     }
   }
 }
 
 //识别已销毁的参与者
-ALSM::DestroyeddActors ALSM::IdentifyDestroyedActors(const ActorList &actor_list) {
-
-  ALSM::DestroyeddActors destroyed_actors; //用于存储销毁的参与者 ID
-  ActorIdSet &deleted_registered = destroyed_actors.first; //存储已销毁的注册车辆的 ID
-  ActorIdSet &deleted_unregistered = destroyed_actors.second; //存储已销毁的未注册参与者的 ID
-
-  //构建当前帧中存在的参与者的哈希集合
-  ActorIdSet current_actors;
-  for  (auto iter = actor_list->begin(); iter != actor_list->end(); ++iter) {
-    current_actors.insert((*iter)->GetId()); //将当前参与者的 ID 插入集合中
-  }
-
-  // 查找被销毁的已注册车辆
-  std::vector<ActorId> registered_ids = registered_vehicles.GetIDList();
-  for (const ActorId &actor_id : registered_ids) {
-    //如果当前帧中不存在某个已注册车辆
-    if (current_actors.find(actor_id) == current_actors.end()) {
-        //将该车辆的 ID 加入到已销毁的注册车辆列表中
-      deleted_registered.insert(actor_id);
+ALSM::DestroyedActors ALSM::IdentifyDestroyedActors(const std::vector<ActorId> &current_actor_ids,
+                                                    const std::vector<ActorId> &existing_actor_ids,
+                                                    const std::vector<ActorId> &registered_ids) {
+
+  ALSM::DestroyedActors destroyed_actors; //用于存储销毁的参与者 ID
+  std::vector<ActorId> &deleted_registered = destroyed_actors.first; //存储已销毁的注册车辆的 ID
+  std::vector<ActorId> &deleted_unregistered = destroyed_actors.second; //存储已销毁的未注册参与者的 ID
+
+  // 查找被销毁的已注册车辆：已注册但已不存在。被过滤掉的车辆保持注册，
+  // 回到过滤范围内后继续控制
+  std::set_difference(registered_ids.begin(), registered_ids.end(),
+                      existing_actor_ids.begin(), existing_actor_ids.end(),
+                      std::back_inserter(deleted_registered));
+
+  // 查找从快照中消失的参与者：上一节拍存在但当前快照中不存在。被过滤掉的
+  // 未注册参与者同样停止跟踪，回到过滤范围内时重新识别
+  std::vector<ActorId> vanished_ids;
+  std::set_difference(world_actor_ids.begin(), world_actor_ids.end(),
+                      current_actor_ids.begin(), current_actor_ids.end(),
+                      std::back_inserter(vanished_ids));
+  for (const ActorId &actor_id : vanished_ids) {
+    if (unregistered_actors.find(actor_id) != unregistered_actors.end()) {
+      deleted_unregistered.push_back(actor_id);
+    } else if (!std::binary_search(existing_actor_ids.begin(), existing_actor_ids.end(), actor_id)) {
+      // 未跟踪的参与者（例如传感器）也可能是英雄
+      hero_actors.erase(actor_id);
     }
   }
 
-  // 查找被销毁的未注册参与者
-  for (const auto &actor_info: unregistered_actors) {
-    const ActorId &actor_id = actor_info.first;
-    //如果当前帧中不存在某个未注册的参与者，或者该参与者已经注册为车辆
-     if (current_actors.find(actor_id) == current_actors.end()
-         || registered_vehicles.Contains(actor_id)) {
-      //将该参与者的 ID 加入到已销毁的未注册参与者列表中
-      deleted_unregistered.insert(actor_id);
+  // 自上一节拍以来新注册的车辆不再作为未注册参与者跟踪
+  std::vector<ActorId> newly_registered;
+  std::set_difference(registered_ids.begin(), registered_ids.end(),
+                      known_registered_ids.begin(), known_registered_ids.end(),
+                      std::back_inserter(newly_registered));
+  for (const ActorId &actor_id : newly_registered) {
+    if (unregistered_actors.find(actor_id) != unregistered_actors.end()) {
+      // 仅清理未注册状态，保留英雄标记
+      unregistered_actors.erase(actor_id);
+      track_traffic.DeleteActor(actor_id);
+      simulation_state.RemoveActor(actor_id);
     }
   }
   //返回销毁的参与者列表
@@ -206,36 +271,41 @@ void ALSM::UpdateRegisteredActorsData(const bool hybrid_physics_mode, ALSM::Idle
   }
   // 首先更新英雄车辆的信息
   for (auto &hero_actor_info: hero_actors){
+    const cc::ActorSnapshot *hero_state = FindActorState(hero_actor_info.first);
+    if (hero_state == nullptr) {
+      continue;
+    }
      //如果启用了重生功能，设置英雄车辆的当前位置
     if (is_respawn_vehicles) {
-      track_traffic.SetHeroLocation(hero_actor_info.second->GetTransform().location);
+      track_traffic.SetHeroLocation(hero_state->transform.location);
     }
     //更新英雄车辆的数据，传入是否处于混合物理模式、英雄车辆、是否有英雄车辆存在、物理半径平方等参数
-    UpdateData(hybrid_physics_mode, hero_actor_info.second, hero_actor_present, physics_radius_square);
+    UpdateData(hybrid_physics_mode, hero_actor_info.second, *hero_state, hero_actor_present, physics_radius_square);
   }
   // 更新其他注册车辆的信息
-  for (const Actor &vehicle : vehicle_list) {
+  for (const ActorPtr &vehicle : vehicle_list) {
     //获取车辆的 ID
     ActorId actor_id = vehicle->GetId();
+    const cc::ActorSnapshot *vehicle_state = FindActorState(actor_id);
     //如果车辆不是英雄车辆，更新该车辆的数据
-    if (hero_actors.find(actor_id) == hero_actors.end()) {
+    if (vehicle_state != nullptr && hero_actors.find(actor_id) == hero_actors.end()) {
       //更新车辆数据
-      UpdateData(hybrid_physics_mode, vehicle, hero_actor_present, physics_radius_square);
+      UpdateData(hybrid_physics_mode, vehicle, *vehicle_state, hero_actor_present, physics_radius_square);
       //更新该车辆的空闲时间信息
       UpdateIdleTime(max_idle_time, actor_id);
     }
   }
 }
 
-void ALSM::UpdateData(const bool hybrid_physics_mode, const Actor &vehicle,
+void ALSM::UpdateData(const bool hybrid_physics_mode, const ActorPtr &vehicle,
+                      const cc::ActorSnapshot &state,
                       const bool hero_actor_present, const float physics_radius_square) {
 
-  //获取车辆的ID和位置信息
-  ActorId actor_id = vehicle->GetId();
-  cg::Transform vehicle_transform = vehicle->GetTransform();
-  cg::Location vehicle_location = vehicle_transform.location;
-  cg::Rotation vehicle_rotation = vehicle_transform.rotation;
-  cg::Vector3D vehicle_velocity = vehicle->GetVelocity();
+  //从快照中获取车辆的ID和位置信息
+  ActorId actor_id = state.id;
+  cg::Location vehicle_location = state.transform.location;
+  cg::Rotation vehicle_rotation = state.transform.rotation;
+  cg::Vector3D vehicle_velocity = state.velocity;
   //检查仿真状态中是否包含当前车辆的状态信息
   bool state_entry_present = simulation_state.ContainsActor(actor_id);
 
@@ -284,13 +354,14 @@ void ALSM::UpdateData(const bool hybrid_physics_mode, const Actor &vehicle,
   }
 
   // 更新运动学状态对象
-  auto vehicle_ptr = boost::static_pointer_cast<cc::Vehicle>(vehicle);
+  const auto &vehicle_data = state.state.vehicle_data;
+  const bool is_dormant = state.actor_state == rpc::ActorState::Dormant;
   KinematicState kinematic_state{vehicle_location, vehicle_rotation,
-                                  vehicle_velocity, vehicle_ptr->GetSpeedLimit(),
-                                  enable_physics, vehicle->IsDormant(), cg::Location()};
+                                  vehicle_velocity, vehicle_data.speed_limit,
+                                  enable_physics, is_dormant, cg::Location()};
 
   // 更新交通信号状态对象
-  TrafficLightState tl_state = {vehicle_ptr->GetTrafficLightState(), vehicle_ptr->IsAtTrafficLight()};
+  TrafficLightState tl_state = {vehicle_data.traffic_light_state, vehicle_data.has_traffic_light};
 
   // 更新仿真状态
   if (state_entry_present) {
@@ -298,8 +369,8 @@ void ALSM::UpdateData(const bool hybrid_physics_mode, const Actor &vehicle,
     simulation_state.UpdateTrafficLightState(actor_id, tl_state);
   }
   else {
-    // 如果是新车辆，添加静态属性，包括车辆的类型和边界尺寸
-    cg::Vector3D dimensions = vehicle_ptr->GetBoundingBox().extent;
+    // 如果是新车辆，添加静态属性，包括车辆的类型和边界尺寸；边界框只在此处读取一次
+    cg::Vector3D dimensions = boost::static_pointer_cast<cc::Vehicle>(vehicle)->GetBoundingBox().extent;
     StaticAttributes attributes{ActorType::Vehicle, dimensions.x, dimensions.y, dimensions.z};
 
     // 将新的车辆及其状态添加到仿真状态中
@@ -313,34 +384,33 @@ void ALSM::UpdateUnregisteredActorsData() {
   for (auto &actor_info: unregistered_actors) {
 
     const ActorId actor_id = actor_info.first; //获取参与者的 ID
-    const ActorPtr actor_ptr = actor_info.second; //获取参与者的指针
-    const std::string type_id = actor_ptr->GetTypeId(); //获取参与者的类型 ID
-     
-    const cg::Transform actor_transform = actor_ptr->GetTransform(); //获取参与者的变换信息
+    const UnregisteredActor &unregistered = actor_info.second;
+    const cc::ActorSnapshot *actor_state = FindActorState(actor_id);
+    if (actor_state == nullptr) {
+      continue;
+    }
+
+    const cg::Transform &actor_transform = actor_state->transform; //获取参与者的变换信息
     const cg::Location actor_location = actor_transform.location; //获取参与者的位置
-    const cg::Rotation actor_rotation = actor_transform.rotation; //获取参与者的旋转信息
-    const cg::Vector3D actor_velocity = actor_ptr->GetVelocity(); //获取参与者的速度
-    const bool actor_is_dormant = actor_ptr->IsDormant(); //判断参与者是否处于休眠状态
+    const bool actor_is_dormant = actor_state->actor_state == rpc::ActorState::Dormant; //判断参与者是否处于休眠状态
     //创建运动状态对象
-    KinematicState kinematic_state {actor_location, actor_rotation, actor_velocity, -1.0f, true, actor_is_dormant, cg::Location()};
+    KinematicState kinematic_state {actor_location, actor_transform.rotation, actor_state->velocity, -1.0f, true, actor_is_dormant, cg::Location()};
 
     TrafficLightState tl_state; //交通灯状态
-    ActorType actor_type = ActorType::Any; //参与者类型
-    cg::Vector3D dimensions; //参与者的尺寸
     std::vector<SimpleWaypointPtr> nearest_waypoints; //最近的路点
 
     //检查参与者在模拟状态中是否存在条目
     bool state_entry_not_present = !simulation_state.ContainsActor(actor_id);
-    if (type_id.front() == 'v') { //如果是车辆
-      auto vehicle_ptr = boost::static_pointer_cast<cc::Vehicle>(actor_ptr); //转换为车辆指针
-      kinematic_state.speed_limit = vehicle_ptr->GetSpeedLimit(); //获取车辆的速度限制
+    if (unregistered.type == ActorType::Vehicle) { //如果是车辆
+      const auto &vehicle_data = actor_state->state.vehicle_data;
+      kinematic_state.speed_limit = vehicle_data.speed_limit; //获取车辆的速度限制
 
-      tl_state = {vehicle_ptr->GetTrafficLightState(), vehicle_ptr->IsAtTrafficLight()}; //获取交通灯状态
+      tl_state = {vehicle_data.traffic_light_state, vehicle_data.has_traffic_light}; //获取交通灯状态
 
       if (state_entry_not_present) {
-        dimensions = vehicle_ptr->GetBoundingBox().extent; //获取车辆的边界框尺寸
-        actor_type = ActorType::Vehicle; //设置参与者类型为车辆
-        StaticAttributes attributes {actor_type, dimensions.x, dimensions.y, dimensions.z}; //创建静态属性
+        auto vehicle_ptr = boost::static_pointer_cast<cc::Vehicle>(unregistered.actor); //转换为车辆指针
+        cg::Vector3D dimensions = vehicle_ptr->GetBoundingBox().extent; //获取车辆的边界框尺寸
+        StaticAttributes attributes {ActorType::Vehicle, dimensions.x, dimensions.y, dimensions.z}; //创建静态属性
 
         //添加参与者到模拟状态
         simulation_state.AddActor(actor_id, kinematic_state, attributes, tl_state);
@@ -350,25 +420,23 @@ void ALSM::UpdateUnregisteredActorsData() {
         simulation_state.UpdateTrafficLightState(actor_id, tl_state);
       }
 
-      // 确定占用的路点
-      cg::Vector3D extent = vehicle_ptr->GetBoundingBox().extent; // 获取车辆的尺寸
-      cg::Vector3D heading_vector = vehicle_ptr->GetTransform().GetForwardVector(); //获取车辆的朝向向量
-     // 计算车辆四个角的位置
-      std::vector<cg::Location> corners = {actor_location + cg::Location(extent.x * heading_vector),
+      // 确定占用的路点，车辆尺寸使用注册时缓存的边界框
+      const float half_length = simulation_state.GetDimensions(actor_id).x;
+      cg::Vector3D heading_vector = actor_transform.GetForwardVector(); //获取车辆的朝向向量
+     // 计算车辆前后端与中心的位置
+      std::vector<cg::Location> corners = {actor_location + cg::Location(half_length * heading_vector),
                                            actor_location,
-                                           actor_location + cg::Location(-extent.x * heading_vector)};
+                                           actor_location + cg::Location(-half_length * heading_vector)};
       for (cg::Location &vertex: corners) {
         SimpleWaypointPtr nearest_waypoint = local_map->GetWaypoint(vertex); //获取最近的路点
         nearest_waypoints.push_back(nearest_waypoint); //添加到最近路点列表
       }
     }
-    else if (type_id.front() == 'w') { //如果是行人
-      auto walker_ptr = boost::static_pointer_cast<cc::Walker>(actor_ptr); //转换为行人指针
-
+    else { //如果是行人
       if (state_entry_not_present) {
-        dimensions = walker_ptr->GetBoundingBox().extent; //获取行人的边界框尺寸
-        actor_type = ActorType::Pedestrian; //设置参与者类型为行人
-        StaticAttributes attributes {actor_type, dimensions.x, dimensions.y, dimensions.z}; //创建静态属性
+        auto walker_ptr = boost::static_pointer_cast<cc::Walker>(unregistered.actor); //转换为行人指针
+        cg::Vector3D dimensions = walker_ptr->GetBoundingBox().extent; //获取行人的边界框尺寸
+        StaticAttributes attributes {ActorType::Pedestrian, dimensions.x, dimensions.y, dimensions.z}; //创建静态属性
 
         // 添加参与者到模拟状态
         simulation_state.AddActor(actor_id, kinematic_state, attributes, tl_state);
@@ -456,6 +524,9 @@ void ALSM::Reset() {
   idle_time.clear();
   hero_actors.clear();
   elapsed_last_actor_destruction = 0.0; // 重置上次参与者销毁的时间
+  world_actor_ids.clear(); // 下一节拍重新识别所有参与者
+  world_actor_states.clear();
+  known_registered_ids.clear();
   current_timestamp = world.GetSnapshot().GetTimestamp(); // 更新当前时间截
 }
 
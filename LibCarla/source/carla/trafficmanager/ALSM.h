@@ -2,10 +2,13 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "carla/client/ActorList.h"
+#include "carla/client/ActorSnapshot.h"
 #include "carla/client/Timestamp.h"
 #include "carla/client/World.h"
+#include "carla/client/WorldSnapshot.h"
 #include "carla/Memory.h"
 
 #include "carla/trafficmanager/AtomicActorSet.h"
@@ -30,22 +33,33 @@ namespace chr = std::chrono;  // 引用时间相关的命名空间
 namespace cg = carla::geom;   // 引用几何相关的命名空间
 namespace cc = carla::client;  // 引用客户端相关的命名空间
 
-using ParticipantList = carla::SharedPtr<cc::ActorList>; // 定义参与者列表共享指针类型
-using ParticipantMap = std::unordered_map<ActorId, ActorPtr>; // 定义参与者映射表类型
+using ActorList = carla::SharedPtr<cc::ActorList>; // 定义参与者列表共享指针类型
+using ActorMap = std::unordered_map<ActorId, ActorPtr>; // 定义参与者映射表类型
 using IdleTimeMap = std::unordered_map<ActorId, double>; // 定义闲置时间映射表类型
 using LocalMapPtr = std::shared_ptr<InMemoryMap>; // 定义本地地图共享指针类型
 
 /// ALSM: 代理生命周期和状态管理
 /// 此类具有更新运动状态本地缓存的功能
 /// 并管理模拟中车辆数量变化的内存和清理。
+///
+/// 每个节拍只读取一次世界快照（EpisodeState），通过与上一节拍的有序 ID
+/// 数组求差来识别新生成和已销毁的参与者；只有新参与者才通过客户端查询
+/// 类型与属性，边界框在注册时缓存，动态状态直接取自快照。
 class ALSM {
 
 private:
+  /// 未注册参与者在发现时缓存的信息
+  struct UnregisteredActor {
+    ActorPtr actor;
+    ActorType type;
+  };
+  using UnregisteredActorMap = std::unordered_map<ActorId, UnregisteredActor>;
+
   AtomicActorSet &registered_vehicles; // 引用已注册参与者的原子集合
-  ParticipantMap unregistered_participants; // 存储未注册参与者的结构
+  UnregisteredActorMap unregistered_actors; // 存储未注册参与者的结构
   BufferMap &buffer_map; // 引用缓冲区映射
   IdleTimeMap idle_time; // 存储参与者在位置上停留时间的结构
-  ParticipantMap hero_participants; // 存储角色名称为"hero"的参与者
+  ActorMap hero_actors; // 存储角色名称为"hero"的参与者
   TrackTraffic &track_traffic; // 引用交通跟踪对象
   std::vector<ActorId>& marked_for_removal; // 标记待移除参与者的数组
   const Parameters &parameters; // 引用参数对象
@@ -57,9 +71,18 @@ private:
   TrafficLightStage &traffic_light_stage; // 引用交通灯阶段对象
   MotionPlanStage &motion_plan_stage; // 引用运动规划阶段对象
   VehicleLightStage &vehicle_light_stage; // 引用车辆灯光阶段对象
-  double elapsed_last_participant_destruction {0.0}; // 记录自上次因闲置过久而销毁参与者的时间
+  double elapsed_last_actor_destruction {0.0}; // 记录自上次因闲置过久而销毁参与者的时间
   cc::Timestamp current_timestamp; // 当前时间戳
   std::unordered_map<ActorId, bool> has_physics_enabled; // 存储每个参与者是否启用物理的映射
+  /// 上一节拍世界中所有参与者的 ID（有序）
+  std::vector<ActorId> world_actor_ids;
+  /// 与 world_actor_ids 对应的快照状态，仅在 Update 期间有效
+  std::vector<cc::ActorSnapshot> world_actor_states;
+  /// 上一节拍结束时已注册车辆的 ID（有序）
+  std::vector<ActorId> known_registered_ids;
+
+  // 在当前快照中查找参与者的状态，不存在时返回 nullptr
+  const cc::ActorSnapshot *FindActorState(const ActorId actor_id) const;
 
   // 更新已注册参与者在某位置上停留的时间
   void UpdateIdleTime(std::pair<ActorId, double>& max_idle_time, const ActorId& actor_id);
@@ -67,23 +90,27 @@ private:
   // 判断一辆车是否长时间停滞不前
   bool IsVehicleStuck(const ActorId& actor_id);
 
-  // 确定自上次更新以来在仿真中新生成的参与者
-  void IdentifyNewParticipants(const ParticipantList &participant_list);
+  // 确定自上次更新以来在仿真中新生成（或不再由交通管理器控制）的参与者
+  void IdentifyNewActors(const std::vector<ActorId> &new_actor_ids);
 
-  using DestroyeddParticipants = std::pair<ActorIdSet, ActorIdSet>; // 定义删除参与者的数据类型
+  using DestroyedActors = std::pair<std::vector<ActorId>, std::vector<ActorId>>; // 定义删除参与者的数据类型
   // 确定在上一帧中删除的参与者
+  // @a current_actor_ids 为快照中的参与者，@a existing_actor_ids 还包括被状态过滤掉的参与者
   // 返回已注册和未注册参与者的数组
-  DestroyeddParticipants IdentifyDestroyedParticipants(const ParticipantList &participant_list);
+  DestroyedActors IdentifyDestroyedActors(const std::vector<ActorId> &current_actor_ids,
+                                          const std::vector<ActorId> &existing_actor_ids,
+                                          const std::vector<ActorId> &registered_ids);
 
   using IdleInfo = std::pair<ActorId, double>; // 定义闲置信息的数据类型
-  void UpdateRegisteredParticipantsData(const bool hybrid_physics_mode, IdleInfo &max_idle_time);
+  void UpdateRegisteredActorsData(const bool hybrid_physics_mode, IdleInfo &max_idle_time);
 
   // 更新参与者数据
-  void UpdateData(const bool hybrid_physics_mode, const Actor &vehicle,
+  void UpdateData(const bool hybrid_physics_mode, const ActorPtr &vehicle,
+                  const cc::ActorSnapshot &state,
                   const bool hero_actor_present, const float physics_radius_square);
 
   // 更新未注册参与者的数据
-  void UpdateUnregisteredParticipantsData();
+  void UpdateUnregisteredActorsData();
 
 public:
   // 构造函数
@@ -101,12 +128,18 @@ public:
        MotionPlanStage &motion_plan_stage,
        VehicleLightStage &vehicle_light_stage);
 
-  // 更新方法
+  // 更新方法，使用世界的最新快照
   void Update();
 
+  // 更新方法，使用指定的世界快照（流水线模式下固定为触发节拍时的快照）
+  void Update(const cc::WorldSnapshot &world_snapshot);
+
   // 从交通管理中移除参与者，并清理与该车辆相关的各种数据
-  void RemoveParticipant(const ActorId actor_id, const bool registered_actor);
+  void RemoveActor(const ActorId actor_id, const bool registered_actor);
 
   // 重置方法
   void Reset();
-};
\ No newline at end of file
+};
+
+} // namespace traffic_manager
+} // namespace carla
@@ -77,7 +77,7 @@ void MotionPlanStage::Update(const unsigned long index) {
   // 根据传入的索引 index，从 localization_frame 中获取对应的车辆定位数据（LocalizationData 类型，包含更详细的车辆定位相关信息，比如定位精度、定位方式等补充数据）
   const CollisionHazardData &collision_hazard = collision_frame.at(index);  // 根据传入的索引 index，从 collision_frame 中获取对应的车辆碰撞危险数据（CollisionHazardData 类型，包含车辆周围是否存在碰撞风险、碰撞危险程度等相关详细信息）
   const bool &tl_hazard = tl_frame.at(index);// 根据传入的索引 index，从 tl_frame 中获取对应的交通信号灯相关危险信息（返回布尔值，用于判断当前车辆是否面临因交通信号灯产生的危险情况，比如即将闯红灯等）
-  current_timestamp = world.GetSnapshot().GetTimestamp();  // 获取当前世界的时间戳信息，通过 world 对象调用 GetSnapshot 函数获取世界的一个快照（可能包含了当前世界的各种状态信息），再从快照中获取时间戳（用于记录当前操作或者决策所处的时间点）
+  current_timestamp = simulation_state.GetTimestamp();  // 获取本节拍世界快照的时间戳（由 ALSM 在节拍开始时设置，流水线模式下不会读到之后的帧）
   StateEntry current_state;// 这里声明了一个 StateEntry 类型的变量 current_state，但后续代码缺失，不清楚具体用途，可能用于记录当前车辆或者整个模拟系统的某种状态信息，等待进一步赋值和使用
 
   // 实例化传送变换为当前载具变换
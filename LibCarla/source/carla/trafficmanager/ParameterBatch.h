@@ -0,0 +1,74 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/MsgPack.h" // 引入 MsgPack 头文件，批量参数需要通过 RPC 传输
+#include "carla/rpc/ActorId.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace traffic_manager {
+
+  /// 可以批量设置的单车参数。只包含标量参数，自定义路径（SetCustomPath）
+  /// 和导入路线（SetImportedRoute）仍需逐车设置。
+  enum class VehicleParameter : uint8_t {
+    PercentageSpeedDifference,       ///< 相对于限速的速度差百分比
+    LaneOffset,                      ///< 车道偏移
+    DesiredSpeed,                    ///< 精确的期望速度
+    UpdateVehicleLights,             ///< 车辆灯光自动更新（0 或 1）
+    AutoLaneChange,                  ///< 自动换道（0 或 1）
+    ForceLaneChange,                 ///< 强制换道，值为方向（0 向右，1 向左）
+    DistanceToLeadingVehicle,        ///< 到前车的距离
+    PercentageRunningLight,          ///< 闯红灯百分比
+    PercentageRunningSign,           ///< 闯交通标志百分比
+    PercentageIgnoreWalkers,         ///< 忽略行人百分比
+    PercentageIgnoreVehicles,        ///< 忽略车辆百分比
+    KeepRightPercentage,             ///< 靠右行驶百分比
+    RandomLeftLaneChangePercentage,  ///< 随机向左换道百分比
+    RandomRightLaneChangePercentage, ///< 随机向右换道百分比
+  };
+
+  /// 批量参数中的一项。布尔参数以 0 或 1 表示。
+  struct ParameterBatchEntry {
+    ParameterBatchEntry() = default;
+
+    ParameterBatchEntry(ActorId in_actor_id, VehicleParameter in_parameter, float in_value)
+      : actor_id(in_actor_id),
+        parameter(static_cast<uint8_t>(in_parameter)),
+        value(in_value) {}
+
+    ActorId actor_id = 0u;
+    uint8_t parameter = 0u;
+    float value = 0.0f;
+
+    VehicleParameter GetParameter() const {
+      return static_cast<VehicleParameter>(parameter);
+    }
+
+    MSGPACK_DEFINE_ARRAY(actor_id, parameter, value);
+  };
+
+  /// 一次 RPC 调用中应用的一组单车参数，按顺序依次应用
+  using ParameterBatch = std::vector<ParameterBatchEntry>;
+
+  /// 将同一参数的 (actor_id, value) 数组转换为批量参数
+  inline ParameterBatch MakeParameterBatch(
+      VehicleParameter parameter,
+      const std::vector<std::pair<ActorId, float>> &values) {
+    ParameterBatch batch;
+    batch.reserve(values.size());
+    for (const auto &item : values) {
+      batch.emplace_back(item.first, parameter, item.second);
+    }
+    return batch;
+  }
+
+} // namespace traffic_manager
+} // namespace carla
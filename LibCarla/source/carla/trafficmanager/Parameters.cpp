@@ -7,17 +7,60 @@
 #include "carla/trafficmanager/Parameters.h"  // 引入参数头文件
 #include "carla/trafficmanager/Constants.h"  // 引入常量头文件
 
+#include <algorithm>
+
 namespace carla {
 namespace traffic_manager {
 
+const VehicleParameters &ParameterSnapshot::Find(const ActorId &actor_id) const {
+  static const VehicleParameters default_parameters;
+  // 在排序的 ID 数组中二分查找
+  auto it = std::lower_bound(ids.begin(), ids.end(), actor_id);
+  if (it == ids.end() || *it != actor_id) {
+    return default_parameters;
+  }
+  return records[static_cast<size_t>(it - ids.begin())];
+}
+
 Parameters::Parameters() {  // 参数构造函数
 
   /// 设置默认的同步模式超时。
   synchronous_time_out = std::chrono::duration<int, std::milli>(10);
+
+  /// 发布一个空快照，使读取方始终有可用的快照
+  current_snapshot_owner = std::make_shared<ParameterSnapshot>();
+  current_snapshot.store(current_snapshot_owner.get());
 }
 
 Parameters::~Parameters() {}  // 参数析构函数
 
+void Parameters::PublishSnapshot() {
+  const uint64_t epoch = pending_epoch.load();
+  if (epoch == published_epoch) {
+    return;  // 参数没有变化，继续使用当前快照
+  }
+
+  auto snapshot = std::make_shared<ParameterSnapshot>();
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex);
+    snapshot->ids.reserve(pending_vehicle_parameters.size());
+    for (auto &entry : pending_vehicle_parameters) {
+      snapshot->ids.push_back(entry.first);
+    }
+    std::sort(snapshot->ids.begin(), snapshot->ids.end());
+    snapshot->records.reserve(snapshot->ids.size());
+    for (auto &id : snapshot->ids) {
+      snapshot->records.push_back(pending_vehicle_parameters.at(id));
+    }
+    published_epoch = pending_epoch.load();
+  }
+
+  // 上一份快照再保留一个节拍后释放
+  previous_snapshot_owner = std::move(current_snapshot_owner);
+  current_snapshot_owner = std::move(snapshot);
+  current_snapshot.store(current_snapshot_owner.get(), std::memory_order_release);
+}
+
 //////////////////////////////////// SETTERS //////////////////////////////////
 
 void Parameters::SetHybridPhysicsMode(const bool mode_switch) {  // 设置混合物理模式
@@ -39,26 +82,88 @@ void Parameters::SetBoundariesRespawnDormantVehicles(const float lower_bound, co
 }
 
 void Parameters::SetPercentageSpeedDifference(const ActorPtr &actor, const float percentage) {  // 设置速度差百分比
-  float new_percentage = std::min(100.0f, percentage);  // 限制最大百分比为100
-  percentage_difference_from_speed_limit.AddEntry({actor->GetId(), new_percentage});  // 添加速度差记录
-  if (exact_desired_speed.Contains(actor->GetId())) {  // 如果参与者的精确期望速度存在
-    exact_desired_speed.RemoveEntry(actor->GetId());  // 移除该参与者的精确期望速度
-  }
+  UpdateVehicleParameters(actor->GetId(), [&](VehicleParameters &record) {
+    ApplyVehicleParameter(record, VehicleParameter::PercentageSpeedDifference, percentage);
+  });
 }
 
 void Parameters::SetLaneOffset(const ActorPtr &actor, const float offset) {  // 设置车道偏移
-  const auto entry = std::make_pair(actor->GetId(), offset);  // 创建参与者ID和偏移的条目
-  lane_offset.AddEntry(entry);  // 添加车道偏移记录
+  UpdateVehicleParameters(actor->GetId(), [&](VehicleParameters &record) {
+    ApplyVehicleParameter(record, VehicleParameter::LaneOffset, offset);
+  });
 }
 
 void Parameters::SetDesiredSpeed(const ActorPtr &actor, const float value) {  // 设置期望速度
-  float new_value = std::max(0.0f, value);  // 确保速度不小于0
-  exact_desired_speed.AddEntry({actor->GetId(), new_value});  // 添加参与者的精确期望速度
-  if (percentage_difference_from_speed_limit.Contains(actor->GetId())) {  // 如果速度差记录存在
-    percentage_difference_from_speed_limit.RemoveEntry(actor->GetId());  // 移除该参与者的速度差记录
+  UpdateVehicleParameters(actor->GetId(), [&](VehicleParameters &record) {
+    ApplyVehicleParameter(record, VehicleParameter::DesiredSpeed, value);
+  });
+}
+
+void Parameters::ApplyVehicleParameter(VehicleParameters &record, VehicleParameter parameter, float value) {
+  switch (parameter) {
+    case VehicleParameter::PercentageSpeedDifference:
+      record.has_percentage_speed_difference = true;
+      record.percentage_speed_difference = std::min(100.0f, value);  // 限制最大百分比为100
+      record.has_exact_desired_speed = false;  // 与精确期望速度互斥
+      break;
+    case VehicleParameter::LaneOffset:
+      record.has_lane_offset = true;
+      record.lane_offset = value;
+      break;
+    case VehicleParameter::DesiredSpeed:
+      record.has_exact_desired_speed = true;
+      record.exact_desired_speed = std::max(0.0f, value);  // 确保速度不小于0
+      record.has_percentage_speed_difference = false;  // 与速度差百分比互斥
+      break;
+    case VehicleParameter::UpdateVehicleLights:
+      record.auto_update_vehicle_lights = value != 0.0f;
+      break;
+    case VehicleParameter::AutoLaneChange:
+      record.auto_lane_change = value != 0.0f;
+      break;
+    case VehicleParameter::DistanceToLeadingVehicle:
+      record.has_distance_to_leading_vehicle = true;
+      record.distance_to_leading_vehicle = std::max(0.0f, value);  // 确保距离不小于0
+      break;
+    case VehicleParameter::PercentageRunningLight:
+      record.perc_run_traffic_light = cg::Math::Clamp(value, 0.0f, 100.0f);
+      break;
+    case VehicleParameter::PercentageRunningSign:
+      record.perc_run_traffic_sign = cg::Math::Clamp(value, 0.0f, 100.0f);
+      break;
+    case VehicleParameter::PercentageIgnoreWalkers:
+      record.perc_ignore_walkers = cg::Math::Clamp(value, 0.0f, 100.0f);
+      break;
+    case VehicleParameter::PercentageIgnoreVehicles:
+      record.perc_ignore_vehicles = cg::Math::Clamp(value, 0.0f, 100.0f);
+      break;
+    case VehicleParameter::KeepRightPercentage:
+      record.perc_keep_right = value;
+      break;
+    case VehicleParameter::RandomLeftLaneChangePercentage:
+      record.perc_random_left = value;
+      break;
+    case VehicleParameter::RandomRightLaneChangePercentage:
+      record.perc_random_right = value;
+      break;
+    case VehicleParameter::ForceLaneChange:
+    default:
+      break;  // 强制换道不属于快照参数，由 ApplyParameterBatch 单独处理
   }
 }
 
+void Parameters::ApplyParameterBatch(const ParameterBatch &batch) {
+  std::lock_guard<std::mutex> lock(pending_mutex);
+  for (const auto &entry : batch) {
+    if (entry.GetParameter() == VehicleParameter::ForceLaneChange) {
+      force_lane_change.AddEntry({entry.actor_id, ChangeLaneInfo{true, entry.value != 0.0f}});
+    } else {
+      ApplyVehicleParameter(pending_vehicle_parameters[entry.actor_id], entry.GetParameter(), entry.value);
+    }
+  }
+  ++pending_epoch;  // 整批参数在下一个节拍一起生效
+}
+
 void Parameters::SetGlobalPercentageSpeedDifference(const float percentage) {  // 设置全局速度差百分比
   float new_percentage = std::min(100.0f, percentage);  // 限制最大百分比为100
   global_percentage_difference_from_limit = new_percentage;  // 设置全局速度差
@@ -101,44 +206,42 @@ void Parameters::SetForceLaneChange(const ActorPtr &actor, const bool direction)
 }
 
 void Parameters::SetKeepRightPercentage(const ActorPtr &actor, const float percentage) {  // 设置保持右侧的百分比
-  const auto entry = std::make_pair(actor->GetId(), percentage);  // 创建参与者ID和保持右侧百分比的条目
-  perc_keep_right.AddEntry(entry);  // 添加保持右侧记录
+  UpdateVehicleParameters(actor->GetId(), [&](VehicleParameters &record) {
+    ApplyVehicleParameter(record, VehicleParameter::KeepRightPercentage, percentage);
+  });
 }
 
 void Parameters::SetRandomLeftLaneChangePercentage(const ActorPtr &actor, const float percentage) {  // 设置随机左变道的百分比
-  const auto entry = std::make_pair(actor->GetId(), percentage);  // 创建参与者ID和随机左变道百分比的条目
-  perc_random_left.AddEntry(entry);  // 添加随机左变道记录
+  UpdateVehicleParameters(actor->GetId(), [&](VehicleParameters &record) {
+    ApplyVehicleParameter(record, VehicleParameter::RandomLeftLaneChangePercentage, percentage);
+  });
 }
 
 void Parameters::SetRandomRightLaneChangePercentage(const ActorPtr &actor, const float percentage) {  // 设置随机右变道的百分比
-  const auto entry = std::make_pair(actor->GetId(), percentage);  // 创建参与者ID和随机右变道百分比的条目
-  perc_random_right.AddEntry(entry);  // 添加随机右变道记录
+  UpdateVehicleParameters(actor->GetId(), [&](VehicleParameters &record) {
+    ApplyVehicleParameter(record, VehicleParameter::RandomRightLaneChangePercentage, percentage);
+  });
 }
 
 void Parameters::SetUpdateVehicleLights(const ActorPtr &actor, const bool do_update) {
     // 设置车辆灯光更新状态
-    const auto entry = std::make_pair(actor->GetId(), do_update);
-    // 创建参与者ID和更新状态的条目
-    auto_update_vehicle_lights.AddEntry(entry);
-    // 将条目添加到自动更新车辆灯光列表中
+    UpdateVehicleParameters(actor->GetId(), [&](VehicleParameters &record) {
+        ApplyVehicleParameter(record, VehicleParameter::UpdateVehicleLights, do_update ? 1.0f : 0.0f);
+    });
 }
 
 void Parameters::SetAutoLaneChange(const ActorPtr &actor, const bool enable) {
     // 设置自动变道功能
-    const auto entry = std::make_pair(actor->GetId(), enable);
-    // 创建参与者ID和变道使能状态的条目
-    auto_lane_change.AddEntry(entry);
-    // 将条目添加到自动变道列表中
+    UpdateVehicleParameters(actor->GetId(), [&](VehicleParameters &record) {
+        ApplyVehicleParameter(record, VehicleParameter::AutoLaneChange, enable ? 1.0f : 0.0f);
+    });
 }
 
 void Parameters::SetDistanceToLeadingVehicle(const ActorPtr &actor, const float distance) {
     // 设置与前车的距离
-    float new_distance = std::max(0.0f, distance);
-    // 确保距离不小于0
-    const auto entry = std::make_pair(actor->GetId(), new_distance);
-    // 创建参与者ID和距离的条目
-    distance_to_leading_vehicle.AddEntry(entry);
-    // 将条目添加到前车距离列表中
+    UpdateVehicleParameters(actor->GetId(), [&](VehicleParameters &record) {
+        ApplyVehicleParameter(record, VehicleParameter::DistanceToLeadingVehicle, distance);
+    });
 }
 
 void Parameters::SetSynchronousMode(const bool mode_switch) {
@@ -151,6 +254,11 @@ void Parameters::SetSynchronousModeTimeOutInMiliSecond(const double time) {
     synchronous_time_out = std::chrono::duration<double, std::milli>(time);
 }
 
+void Parameters::SetPipelinedMode(const bool mode_switch) {
+    // 设置流水线模式开关
+    pipelined_mode.store(mode_switch);
+}
+
 void Parameters::SetGlobalDistanceToLeadingVehicle(const float dist) {
     // 设置全局前车距离
    distance_margin.store(dist);
@@ -158,33 +266,30 @@ void Parameters::SetGlobalDistanceToLeadingVehicle(const float dist) {
 
 void Parameters::SetPercentageRunningLight(const ActorPtr &actor, const float perc) {
     // 设置运行信号灯的百分比
-    float new_perc = cg::Math::Clamp(perc, 0.0f, 100.0f);
-    // 确保百分比在0到100之间
-    const auto entry = std::make_pair(actor->GetId(), new_perc);
-    // 创建参与者ID和百分比的条目
-    perc_run_traffic_light.AddEntry(entry);
-    // 将条目添加到运行信号灯百分比列表中
+    UpdateVehicleParameters(actor->GetId(), [&](VehicleParameters &record) {
+        ApplyVehicleParameter(record, VehicleParameter::PercentageRunningLight, perc);
+    });
 }
 
 void Parameters::SetPercentageRunningSign(const ActorPtr &actor, const float perc) {
     // 设置运行标志的百分比
-   float new_perc = cg::Math::Clamp(perc, 0.0f, 100.0f);
-   const auto entry = std::make_pair(actor->GetId(), new_perc);
-   perc_run_traffic_sign.AddEntry(entry);
+    UpdateVehicleParameters(actor->GetId(), [&](VehicleParameters &record) {
+        ApplyVehicleParameter(record, VehicleParameter::PercentageRunningSign, perc);
+    });
 }
 
 void Parameters::SetPercentageIgnoreVehicles(const ActorPtr &actor, const float perc) {
     // 设置忽略车辆的百分比
-   float new_perc = cg::Math::Clamp(perc, 0.0f, 100.0f);
-   const auto entry = std::make_pair(actor->GetId(), new_perc);
-   perc_ignore_vehicles.AddEntry(entry);
+    UpdateVehicleParameters(actor->GetId(), [&](VehicleParameters &record) {
+        ApplyVehicleParameter(record, VehicleParameter::PercentageIgnoreVehicles, perc);
+    });
 }
 
 void Parameters::SetPercentageIgnoreWalkers(const ActorPtr &actor, const float perc) {
     // 设置忽略行人的百分比
-   float new_perc = cg::Math::Clamp(perc, 0.0f, 100.0f);
-   const auto entry = std::make_pair(actor->GetId(), new_perc);
-   perc_ignore_walkers.AddEntry(entry);
+    UpdateVehicleParameters(actor->GetId(), [&](VehicleParameters &record) {
+        ApplyVehicleParameter(record, VehicleParameter::PercentageIgnoreWalkers, perc);
+    });
 }
 
 void Parameters::SetHybridPhysicsRadius(const float radius) {
@@ -270,17 +375,24 @@ double Parameters::GetSynchronousModeTimeOutInMiliSecond() const {
     return synchronous_time_out.count();
 }
 
+bool Parameters::GetPipelinedMode() const {
+    // 获取流水线模式状态
+    return pipelined_mode.load();
+}
+
 float Parameters::GetVehicleTargetVelocity(const ActorId &actor_id, const float speed_limit) const {
+    const VehicleParameters &record = GetSnapshotRecord(actor_id);
+
     // 从全局获取参与者与速度限制的百分比差异
     float percentage_difference = global_percentage_difference_from_limit;
 
     // 如果参与者的速度限制包含在内，获取其特定的百分比差异
-    if (percentage_difference_from_speed_limit.Contains(actor_id)) {
-        percentage_difference = percentage_difference_from_speed_limit.GetValue(actor_id);
-    } 
+    if (record.has_percentage_speed_difference) {
+        percentage_difference = record.percentage_speed_difference;
+    }
     // 如果参与者有精确的期望速度，直接返回该速度
-    else if (exact_desired_speed.Contains(actor_id)) {
-        return exact_desired_speed.GetValue(actor_id);
+    else if (record.has_exact_desired_speed) {
+        return record.exact_desired_speed;
     }
 
     // 根据速度限制和百分比差异计算目标速度
@@ -288,15 +400,9 @@ float Parameters::GetVehicleTargetVelocity(const ActorId &actor_id, const float
 }
 
 float Parameters::GetLaneOffset(const ActorId &actor_id) const {
-    // 从全局获取车道偏移
-    float offset = global_lane_offset;
-
-    // 如果参与者的车道偏移存在，获取其特定的偏移值
-    if (lane_offset.Contains(actor_id)) {
-        offset = lane_offset.GetValue(actor_id);
-    }
-
-   return offset; // 返回车道偏移
+    const VehicleParameters &record = GetSnapshotRecord(actor_id);
+    // 参与者的车道偏移存在时使用其特定的偏移值，否则使用全局偏移
+    return record.has_lane_offset ? record.lane_offset : global_lane_offset.load();
 }
 
 bool Parameters::GetCollisionDetection(const ActorId &reference_actor_id, const ActorId &other_actor_id) const {
@@ -328,125 +434,54 @@ ChangeLaneInfo Parameters::GetForceLaneChange(const ActorId &actor_id) {
 }
 
 float Parameters::GetKeepRightPercentage(const ActorId &actor_id) {
-    // 初始化保持右侧的百分比
-    float percentage = -1.0f;
-
-    // 如果参与者的保持右侧百分比存在，获取其值
-    if (perc_keep_right.Contains(actor_id)) {
-        percentage = perc_keep_right.GetValue(actor_id);
-    }
-
-   return percentage; // 返回保持右侧的百分比
+    // 返回保持右侧的百分比，未设置时为 -1
+    return GetSnapshotRecord(actor_id).perc_keep_right;
 }
 
 float Parameters::GetRandomLeftLaneChangePercentage(const ActorId &actor_id) {
-    // 初始化随机左侧车道变更的百分比
-    float percentage = -1.0f;
-
-    // 如果参与者的随机左侧车道变更百分比存在，获取其值
-    if (perc_random_left.Contains(actor_id)) {
-        percentage = perc_random_left.GetValue(actor_id);
-    }
-
-   return percentage; // 返回随机左侧车道变更的百分比
+    // 返回随机左侧车道变更的百分比，未设置时为 -1
+    return GetSnapshotRecord(actor_id).perc_random_left;
 }
 
 float Parameters::GetRandomRightLaneChangePercentage(const ActorId &actor_id) {
-    // 初始化随机右侧车道变更的百分比
-    float percentage = -1.0f;
-
-    // 如果参与者的随机右侧车道变更百分比存在，获取其值
-    if (perc_random_right.Contains(actor_id)) {
-        percentage = perc_random_right.GetValue(actor_id);
-    }
-
-   return percentage; // 返回随机右侧车道变更的百分比
+    // 返回随机右侧车道变更的百分比，未设置时为 -1
+    return GetSnapshotRecord(actor_id).perc_random_right;
 }
 
 bool Parameters::GetAutoLaneChange(const ActorId &actor_id) const {
     // 默认自动车道变更政策为真
-    bool auto_lane_change_policy = true;
-
-    // 如果参与者的自动车道变更设置存在，获取其值
-    if (auto_lane_change.Contains(actor_id)) {
-        auto_lane_change_policy = auto_lane_change.GetValue(actor_id);
-    }
-
-   return auto_lane_change_policy; // 返回自动车道变更政策
+    return GetSnapshotRecord(actor_id).auto_lane_change;
 }
 
 float Parameters::GetDistanceToLeadingVehicle(const ActorId &actor_id) const {
-    // 初始化与前车的距离边际
-    float specific_distance_margin = 0.0f;
-    
-    // 如果参与者的前车距离存在，获取其值
-    if (distance_to_leading_vehicle.Contains(actor_id)) {
-        specific_distance_margin = distance_to_leading_vehicle.GetValue(actor_id);
-    } else {
-        specific_distance_margin = distance_margin; // 否则使用全局默认值
-    }
-
-    return specific_distance_margin; // 返回与前车的距离
+    const VehicleParameters &record = GetSnapshotRecord(actor_id);
+    // 参与者的前车距离存在时使用其值，否则使用全局默认值
+    return record.has_distance_to_leading_vehicle ? record.distance_to_leading_vehicle : distance_margin.load();
 }
 
 float Parameters::GetPercentageRunningLight(const ActorId &actor_id) const {
-    // 初始化红绿灯违规的百分比
-    float percentage = 0.0f;
-
-    // 如果参与者的红绿灯违规百分比存在，获取其值
-    if (perc_run_traffic_light.Contains(actor_id)) {
-        percentage = perc_run_traffic_light.GetValue(actor_id);
-    }
-
-   return percentage; // 返回红绿灯违规的百分比
+    // 返回红绿灯违规的百分比
+    return GetSnapshotRecord(actor_id).perc_run_traffic_light;
 }
 
 float Parameters::GetPercentageRunningSign(const ActorId &actor_id) const {
-    // 初始化交通标志违规的百分比
-    float percentage = 0.0f;
-
-    // 如果参与者的交通标志违规百分比存在，获取其值
-    if (perc_run_traffic_sign.Contains(actor_id)) {
-        percentage = perc_run_traffic_sign.GetValue(actor_id);
-    }
-
-   return percentage; // 返回交通标志违规的百分比
+    // 返回交通标志违规的百分比
+    return GetSnapshotRecord(actor_id).perc_run_traffic_sign;
 }
 
 float Parameters::GetPercentageIgnoreWalkers(const ActorId &actor_id) const {
-    // 初始化忽略行人的百分比
-    float percentage = 0.0f;
-
-    // 如果参与者的忽略行人百分比存在，获取其值
-    if (perc_ignore_walkers.Contains(actor_id)) {
-        percentage = perc_ignore_walkers.GetValue(actor_id);
-    }
-
-   return percentage; // 返回忽略行人的百分比
+    // 返回忽略行人的百分比
+    return GetSnapshotRecord(actor_id).perc_ignore_walkers;
 }
 
 bool Parameters::GetUpdateVehicleLights(const ActorId &actor_id) const {
-    // 默认更新车辆灯光为假
-    bool do_update = false;
-
-    // 如果参与者的灯光更新设置存在，获取其值
-    if (auto_update_vehicle_lights.Contains(actor_id)) {
-        do_update = auto_update_vehicle_lights.GetValue(actor_id);
-    }
-
-   return do_update; // 返回灯光更新设置
+    // 默认不更新车辆灯光
+    return GetSnapshotRecord(actor_id).auto_update_vehicle_lights;
 }
 
 float Parameters::GetPercentageIgnoreVehicles(const ActorId &actor_id) const {
-    // 初始化忽略其他车辆的百分比
-    float percentage = 0.0f;
-
-    // 如果参与者的忽略车辆百分比存在，获取其值
-    if (perc_ignore_vehicles.Contains(actor_id)) {
-        percentage = perc_ignore_vehicles.GetValue(actor_id);
-    }
-
-   return percentage; // 返回忽略车辆的百分比
+    // 返回忽略车辆的百分比
+    return GetSnapshotRecord(actor_id).perc_ignore_vehicles;
 }
 
 bool Parameters::GetHybridPhysicsMode() const {
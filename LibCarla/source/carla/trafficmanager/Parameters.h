@@ -8,8 +8,11 @@
 
 #include <atomic>  /// 提供原子操作，确保线程安全
 #include <chrono>  /// 提供时间功能，用于时间计算
+#include <memory>  /// 提供智能指针，用于持有参数快照
+#include <mutex>   /// 提供互斥锁，保护待发布的参数
 #include <random>  /// 提供随机数生成功能
 #include <unordered_map> /// 提供无序映射容器，用于快速查找
+#include <vector>
 /// 包含Carla客户端相关的头文件
 #include "carla/client/Actor.h"
 #include "carla/client/Vehicle.h"
@@ -18,6 +21,7 @@
 
 #include "carla/trafficmanager/AtomicActorSet.h"/// 包含Carla交通管理器的相关头文件
 #include "carla/trafficmanager/AtomicMap.h"
+#include "carla/trafficmanager/ParameterBatch.h"
 
 namespace carla {
     namespace traffic_manager {
@@ -33,46 +37,73 @@ namespace carla {
             bool change_lane = false;/// 是否换道
             bool direction = false;/// 换道方向
         };
+        /// 单个车辆的参数记录。未设置的值使用全局默认值
+        struct VehicleParameters {
+            /// 相对于速度限制的速度差百分比
+            bool has_percentage_speed_difference = false;
+            float percentage_speed_difference = 0.0f;
+            /// 精确的期望速度
+            bool has_exact_desired_speed = false;
+            float exact_desired_speed = 0.0f;
+            /// 车道偏移
+            bool has_lane_offset = false;
+            float lane_offset = 0.0f;
+            /// 到前车的距离
+            bool has_distance_to_leading_vehicle = false;
+            float distance_to_leading_vehicle = 0.0f;
+            /// 自动换道
+            bool auto_lane_change = true;
+            /// 闯红灯、闯标志、忽略行人与车辆的百分比
+            float perc_run_traffic_light = 0.0f;
+            float perc_run_traffic_sign = 0.0f;
+            float perc_ignore_walkers = 0.0f;
+            float perc_ignore_vehicles = 0.0f;
+            /// 靠右行驶与随机换道的百分比，-1 表示未设置
+            float perc_keep_right = -1.0f;
+            float perc_random_left = -1.0f;
+            float perc_random_right = -1.0f;
+            /// 车辆灯光自动更新
+            bool auto_update_vehicle_lights = false;
+        };
+
+        /// 某一时刻所有车辆参数的不可变快照，按参与者 ID 排序连续存放
+        struct ParameterSnapshot {
+            std::vector<ActorId> ids;
+            std::vector<VehicleParameters> records;
+
+            /// 查找车辆的参数记录，未设置过参数的车辆返回默认记录
+            const VehicleParameters &Find(const ActorId &actor_id) const;
+        };
+
         /// 交通管理参数
+        ///
+        /// 每辆车的参数写入待发布的记录表（由互斥锁保护），并在每个节拍开始时
+        /// 通过 PublishSnapshot 发布为不可变快照。各阶段读取参数时只访问当前快照，
+        /// 不再加锁；上一份快照会多保留一个节拍，以保证仍在读取它的线程安全。
         class Parameters {
 
         private:
-            /// 基于速度限制差异的单个车辆目标速度映射
-            AtomicMap<ActorId, float> percentage_difference_from_speed_limit;
-            /// 单个车辆的车道偏移映射
-            AtomicMap<ActorId, float> lane_offset;
-            /// 基于期望速度的单个车辆目标速度映射
-            AtomicMap<ActorId, float> exact_desired_speed;
+            /// 待发布的单车参数，以及修改计数
+            std::unordered_map<ActorId, VehicleParameters> pending_vehicle_parameters;
+            mutable std::mutex pending_mutex;
+            std::atomic<uint64_t> pending_epoch{ 0u };
+            uint64_t published_epoch = 0u;
+            /// 当前发布的快照（读取时不加锁）及其所有权
+            std::atomic<const ParameterSnapshot *> current_snapshot{ nullptr };
+            std::shared_ptr<const ParameterSnapshot> current_snapshot_owner;
+            std::shared_ptr<const ParameterSnapshot> previous_snapshot_owner;
             /// 全局目标速度限制差异百分比
-            float global_percentage_difference_from_limit = 0;
+            std::atomic<float> global_percentage_difference_from_limit{ 0.0f };
             /// 全局车道偏移
-            float global_lane_offset = 0;
+            std::atomic<float> global_lane_offset{ 0.0f };
             /// 在碰撞检测期间要忽略的演员集合映射
             AtomicMap<ActorId, std::shared_ptr<AtomicActorSet>> ignore_collision;
-            /// 到前导车辆的距离映射
-            AtomicMap<ActorId, float> distance_to_leading_vehicle;
-            /// 强制换道命令映射
+            /// 强制换道命令映射（读取后即被消费，因此不放入快照）
             AtomicMap<ActorId, ChangeLaneInfo> force_lane_change;
-            /// 自动换道命令映射
-            AtomicMap<ActorId, bool> auto_lane_change;
-            /// 闯交通信号灯百分比映射
-            AtomicMap<ActorId, float> perc_run_traffic_light;
-            /// 闯交通标志百分比映射
-            AtomicMap<ActorId, float> perc_run_traffic_sign;
-            /// 忽略行人百分比映射
-            AtomicMap<ActorId, float> perc_ignore_walkers;
-            /// 忽略车辆百分比映射
-            AtomicMap<ActorId, float> perc_ignore_vehicles;
-            /// 靠右行驶规则百分比映射
-            AtomicMap<ActorId, float> perc_keep_right;
-            /// 随机左换道百分比映射
-            AtomicMap<ActorId, float> perc_random_left;
-            /// 随机右换道百分比映射
-            AtomicMap<ActorId, float> perc_random_right;
-            /// 车辆灯光自动更新标志映射
-            AtomicMap<ActorId, bool> auto_update_vehicle_lights;
             /// 同步开关
             std::atomic<bool> synchronous_mode{ false };
+            /// 同步模式下的流水线开关
+            std::atomic<bool> pipelined_mode{ false };
             /// 距离边距
             std::atomic<float> distance_margin{ 2.0 };
             /// 混合物理模式开关
@@ -100,14 +131,42 @@ namespace carla {
             /// 存储所有自定义路线的结构
             AtomicMap<ActorId, Route> custom_route;
 
+            /// 修改待发布的单车参数记录
+            template <typename FunctorT>
+            void UpdateVehicleParameters(const ActorId &actor_id, FunctorT &&functor) {
+                std::lock_guard<std::mutex> lock(pending_mutex);
+                functor(pending_vehicle_parameters[actor_id]);
+                ++pending_epoch;
+            }
+
+            /// 将单个参数写入记录，并进行与对应设置函数相同的范围限制
+            static void ApplyVehicleParameter(VehicleParameters &record, VehicleParameter parameter, float value);
+
+            /// 当前快照中车辆的参数记录
+            const VehicleParameters &GetSnapshotRecord(const ActorId &actor_id) const {
+                return current_snapshot.load(std::memory_order_acquire)->Find(actor_id);
+            }
+
         public:
             /// 构造函数
             Parameters();
             /// 析构函数
             ~Parameters();
 
+            /// 若自上次发布以来参数有变化，则将其发布为新的不可变快照。
+            /// 由交通管理器在每个节拍开始时调用。
+            void PublishSnapshot();
+
+            /// 返回车辆在当前快照中的全部参数
+            const VehicleParameters &GetVehicleParameters(const ActorId &actor_id) const {
+                return GetSnapshotRecord(actor_id);
+            }
+
             ////////////////////////////////// SETTERS /////////////////////////////////////
 
+            /// 在一次加锁内按顺序应用一组单车参数
+            void ApplyParameterBatch(const ParameterBatch &batch);
+
             /// 设置车辆相对于速度限制的速度降低百分比
             /// 如果小于0，则表示速度增加百分比
             void SetPercentageSpeedDifference(const ActorPtr& actor, const float percentage);
@@ -173,6 +232,9 @@ namespace carla {
             /// 设置同步模式超时时间
             void SetSynchronousModeTimeOutInMiliSecond(const double time);///< 超时时间值
 
+            /// 设置同步模式下流水线执行的方法
+            void SetPipelinedMode(const bool mode_switch);///< 是否启用流水线模式的布尔值
+
             /// 设置混合物理模式的方法
             void SetHybridPhysicsMode(const bool mode_switch);///< 是否启用混合物理模式的布尔值
 
@@ -265,6 +327,9 @@ namespace carla {
             /// 获取同步模式超时
             double GetSynchronousModeTimeOutInMiliSecond() const;
 
+            /// 获取流水线模式的方法
+            bool GetPipelinedMode() const;
+
             /// 获取混合物理模式的方法
             bool GetHybridPhysicsMode() const;
 
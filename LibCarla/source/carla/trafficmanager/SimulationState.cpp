@@ -33,6 +33,7 @@ void SimulationState::Reset() {
   kinematic_state_map.clear();// 清空 kinematic_state_map
   static_attribute_map.clear();// 清空 static_attribute_map
   tl_state_map.clear(); // 清空 tl_state_map
+  timestamp = cc::Timestamp(); // 重置时间戳
 }
 // 更新特定actor的运动状态
 void SimulationState::UpdateKinematicState(ActorId actor_id, KinematicState state) {
@@ -3,6 +3,7 @@
 
 #include <unordered_set> // 引入无序集合头文件
 
+#include "carla/client/Timestamp.h" // 引入时间戳类的定义
 #include "carla/trafficmanager/DataStructures.h" // 引入数据结构的头文件
 
 namespace carla {
@@ -55,6 +56,8 @@ private:
   StaticAttributeMap static_attribute_map; 
   // 存储参与者动态交通灯相关状态的结构
   TrafficLightStateMap tl_state_map; 
+  // 当前节拍所用世界快照的时间戳，各阶段统一读取，不再各自查询世界
+  cc::Timestamp timestamp;
 
 public :
   SimulationState(); // 构造函数
@@ -119,6 +122,16 @@ public :
   // 获取参与者尺寸的方法
   cg::Vector3D GetDimensions(const ActorId actor_id) const;
 
+  // 设置当前节拍时间戳的方法
+  void SetTimestamp(const cc::Timestamp &current_timestamp) {
+    timestamp = current_timestamp;
+  }
+
+  // 获取当前节拍时间戳的方法
+  const cc::Timestamp &GetTimestamp() const {
+    return timestamp;
+  }
+
 };
 
 } // namespace traffic_manager
@@ -43,7 +43,7 @@ void TrafficLightStage::Update(const unsigned long index) {
     }
     auto affected_junction_id = GetAffectedJunctionId(ego_actor_id); // 获取受影响的交叉口 ID
 
-    current_timestamp = world.GetSnapshot().GetTimestamp(); // 获取当前时间戳
+    current_timestamp = simulation_state.GetTimestamp(); // 获取本节拍的时间戳
 
     const TrafficLightState tl_state = simulation_state.GetTLS(ego_actor_id); // 获取交通信号灯状态
     const TLS traffic_light_state = tl_state.tl_state; // 交通信号灯当前状态
@@ -236,6 +236,23 @@ public:
     }
   }
 
+  /// @brief 按顺序应用一组单车参数。远程交通管理器只需一次往返。
+  /// 只支持 VehicleParameter 中的标量参数，路径和路线请使用 SetCustomPath/SetImportedRoute。
+  /// @param batch 批量参数。
+  void ApplyParameterBatch(const ParameterBatch &batch) {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if(tm_ptr != nullptr){
+      tm_ptr->ApplyParameterBatch(batch);
+    }
+  }
+
+  /// @brief 为多辆车设置同一参数。
+  /// @param parameter 要设置的参数。
+  /// @param values (actor_id, value) 数组。
+  void SetVehicleParameterBatch(VehicleParameter parameter, const std::vector<std::pair<ActorId, float>> &values) {
+    ApplyParameterBatch(MakeParameterBatch(parameter, values));
+  }
+
   /// @brief 设置全局速度百分比差异。  
 /// 此方法用于设置所有车辆相对于道路限速的全局速度百分比差异。如果百分比小于0，则表示速度增加。  
 /// @param percentage 全局速度百分比差异。
@@ -354,6 +371,15 @@ public:
     }
   }
 
+  /// 设置同步模式下是否以流水线方式执行。
+/// @param mode_switch 为 true 时，交通管理器在服务器模拟下一帧的同时计算控制命令，命令延迟一帧生效。
+  void SetPipelinedMode(const bool mode_switch) {
+    TrafficManagerBase* tm_ptr = GetTM(_port);// 获取交通管理器实例
+    if(tm_ptr != nullptr){// 检查实例是否有效
+      tm_ptr->SetPipelinedMode(mode_switch);// 调用设置流水线模式的方法
+    }
+  }
+
   /// 执行同步滴答。  
 /// @return 如果成功执行同步滴答，则返回true；否则返回false。 
   bool SynchronousTick() {
@@ -9,6 +9,7 @@
 #include <memory>
 #include "carla/client/Actor.h"/// @brief 包含CARLA客户端中Actor类的定义
 #include "carla/trafficmanager/SimpleWaypoint.h"/// @brief 包含CARLA交通管理器中SimpleWaypoint类的定义
+#include "carla/trafficmanager/ParameterBatch.h"/// @brief 包含批量设置单车参数的定义
 /**
  * @namespace carla::traffic_manager
  * @brief CARLA交通管理器的命名空间。
@@ -119,6 +120,13 @@ public:
  */
   virtual void SetDesiredSpeed(const ActorPtr &actor, const float value) = 0;
 
+  /**
+ * @brief 按顺序应用一组单车参数。
+ * 远程交通管理器只需一次往返即可完成全部设置。
+ * @param batch 批量参数。
+ */
+  virtual void ApplyParameterBatch(const ParameterBatch &batch) = 0;
+
   /**
  * @brief 设置全局相对于限速的速度百分比降低。
  * 如果小于0，则表示百分比增加。
@@ -221,6 +229,16 @@ public:
   */
   virtual void SetSynchronousModeTimeOutInMiliSecond(double time) = 0;
 
+  /**
+  * @brief 设置同步模式下是否以流水线方式执行。
+  *
+  * 启用后，SynchronousTick 立即返回，交通管理器在服务器模拟下一帧的同时
+  * 根据当前帧计算控制命令，并在下一次 SynchronousTick 时应用，即固定一帧延迟。
+  *
+  * @param mode_switch 是否启用流水线模式。
+  */
+  virtual void SetPipelinedMode(const bool mode_switch) = 0;
+
   /**
  * @brief 提供同步Tick。
  *
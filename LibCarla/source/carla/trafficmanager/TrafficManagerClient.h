@@ -8,6 +8,7 @@
 
 #include "carla/trafficmanager/Constants.h"// 引入常量定义
 #include "carla/rpc/Actor.h"// 引入Actor类的定义
+#include "carla/trafficmanager/ParameterBatch.h"// 引入批量参数的定义
 
 #include <rpc/client.h>// 引入RPC客户端库
 
@@ -128,6 +129,13 @@ public:
     _client->call("set_desired_speed", std::move(_actor), value);// 调用RPC方法设置期望速度
   }
 
+  /// 按顺序应用一组单车参数。  
+/// @param batch 批量参数。
+  void ApplyParameterBatch(const ParameterBatch &batch) {
+    DEBUG_ASSERT(_client != nullptr);// 断言_client不为空
+    _client->call("apply_parameter_batch", batch);// 一次RPC调用发送全部参数
+  }
+
   /// 设置全局相对于限速的速度百分比差异。  
 /// 如果小于0，则表示百分比增加。  
 /// @param percentage 全局速度百分比差异。
@@ -230,6 +238,12 @@ public:
     _client->call("set_synchronous_mode_timeout_in_milisecond", time);/// 调用_client的call方法设置超时时间
   }
 
+  /// 设置同步模式下是否以流水线方式执行
+  void SetPipelinedMode(const bool mode_switch) {
+    DEBUG_ASSERT(_client != nullptr);/// 断言_client指针不为空
+    _client->call("set_pipelined_mode", mode_switch);/// 调用_client的call方法设置流水线模式
+  }
+
   /// 提供同步滴答（tick）操作
   bool SynchronousTick() {
     DEBUG_ASSERT(_client != nullptr);/// 断言_client指针不为空
@@ -7,6 +7,8 @@
 #include <algorithm>
 
 #include "carla/Logging.h"
+#include "carla/profiler/Metrics.h"
+#include "carla/profiler/Tracer.h"
 
 #include "carla/client/detail/Simulator.h"
 
@@ -142,6 +144,24 @@ void TrafficManagerLocal::Start() {
 // 启动交通管理器的工作线程
 void TrafficManagerLocal::Run() {
 
+  // 各阶段耗时和车辆数，以端口区分同一进程中的多个交通管理器
+  auto &registry = carla::profiler::MetricsRegistry::Get();
+  const std::string tm_label = "port=\"" + std::to_string(server.port()) + "\"";
+  auto stage_histogram = [&](const char *stage) -> carla::profiler::MetricHistogram & {
+    return registry.GetHistogram(
+        "carla_trafficmanager_stage_duration_seconds",
+        "Duration of the traffic manager stages per step.",
+        tm_label + ",stage=\"" + stage + "\"");
+  };
+  auto &step_duration = stage_histogram("step");
+  auto &alsm_duration = stage_histogram("alsm");
+  auto &localization_duration = stage_histogram("localization");
+  auto &collision_duration = stage_histogram("collision");
+  auto &planning_duration = stage_histogram("planning");
+  auto &apply_batch_duration = stage_histogram("apply_batch");
+  auto &vehicles_gauge = registry.GetGauge(
+      "carla_trafficmanager_registered_vehicles", "Vehicles registered with the traffic manager.", tm_label);
+
   localization_frame.reserve(INITIAL_SIZE);
   collision_frame.reserve(INITIAL_SIZE);
   tl_frame.reserve(INITIAL_SIZE);
@@ -155,10 +175,16 @@ void TrafficManagerLocal::Run() {
     bool hybrid_physics_mode = parameters.GetHybridPhysicsMode();
     parameters.SetMaxBoundaries(20.0f, episode_proxy.Lock()->GetEpisodeSettings().actor_active_distance);
 
+    bool pipelined_step = false;
+    boost::optional<cc::WorldSnapshot> pinned_snapshot;
        if (synchronous_mode) {   // 在同步模式下，等待外部触发以启动循环
       std::unique_lock<std::mutex> lock(step_execution_mutex);
       step_begin_trigger.wait(lock, [this]() {return step_begin.load() || !run_traffic_manger.load();});
       step_begin.store(false);
+      // 取出 SynchronousTick 为本节拍设置的执行方式和固定快照
+      pipelined_step = step_pipelined;
+      pinned_snapshot = std::move(step_snapshot);
+      step_snapshot.reset();
     }
 
     //   如果在异步混合模式下，经过的时间小于0.05秒，则跳过速度更新
@@ -181,9 +207,21 @@ void TrafficManagerLocal::Run() {
       last_frame = timestamp.frame;
     }
 
+    CARLA_TRACE_SCOPE(trafficmanager, Step);
+    carla::profiler::ScopedMetricTimer step_timer(step_duration);
     std::unique_lock<std::mutex> registration_lock(registration_mutex);
+    // 发布本节拍的参数快照，各阶段在节拍内只读取该快照
+    parameters.PublishSnapshot();
     // 更新模拟状态、角色生命周期并执行必要的清理
-    alsm.Update();
+    {
+      CARLA_TRACE_SCOPE(trafficmanager, ALSM);
+      carla::profiler::ScopedMetricTimer timer(alsm_duration);
+      if (pinned_snapshot) {
+        alsm.Update(*pinned_snapshot);
+      } else {
+        alsm.Update();
+      }
+    }
 
     // 基于已注册车辆数量变化的阶段间通信帧重新分配
     int current_registered_vehicles_state = registered_vehicles.GetState();
@@ -203,6 +241,7 @@ void TrafficManagerLocal::Run() {
       }
 
       registered_vehicles_state = registered_vehicles.GetState();
+      vehicles_gauge.Set(static_cast<double>(number_of_vehicles));
     }
 
     // 重置当前周期的帧
@@ -221,29 +260,50 @@ void TrafficManagerLocal::Run() {
     control_frame.resize(number_of_vehicles);
 
     // 运行核心操作阶段
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      localization_stage.Update(index);
+    {
+      CARLA_TRACE_SCOPE(trafficmanager, Localization);
+      carla::profiler::ScopedMetricTimer timer(localization_duration);
+      for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+        localization_stage.Update(index);
+      }
     }
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      collision_stage.Update(index);
+    {
+      CARLA_TRACE_SCOPE(trafficmanager, Collision);
+      carla::profiler::ScopedMetricTimer timer(collision_duration);
+      for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+        collision_stage.Update(index);
+      }
+      collision_stage.ClearCycleCache();
     }
-    collision_stage.ClearCycleCache();
-    vehicle_light_stage.UpdateWorldInfo();
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      traffic_light_stage.Update(index);
-      motion_plan_stage.Update(index);
-      vehicle_light_stage.Update(index);
+    {
+      CARLA_TRACE_SCOPE(trafficmanager, Planning);
+      carla::profiler::ScopedMetricTimer timer(planning_duration);
+      vehicle_light_stage.UpdateWorldInfo();
+      for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+        traffic_light_stage.Update(index);
+        motion_plan_stage.Update(index);
+        vehicle_light_stage.Update(index);
+      }
     }
 
     registration_lock.unlock();
 
     // 将当前周期的批处理命令发送给模拟器
     if (synchronous_mode) {
-      episode_proxy.Lock()->ApplyBatchSync(control_frame, false);
+      if (pipelined_step) {
+        // 流水线模式下由下一次 SynchronousTick 应用命令，保证固定一帧延迟
+        pending_control_frame.swap(control_frame);
+      } else {
+        CARLA_TRACE_SCOPE(trafficmanager, ApplyBatch);
+        carla::profiler::ScopedMetricTimer timer(apply_batch_duration);
+        episode_proxy.Lock()->ApplyBatchSync(control_frame, false);
+      }
       step_end.store(true);
       step_end_trigger.notify_one();
     } else {
       if (control_frame.size() > 0){
+        CARLA_TRACE_SCOPE(trafficmanager, ApplyBatch);
+        carla::profiler::ScopedMetricTimer timer(apply_batch_duration);
         episode_proxy.Lock()->ApplyBatchSync(control_frame, false);
       }
     }
@@ -252,16 +312,56 @@ void TrafficManagerLocal::Run() {
 // 在同步模式下执行单步操作
 bool TrafficManagerLocal::SynchronousTick() {
   if (parameters.GetSynchronousMode()) {
-    step_begin.store(true);
+    // 先取回上一个流水线节拍基于上一帧计算的命令，使其在服务器即将模拟的帧生效
+    CompletePipelinedStep();
+
+    const bool pipelined = parameters.GetPipelinedMode();
+    {
+      std::lock_guard<std::mutex> lock(step_execution_mutex);
+      step_pipelined = pipelined;
+      if (pipelined) {
+        // 固定当前帧的快照，计算期间服务器推进到下一帧也不影响结果
+        step_snapshot = world.GetSnapshot();
+      }
+      step_begin.store(true);
+    }
     step_begin_trigger.notify_one();
 
+    if (pipelined) {
+      // 不等待计算结束，交通管理器与服务器模拟下一帧并行进行
+      pipelined_step_in_flight = true;
+      return true;
+    }
+
     std::unique_lock<std::mutex> lock(step_execution_mutex);
     step_end_trigger.wait(lock, [this]() { return step_end.load(); });
     step_end.store(false);
+  } else {
+    // 退出同步模式时不丢弃已经计算出的命令
+    CompletePipelinedStep();
   }
   return true;
 }
 
+void TrafficManagerLocal::CompletePipelinedStep() {
+  if (!pipelined_step_in_flight) {
+    return;
+  }
+  pipelined_step_in_flight = false;
+  {
+    std::unique_lock<std::mutex> lock(step_execution_mutex);
+    step_end_trigger.wait(lock, [this]() { return step_end.load() || !run_traffic_manger.load(); });
+    if (!step_end.load()) {
+      return; // 交通管理器正在停止
+    }
+    step_end.store(false);
+  }
+  if (!pending_control_frame.empty()) {
+    episode_proxy.Lock()->ApplyBatchSync(pending_control_frame, false);
+  }
+  pending_control_frame.clear();
+}
+
 void TrafficManagerLocal::Stop() {
 // 停止交通管理器的工作线程并清理资源
     run_traffic_manger.store(false);// 停止交通管理器运行
@@ -295,6 +395,9 @@ void TrafficManagerLocal::Stop() {
   collision_frame.clear();
   tl_frame.clear();
   control_frame.clear();
+  pending_control_frame.clear();
+  pipelined_step_in_flight = false;
+  step_snapshot.reset();
    // 恢复状态变量
   run_traffic_manger.store(true); // 恢复交通管理器的运行状态
   step_begin.store(false);// 重置步开始标志
@@ -349,6 +452,10 @@ void TrafficManagerLocal::SetDesiredSpeed(const ActorPtr &actor, const float val
   parameters.SetDesiredSpeed(actor, value);
 }
 
+void TrafficManagerLocal::ApplyParameterBatch(const ParameterBatch &batch) {// 批量设置单车参数
+  parameters.ApplyParameterBatch(batch);
+}
+
 /// 设置车辆灯光自动管理的方法
 void TrafficManagerLocal::SetUpdateVehicleLights(const ActorPtr &actor, const bool do_update) {
   parameters.SetUpdateVehicleLights(actor, do_update);
@@ -469,6 +576,10 @@ bool TrafficManagerLocal::CheckAllFrozen(TLGroup tl_to_freeze) {
 
 void TrafficManagerLocal::SetSynchronousMode(bool mode) {
   const bool previous_mode = parameters.GetSynchronousMode();
+  if (previous_mode && !mode) {
+    // 离开同步模式前应用最后一个流水线节拍的命令
+    CompletePipelinedStep();
+  }
   parameters.SetSynchronousMode(mode);
   if (previous_mode && !mode) {
     step_begin.store(true);
@@ -480,6 +591,10 @@ void TrafficManagerLocal::SetSynchronousModeTimeOutInMiliSecond(double time) {
   parameters.SetSynchronousModeTimeOutInMiliSecond(time);
 }
 
+void TrafficManagerLocal::SetPipelinedMode(const bool mode_switch) {
+  parameters.SetPipelinedMode(mode_switch);
+}
+
 carla::client::detail::EpisodeProxy &TrafficManagerLocal::GetEpisodeProxy() {
   return episode_proxy;
 }
@@ -12,6 +12,8 @@
 #include <thread>///@brief 包含C++线程库，用于多线程编程
 #include <vector>///@brief 包含C++动态数组库，用于存储和管理序列化的数据
 
+#include <boost/optional.hpp>///@brief 流水线模式下保存触发节拍时的世界快照
+
 #include "carla/client/detail/EpisodeProxy.h"///@brief 包含CARLA客户端的Episode代理类，用于管理仿真场景的一个回合
 #include "carla/client/TrafficLight.h"///@brief 包含CARLA客户端的交通灯控制类
 #include "carla/client/World.h"///@brief 包含CARLA客户端的世界管理类，用于访问和修改仿真世界
@@ -165,6 +167,15 @@ private:
   /// std::condition_variable用于线程间的同步，当一个线程需要等待某个条件成立时，可以阻塞在该条件变量上，直到另一个线程通知条件已成立
   std::condition_variable step_begin_trigger;
   std::condition_variable step_end_trigger;
+  /// @brief 当前节拍是否以流水线方式执行，由 SynchronousTick 在触发节拍时设置
+  bool step_pipelined = false;
+  /// @brief 流水线节拍所用的世界快照，固定为触发节拍时的帧，
+  /// 服务器在计算期间推进到下一帧也不会影响结果
+  boost::optional<cc::WorldSnapshot> step_snapshot;
+  /// @brief 是否有尚未取回结果的流水线节拍，只由调用 SynchronousTick 的线程访问
+  bool pipelined_step_in_flight = false;
+  /// @brief 流水线节拍计算出、等待下一次 SynchronousTick 应用的控制命令
+  ControlFrame pending_control_frame;
   /// @brief 用于顺序执行子组件的单个工作线程  
   /// 使用std::unique_ptr<std::thread>管理线程的生命周期，确保线程在不再需要时能够被正确销毁
   std::unique_ptr<std::thread> worker_thread;
@@ -185,6 +196,8 @@ private:
   /// @param tl_to_freeze 要检查的交通灯组 
   /// @return 如果所有交通灯都被冻结，则返回true；否则返回false
   bool CheckAllFrozen(TLGroup tl_to_freeze);
+  /// @brief 等待正在进行的流水线节拍结束，并应用其计算出的控制命令
+  void CompletePipelinedStep();
 
 public:
     /// @brief 私有构造函数，用于单例生命周期管理  
@@ -252,6 +265,10 @@ public:
   /// @param value 车辆的期望速度值
   void SetDesiredSpeed(const ActorPtr &actor, const float value);
 
+  /// @brief 按顺序应用一组单车参数
+  /// @param batch 批量参数
+  void ApplyParameterBatch(const ParameterBatch &batch);
+
   /// @brief 设置全局相对于限速的速度百分比差异 
   /// @param percentage 全局速度百分比差异，如果小于0，则表示速度百分比增加  
   /// 此设置将影响所有已注册的车辆
@@ -324,6 +341,11 @@ public:
 /// @param time Tick超时时间，单位为毫秒
   void SetSynchronousModeTimeOutInMiliSecond(double time);
 
+  /// @brief 设置同步模式下是否以流水线方式执行。  
+///   
+/// @param mode_switch 启用后控制命令固定延迟一帧生效，交通管理器与服务器并行计算
+  void SetPipelinedMode(const bool mode_switch);
+
   /// @brief 提供同步Tick。  
 ///   
 /// @return 如果成功提供同步Tick，则返回true；否则返回false
@@ -151,6 +151,11 @@ void TrafficManagerRemote::SetDesiredSpeed(const ActorPtr &_actor, const float v
 // 通过客户端设置车辆的期望速度
 }
 
+void TrafficManagerRemote::ApplyParameterBatch(const ParameterBatch &batch) {
+  client.ApplyParameterBatch(batch);
+// 通过客户端一次性发送全部参数
+}
+
 void TrafficManagerRemote::SetGlobalPercentageSpeedDifference(const float percentage) {
   client.SetGlobalPercentageSpeedDifference(percentage);
 // 通过客户端设置全局速度差异百分比
@@ -353,6 +358,11 @@ void TrafficManagerRemote::SetSynchronousModeTimeOutInMiliSecond(double time) {
 // 通过客户端设置同步模式超时时间（毫秒）
 }
 
+void TrafficManagerRemote::SetPipelinedMode(const bool mode_switch) {
+  client.SetPipelinedMode(mode_switch);
+// 通过客户端设置流水线模式开关
+}
+
 Action TrafficManagerRemote::GetNextAction(const ActorId &actor_id) {
   return client.GetNextAction(actor_id);
 // 通过客户端获取指定车辆的下一个动作
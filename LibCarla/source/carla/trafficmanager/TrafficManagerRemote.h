@@ -134,6 +134,13 @@ public:
 	*/
   void SetDesiredSpeed(const ActorPtr &actor, const float value);
 
+  /**
+	* @brief 按顺序应用一组单车参数，整批参数只需一次 RPC 往返。
+	*
+	* @param batch 批量参数。
+	*/
+  void ApplyParameterBatch(const ParameterBatch &batch);
+
   /**
    * @brief 设置全局速度相对于限速的百分比减少量。
    *
@@ -248,6 +255,13 @@ public:
  */
   void SetSynchronousModeTimeOutInMiliSecond(double time);
 
+  /**
+ * @brief 设置同步模式下是否以流水线方式执行。
+ *
+ * @param mode_switch 是否启用流水线模式。
+ */
+  void SetPipelinedMode(const bool mode_switch);
+
   /**
   * @brief 设置车辆保持在右侧车道的百分比概率。
   *
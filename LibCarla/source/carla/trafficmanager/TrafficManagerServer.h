@@ -167,6 +167,11 @@ public:
         tm->SetDesiredSpeed(carla::client::detail::ActorVariant(actor).Get(tm->GetEpisodeProxy()), value);
       });
 
+      /// 批量设置单车参数的方法，整批参数按顺序应用
+      server->bind("apply_parameter_batch", [=](const ParameterBatch &batch) {
+        tm->ApplyParameterBatch(batch);
+      });
+
       /// 设置车辆灯光自动管理的方法
       server->bind("update_vehicle_lights", [=](carla::rpc::Actor actor, const bool do_update) {
           /// 设置是否更新车辆灯光
@@ -391,6 +396,12 @@ public:
         tm->SetSynchronousModeTimeOutInMiliSecond(time);
       });
 
+      /// 设置同步模式下是否以流水线方式执行
+      /// @param mode_switch 是否启用流水线模式
+      server->bind("set_pipelined_mode", [=](const bool mode_switch) {
+        tm->SetPipelinedMode(mode_switch);
+      });
+
       /// 设置随机化种子的方法
       /// @param seed 用于随机化过程的种子值
       server->bind("set_random_device_seed", [=](const uint64_t seed) {
@@ -0,0 +1,115 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "NavMesh.h"
+
+#include <carla/nav/Navigation.h>
+
+#include <cstring>
+
+namespace util {
+
+  std::vector<uint8_t> NavMesh::MakeFlat(float size) {
+    namespace cn = carla::nav;
+    const float cs = 0.5f;
+    const float ch = 0.2f;
+    const unsigned short cells = static_cast<unsigned short>(size / cs);
+
+    // 一个覆盖整个区域的四边形（以格子为单位），四条边都是边界
+    const unsigned short verts[] = {
+      0u,    0u, 0u,
+      0u,    0u, cells,
+      cells, 0u, cells,
+      cells, 0u, 0u
+    };
+    unsigned short polys[2 * DT_VERTS_PER_POLYGON];
+    for (int i = 0; i < DT_VERTS_PER_POLYGON; ++i) {
+      polys[i] = 0xffff;
+      polys[DT_VERTS_PER_POLYGON + i] = 0u;
+    }
+    for (unsigned short i = 0u; i < 4u; ++i) {
+      polys[i] = i;
+      polys[DT_VERTS_PER_POLYGON + i] = 0x800f;
+    }
+    const unsigned short flags[] = { cn::CARLA_TYPE_SIDEWALK };
+    const unsigned char areas[] = { cn::CARLA_AREA_SIDEWALK };
+
+    dtNavMeshCreateParams params;
+    std::memset(&params, 0, sizeof(params));
+    params.verts = verts;
+    params.vertCount = 4;
+    params.polys = polys;
+    params.polyFlags = flags;
+    params.polyAreas = areas;
+    params.polyCount = 1;
+    params.nvp = DT_VERTS_PER_POLYGON;
+    params.bmin[0] = 0.0f;
+    params.bmin[1] = 0.0f;
+    params.bmin[2] = 0.0f;
+    params.bmax[0] = size;
+    params.bmax[1] = 2.0f;
+    params.bmax[2] = size;
+    params.walkableHeight = 2.0f;
+    params.walkableRadius = 0.3f;
+    params.walkableClimb = 0.9f;
+    params.cs = cs;
+    params.ch = ch;
+    params.buildBvTree = true;
+
+    unsigned char *data = nullptr;
+    int data_size = 0;
+    if (!dtCreateNavMeshData(&params, &data, &data_size)) {
+      return {};
+    }
+
+    dtNavMeshParams mesh_params;
+    std::memset(&mesh_params, 0, sizeof(mesh_params));
+    mesh_params.tileWidth = size;
+    mesh_params.tileHeight = size;
+    mesh_params.maxTiles = 1;
+    mesh_params.maxPolys = 1;
+
+    // 与 Navigation::Load 中的结构相同
+#pragma pack(push, 1)
+    struct NavMeshSetHeader {
+      int magic;
+      int version;
+      int num_tiles;
+      dtNavMeshParams params;
+    } header;
+    struct NavMeshTileHeader {
+      dtTileRef tile_ref;
+      int data_size;
+    } tile_header;
+#pragma pack(pop)
+
+    header.magic = 'M' << 24 | 'S' << 16 | 'E' << 8 | 'T';
+    header.version = 1;
+    header.num_tiles = 1;
+    header.params = mesh_params;
+
+    std::vector<uint8_t> result(sizeof(header) + sizeof(tile_header) + static_cast<size_t>(data_size));
+    std::memcpy(result.data() + sizeof(header) + sizeof(tile_header), data, static_cast<size_t>(data_size));
+
+    // 瓦片引用的位数取决于 Detour 的编译选项，用一个临时网格生成
+    tile_header.tile_ref = 0;
+    tile_header.data_size = data_size;
+    dtNavMesh *mesh = dtAllocNavMesh();
+    if (mesh != nullptr && !dtStatusFailed(mesh->init(&mesh_params))) {
+      mesh->addTile(data, data_size, 0, 0, &tile_header.tile_ref);
+    }
+    dtFreeNavMesh(mesh);
+    dtFree(data);
+    if (tile_header.tile_ref == 0) {
+      return {};
+    }
+
+    std::memcpy(result.data(), &header, sizeof(header));
+    std::memcpy(result.data() + sizeof(header), &tile_header, sizeof(tile_header));
+    return result;
+  }
+
+} // namespace util
@@ -0,0 +1,23 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace util {
+
+  /// 生成测试用导航网格的工具类.
+  class NavMesh {
+  public:
+
+    /// 返回一块原点在 (0, 0)、边长为 @a size 米的平坦人行道网格，
+    /// 格式与 carla::nav::Navigation::Load 读取的二进制内容相同。
+    static std::vector<uint8_t> MakeFlat(float size);
+  };
+
+} // namespace util
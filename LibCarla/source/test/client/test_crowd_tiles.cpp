@@ -0,0 +1,207 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "NavMesh.h"
+
+#include <carla/geom/Location.h>
+#include <carla/nav/CrowdTileGrid.h>
+#include <carla/nav/Navigation.h>
+
+#include <algorithm>
+#include <cmath>
+
+using carla::geom::Location;
+using carla::nav::CrowdTileCoord;
+using carla::nav::CrowdTileGrid;
+using carla::nav::Navigation;
+
+static bool Contains(const std::vector<CrowdTileCoord> &tiles, int x, int y) {
+  return std::find(tiles.begin(), tiles.end(), std::make_pair(x, y)) != tiles.end();
+}
+
+// 所有方格人群中位于 Unreal 坐标 (x, y) 的活动代理数（包括副本）
+static int CountAgentsAt(const Navigation &nav, float x, float y) {
+  int count = 0;
+  for (dtCrowd *crowd : nav.GetCrowds()) {
+    for (int i = 0; i < crowd->getAgentCount(); ++i) {
+      const dtCrowdAgent *agent = crowd->getAgent(i);
+      if (agent->active &&
+          std::abs(agent->npos[0] - x) < 0.01f &&
+          std::abs(agent->npos[2] - y) < 0.01f) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+static int CountActiveAgents(const Navigation &nav) {
+  int count = 0;
+  for (dtCrowd *crowd : nav.GetCrowds()) {
+    for (int i = 0; i < crowd->getAgentCount(); ++i) {
+      if (crowd->getAgent(i)->active) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+TEST(crowd_tiles, untiled_grid_has_a_single_tile) {
+  CrowdTileGrid grid;
+  ASSERT_FALSE(grid.IsTiled());
+  ASSERT_EQ(grid.GetTileOf(-1000.0f, 2500.0f), std::make_pair(0, 0));
+  ASSERT_FALSE(grid.IsOutside(std::make_pair(0, 0), 1e6f, -1e6f, 2.0f));
+  auto tiles = grid.GetTilesAround(123.0f, -45.0f, 12.0f);
+  ASSERT_EQ(tiles.size(), 1u);
+  ASSERT_TRUE(Contains(tiles, 0, 0));
+}
+
+TEST(crowd_tiles, tile_of_position) {
+  CrowdTileGrid grid(50.0f);
+  ASSERT_EQ(grid.GetTileOf(0.0f, 0.0f), std::make_pair(0, 0));
+  ASSERT_EQ(grid.GetTileOf(49.9f, 10.0f), std::make_pair(0, 0));
+  ASSERT_EQ(grid.GetTileOf(50.0f, 10.0f), std::make_pair(1, 0));
+  // 负坐标向下取整，不能与方格 0 合并
+  ASSERT_EQ(grid.GetTileOf(-0.1f, -49.9f), std::make_pair(-1, -1));
+  ASSERT_EQ(grid.GetTileOf(-50.1f, 120.0f), std::make_pair(-2, 2));
+}
+
+TEST(crowd_tiles, handover_needs_to_cross_the_margin) {
+  CrowdTileGrid grid(50.0f);
+  const auto tile = std::make_pair(0, 0);
+  const float margin = 2.0f;
+  // 在边界附近来回走动时不移交
+  ASSERT_FALSE(grid.IsOutside(tile, 25.0f, 25.0f, margin));
+  ASSERT_FALSE(grid.IsOutside(tile, 51.0f, 25.0f, margin));
+  ASSERT_FALSE(grid.IsOutside(tile, -1.9f, 25.0f, margin));
+  ASSERT_FALSE(grid.IsOutside(tile, 25.0f, 51.9f, margin));
+  // 越过余量后移交
+  ASSERT_TRUE(grid.IsOutside(tile, 52.0f, 25.0f, margin));
+  ASSERT_TRUE(grid.IsOutside(tile, -2.1f, 25.0f, margin));
+  ASSERT_TRUE(grid.IsOutside(tile, 25.0f, 52.5f, margin));
+  ASSERT_TRUE(grid.IsOutside(tile, 25.0f, -3.0f, margin));
+  // 移交到新方格后，刚越过边界的位置在新方格中不会立即移交回去
+  const auto next = grid.GetTileOf(52.0f, 25.0f);
+  ASSERT_EQ(next, std::make_pair(1, 0));
+  ASSERT_FALSE(grid.IsOutside(next, 52.0f, 25.0f, margin));
+  ASSERT_FALSE(grid.IsOutside(next, 48.5f, 25.0f, margin));
+}
+
+TEST(crowd_tiles, border_walkers_reach_adjacent_tiles) {
+  CrowdTileGrid grid(50.0f);
+  const float margin = 3.0f;
+  // 方格中心附近只在自己的方格中
+  auto center = grid.GetTilesAround(25.0f, 25.0f, margin);
+  ASSERT_EQ(center.size(), 1u);
+  ASSERT_TRUE(Contains(center, 0, 0));
+  // 靠近右边界时也出现在右侧方格
+  auto border = grid.GetTilesAround(48.0f, 25.0f, margin);
+  ASSERT_EQ(border.size(), 2u);
+  ASSERT_TRUE(Contains(border, 0, 0));
+  ASSERT_TRUE(Contains(border, 1, 0));
+  // 在边界另一侧的行人同样出现在左侧方格，两侧的行人可以互相避让
+  auto other_side = grid.GetTilesAround(51.0f, 25.0f, margin);
+  ASSERT_TRUE(Contains(other_side, 0, 0));
+  ASSERT_TRUE(Contains(other_side, 1, 0));
+  // 靠近角落时出现在周围四个方格
+  auto corner = grid.GetTilesAround(-1.0f, 49.0f, margin);
+  ASSERT_EQ(corner.size(), 4u);
+  ASSERT_TRUE(Contains(corner, -1, 0));
+  ASSERT_TRUE(Contains(corner, 0, 0));
+  ASSERT_TRUE(Contains(corner, -1, 1));
+  ASSERT_TRUE(Contains(corner, 0, 1));
+}
+
+// 以下测试在 60 x 60 米的平坦网格上使用 20 米的方格，Unreal 坐标中 z 为行人中心的高度
+
+TEST(crowd_tiles, walkers_are_handed_over_between_tiles) {
+  Navigation nav;
+  ASSERT_TRUE(nav.Load(util::NavMesh::MakeFlat(60.0f)));
+  ASSERT_TRUE(nav.SetCrowdTileSize(20.0f));
+  ASSERT_TRUE(nav.AddWalker(1u, Location(15.0f, 10.0f, 0.9f)));
+  ASSERT_TRUE(nav.AddWalker(2u, Location(35.0f, 10.0f, 0.9f)));
+  ASSERT_TRUE(nav.SetWalkerDirectTarget(1u, Location(27.0f, 10.0f, 0.0f)));
+  // 添加代理后不能再修改方格大小
+  ASSERT_FALSE(nav.SetCrowdTileSize(10.0f));
+
+  CrowdTileCoord tile;
+  ASSERT_TRUE(nav.GetWalkerTile(1u, tile));
+  ASSERT_EQ(tile, std::make_pair(0, 0));
+  ASSERT_TRUE(nav.GetWalkerTile(2u, tile));
+  ASSERT_EQ(tile, std::make_pair(1, 0));
+
+  // 越过边界 (x = 20) 加上 2 米余量之后才移交
+  const float handover_x = 22.0f;
+  Location position;
+  for (int i = 0; i < 200; ++i) {
+    nav.UpdateCrowd(0.1);
+    ASSERT_TRUE(nav.GetWalkerPosition(1u, position));
+    ASSERT_TRUE(nav.GetWalkerTile(1u, tile));
+    if (position.x < handover_x - 0.1f) {
+      ASSERT_EQ(tile, std::make_pair(0, 0)) << "x = " << position.x;
+    } else if (position.x > handover_x + 0.1f) {
+      ASSERT_EQ(tile, std::make_pair(1, 0)) << "x = " << position.x;
+    }
+    if (position.x > 26.0f) {
+      break;
+    }
+  }
+  // 移交后行人在新的人群中继续走向原来的目标点
+  ASSERT_GT(position.x, 26.0f);
+  ASSERT_NEAR(position.y, 10.0f, 0.5f);
+  ASSERT_TRUE(nav.GetWalkerTile(1u, tile));
+  ASSERT_EQ(tile, std::make_pair(1, 0));
+  ASSERT_EQ(CountActiveAgents(nav), 2);
+}
+
+TEST(crowd_tiles, border_walkers_are_visible_in_adjacent_tiles) {
+  Navigation nav;
+  ASSERT_TRUE(nav.Load(util::NavMesh::MakeFlat(60.0f)));
+  ASSERT_TRUE(nav.SetCrowdTileSize(20.0f));
+  // 1 和 2 在边界 (x = 20) 两侧，3 远离边界
+  ASSERT_TRUE(nav.AddWalker(1u, Location(18.0f, 10.0f, 0.9f)));
+  ASSERT_TRUE(nav.AddWalker(2u, Location(22.0f, 10.0f, 0.9f)));
+  ASSERT_TRUE(nav.AddWalker(3u, Location(50.0f, 10.0f, 0.9f)));
+  ASSERT_TRUE(nav.GetWalkerGhostTiles(1u).empty());
+
+  nav.UpdateCrowd(0.1);
+
+  // 边界附近的行人在另一侧的人群中有一个副本，两侧的行人可以互相避让
+  auto ghosts = nav.GetWalkerGhostTiles(1u);
+  ASSERT_EQ(ghosts.size(), 1u);
+  ASSERT_TRUE(Contains(ghosts, 1, 0));
+  ghosts = nav.GetWalkerGhostTiles(2u);
+  ASSERT_EQ(ghosts.size(), 1u);
+  ASSERT_TRUE(Contains(ghosts, 0, 0));
+  ASSERT_TRUE(nav.GetWalkerGhostTiles(3u).empty());
+  ASSERT_EQ(CountActiveAgents(nav), 5);
+  Location position;
+  ASSERT_TRUE(nav.GetWalkerPosition(1u, position));
+  ASSERT_EQ(CountAgentsAt(nav, position.x, position.y), 2);
+
+  // 离开边界时副本跟随行人移动，走远后副本被移除
+  ASSERT_TRUE(nav.SetWalkerDirectTarget(1u, Location(10.0f, 10.0f, 0.0f)));
+  for (int i = 0; i < 100; ++i) {
+    nav.UpdateCrowd(0.1);
+    ASSERT_TRUE(nav.GetWalkerPosition(1u, position));
+    if (!nav.GetWalkerGhostTiles(1u).empty()) {
+      ASSERT_EQ(CountAgentsAt(nav, position.x, position.y), 2) << "x = " << position.x;
+    }
+    if (position.x < 16.5f) {
+      break;
+    }
+  }
+  ASSERT_LT(position.x, 16.5f);
+  CrowdTileCoord tile;
+  ASSERT_TRUE(nav.GetWalkerTile(1u, tile));
+  ASSERT_EQ(tile, std::make_pair(0, 0));
+  ASSERT_TRUE(nav.GetWalkerGhostTiles(1u).empty());
+  ASSERT_EQ(CountAgentsAt(nav, position.x, position.y), 1);
+  ASSERT_EQ(nav.GetWalkerGhostTiles(2u).size(), 1u);
+  ASSERT_EQ(CountActiveAgents(nav), 4);
+}
@@ -9,8 +9,16 @@
 #include <carla/image/ImageConverter.h>
 #include <carla/image/ImageIO.h>
 #include <carla/image/ImageView.h>
+#include <carla/image/VectorizedColorConverter.h>
 
+#include <boost/filesystem/operations.hpp>
+
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <random>
+#include <string>
+#include <vector>
 
 template <typename ViewT, typename PixelT>
 struct TestImage {
@@ -218,3 +226,147 @@ TEST(image, semantic_segmentation) {
     }
   }
 }
+
+static std::vector<char> ReadFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static std::string MakeTempPath(const std::string &extension) {
+  namespace fs = boost::filesystem;
+  return (fs::temp_directory_path() / fs::unique_path("carla-image-%%%%-%%%%" + extension)).string();
+}
+
+TEST(image, raw_and_npy_output) {
+  using namespace boost::gil;
+  using namespace carla::image;
+  constexpr size_t width = 3u;
+  constexpr size_t height = 2u;
+  auto img = MakeTestImage<bgra8_pixel_t>(width, height);
+  uint8_t value = 0u;
+  for (auto &pixel : img.view) {
+    pixel = bgra8_pixel_t(value, value + 1u, value + 2u, value + 3u);
+    value += 4u;
+  }
+
+  // 未编码输出与像素缓冲区逐字节一致
+  const auto raw_path = ImageIO::WriteRawView(MakeTempPath(".raw"), img.view, false);
+  const auto raw = ReadFile(raw_path);
+  ASSERT_EQ(raw.size(), width * height * 4u);
+  for (size_t i = 0u; i < raw.size(); ++i) {
+    ASSERT_EQ(static_cast<uint8_t>(raw[i]), static_cast<uint8_t>(i));
+  }
+
+  // .npy 头按 64 字节对齐，数据紧随其后
+  const auto npy_path = ImageIO::WriteRawView(MakeTempPath(".npy"), img.view, true);
+  const auto npy = ReadFile(npy_path);
+  ASSERT_GT(npy.size(), 10u);
+  ASSERT_EQ(std::string(npy.data() + 1u, 5u), "NUMPY");
+  const size_t header_size = 10u +
+      (static_cast<uint8_t>(npy[8]) | (static_cast<size_t>(static_cast<uint8_t>(npy[9])) << 8u));
+  ASSERT_EQ(header_size % 64u, 0u);
+  ASSERT_EQ(npy[header_size - 1u], '\n');
+  const std::string header(npy.data() + 10u, header_size - 10u);
+  ASSERT_NE(header.find("'shape': (2, 3, 4)"), std::string::npos) << header;
+  ASSERT_EQ(npy.size(), header_size + raw.size());
+  ASSERT_TRUE(std::equal(raw.begin(), raw.end(), npy.begin() + static_cast<std::ptrdiff_t>(header_size)));
+
+  // 转换为单通道后形状为 (高, 宽)
+  const auto depth_path = ImageIO::WriteRawView(
+      MakeTempPath(".npy"),
+      ImageView::MakeColorConvertedView(img.view, ColorConverter::Depth()),
+      true);
+  const auto depth = ReadFile(depth_path);
+  ASSERT_NE(std::string(depth.data(), depth.size()).find("'shape': (2, 3)"), std::string::npos);
+
+  boost::filesystem::remove(raw_path);
+  boost::filesystem::remove(npy_path);
+  boost::filesystem::remove(depth_path);
+}
+
+TEST(image, png_compression_level) {
+  using namespace boost::gil;
+  using namespace carla::image;
+  if (!io::has_png_support()) {
+    carla::log_info("PNG not supported, skipping.");
+    return;
+  }
+  constexpr size_t width = 64u;
+  constexpr size_t height = 64u;
+  auto img = MakeTestImage<rgb8_pixel_t>(width, height);
+  for (size_t y = 0u; y < height; ++y) {
+    for (size_t x = 0u; x < width; ++x) {
+      img.view(x, y) = rgb8_pixel_t(
+          static_cast<uint8_t>(x / 8u),
+          static_cast<uint8_t>(y / 8u),
+          0u);
+    }
+  }
+  const auto fast = ImageIO::WritePngView(MakeTempPath(".png"), img.view, 0);
+  const auto small = ImageIO::WritePngView(MakeTempPath(".png"), img.view, 9);
+  ASSERT_GT(boost::filesystem::file_size(fast), boost::filesystem::file_size(small));
+
+  // 不同压缩级别解码后的像素相同
+  rgb8_image_t decoded;
+  ImageIO::ReadImage(fast, decoded, io::png());
+  ASSERT_EQ(decoded.width(), static_cast<std::ptrdiff_t>(width));
+  ASSERT_TRUE(equal_pixels(const_view(decoded), img.view));
+  ImageIO::ReadImage(small, decoded, io::png());
+  ASSERT_TRUE(equal_pixels(const_view(decoded), img.view));
+
+  boost::filesystem::remove(fast);
+  boost::filesystem::remove(small);
+}
+
+template <typename ViewT>
+static void FillRandom(const ViewT &view, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> byte(0, 255);
+  for (auto &pixel : view) {
+    for (auto c = 0u; c < 4u; ++c) {
+      pixel[c] = static_cast<uint8_t>(byte(rng));
+    }
+  }
+}
+
+// 用逐像素的 ColorConverter 计算参考结果
+template <typename ViewT, typename CC>
+static void ReferenceConvert(const ViewT &src, const ViewT &dst, CC cc) {
+  using namespace carla::image;
+  using PixelT = typename ViewT::value_type;
+  boost::gil::copy_pixels(ImageView::MakeColorConvertedView<ViewT, PixelT>(src, cc), dst);
+}
+
+TEST(image, vectorized_color_converters) {
+  using namespace boost::gil;
+  using namespace carla::image;
+  // 宽度不是 8 的倍数，以覆盖向量化实现的尾部处理
+  constexpr size_t width = 1037u;
+  constexpr size_t height = 5u;
+  auto src = MakeTestImage<bgra8_pixel_t>(width, height);
+  auto expected = MakeTestImage<bgra8_pixel_t>(width, height);
+  auto actual = MakeTestImage<bgra8_pixel_t>(width, height);
+  FillRandom(src.view, 42u);
+
+  using ConvertFunction = void (*)(uint8_t *, size_t, SimdLevel);
+  const auto check = [&](auto cc, ConvertFunction convert, const char *name) {
+    ReferenceConvert(src.view, expected.view, cc);
+    for (auto level : {SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2}) {
+      copy_pixels(src.view, actual.view);
+      convert(reinterpret_cast<uint8_t *>(&actual.view(0, 0)), width * height, level);
+      ASSERT_TRUE(equal_pixels(expected.view, actual.view))
+          << name << " with SIMD level " << static_cast<int>(level);
+    }
+  };
+  check(ColorConverter::Depth(), &VectorizedColorConverter::Depth, "Depth");
+  check(ColorConverter::LogarithmicDepth(), &VectorizedColorConverter::LogarithmicDepth, "LogarithmicDepth");
+  check(ColorConverter::CityScapesPalette(), &VectorizedColorConverter::CityScapesPalette, "CityScapesPalette");
+
+  // ImageConverter 对 BGRA8 视图使用向量化实现，对带行填充的子视图逐行处理
+  auto sub_view = subimage_view(src.view, 3, 1, 100, 3);
+  auto sub_expected = MakeTestImage<bgra8_pixel_t>(100u, 3u);
+  ReferenceConvert(sub_view, sub_expected.view, ColorConverter::LogarithmicDepth());
+  ASSERT_FALSE(sub_view.is_1d_traversable());
+  ImageConverter::ConvertInPlace(sub_view, ColorConverter::LogarithmicDepth());
+  ASSERT_TRUE(equal_pixels(sub_expected.view, sub_view));
+}
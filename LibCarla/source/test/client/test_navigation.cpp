@@ -0,0 +1,47 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "NavMesh.h"
+
+#include <carla/client/detail/EpisodeState.h>
+#include <carla/nav/Navigation.h>
+
+using carla::client::detail::EpisodeState;
+using carla::nav::CrowdTickStats;
+using carla::nav::Navigation;
+
+TEST(navigation, load_flat_mesh) {
+  Navigation nav;
+  auto mesh = util::NavMesh::MakeFlat(20.0f);
+  ASSERT_FALSE(mesh.empty());
+  ASSERT_TRUE(nav.Load(std::move(mesh)));
+  ASSERT_NE(nav.GetCrowd(), nullptr);
+  carla::geom::Location location;
+  ASSERT_TRUE(nav.GetRandomLocation(location));
+  ASSERT_GE(location.x, 0.0f);
+  ASSERT_LE(location.x, 20.0f);
+  ASSERT_GE(location.y, 0.0f);
+  ASSERT_LE(location.y, 20.0f);
+}
+
+TEST(navigation, tick_stats) {
+  Navigation nav;
+  ASSERT_TRUE(nav.Load(util::NavMesh::MakeFlat(20.0f)));
+  CrowdTickStats stats = nav.GetTickStats();
+  ASSERT_EQ(stats.ticks, 0u);
+
+  const EpisodeState state(0u);
+  constexpr uint64_t ticks = 10u;
+  for (uint64_t i = 0u; i < ticks; ++i) {
+    nav.UpdateCrowd(state);
+  }
+  stats = nav.GetTickStats();
+  ASSERT_EQ(stats.ticks, ticks);
+  // 只有客户端的 WalkerNavigation 会填写整个导航节拍的统计
+  ASSERT_EQ(stats.navigation_ticks, 0u);
+  ASSERT_EQ(stats.navigation_us, 0u);
+}
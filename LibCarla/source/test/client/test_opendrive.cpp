@@ -504,3 +504,65 @@ TEST(road, get_waypoint) {
     result.get();
   }
 }
+
+TEST(road, get_waypoints_batch) {
+  for (const auto& file : util::OpenDrive::GetAvailableFiles()) {
+    carla::logging::log("Parsing", file);
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    auto &map = *m;
+    // 生成一批随机位置
+    std::vector<Location> locations;
+    for (auto i = 0u; i < 5'000u; ++i) {
+      locations.emplace_back(Random::Location(-500.0f, 500.0f));
+    }
+    // 批量结果必须与逐点查询的结果完全一致，且顺序与输入相同
+    const auto closest = map.GetClosestWaypointsOnRoad(locations);
+    const auto exact = map.GetWaypoints(locations);
+    ASSERT_EQ(closest.size(), locations.size());
+    ASSERT_EQ(exact.size(), locations.size());
+    for (auto i = 0u; i < locations.size(); ++i) {
+      const auto expected_closest = map.GetClosestWaypointOnRoad(locations[i]);
+      ASSERT_EQ(closest[i].has_value(), expected_closest.has_value());
+      if (expected_closest.has_value()) {
+        ASSERT_EQ(*closest[i], *expected_closest);
+      }
+      const auto expected_exact = map.GetWaypoint(locations[i]);
+      ASSERT_EQ(exact[i].has_value(), expected_exact.has_value());
+      if (expected_exact.has_value()) {
+        ASSERT_EQ(*exact[i], *expected_exact);
+      }
+    }
+  }
+}
+
+TEST(road, generate_waypoints_lazy_and_cached) {
+  for (const auto& file : util::OpenDrive::GetAvailableFiles()) {
+    carla::logging::log("Parsing", file);
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    auto &map = *m;
+    // 并行生成的结果与惰性生成器逐个生成的结果顺序一致
+    const auto waypoints = map.GenerateWaypoints(2.0);
+    auto generator = map.GenerateWaypointsLazy(2.0);
+    for (const auto &expected : waypoints) {
+      auto waypoint = generator.Next();
+      ASSERT_TRUE(waypoint.has_value());
+      ASSERT_EQ(*waypoint, expected);
+    }
+    ASSERT_FALSE(generator.Next().has_value());
+    // 第二次调用返回缓存的相同结果
+    const auto cached = map.GenerateWaypoints(2.0);
+    ASSERT_EQ(cached.size(), waypoints.size());
+    const auto topology = map.GenerateTopology();
+    ASSERT_EQ(map.GenerateTopology().size(), topology.size());
+    // 超出缓存上限后最久未使用的结果被丢弃，重新生成的结果不变
+    for (double distance : {3.0, 4.0, 5.0, 6.0, 7.0}) {
+      map.GenerateWaypoints(distance);
+    }
+    ASSERT_EQ(map.GenerateWaypoints(2.0).size(), waypoints.size());
+    map.ClearCache();
+    ASSERT_EQ(map.GenerateWaypoints(2.0).size(), waypoints.size());
+    ASSERT_EQ(map.GenerateTopology().size(), topology.size());
+  }
+}
@@ -0,0 +1,106 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/geom/Mesh.h>
+#include <carla/geom/Simplification.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace carla::geom;
+
+// 由若干三角形条带组成的起伏网格，@a seed 改变形状
+static std::unique_ptr<Mesh> MakeStripMesh(size_t rows, size_t columns, float seed) {
+  auto mesh = std::make_unique<Mesh>();
+  for (size_t row = 0u; row < rows; ++row) {
+    std::vector<Mesh::vertex_type> strip;
+    for (size_t column = 0u; column < columns; ++column) {
+      for (size_t side = 0u; side < 2u; ++side) {
+        const float x = static_cast<float>(column);
+        const float y = static_cast<float>(row + side);
+        strip.emplace_back(x, y, std::sin(seed + 0.3f * x) * std::cos(0.2f * y));
+      }
+    }
+    mesh->AddTriangleStrip(strip);
+  }
+  return mesh;
+}
+
+// 连通的起伏网格，内部的边可以被简化掉。索引从 1 开始，与 AddTriangleStrip 一致
+static std::unique_ptr<Mesh> MakeGridMesh(size_t rows, size_t columns, float seed) {
+  auto mesh = std::make_unique<Mesh>();
+  for (size_t row = 0u; row <= rows; ++row) {
+    for (size_t column = 0u; column <= columns; ++column) {
+      const float x = static_cast<float>(column);
+      const float y = static_cast<float>(row);
+      mesh->AddVertex(Vector3D(x, y, 0.2f * std::sin(seed + 0.3f * x) * std::cos(0.2f * y)));
+    }
+  }
+  auto index = [=](size_t row, size_t column) { return row * (columns + 1u) + column + 1u; };
+  for (size_t row = 0u; row < rows; ++row) {
+    for (size_t column = 0u; column < columns; ++column) {
+      mesh->AddIndex(index(row, column));
+      mesh->AddIndex(index(row, column + 1u));
+      mesh->AddIndex(index(row + 1u, column));
+      mesh->AddIndex(index(row + 1u, column));
+      mesh->AddIndex(index(row, column + 1u));
+      mesh->AddIndex(index(row + 1u, column + 1u));
+    }
+  }
+  return mesh;
+}
+
+TEST(mesh, append_keeps_indexes_and_materials) {
+  Mesh merged;
+  auto first = MakeStripMesh(2u, 4u, 0.0f);
+  auto second = MakeStripMesh(3u, 5u, 1.0f);
+  second->AddMaterial("road");
+  second->AddTriangleStrip({Vector3D(0, 0, 0), Vector3D(1, 0, 0), Vector3D(0, 1, 0)});
+  second->EndMaterial();
+  merged += *first;
+  merged += *second;
+  ASSERT_EQ(merged.GetVerticesNum(), first->GetVerticesNum() + second->GetVerticesNum());
+  ASSERT_EQ(merged.GetIndexesNum(), first->GetIndexesNum() + second->GetIndexesNum());
+  for (size_t i = 0u; i < second->GetIndexesNum(); ++i) {
+    ASSERT_EQ(merged.GetIndexes()[first->GetIndexesNum() + i], second->GetIndexes()[i] + first->GetVerticesNum());
+  }
+  ASSERT_EQ(merged.GetMaterials().size(), 1u);
+  EXPECT_EQ(merged.GetMaterials()[0].index_start, first->GetIndexesNum() + second->GetMaterials()[0].index_start);
+  EXPECT_TRUE(merged.IsValid());
+}
+
+TEST(mesh, parallel_simplification_matches_serial) {
+  std::vector<std::unique_ptr<Mesh>> serial;
+  std::vector<std::unique_ptr<Mesh>> parallel;
+  for (size_t i = 0u; i < 16u; ++i) {
+    serial.emplace_back(MakeGridMesh(4u + i, 20u + 3u * i, static_cast<float>(i)));
+    parallel.emplace_back(std::make_unique<Mesh>(*serial.back()));
+  }
+  // 空网格被跳过
+  serial.emplace_back(std::make_unique<Mesh>());
+  parallel.emplace_back(std::make_unique<Mesh>());
+
+  Simplification simplify(0.15f);
+  for (auto &mesh : serial) {
+    if (mesh->GetIndexesNum() >= 3u) {
+      simplify.Simplificate(mesh);
+    }
+  }
+  simplify.Simplificate(parallel);
+
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (size_t i = 0u; i < serial.size(); ++i) {
+    ASSERT_EQ(serial[i]->GetVertices().size(), parallel[i]->GetVertices().size()) << "mesh " << i;
+    for (size_t v = 0u; v < serial[i]->GetVertices().size(); ++v) {
+      ASSERT_EQ(serial[i]->GetVertices()[v], parallel[i]->GetVertices()[v]) << "mesh " << i;
+    }
+    ASSERT_EQ(serial[i]->GetIndexes(), parallel[i]->GetIndexes()) << "mesh " << i;
+  }
+  EXPECT_LT(serial[15]->GetIndexesNum(), MakeGridMesh(19u, 65u, 15.0f)->GetIndexesNum());
+}
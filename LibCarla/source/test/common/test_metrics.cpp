@@ -0,0 +1,150 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/profiler/Metrics.h>
+#include <carla/profiler/MetricsServer.h>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/read.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using carla::profiler::MetricsRegistry;
+
+TEST(metrics, counters_and_gauges) {
+  auto &registry = MetricsRegistry::Get();
+  auto &counter = registry.GetCounter("test_metrics_events_total", "Events.", "kind=\"a\"");
+  ASSERT_EQ(&counter, &registry.GetCounter("test_metrics_events_total", "", "kind=\"a\""));
+  ASSERT_NE(&counter, &registry.GetCounter("test_metrics_events_total", "", "kind=\"b\""));
+  auto &gauge = registry.GetGauge("test_metrics_level");
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 10000; ++j) {
+        counter.Increment();
+        gauge.Add(1.0);
+        gauge.Add(-0.5);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(counter.Get(), 40000u);
+  EXPECT_DOUBLE_EQ(gauge.Get(), 20000.0);
+
+  // 同名的指标不能以不同的类型注册
+  EXPECT_THROW(registry.GetGauge("test_metrics_events_total"), std::invalid_argument);
+
+  const auto text = registry.GetPrometheusText();
+  EXPECT_NE(text.find("# HELP test_metrics_events_total Events.\n"), std::string::npos);
+  EXPECT_NE(text.find("# TYPE test_metrics_events_total counter\n"), std::string::npos);
+  EXPECT_NE(text.find("test_metrics_events_total{kind=\"a\"} 40000\n"), std::string::npos);
+  EXPECT_NE(text.find("test_metrics_events_total{kind=\"b\"} 0\n"), std::string::npos);
+  EXPECT_NE(text.find("# TYPE test_metrics_level gauge\ntest_metrics_level 20000\n"), std::string::npos);
+}
+
+TEST(metrics, derived_gauge) {
+  auto &registry = MetricsRegistry::Get();
+  auto &in = registry.GetCounter("test_metrics_in_total");
+  auto &out = registry.GetCounter("test_metrics_out_total");
+  auto &gauge = registry.GetDerivedGauge("test_metrics_queued", "Queued.", "", [&]() {
+    return static_cast<double>(in.Get()) - static_cast<double>(out.Get());
+  });
+  // 再次注册时保留原来的计算函数
+  ASSERT_EQ(&gauge, &registry.GetDerivedGauge("test_metrics_queued", "", "", []() { return -1.0; }));
+  in.Increment(5u);
+  out.Increment(2u);
+  EXPECT_DOUBLE_EQ(gauge.Get(), 3.0);
+  EXPECT_NE(registry.GetPrometheusText().find("# TYPE test_metrics_queued gauge\ntest_metrics_queued 3\n"), std::string::npos);
+}
+
+TEST(metrics, histogram_quantiles) {
+  carla::profiler::MetricHistogram histogram(1e-6);
+  EXPECT_EQ(histogram.GetQuantile(0.5), 0.0);
+  // 对数均匀分布在 1 微秒到 10 秒之间
+  std::mt19937_64 random(42u);
+  std::uniform_real_distribution<double> exponent(0.0, 7.0);
+  std::vector<uint64_t> values;
+  for (int i = 0; i < 100000; ++i) {
+    values.push_back(static_cast<uint64_t>(std::pow(10.0, exponent(random))));
+    histogram.Record(values.back());
+  }
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(histogram.GetCount(), values.size());
+  EXPECT_DOUBLE_EQ(histogram.GetMax(), 1e-6 * static_cast<double>(values.back()));
+  for (double q : {0.01, 0.5, 0.9, 0.99, 0.999, 1.0}) {
+    const auto rank = static_cast<size_t>(std::ceil(q * static_cast<double>(values.size()))) - 1u;
+    const double expected = 1e-6 * static_cast<double>(values[rank]);
+    EXPECT_NEAR(histogram.GetQuantile(q), expected, 0.03 * expected) << "quantile " << q;
+  }
+
+  // 小的值是精确的
+  carla::profiler::MetricHistogram small;
+  for (uint64_t value = 1u; value <= 50u; ++value) {
+    small.Record(value);
+  }
+  EXPECT_EQ(small.GetQuantile(0.5), 25.0);
+  EXPECT_EQ(small.GetQuantile(1.0), 50.0);
+  EXPECT_EQ(small.GetSum(), 1275.0);
+
+  auto &registry = MetricsRegistry::Get();
+  auto &timings = registry.GetHistogram("test_metrics_duration_seconds", "Durations.", "stage=\"x\"");
+  // 只有一个值时分位数不超过最大值，即该值本身
+  timings.Record(2048u);
+  const auto text = registry.GetPrometheusText();
+  EXPECT_NE(text.find("# TYPE test_metrics_duration_seconds summary\n"), std::string::npos);
+  EXPECT_NE(text.find("test_metrics_duration_seconds{stage=\"x\",quantile=\"0.99\"} 0.002048\n"), std::string::npos);
+  EXPECT_NE(text.find("test_metrics_duration_seconds_sum{stage=\"x\"} 0.002048\n"), std::string::npos);
+  EXPECT_NE(text.find("test_metrics_duration_seconds_count{stage=\"x\"} 1\n"), std::string::npos);
+}
+
+TEST(metrics, server) {
+  MetricsRegistry::Get().GetCounter("test_metrics_served_total").Increment(7u);
+  // 需要本地的网络，无法监听或连接时跳过
+  std::unique_ptr<carla::profiler::MetricsServer> server;
+  try {
+    server = std::make_unique<carla::profiler::MetricsServer>(0u);
+    boost::asio::io_context io_context;
+    boost::asio::ip::tcp::socket socket(io_context);
+    socket.connect(server->GetLocalEndpoint());
+  } catch (const boost::system::system_error &e) {
+    std::cout << "skipping metrics.server: " << e.what() << std::endl;
+    return;
+  }
+
+  auto fetch = [&](const std::string &path) {
+    boost::asio::io_context io_context;
+    boost::asio::ip::tcp::socket socket(io_context);
+    socket.connect(server->GetLocalEndpoint());
+    const std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    boost::asio::write(socket, boost::asio::buffer(request));
+    std::string response;
+    boost::system::error_code ec;
+    boost::asio::read(socket, boost::asio::dynamic_buffer(response), ec);
+    EXPECT_EQ(ec, boost::asio::error::eof);
+    return response;
+  };
+
+  const auto response = fetch("/metrics");
+  EXPECT_EQ(response.find("HTTP/1.1 200 OK\r\n"), 0u);
+  EXPECT_NE(response.find("Content-Type: text/plain; version=0.0.4"), std::string::npos);
+  EXPECT_NE(response.find("\r\n\r\n"), std::string::npos);
+  EXPECT_NE(response.find("test_metrics_served_total 7\n"), std::string::npos);
+  EXPECT_EQ(fetch("/other").find("HTTP/1.1 404 Not Found\r\n"), 0u);
+  // 请求头超过 MetricsServer::MAX_REQUEST_SIZE 时不再读取
+  EXPECT_EQ(fetch("/" + std::string(16u * 1024u, 'x')).find("HTTP/1.1 431 "), 0u);
+}
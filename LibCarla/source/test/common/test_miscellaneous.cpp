@@ -6,8 +6,29 @@
 
 #include "test.h"
 
+#include <carla/StringUtil.h>
 #include <carla/Version.h>
 
+#include <string>
+#include <vector>
+
 TEST(miscellaneous, version) {
   std::cout << "LibCarla " << carla::version() << std::endl;
 }
+
+TEST(miscellaneous, wildcard_pattern) {
+  const std::vector<std::string> strings = {
+      "", "vehicle", "vehicle.", "vehicle.tesla.model3", "walker.pedestrian.0001",
+      "sensor.camera.rgb", "traffic.traffic_light", "aaa", "abab", "static.prop.bin"};
+  const std::vector<std::string> patterns = {
+      "", "*", "**", "vehicle", "vehicle.*", "*.*", "*walker*", "*.rgb",
+      "vehicle.*.model3", "a*a", "a*b*b", "*ab*ab*", "traffic.*_light",
+      "sensor.camera.?gb", "static.prop.[ab]in"};
+  for (auto &&pattern : patterns) {
+    const carla::WildcardPattern compiled(pattern);
+    for (auto &&str : strings) {
+      EXPECT_EQ(compiled.Match(str), carla::StringUtil::Match(str, pattern))
+          << "str = \"" << str << "\", pattern = \"" << pattern << '"';
+    }
+  }
+}
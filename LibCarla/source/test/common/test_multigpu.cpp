@@ -0,0 +1,315 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/multigpu/frameCodec.h>
+#include <carla/multigpu/loadBalancer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using carla::multigpu::CommandHeader;
+using carla::multigpu::LoadBalancer;
+using carla::multigpu::MultiGPUCommand;
+using carla::multigpu::SecondaryLoad;
+
+namespace {
+
+  /// 模拟的辅助服务器：帧时间为固定开销加上每单位代价的渲染时间。
+  struct SimulatedSecondary {
+    float base_ms;
+    float ms_per_cost;
+    float assigned_cost = 0.0f;
+
+    SimulatedSecondary(float base, float unit) : base_ms(base), ms_per_cost(unit) {}
+
+    float FrameTime() const {
+      return base_ms + ms_per_cost * assigned_cost;
+    }
+
+    SecondaryLoad MakeReport(uint64_t frame, uint32_t pending = 0u) const {
+      SecondaryLoad report;
+      report.frame = frame;
+      report.frame_time_ms = FrameTime();
+      report.pending_frames = pending;
+      return report;
+    }
+  };
+
+  /// 依次放置 @a costs 中的传感器，每放置一个后所有服务器报告一帧，
+  /// 返回最慢服务器的帧时间。
+  float Simulate(std::vector<SimulatedSecondary> &secondaries, const std::vector<float> &costs, bool round_robin) {
+    LoadBalancer balancer;
+    for (auto &secondary : secondaries) {
+      balancer.AddServer(&secondary);
+    }
+    uint64_t frame = 0u;
+    size_t next = 0u;
+    for (auto cost : costs) {
+      SimulatedSecondary *target;
+      if (round_robin) {
+        target = &secondaries[next++ % secondaries.size()];
+      } else {
+        target = static_cast<SimulatedSecondary *>(const_cast<void *>(balancer.Place(cost)));
+      }
+      target->assigned_cost += cost;
+      ++frame;
+      for (auto &secondary : secondaries) {
+        balancer.Report(&secondary, secondary.MakeReport(frame));
+      }
+    }
+    float slowest = 0.0f;
+    for (auto &secondary : secondaries) {
+      slowest = std::max(slowest, secondary.FrameTime());
+    }
+    return slowest;
+  }
+
+} // namespace
+
+TEST(multigpu, place_without_reports_balances_cost) {
+  int a = 0, b = 0;
+  LoadBalancer balancer;
+  ASSERT_EQ(balancer.Place(1.0f), nullptr);
+  balancer.AddServer(&a);
+  balancer.AddServer(&b);
+  // 先放两个相机，再放 8 个 IMU
+  EXPECT_EQ(balancer.Place(4.0f), &a);
+  EXPECT_EQ(balancer.Place(4.0f), &b);
+  for (int i = 0; i < 8; ++i) {
+    balancer.Place(1.0f);
+  }
+  EXPECT_EQ(balancer.GetLoad(&a).assigned_cost, 8.0f);
+  EXPECT_EQ(balancer.GetLoad(&b).assigned_cost, 8.0f);
+  EXPECT_EQ(balancer.GetLoad(&a).sensors + balancer.GetLoad(&b).sensors, 10u);
+  balancer.RemoveServer(&a);
+  EXPECT_EQ(balancer.size(), 1u);
+  EXPECT_EQ(balancer.Place(1.0f), &b);
+}
+
+TEST(multigpu, place_uses_reported_frame_time) {
+  int fast = 0, slow = 0;
+  LoadBalancer balancer;
+  balancer.AddServer(&fast);
+  balancer.AddServer(&slow);
+  ASSERT_EQ(balancer.Place(4.0f), &fast);
+  ASSERT_EQ(balancer.Place(4.0f), &slow);
+  // 同样的负载，slow 的帧时间是 fast 的三倍
+  SecondaryLoad report;
+  report.frame_time_ms = 10.0f;
+  balancer.Report(&fast, report);
+  report.frame_time_ms = 30.0f;
+  balancer.Report(&slow, report);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(balancer.Place(4.0f), &fast);
+  }
+}
+
+TEST(multigpu, overloaded_secondary_gets_no_new_sensors) {
+  int a = 0, b = 0;
+  LoadBalancer::Settings settings;
+  settings.max_pending_frames = 1u;
+  settings.max_frame_time_ms = 50.0f;
+  settings.smoothing = 1.0f;
+  LoadBalancer balancer(settings);
+  balancer.AddServer(&a);
+  balancer.AddServer(&b);
+  balancer.Place(1.0f);
+  balancer.Place(4.0f);
+
+  SecondaryLoad report;
+  report.frame_time_ms = 5.0f;
+  report.pending_frames = 3u;
+  EXPECT_TRUE(balancer.Report(&a, report));
+  EXPECT_TRUE(balancer.GetLoad(&a).overloaded);
+  EXPECT_FALSE(balancer.Report(&a, report));
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(balancer.Place(1.0f), &b);
+  }
+
+  // b 超出帧时间预算，两者都落后时仍按预计帧时间放置
+  report.pending_frames = 0u;
+  report.frame_time_ms = 80.0f;
+  EXPECT_TRUE(balancer.Report(&b, report));
+  EXPECT_NE(balancer.Place(1.0f), nullptr);
+
+  // a 追上后重新接收传感器
+  report.frame_time_ms = 5.0f;
+  EXPECT_TRUE(balancer.Report(&a, report));
+  EXPECT_FALSE(balancer.GetLoad(&a).overloaded);
+  EXPECT_EQ(balancer.Place(1.0f), &a);
+}
+
+// 与 SecondaryCommands 发送的消息一样，在数据前加上命令头
+template <typename T>
+static std::vector<unsigned char> MakeMessage(MultiGPUCommand id, const T &data) {
+  CommandHeader header;
+  header.id = id;
+  header.size = sizeof(T);
+  std::vector<unsigned char> message(sizeof(CommandHeader) + sizeof(T));
+  std::memcpy(message.data(), &header, sizeof(CommandHeader));
+  std::memcpy(message.data() + sizeof(CommandHeader), &data, sizeof(T));
+  return message;
+}
+
+TEST(multigpu, read_report_rejects_command_responses) {
+  SecondaryLoad report;
+  report.frame = 42u;
+  report.frame_time_ms = 12.5f;
+  SecondaryLoad parsed;
+  const auto message = MakeMessage(MultiGPUCommand::LOAD_REPORT, report);
+  ASSERT_TRUE(LoadBalancer::ReadReport(message.data(), message.size(), parsed));
+  EXPECT_EQ(parsed.frame, 42u);
+  EXPECT_EQ(parsed.frame_time_ms, 12.5f);
+
+  // 令牌或 bool 应答不是负载报告，即使大小相同
+  const auto yes = MakeMessage(MultiGPUCommand::IS_ENABLED_ROS, true);
+  EXPECT_FALSE(LoadBalancer::ReadReport(yes.data(), yes.size(), parsed));
+  const auto token = MakeMessage(MultiGPUCommand::GET_TOKEN, report);
+  EXPECT_FALSE(LoadBalancer::ReadReport(token.data(), token.size(), parsed));
+  EXPECT_FALSE(LoadBalancer::ReadReport(message.data(), message.size() - 1u, parsed));
+  EXPECT_FALSE(LoadBalancer::ReadReport(nullptr, 0u, parsed));
+}
+
+TEST(multigpu, release_removes_sensor_cost) {
+  int a = 0, b = 0;
+  LoadBalancer balancer;
+  balancer.AddServer(&a);
+  balancer.AddServer(&b);
+  ASSERT_EQ(balancer.Place(4.0f), &a);
+  ASSERT_EQ(balancer.Place(1.0f), &b);
+  ASSERT_EQ(balancer.Place(1.0f), &b);
+  balancer.Release(&a, 4.0f);
+  EXPECT_EQ(balancer.GetLoad(&a).assigned_cost, 0.0f);
+  EXPECT_EQ(balancer.GetLoad(&a).sensors, 0u);
+  // 销毁的传感器不再占用 a，新的传感器重新放在 a 上
+  EXPECT_EQ(balancer.Place(1.0f), &a);
+  // 未知的服务器和多余的释放不会使负载变为负数
+  balancer.Release(nullptr, 1.0f);
+  balancer.Release(&a, 8.0f);
+  balancer.Release(&a, 8.0f);
+  EXPECT_EQ(balancer.GetLoad(&a).assigned_cost, 0.0f);
+  EXPECT_EQ(balancer.GetLoad(&a).sensors, 0u);
+  EXPECT_EQ(balancer.GetLoad(&b).assigned_cost, 2.0f);
+  EXPECT_EQ(balancer.GetLoad(&b).sensors, 2u);
+}
+
+TEST(multigpu, simulated_secondaries_beat_round_robin) {
+  // 三台 GPU 速度不同的辅助服务器，放置 4K 相机和 IMU 的混合。按轮询
+  // 时相机都落到最慢的服务器上
+  const std::vector<float> costs = {
+      1.0f, 1.0f, 16.0f, 1.0f, 1.0f, 16.0f, 4.0f, 1.0f, 16.0f, 4.0f, 4.0f, 16.0f, 1.0f, 1.0f};
+  auto make = []() {
+    return std::vector<SimulatedSecondary>{{5.0f, 0.5f}, {5.0f, 1.0f}, {5.0f, 2.0f}};
+  };
+  auto round_robin = make();
+  auto balanced = make();
+  const float round_robin_ms = Simulate(round_robin, costs, true);
+  const float balanced_ms = Simulate(balanced, costs, false);
+  EXPECT_LT(balanced_ms, round_robin_ms);
+  // 最快的服务器承担最多的代价
+  EXPECT_GT(balanced[0].assigned_cost, balanced[2].assigned_cost);
+}
+
+namespace {
+
+  /// 模拟的帧数据：每个 actor 一条定长的记录（id 和变换）。
+  struct ActorRecord {
+    uint32_t id;
+    float location[3];
+    float rotation[3];
+  };
+
+  std::vector<unsigned char> MakeFrame(const std::vector<ActorRecord> &actors) {
+    std::vector<unsigned char> frame(sizeof(uint32_t) + actors.size() * sizeof(ActorRecord));
+    const uint32_t count = static_cast<uint32_t>(actors.size());
+    std::memcpy(frame.data(), &count, sizeof(count));
+    std::memcpy(frame.data() + sizeof(count), actors.data(), actors.size() * sizeof(ActorRecord));
+    return frame;
+  }
+
+  std::vector<unsigned char> ToVector(const carla::Buffer &buffer) {
+    return {buffer.begin(), buffer.end()};
+  }
+
+} // namespace
+
+TEST(multigpu, frame_codec_round_trip) {
+  using carla::multigpu::FrameDecoder;
+  using carla::multigpu::FrameEncoder;
+  std::vector<ActorRecord> actors(2000u);
+  for (uint32_t i = 0u; i < actors.size(); ++i) {
+    actors[i] = ActorRecord{i, {float(i), 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}};
+  }
+  for (bool compress : {false, true}) {
+    FrameEncoder::Settings settings;
+    settings.compress = compress;
+    settings.keyframe_interval = 50u;
+    FrameEncoder encoder(settings);
+    FrameDecoder decoder;
+    size_t raw_bytes = 0u;
+    size_t encoded_bytes = 0u;
+    auto moving = actors;
+    for (int frame = 0; frame < 200; ++frame) {
+      // 每帧有 5% 的 actor 移动，偶尔有 actor 加入或离开
+      for (size_t i = frame % 20; i < moving.size(); i += 20u) {
+        moving[i].location[0] += 0.1f;
+        moving[i].rotation[2] += 1.0f;
+      }
+      if (frame == 120) {
+        moving.push_back(ActorRecord{9999u, {1.0f, 2.0f, 3.0f}, {}});
+      } else if (frame == 160) {
+        moving.erase(moving.begin() + 10);
+      }
+      const auto raw = MakeFrame(moving);
+      auto encoded = encoder.Encode(raw.data(), raw.size(), frame == 90);
+      carla::Buffer decoded;
+      ASSERT_TRUE(decoder.Decode(encoded.data(), encoded.size(), decoded)) << "frame " << frame;
+      ASSERT_EQ(ToVector(decoded), raw) << "frame " << frame;
+      raw_bytes += raw.size();
+      encoded_bytes += encoded.size();
+    }
+    EXPECT_LT(encoded_bytes * 4u, raw_bytes) << (compress ? "delta+rle" : "delta");
+  }
+}
+
+TEST(multigpu, frame_decoder_waits_for_key_frame) {
+  using carla::multigpu::FrameDecoder;
+  using carla::multigpu::FrameEncoder;
+  std::vector<ActorRecord> actors(100u);
+  for (uint32_t i = 0u; i < actors.size(); ++i) {
+    actors[i] = ActorRecord{i, {float(i), 1.0f, 2.0f}, {}};
+  }
+  FrameEncoder encoder;
+  auto raw = MakeFrame(actors);
+  auto key = encoder.Encode(raw.data(), raw.size());
+  actors[3].location[1] = 5.0f;
+  raw = MakeFrame(actors);
+  auto delta = encoder.Encode(raw.data(), raw.size());
+  EXPECT_LT(delta.size(), raw.size() / 10u);
+
+  // 刚连接的辅助服务器先收到差异
+  FrameDecoder late;
+  carla::Buffer decoded;
+  EXPECT_FALSE(late.Decode(delta.data(), delta.size(), decoded));
+  auto forced = encoder.Encode(raw.data(), raw.size(), true);
+  ASSERT_TRUE(late.Decode(forced.data(), forced.size(), decoded));
+  EXPECT_EQ(ToVector(decoded), raw);
+
+  // 丢失或损坏一帧后，之后的差异都被拒绝
+  FrameDecoder decoder;
+  ASSERT_TRUE(decoder.Decode(key.data(), key.size(), decoded));
+  actors[7].rotation[0] = 90.0f;
+  raw = MakeFrame(actors);
+  auto next = encoder.Encode(raw.data(), raw.size());
+  EXPECT_FALSE(decoder.Decode(next.data(), next.size(), decoded));
+  EXPECT_FALSE(decoder.Decode(next.data(), next.size() - 1u, decoded));
+
+  // 没有编码的帧不被识别
+  EXPECT_FALSE(FrameDecoder::IsEncoded(raw.data(), raw.size()));
+}
@@ -0,0 +1,353 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/BoundedWorkQueue.h>
+#include <carla/pointcloud/PointCloudFilter.h>
+#include <carla/pointcloud/PointCloudIO.h>
+#include <carla/pointcloud/PointCloudProjection.h>
+#include <carla/sensor/data/LidarData.h>
+#include <carla/sensor/data/SemanticLidarData.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <map>
+#include <tuple>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using carla::pointcloud::PointCloudIO;
+using carla::sensor::data::LidarDetection;
+using carla::sensor::data::SemanticLidarDetection;
+
+static std::vector<LidarDetection> make_lidar_points(size_t count) {
+  std::vector<LidarDetection> points;
+  points.reserve(count);
+  for (size_t i = 0u; i < count; ++i) {
+    const float f = static_cast<float>(i);
+    points.emplace_back(0.5f * f, -0.25f * f, 0.125f * f, 1.0f / (1.0f + f));
+  }
+  return points;
+}
+
+// 返回 "end_header\n" 之后的二进制数据
+static std::string get_payload(const std::string &file, const std::string &end_of_header) {
+  const auto pos = file.find(end_of_header);
+  EXPECT_NE(pos, std::string::npos);
+  return file.substr(pos + end_of_header.size());
+}
+
+TEST(pointcloud, binary_ply) {
+  const auto points = make_lidar_points(100u);
+  std::ostringstream out;
+  PointCloudIO::DumpBinaryPly(out, points.data(), points.data() + points.size());
+  const std::string file = out.str();
+  ASSERT_EQ(file.find("ply\nformat binary_little_endian 1.0\nelement vertex 100\n"), 0u);
+  ASSERT_NE(file.find("property float32 I\nend_header\n"), std::string::npos);
+  const std::string payload = get_payload(file, "end_header\n");
+  ASSERT_EQ(payload.size(), points.size() * sizeof(LidarDetection));
+  ASSERT_EQ(std::memcmp(payload.data(), points.data(), payload.size()), 0);
+}
+
+TEST(pointcloud, binary_pcd) {
+  const std::vector<SemanticLidarDetection> points = {
+      {1.0f, 2.0f, 3.0f, 0.5f, 7u, 10u},
+      {4.0f, 5.0f, 6.0f, 0.25f, 8u, 14u}};
+  std::ostringstream out;
+  PointCloudIO::DumpBinaryPcd(out, points.data(), points.data() + points.size());
+  const std::string file = out.str();
+  ASSERT_NE(file.find("FIELDS x y z CosAngle ObjIdx ObjTag\nSIZE 4 4 4 4 4 4\nTYPE F F F F U U\n"), std::string::npos);
+  ASSERT_NE(file.find("\nPOINTS 2\n"), std::string::npos);
+  const std::string payload = get_payload(file, "DATA binary\n");
+  ASSERT_EQ(payload.size(), 2u * 24u);
+  ASSERT_EQ(std::memcmp(payload.data(), points.data(), payload.size()), 0);
+}
+
+TEST(pointcloud, empty_ply) {
+  // 没有点时仍然声明属性
+  const std::vector<LidarDetection> points;
+  std::ostringstream binary;
+  PointCloudIO::DumpBinaryPly(binary, points.data(), points.data());
+  ASSERT_EQ(binary.str().find("ply\nformat binary_little_endian 1.0\nelement vertex 0\nproperty float32 x\n"), 0u);
+  ASSERT_EQ(get_payload(binary.str(), "property float32 I\nend_header\n"), "");
+  std::ostringstream ascii;
+  PointCloudIO::Dump(ascii, points.begin(), points.end());
+  ASSERT_EQ(ascii.str().find("ply\nformat ascii 1.0\nelement vertex 0\nproperty float32 x\n"), 0u);
+  ASSERT_EQ(get_payload(ascii.str(), "property float32 I\nend_header\n"), "");
+}
+
+TEST(pointcloud, bounded_work_queue) {
+  std::atomic_size_t executed{0u};
+  {
+    carla::BoundedWorkQueue queue(2u, 4u);
+    for (size_t i = 0u; i < 100u; ++i) {
+      ASSERT_TRUE(queue.Push([&]() { ++executed; }));
+    }
+    queue.Push([]() { throw std::runtime_error("expected failure"); });
+    queue.Flush();
+    ASSERT_EQ(executed.load(), 100u);
+    const auto stats = queue.GetStats();
+    ASSERT_EQ(stats.submitted, 101u);
+    ASSERT_EQ(stats.completed, 101u);
+    ASSERT_EQ(stats.failed, 1u);
+    ASSERT_EQ(stats.pending, 0u);
+    ASSERT_LE(stats.max_pending, 4u);
+  }
+  {
+    // 不阻塞时，队列已满的任务被丢弃
+    std::promise<void> started;
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    carla::BoundedWorkQueue queue(1u, 1u, false);
+    ASSERT_TRUE(queue.Push([&]() { started.set_value(); released.wait(); }));
+    started.get_future().wait();
+    // 工作线程被占用，只有一个任务能进入队列
+    size_t accepted = 0u;
+    for (size_t i = 0u; i < 10u; ++i) {
+      accepted += queue.Push([]() {}) ? 1u : 0u;
+    }
+    release.set_value();
+    queue.Flush();
+    const auto stats = queue.GetStats();
+    ASSERT_EQ(accepted, 1u);
+    ASSERT_EQ(stats.dropped, 9u);
+    ASSERT_EQ(stats.completed, 2u);
+  }
+}
+
+TEST(pointcloud, transform_points) {
+  using carla::pointcloud::PointCloudProjection;
+  const auto points = make_lidar_points(1000u);
+  const carla::geom::Transform transform{
+      carla::geom::Location{1.0f, -2.0f, 3.0f},
+      carla::geom::Rotation{10.0f, 35.0f, -5.0f}};
+  const auto result = PointCloudProjection::TransformPoints(
+      points.begin(), points.end(), transform.GetMatrix());
+  ASSERT_EQ(result.size(), 3u * points.size());
+  for (size_t i = 0u; i < points.size(); ++i) {
+    carla::geom::Vector3D expected = points[i].point;
+    transform.TransformPoint(expected);
+    ASSERT_NEAR(result[3u * i + 0u], expected.x, 1e-3f * (1.0f + std::abs(expected.x)));
+    ASSERT_NEAR(result[3u * i + 1u], expected.y, 1e-3f * (1.0f + std::abs(expected.y)));
+    ASSERT_NEAR(result[3u * i + 2u], expected.z, 1e-3f * (1.0f + std::abs(expected.z)));
+  }
+}
+
+TEST(pointcloud, project_to_camera) {
+  using namespace carla::pointcloud;
+  // 90 度视场角、100x100 的相机，焦距为 50 像素
+  const auto intrinsics = CameraIntrinsics::FromFov(100u, 100u, 90.0f);
+  ASSERT_NEAR(intrinsics.fx, 50.0f, 1e-4f);
+  const std::vector<LidarDetection> points = {
+      {10.0f, 0.0f, 0.0f, 1.0f},  // 图像中心
+      {20.0f, 0.0f, 0.0f, 1.0f},  // 同一像素，被遮挡
+      {-5.0f, 0.0f, 0.0f, 1.0f},  // 相机后方
+      {10.0f, 50.0f, 0.0f, 1.0f}, // 视野外
+      {10.0f, 4.0f, 2.0f, 1.0f},  // u = 50 + 50 * 4 / 11，v = 50 - 50 * 2 / 11
+      {10.0f, 0.0f, 0.0f, 1.0f}}; // 与第一个点重合，保留下标较小的点
+  // 相机位于激光雷达后方 1 米处，图像中心的点深度为 11 米
+  const carla::geom::Transform lidar{carla::geom::Location{0.0f, 0.0f, 2.0f}, carla::geom::Rotation{}};
+  const carla::geom::Transform camera{carla::geom::Location{-1.0f, 0.0f, 2.0f}, carla::geom::Rotation{}};
+  const auto image = PointCloudProjection::Project(
+      points.begin(), points.end(),
+      PointCloudProjection::MakeRelativeMatrix(lidar, camera),
+      intrinsics);
+  ASSERT_EQ(image.depth.size(), 100u * 100u);
+  ASSERT_EQ(image.number_of_points, 4u);
+  const size_t center = 50u * 100u + 50u;
+  ASSERT_EQ(image.index[center], 0);
+  ASSERT_FLOAT_EQ(image.depth[center], 11.0f);
+  const size_t offset = static_cast<size_t>(50.0f - 50.0f * 2.0f / 11.0f) * 100u +
+                        static_cast<size_t>(50.0f + 50.0f * 4.0f / 11.0f);
+  ASSERT_EQ(image.index[offset], 4);
+  size_t filled = 0u;
+  for (size_t i = 0u; i < image.index.size(); ++i) {
+    if (image.index[i] >= 0) {
+      ++filled;
+    } else {
+      ASSERT_EQ(image.depth[i], 0.0f);
+    }
+  }
+  ASSERT_EQ(filled, 2u);
+}
+
+TEST(pointcloud, camera_intrinsics_reject_invalid_fov) {
+  using carla::pointcloud::CameraIntrinsics;
+  ASSERT_THROW(CameraIntrinsics::FromFov(100u, 100u, 0.0f), std::invalid_argument);
+  ASSERT_THROW(CameraIntrinsics::FromFov(100u, 100u, -10.0f), std::invalid_argument);
+  ASSERT_THROW(CameraIntrinsics::FromFov(100u, 100u, 180.0f), std::invalid_argument);
+  ASSERT_THROW(CameraIntrinsics::FromFov(100u, 100u, std::nanf("")), std::invalid_argument);
+  ASSERT_THROW(CameraIntrinsics::FromFov(0u, 100u, 90.0f), std::invalid_argument);
+  ASSERT_THROW(CameraIntrinsics::FromFov(100u, 0u, 90.0f), std::invalid_argument);
+  ASSERT_NO_THROW(CameraIntrinsics::FromFov(1u, 1u, 179.0f));
+}
+
+TEST(pointcloud, project_to_camera_matches_serial) {
+  using namespace carla::pointcloud;
+  std::mt19937 rng(3u);
+  std::uniform_real_distribution<float> coordinate(-50.0f, 50.0f);
+  std::vector<LidarDetection> points(200000u);
+  for (auto &point : points) {
+    point = LidarDetection{coordinate(rng), coordinate(rng), coordinate(rng) / 10.0f, 1.0f};
+  }
+  const auto intrinsics = CameraIntrinsics::FromFov(320u, 240u, 110.0f);
+  const carla::geom::Transform lidar{carla::geom::Location{0.0f, 0.0f, 2.4f}, carla::geom::Rotation{0.0f, 0.0f, 0.0f}};
+  const carla::geom::Transform camera{carla::geom::Location{0.5f, 0.0f, 1.8f}, carla::geom::Rotation{-5.0f, 20.0f, 0.0f}};
+  const auto matrix = PointCloudProjection::MakeRelativeMatrix(lidar, camera);
+  const auto image = PointCloudProjection::Project(points.begin(), points.end(), matrix, intrinsics);
+
+  // 单线程参考实现，使用相同的坐标计算
+  const auto transformed = PointCloudProjection::TransformPoints(points.begin(), points.end(), matrix);
+  std::vector<float> depth(320u * 240u, 0.0f);
+  std::vector<int32_t> index(320u * 240u, -1);
+  size_t projected = 0u;
+  for (size_t i = 0u; i < points.size(); ++i) {
+    const float x = transformed[3u * i];
+    const float u = intrinsics.fx * transformed[3u * i + 1u] * (1.0f / x) + intrinsics.cx;
+    const float v = intrinsics.fy * -transformed[3u * i + 2u] * (1.0f / x) + intrinsics.cy;
+    if (!(x > 0.0f && u >= 0.0f && v >= 0.0f && u < 320.0f && v < 240.0f)) {
+      continue;
+    }
+    ++projected;
+    const size_t pixel = static_cast<size_t>(v) * 320u + static_cast<size_t>(u);
+    if (index[pixel] < 0 || x < depth[pixel]) {
+      depth[pixel] = x;
+      index[pixel] = static_cast<int32_t>(i);
+    }
+  }
+  ASSERT_GT(projected, 0u);
+  ASSERT_EQ(image.number_of_points, projected);
+  ASSERT_EQ(image.index, index);
+  ASSERT_EQ(image.depth, depth);
+}
+
+TEST(pointcloud, filter_channels_and_range) {
+  using namespace carla::pointcloud;
+  // 4 个通道，第 c 个通道有 c + 2 个点，点到原点的距离依次为 1, 2, 3...
+  std::vector<uint32_t> counts = {2u, 3u, 4u, 5u};
+  std::vector<LidarDetection> points;
+  for (uint32_t channel = 0u; channel < counts.size(); ++channel) {
+    for (uint32_t i = 0u; i < counts[channel]; ++i) {
+      points.emplace_back(static_cast<float>(i + 1u), 0.0f, 0.0f, static_cast<float>(channel));
+    }
+  }
+
+  PointCloudFilterSettings settings;
+  ASSERT_FALSE(settings.IsEnabled());
+  settings.channel_step = 2u;
+  settings.channel_offset = 1u;
+  auto result = PointCloudFilter::Apply(points.data(), counts, settings);
+  ASSERT_EQ(result.channel_counts, (std::vector<uint32_t>{0u, 3u, 0u, 5u}));
+  ASSERT_EQ(result.points.size(), 8u);
+  for (size_t i = 0u; i < 3u; ++i) {
+    ASSERT_EQ(result.points[i].intensity, 1.0f);
+  }
+  for (size_t i = 3u; i < 8u; ++i) {
+    ASSERT_EQ(result.points[i].intensity, 3.0f);
+  }
+
+  settings = PointCloudFilterSettings{};
+  settings.min_range = 1.5f;
+  settings.max_range = 3.5f;
+  result = PointCloudFilter::Apply(points.data(), counts, settings);
+  ASSERT_EQ(result.channel_counts, (std::vector<uint32_t>{1u, 2u, 2u, 2u}));
+
+  settings = PointCloudFilterSettings{};
+  settings.crop_to_box = true;
+  settings.box_min = {3.5f, -1.0f, -1.0f};
+  settings.box_max = {10.0f, 1.0f, 1.0f};
+  result = PointCloudFilter::Apply(points.data(), counts, settings);
+  ASSERT_EQ(result.channel_counts, (std::vector<uint32_t>{0u, 0u, 1u, 2u}));
+  ASSERT_EQ(result.points.front().point.x, 4.0f);
+  ASSERT_EQ(result.points.back().point.x, 5.0f);
+}
+
+TEST(pointcloud, voxel_downsample) {
+  using namespace carla::pointcloud;
+  const std::vector<uint32_t> counts = {3u, 2u};
+  const std::vector<SemanticLidarDetection> points = {
+      {0.1f, 0.1f, 0.1f, 0.5f, 1u, 10u},
+      {5.5f, 0.5f, 0.5f, 0.5f, 2u, 11u},
+      {0.3f, 0.5f, 0.7f, 0.5f, 3u, 12u},
+      {-0.5f, 0.5f, 0.5f, 0.5f, 4u, 13u},
+      {0.9f, 0.9f, 0.9f, 0.5f, 5u, 14u}};
+  PointCloudFilterSettings settings;
+  settings.voxel_size = 1.0f;
+  const auto result = PointCloudFilter::Apply(points.data(), counts, settings);
+  ASSERT_EQ(result.channel_counts, (std::vector<uint32_t>{2u, 1u}));
+  ASSERT_EQ(result.points.size(), 3u);
+  // 第一个体素包含第 0、2、4 个点，属性取第一个点
+  EXPECT_FLOAT_EQ(result.points[0u].point.x, (0.1f + 0.3f + 0.9f) / 3.0f);
+  EXPECT_FLOAT_EQ(result.points[0u].point.y, (0.1f + 0.5f + 0.9f) / 3.0f);
+  EXPECT_FLOAT_EQ(result.points[0u].point.z, (0.1f + 0.7f + 0.9f) / 3.0f);
+  ASSERT_EQ(result.points[0u].object_idx, 1u);
+  ASSERT_EQ(result.points[1u].object_idx, 2u);
+  ASSERT_EQ(result.points[2u].object_idx, 4u);
+
+  // 强度取平均值
+  const std::vector<LidarDetection> lidar_points = {
+      {0.1f, 0.1f, 0.1f, 0.2f},
+      {0.2f, 0.2f, 0.2f, 0.4f}};
+  const auto lidar_result = PointCloudFilter::Apply(
+      lidar_points.data(), std::vector<uint32_t>{2u}, settings);
+  ASSERT_EQ(lidar_result.points.size(), 1u);
+  EXPECT_FLOAT_EQ(lidar_result.points[0u].intensity, 0.3f);
+}
+
+// 生成 number_of_channels 个通道、共 number_of_points 个随机点
+static std::vector<LidarDetection> make_random_sweep(
+    size_t number_of_points,
+    uint32_t number_of_channels,
+    std::vector<uint32_t> &counts) {
+  std::mt19937 rng(7u);
+  std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+  std::uniform_real_distribution<float> height(-2.0f, 10.0f);
+  std::vector<LidarDetection> points(number_of_points);
+  for (auto &point : points) {
+    point = LidarDetection{coordinate(rng), coordinate(rng), height(rng), coordinate(rng)};
+  }
+  counts.assign(number_of_channels, static_cast<uint32_t>(number_of_points / number_of_channels));
+  counts.back() += static_cast<uint32_t>(number_of_points % number_of_channels);
+  return points;
+}
+
+TEST(pointcloud, voxel_downsample_matches_reference) {
+  using namespace carla::pointcloud;
+  std::vector<uint32_t> counts;
+  const auto points = make_random_sweep(100000u, 32u, counts);
+  PointCloudFilterSettings settings;
+  settings.voxel_size = 2.0f;
+  const auto result = PointCloudFilter::Apply(points.data(), counts, settings);
+
+  // 参考实现：用 std::map 统计每个体素的点数
+  std::map<std::tuple<int, int, int>, size_t> voxels;
+  for (const auto &detection : points) {
+    const auto &p = detection.point;
+    ++voxels[std::make_tuple(
+        static_cast<int>(std::floor(p.x / 2.0f)),
+        static_cast<int>(std::floor(p.y / 2.0f)),
+        static_cast<int>(std::floor(p.z / 2.0f)))];
+  }
+  ASSERT_EQ(result.points.size(), voxels.size());
+  size_t total = 0u;
+  for (auto count : result.channel_counts) {
+    total += count;
+  }
+  ASSERT_EQ(total, result.points.size());
+  for (const auto &detection : result.points) {
+    const auto &p = detection.point;
+    ASSERT_NE(voxels.count(std::make_tuple(
+        static_cast<int>(std::floor(p.x / 2.0f)),
+        static_cast<int>(std::floor(p.y / 2.0f)),
+        static_cast<int>(std::floor(p.z / 2.0f)))), 0u);
+  }
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/ros2/ROS2PublishQueue.h>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using carla::ros2::ROS2PublishQueue;
+
+TEST(ros2_publish_queue, drops_oldest_and_round_robins) {
+  const int a = 0, b = 0;
+  std::vector<std::string> published;
+  std::promise<void> started;
+  std::promise<void> release;
+  auto released = release.get_future().share();
+
+  ROS2PublishQueue queue(2u);
+  queue.Push(&a, [&]() { started.set_value(); released.wait(); published.push_back("a0"); });
+  started.get_future().wait();
+  // 发布线程被 a0 阻塞，a 的队列最多保留 2 帧
+  for (int i = 1; i <= 4; ++i) {
+    queue.Push(&a, [&published, i]() { published.push_back("a" + std::to_string(i)); });
+  }
+  queue.Push(&b, [&]() { published.push_back("b0"); });
+  EXPECT_EQ(queue.GetStats(&a).depth, 2u);
+  release.set_value();
+  queue.Flush();
+
+  const std::vector<std::string> expected = {"a0", "a3", "b0", "a4"};
+  EXPECT_EQ(published, expected);
+  const auto stats = queue.GetStats(&a);
+  EXPECT_EQ(stats.submitted, 5u);
+  EXPECT_EQ(stats.published, 3u);
+  EXPECT_EQ(stats.dropped, 2u);
+  EXPECT_EQ(stats.depth, 0u);
+  EXPECT_EQ(stats.max_depth, 2u);
+  EXPECT_GE(stats.max_latency_ms, stats.average_latency_ms);
+  const auto total = queue.GetTotalStats();
+  EXPECT_EQ(total.submitted, 6u);
+  EXPECT_EQ(total.published, 4u);
+  EXPECT_EQ(total.dropped, 2u);
+}
+
+TEST(ros2_publish_queue, failures_and_remove) {
+  const int a = 0;
+  std::atomic_size_t count{0u};
+  {
+    ROS2PublishQueue queue(8u);
+    queue.Push(&a, []() { throw std::runtime_error("publish error"); });
+    queue.Push(&a, [&]() { ++count; });
+    queue.Flush();
+    const auto stats = queue.GetStats(&a);
+    EXPECT_EQ(stats.published, 2u);
+    EXPECT_EQ(stats.failed, 1u);
+    queue.Remove(&a);
+    EXPECT_EQ(queue.GetStats(&a).submitted, 0u);
+    // 析构时发布剩余的帧
+    for (int i = 0; i < 4; ++i) {
+      queue.Push(&a, [&]() { ++count; });
+    }
+  }
+  EXPECT_EQ(count, 5u);
+}
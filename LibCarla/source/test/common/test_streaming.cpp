@@ -359,3 +359,38 @@ TEST(streaming, multi_stream) {
     }
   }
 }
+
+// 每有一个客户端订阅，流的会话连接计数都会增加，断开后不会减少，
+// 服务器据此为新订阅的客户端发送完整的关键帧
+TEST(streaming, session_connections) {
+  using namespace carla::streaming;
+  Server srv(TESTING_PORT);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+  ASSERT_EQ(stream.GetSessionConnections(), 0u);
+
+  auto wait_for = [&](uint64_t expected) {
+    for (auto i = 0u; i < 200u && stream.GetSessionConnections() < expected; ++i) {
+      std::this_thread::sleep_for(5ms);
+    }
+    return stream.GetSessionConnections();
+  };
+
+  {
+    Client c0;
+    c0.AsyncRun(1u);
+    c0.Subscribe(stream.token(), [](auto) {});
+    ASSERT_EQ(wait_for(1u), 1u);
+
+    Client c1;
+    c1.AsyncRun(1u);
+    c1.Subscribe(stream.token(), [](auto) {});
+    ASSERT_EQ(wait_for(2u), 2u);
+  } // clients die here.
+
+  // 重新连接的客户端同样被视为新的订阅
+  Client c2;
+  c2.AsyncRun(1u);
+  c2.Subscribe(stream.token(), [](auto) {});
+  ASSERT_EQ(wait_for(3u), 3u);
+}
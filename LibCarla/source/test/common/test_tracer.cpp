@@ -0,0 +1,148 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/profiler/Tracer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using carla::profiler::Tracer;
+
+static void TraceNested(int depth) {
+  CARLA_TRACE_SCOPE(test, nested);
+  if (depth > 0) {
+    TraceNested(depth - 1);
+  }
+}
+
+TEST(tracer, nested_scopes_and_chrome_trace) {
+  auto &tracer = Tracer::Get();
+  tracer.Clear();
+  tracer.Disable();
+  {
+    CARLA_TRACE_SCOPE(test, disabled);
+  }
+  ASSERT_TRUE(tracer.GetEvents().empty());
+
+  tracer.Enable();
+  {
+    CARLA_TRACE_SCOPE(test, outer);
+    TraceNested(2);
+    TraceNested(0);
+  }
+  tracer.Disable();
+
+  const auto events = tracer.GetEvents();
+  ASSERT_EQ(events.size(), 5u);
+  // 按结束的先后排列，最外层的作用域最后结束
+  EXPECT_STREQ(events.back().name, "outer");
+  EXPECT_EQ(events.back().depth, 0u);
+  EXPECT_EQ(events[0].depth, 3u);
+  EXPECT_EQ(events[2].depth, 1u);
+  for (auto &event : events) {
+    EXPECT_GE(event.begin_ns, events.back().begin_ns);
+    EXPECT_LE(event.begin_ns + event.duration_ns, events.back().begin_ns + events.back().duration_ns);
+  }
+
+  auto stats = tracer.Summarize();
+  ASSERT_EQ(stats.size(), 2u);
+  // 只检查与耗时无关的结果，两者的先后取决于耗时
+  if (stats[0].name != "nested") {
+    std::swap(stats[0], stats[1]);
+  }
+  const auto &nested = stats[0];
+  const auto &outer = stats[1];
+  ASSERT_EQ(nested.name, "nested");
+  ASSERT_EQ(outer.name, "outer");
+  EXPECT_EQ(nested.count, 4u);
+  EXPECT_EQ(outer.count, 1u);
+  // self 时间不重复计算，之和等于最外层的总时间
+  EXPECT_NEAR(outer.self_ms + nested.self_ms, outer.total_ms, 1e-3);
+
+  std::ostringstream out;
+  tracer.WriteChromeTrace(out);
+  const auto json = out.str();
+  EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+  EXPECT_NE(json.find("\"ph\":\"X\",\"pid\":1"), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"thread_name\""), std::string::npos);
+  EXPECT_EQ(std::count(json.begin(), json.end(), '{'), std::count(json.begin(), json.end(), '}'));
+  tracer.Clear();
+  EXPECT_TRUE(tracer.GetEvents().empty());
+}
+
+TEST(tracer, concurrent_writers) {
+  auto &tracer = Tracer::Get();
+  tracer.Clear();
+  tracer.Enable();
+  constexpr size_t number_of_threads = 4u;
+  // 超过环形缓冲区的容量，最旧的事件被覆盖
+  const size_t scopes_per_thread = Tracer::BUFFER_CAPACITY + 1000u;
+  std::atomic_size_t finished{0u};
+  std::vector<std::thread> threads;
+  for (size_t i = 0u; i < number_of_threads; ++i) {
+    threads.emplace_back([&]() {
+      for (size_t j = 0u; j < scopes_per_thread; ++j) {
+        CARLA_TRACE_SCOPE(test, worker);
+      }
+      ++finished;
+    });
+  }
+  // 写入的同时导出，直到所有线程结束，不依赖写入的快慢
+  while (finished < number_of_threads) {
+    const auto events = tracer.GetEvents();
+    for (auto &event : events) {
+      ASSERT_STREQ(event.name, "worker");
+    }
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  tracer.Disable();
+  // 结束的线程释放各自的缓冲区，共享的缓冲区只保留最新的事件
+  const auto events = tracer.GetEvents();
+  EXPECT_EQ(events.size(), static_cast<size_t>(Tracer::BUFFER_CAPACITY));
+  tracer.Clear();
+}
+
+TEST(tracer, finished_threads_keep_their_events) {
+  auto &tracer = Tracer::Get();
+  tracer.Clear();
+  tracer.Enable();
+  std::thread([]() {
+    CARLA_TRACE_SCOPE(test, finished_outer);
+    {
+      CARLA_TRACE_SCOPE(test, finished_inner);
+    }
+  }).join();
+  {
+    CARLA_TRACE_SCOPE(test, running);
+  }
+  tracer.Disable();
+
+  const auto events = tracer.GetEvents();
+  ASSERT_EQ(events.size(), 3u);
+  // 已结束的线程排在前面
+  EXPECT_STREQ(events[0].name, "finished_inner");
+  EXPECT_STREQ(events[1].name, "finished_outer");
+  EXPECT_STREQ(events[2].name, "running");
+  EXPECT_EQ(events[0].thread, events[1].thread);
+  EXPECT_NE(events[0].thread, events[2].thread);
+  EXPECT_EQ(events[1].depth, 0u);
+
+  std::ostringstream out;
+  tracer.WriteChromeTrace(out);
+  const auto json = out.str();
+  const auto name = "\"name\":\"thread " + std::to_string(events[0].thread) + "\"";
+  EXPECT_NE(json.find(name), std::string::npos);
+  tracer.Clear();
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/image/ImageView.h>
+#include <carla/image/VectorizedColorConverter.h>
+
+#include <memory>
+#include <random>
+
+template <typename ViewT, typename PixelT>
+struct TestImage {
+  TestImage(TestImage &&) = default;
+  using pixel_type = PixelT;
+  std::unique_ptr<PixelT[]> data;
+  ViewT view;
+};
+
+template <typename PixelT>
+static auto MakeTestImage(size_t width, size_t height) {
+  auto data = std::make_unique<PixelT[]>(sizeof(PixelT) * width * height);
+  auto view = boost::gil::interleaved_view(
+      width,
+      height,
+      reinterpret_cast<PixelT*>(data.get()),
+      static_cast<long>(sizeof(PixelT) * width));
+  return TestImage<decltype(view), PixelT>{std::move(data), view};
+}
+
+template <typename ViewT>
+static void FillRandom(const ViewT &view, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> byte(0, 255);
+  for (auto &pixel : view) {
+    for (auto c = 0u; c < 4u; ++c) {
+      pixel[c] = static_cast<uint8_t>(byte(rng));
+    }
+  }
+}
+
+// 用逐像素的 ColorConverter 转换，作为对照
+template <typename ViewT, typename CC>
+static void ReferenceConvert(const ViewT &src, const ViewT &dst, CC cc) {
+  using namespace carla::image;
+  using PixelT = typename ViewT::value_type;
+  boost::gil::copy_pixels(ImageView::MakeColorConvertedView<ViewT, PixelT>(src, cc), dst);
+}
+
+TEST(benchmark_image, vectorized_color_converters) {
+  using namespace boost::gil;
+  using namespace carla::image;
+  constexpr size_t width = 1920u;
+  constexpr size_t height = 1080u;
+  constexpr size_t count = width * height;
+  auto src = MakeTestImage<bgra8_pixel_t>(width, height);
+  auto dst = MakeTestImage<bgra8_pixel_t>(width, height);
+  FillRandom(src.view, 7u);
+  carla::log_info("supported SIMD level:", static_cast<int>(VectorizedColorConverter::GetSupportedSimdLevel()));
+
+  using ConvertFunction = void (*)(uint8_t *, size_t, SimdLevel);
+  const auto benchmark = [&](auto cc, ConvertFunction convert, const char *name) {
+    carla::StopWatch stop_watch;
+    ReferenceConvert(src.view, dst.view, cc);
+    stop_watch.Stop();
+    carla::log_info(name, "per-pixel functor:", stop_watch.GetElapsedTime(), "ms");
+    for (auto level : {SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2}) {
+      copy_pixels(src.view, dst.view);
+      // 首次调用会构建查找表，不计入时间
+      convert(reinterpret_cast<uint8_t *>(&dst.view(0, 0)), 1u, level);
+      copy_pixels(src.view, dst.view);
+      stop_watch.Restart();
+      convert(reinterpret_cast<uint8_t *>(&dst.view(0, 0)), count, level);
+      stop_watch.Stop();
+      carla::log_info(name, "SIMD level", static_cast<int>(level), ":", stop_watch.GetElapsedTime(), "ms");
+    }
+  };
+  benchmark(ColorConverter::Depth(), &VectorizedColorConverter::Depth, "Depth");
+  benchmark(ColorConverter::LogarithmicDepth(), &VectorizedColorConverter::LogarithmicDepth, "LogarithmicDepth");
+  benchmark(ColorConverter::CityScapesPalette(), &VectorizedColorConverter::CityScapesPalette, "CityScapesPalette");
+}
@@ -0,0 +1,128 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/pointcloud/PointCloudFilter.h>
+#include <carla/pointcloud/PointCloudIO.h>
+#include <carla/sensor/data/LidarData.h>
+
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using carla::pointcloud::PointCloudIO;
+using carla::sensor::data::LidarDetection;
+
+static std::vector<LidarDetection> make_lidar_points(size_t count) {
+  std::vector<LidarDetection> points;
+  points.reserve(count);
+  for (size_t i = 0u; i < count; ++i) {
+    const float f = static_cast<float>(i);
+    points.emplace_back(0.5f * f, -0.25f * f, 0.125f * f, 1.0f / (1.0f + f));
+  }
+  return points;
+}
+
+TEST(benchmark_pointcloud, ascii_vs_binary) {
+  // 约为 128 线激光雷达单帧的点数
+  constexpr size_t number_of_points = 1000000u;
+  const auto points = make_lidar_points(number_of_points);
+  const auto *begin = points.data();
+  const auto *end = points.data() + points.size();
+
+  carla::StopWatch stop_watch;
+  std::ostringstream ascii;
+  PointCloudIO::Dump(ascii, begin, end);
+  stop_watch.Stop();
+  const auto ascii_time = stop_watch.GetElapsedTime();
+
+  stop_watch.Restart();
+  std::ostringstream ply;
+  PointCloudIO::DumpBinaryPly(ply, begin, end);
+  stop_watch.Stop();
+  const auto ply_time = stop_watch.GetElapsedTime();
+
+  stop_watch.Restart();
+  std::ostringstream pcd;
+  PointCloudIO::DumpBinaryPcd(pcd, begin, end);
+  stop_watch.Stop();
+  const auto pcd_time = stop_watch.GetElapsedTime();
+
+  std::cout << number_of_points << " points: "
+            << "ASCII PLY " << ascii_time << "ms (" << ascii.str().size() << " bytes), "
+            << "binary PLY " << ply_time << "ms (" << ply.str().size() << " bytes), "
+            << "binary PCD " << pcd_time << "ms (" << pcd.str().size() << " bytes)" << std::endl;
+  ASSERT_LT(ply.str().size(), ascii.str().size());
+}
+
+// 生成 number_of_channels 个通道、共 number_of_points 个随机点
+static std::vector<LidarDetection> make_random_sweep(
+    size_t number_of_points,
+    uint32_t number_of_channels,
+    std::vector<uint32_t> &counts) {
+  std::mt19937 rng(7u);
+  std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+  std::uniform_real_distribution<float> height(-2.0f, 10.0f);
+  std::vector<LidarDetection> points(number_of_points);
+  for (auto &point : points) {
+    point = LidarDetection{coordinate(rng), coordinate(rng), height(rng), coordinate(rng)};
+  }
+  counts.assign(number_of_channels, static_cast<uint32_t>(number_of_points / number_of_channels));
+  counts.back() += static_cast<uint32_t>(number_of_points % number_of_channels);
+  return points;
+}
+
+TEST(benchmark_pointcloud, filter) {
+  using namespace carla::pointcloud;
+  constexpr size_t number_of_points = 1000000u;
+  std::vector<uint32_t> counts;
+  const auto points = make_random_sweep(number_of_points, 128u, counts);
+
+  PointCloudFilterSettings settings;
+  settings.voxel_size = 0.5f;
+  carla::StopWatch stop_watch;
+  const auto voxel = PointCloudFilter::Apply(points.data(), counts, settings);
+  stop_watch.Stop();
+  const auto voxel_time = stop_watch.GetElapsedTime();
+
+  // 对照：以 std::unordered_map 累加体素
+  stop_watch.Restart();
+  std::unordered_map<uint64_t, std::pair<LidarDetection, uint32_t>> voxels;
+  for (const auto &detection : points) {
+    const auto &p = detection.point;
+    const uint64_t key =
+        (static_cast<uint64_t>(static_cast<int64_t>(std::floor(p.x / 0.5f)) + (1 << 20)) << 42u) |
+        (static_cast<uint64_t>(static_cast<int64_t>(std::floor(p.y / 0.5f)) + (1 << 20)) << 21u) |
+        static_cast<uint64_t>(static_cast<int64_t>(std::floor(p.z / 0.5f)) + (1 << 20));
+    auto &entry = voxels[key];
+    entry.first.point += p;
+    entry.first.intensity += detection.intensity;
+    ++entry.second;
+  }
+  stop_watch.Stop();
+  const auto map_time = stop_watch.GetElapsedTime();
+
+  settings = PointCloudFilterSettings{};
+  settings.channel_step = 2u;
+  settings.max_range = 80.0f;
+  stop_watch.Restart();
+  const auto cropped = PointCloudFilter::Apply(points.data(), counts, settings);
+  stop_watch.Stop();
+  const auto crop_time = stop_watch.GetElapsedTime();
+
+  std::cout << number_of_points << " points: "
+            << "voxel grid " << voxel_time << "ms (" << voxel.points.size() << " voxels), "
+            << "std::unordered_map " << map_time << "ms (" << voxels.size() << " voxels), "
+            << "decimation + range crop " << crop_time << "ms (" << cropped.points.size() << " points)"
+            << std::endl;
+  ASSERT_EQ(voxel.points.size(), voxels.size());
+  ASSERT_LT(cropped.points.size(), number_of_points / 2u);
+}
@@ -0,0 +1,48 @@
+// Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/StringUtil.h>
+
+#include <string>
+#include <vector>
+
+TEST(benchmark_wildcard_pattern, match_type_ids) {
+  constexpr size_t number_of_actors = 10000u;
+  const std::vector<std::string> types = {
+      "vehicle.tesla.model3", "vehicle.audi.tt", "walker.pedestrian.0001",
+      "sensor.camera.rgb", "traffic.traffic_light", "static.prop.bin"};
+  std::vector<std::string> type_ids;
+  type_ids.reserve(number_of_actors);
+  for (size_t i = 0u; i < number_of_actors; ++i) {
+    type_ids.push_back(types[i % types.size()]);
+  }
+  const std::string pattern = "vehicle.*";
+
+  size_t matched = 0u;
+  carla::StopWatch stop_watch;
+  for (auto &&type_id : type_ids) {
+    matched += carla::StringUtil::Match(type_id, pattern) ? 1u : 0u;
+  }
+  stop_watch.Stop();
+  const auto fnmatch_time = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+
+  size_t compiled_matched = 0u;
+  stop_watch.Restart();
+  const carla::WildcardPattern compiled(pattern);
+  for (auto &&type_id : type_ids) {
+    compiled_matched += compiled.Match(type_id) ? 1u : 0u;
+  }
+  stop_watch.Stop();
+  const auto compiled_time = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+
+  ASSERT_EQ(matched, compiled_matched);
+  std::cout << "Matched " << matched << '/' << number_of_actors << " type ids: "
+            << "StringUtil::Match " << fnmatch_time << "us, "
+            << "WildcardPattern " << compiled_time << "us" << std::endl;
+}
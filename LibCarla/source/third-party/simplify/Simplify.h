@@ -1529,7 +1529,7 @@ namespace Simplify
         {
 // 创建一个Triangle类型的对象t，用于存储三角形相关信息（Triangle类型应该是自定义的结构体或类，具体成员表示三角形的顶点等信息）
           Triangle t;
-/ 用于标记三角形数据是否读取正确的布尔变量，初始化为false
+// 用于标记三角形数据是否读取正确的布尔变量，初始化为false
           bool tri_ok = false;
 // 用于标记是否包含UV坐标信息的布尔变量，初始化为false
           bool has_uv = false;
@@ -186,7 +186,9 @@ void export_blueprint() {
     .def("find", +[](const cc::BlueprintLibrary &self, const std::string &key) -> cc::ActorBlueprint {
       return self.at(key);
     }, (arg("id")))
-    .def("filter", &cc::BlueprintLibrary::Filter, (arg("wildcard_pattern")))
+    .def("filter", +[](const cc::BlueprintLibrary &self, const std::string &wildcard_pattern) {
+      return self.Filter(wildcard_pattern);
+    }, (arg("wildcard_pattern")))
     .def("filter_by_attribute", &cc::BlueprintLibrary::FilterByAttribute, (arg("name"), arg("value")))
     .def("__getitem__", +[](const cc::BlueprintLibrary &self, size_t pos) -> cc::ActorBlueprint {
       return self.at(pos);
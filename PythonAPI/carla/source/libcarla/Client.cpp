@@ -6,9 +6,13 @@
 #include "carla/client/Client.h"// 引入Client头文件，定义与CARLA服务器交互的客户端功能
 #include "carla/client/World.h"// 引入World头文件，定义操作CARLA世界的接口
 #include "carla/Logging.h"// 引入Logging头文件，用于日志记录
+#include "carla/profiler/Metrics.h"
+#include "carla/profiler/MetricsServer.h"
+#include "carla/profiler/Tracer.h"
 #include "carla/rpc/ActorId.h"// 引入ActorId头文件，定义与CARLA中Actor相关的ID操作
 #include "carla/trafficmanager/TrafficManager.h"// 引入TrafficManager头文件，用于管理和控制交通
 
+#include <stdexcept>
 #include <thread> // 引入thread头文件，用于多线程处理
 
 #include <boost/python/stl_iterator.hpp>// 引入boost::python::stl_iterator头文件，用于Python与C++ STL容器的交互
@@ -206,6 +210,52 @@ static auto ApplyBatchCommandsSync(
 为了并行处理这些命令检查，将命令分成多个批次，每个批次最多处理TaskLimit个命令，创建相应数量的线程来并行执行ProcessCommand函数处理每个批次的命令。
 在所有线程执行完毕后，根据实际添加到vehicles_to_enable和vehicles_to_disable向量中的元素数量调整向量大小，并进行内存释放操作（通过shrink_to_fit）。
 最后，对要启用和禁用自动驾驶的车辆指针向量进行排序，确保按照演员 ID 从小到大的顺序排列，然后如果这两个向量中有元素，就通过客户端获取交通管理器实例，并分别注册要启用自动驾驶的车辆和注销要禁用自动驾驶的车辆。*/
+// 进程内的运行时指标，键为 name{labels}
+static boost::python::dict GetMetrics() {
+  boost::python::dict result;
+  for (auto &sample : carla::profiler::MetricsRegistry::Get().GetSamples()) {
+    result[sample.labels.empty() ? sample.name : sample.name + "{" + sample.labels + "}"] = sample.value;
+  }
+  return result;
+}
+
+static std::string GetMetricsText() {
+  return carla::profiler::MetricsRegistry::Get().GetPrometheusText();
+}
+
+static std::unique_ptr<carla::profiler::MetricsServer> METRICS_SERVER;
+
+// 在本地端口上提供 Prometheus 格式的指标，返回实际监听的端口
+static uint16_t StartMetricsServer(uint16_t port) {
+  METRICS_SERVER.reset();
+  METRICS_SERVER = std::make_unique<carla::profiler::MetricsServer>(port);
+  return METRICS_SERVER->GetLocalEndpoint().port();
+}
+
+static void StopMetricsServer() {
+  METRICS_SERVER.reset();
+}
+
+// 进程内的作用域计时，见 carla/profiler/Tracer.h
+static void EnableTracing() {
+  carla::profiler::Tracer::Get().Enable();
+}
+
+static void DisableTracing() {
+  carla::profiler::Tracer::Get().Disable();
+}
+
+static void WriteChromeTrace(const std::string &path) {
+  bool written;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    written = carla::profiler::Tracer::Get().WriteChromeTrace(path);
+  }
+  if (!written) {
+    throw std::runtime_error("failed to write trace file \"" + path + "\"");
+  }
+}
+
 void export_client() {
   using namespace boost::python;
   namespace cc = carla::client;
@@ -252,4 +302,12 @@ void export_client() {
     .def("apply_batch_sync", &ApplyBatchCommandsSync, (arg("commands"), arg("do_tick")=false))
     .def("get_trafficmanager", CONST_CALL_WITHOUT_GIL_1(cc::Client, GetInstanceTM, uint16_t), (arg("port")=ctm::TM_DEFAULT_PORT))
   ;
+
+  def("get_metrics", &GetMetrics);
+  def("get_metrics_text", &GetMetricsText);
+  def("start_metrics_server", &StartMetricsServer, (arg("port")=9464));
+  def("stop_metrics_server", &StopMetricsServer);
+  def("enable_tracing", &EnableTracing);
+  def("disable_tracing", &DisableTracing);
+  def("write_chrome_trace", &WriteChromeTrace, (arg("path")));
 }
@@ -109,6 +109,72 @@ static carla::geom::GeoLocation ToGeolocation(
   return self.GetGeoReference().Transform(location);
 }
 
+// 从 carla.Location 列表或 (N, 3) 的 NumPy 数组读取位置
+static std::vector<carla::geom::Location> ToLocations(boost::python::object locations) {
+  return PythonArrayToVector<carla::geom::Location>(locations, 3u, [](const double *v) {
+    return carla::geom::Location(
+        static_cast<float>(v[0]),
+        static_cast<float>(v[1]),
+        static_cast<float>(v[2]));
+  });
+}
+
+// 批量获取路点，返回与输入一一对应的列表，未找到的位置为 None
+static boost::python::list GetWaypoints(
+    const carla::client::Map &self,
+    boost::python::object locations,
+    bool project_to_road,
+    int32_t lane_type) {
+  auto input = ToLocations(locations);
+  std::vector<carla::SharedPtr<carla::client::Waypoint>> waypoints;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    waypoints = self.GetWaypoints(input, project_to_road, lane_type);
+  }
+  boost::python::list result;
+  for (auto &&waypoint : waypoints) {
+    if (waypoint != nullptr) {
+      result.append(waypoint);
+    } else {
+      result.append(boost::python::object());
+    }
+  }
+  return result;
+}
+
+// 批量获取路点的 OpenDRIVE 坐标，以紧凑的二进制记录返回：
+// numpy.frombuffer(data, dtype=[('road_id', '<u4'), ('section_id', '<u4'),
+//     ('lane_id', '<i4'), ('valid', '<u4'), ('s', '<f8')])
+static boost::python::object GetWaypointsArray(
+    const carla::client::Map &self,
+    boost::python::object locations,
+    bool project_to_road,
+    int32_t lane_type) {
+  struct Record {
+    uint32_t road_id;
+    uint32_t section_id;
+    int32_t lane_id;
+    uint32_t valid;
+    double s;
+  };
+  static_assert(sizeof(Record) == 24u, "Unexpected padding in waypoint record");
+  auto input = ToLocations(locations);
+  std::vector<Record> records;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    const auto waypoints = self.GetRawWaypoints(input, project_to_road, lane_type);
+    records.reserve(waypoints.size());
+    for (const auto &waypoint : waypoints) {
+      if (waypoint.has_value()) {
+        records.push_back(Record{waypoint->road_id, waypoint->section_id, waypoint->lane_id, 1u, waypoint->s});
+      } else {
+        records.push_back(Record{0u, 0u, 0, 0u, 0.0});
+      }
+    }
+  }
+  return VectorToPythonBytes(records);
+}
+
 void export_map() {
   using namespace boost::python;
   namespace cc = carla::client;
@@ -200,6 +266,19 @@ enum_<cr::SignalOrientation>("LandmarkOrientation")
 
 // 定义了名为"Map"的类，该类不可复制，使用智能指针进行管理
 // 提供了多种初始化以及获取地图相关信息、操作地图的方法
+// 惰性路点迭代器，实现 Python 的迭代器协议
+class_<cc::Map::WaypointIterator>("WaypointIterator", no_init)
+   .def("__iter__", +[](object self) { return self; })
+   .def("__next__", +[](cc::Map::WaypointIterator &self) {
+      auto waypoint = self.Next();
+      if (waypoint == nullptr) {
+        PyErr_SetNone(PyExc_StopIteration);
+        throw_error_already_set();
+      }
+      return waypoint;
+    })
+  ;
+
 class_<cc::Map, boost::noncopyable, boost::shared_ptr<cc::Map>>("Map", no_init)
     // 使用给定的名称和OpenDRIVE内容初始化地图对象
    .def(init<std::string, std::string>((arg("name"), arg("xodr_content"))))
@@ -209,12 +288,20 @@ class_<cc::Map, boost::noncopyable, boost::shared_ptr<cc::Map>>("Map", no_init)
    .def("get_spawn_points", CALL_RETURNING_LIST(cc::Map, GetRecommendedSpawnPoints))
     // 根据位置获取路点，可指定是否投影到道路以及车道类型（默认是驾驶车道）
    .def("get_waypoint", &cc::Map::GetWaypoint, (arg("location"), arg("project_to_road")=true, arg("lane_type")=cr::Lane::LaneType::Driving))
+    // 批量获取路点，输入可以是 Location 列表或 (N, 3) 的 NumPy 数组
+   .def("get_waypoints", &GetWaypoints, (arg("locations"), arg("project_to_road")=true, arg("lane_type")=cr::Lane::LaneType::Driving))
+    // 批量获取路点的 OpenDRIVE 坐标（road_id, section_id, lane_id, valid, s），以 bytes 返回
+   .def("get_waypoints_array", &GetWaypointsArray, (arg("locations"), arg("project_to_road")=true, arg("lane_type")=cr::Lane::LaneType::Driving))
     // 根据道路ID、车道ID和距离获取路点（基于OpenDRIVE格式相关参数）
    .def("get_waypoint_xodr", &cc::Map::GetWaypointXODR, (arg("road_id"), arg("lane_id"), arg("s")))
     // 获取地图拓扑结构的相关方法（这里具体函数未给出完整定义，可能在别处实现）
    .def("get_topology", &GetTopology)
     // 按照给定距离生成路点列表
    .def("generate_waypoints", CALL_RETURNING_LIST_1(cc::Map, GenerateWaypoints, double), (args("distance")))
+    // 按照给定距离惰性生成路点，返回一个迭代器
+   .def("generate_waypoints_lazy", +[](const cc::Map &self, double distance, cr::Lane::LaneType lane_type) {
+      return self.GenerateWaypointsLazy(distance, lane_type);
+    }, (arg("distance"), arg("lane_type")=cr::Lane::LaneType::Driving))
     // 将给定位置转换为地理位置信息（具体转换逻辑在对应函数中实现）
    .def("transform_to_geolocation", &ToGeolocation, (arg("location")))
     // 获取地图的OpenDRIVE表示（以副本形式返回）
@@ -8,6 +8,9 @@
 #include <carla/client/LaneInvasionSensor.h>
 #include <carla/client/Sensor.h>
 #include <carla/client/ServerSideSensor.h>
+#include <carla/pointcloud/PointCloudFilter.h>
+
+#include <stdexcept>
 
 // 定义一个静态函数 SubscribeToStream，用于让传感器订阅流并执行回调函数
 static void SubscribeToStream(carla::client::Sensor &self, boost::python::object callback) {
@@ -23,6 +26,51 @@ static void SubscribeToGBuffer(
     self.ListenToGBuffer(GBufferId, MakeCallback(std::move(callback)));
 }
 
+// 由 Python 的关键字参数构造点云过滤参数，roi_min 和 roi_max 必须同时给出
+static carla::pointcloud::PointCloudFilterSettings MakePointCloudFilterSettings(
+    uint32_t channel_step,
+    uint32_t channel_offset,
+    float min_range,
+    float max_range,
+    boost::python::object roi_min,
+    boost::python::object roi_max,
+    float voxel_size) {
+  carla::pointcloud::PointCloudFilterSettings settings;
+  if (channel_step == 0u) {
+    throw std::invalid_argument("channel_step must be greater than zero");
+  }
+  if (voxel_size < 0.0f) {
+    throw std::invalid_argument("voxel_size must not be negative");
+  }
+  settings.channel_step = channel_step;
+  settings.channel_offset = channel_offset;
+  settings.min_range = min_range;
+  settings.max_range = max_range;
+  settings.voxel_size = voxel_size;
+  if (roi_min.is_none() != roi_max.is_none()) {
+    throw std::invalid_argument("roi_min and roi_max must be given together");
+  }
+  if (!roi_min.is_none()) {
+    settings.crop_to_box = true;
+    settings.box_min = boost::python::extract<carla::geom::Vector3D>(roi_min);
+    settings.box_max = boost::python::extract<carla::geom::Vector3D>(roi_max);
+  }
+  return settings;
+}
+
+static void SetPointCloudFilter(
+    carla::client::ServerSideSensor &self,
+    uint32_t channel_step,
+    uint32_t channel_offset,
+    float min_range,
+    float max_range,
+    boost::python::object roi_min,
+    boost::python::object roi_max,
+    float voxel_size) {
+  self.SetPointCloudFilter(MakePointCloudFilterSettings(
+      channel_step, channel_offset, min_range, max_range, roi_min, roi_max, voxel_size));
+}
+
 // 定义一个名为 export_sensor 的函数，用于将 C++ 中的传感器类暴露给 Python
 void export_sensor() {
     using namespace boost::python;
@@ -46,6 +94,10 @@ void export_sensor() {
         .def("disable_for_ros", &cc::ServerSideSensor::DisableForROS)
         .def("is_enabled_for_ros", &cc::ServerSideSensor::IsEnabledForROS)
         .def("send", &cc::ServerSideSensor::Send, (arg("message")))
+        .def("set_point_cloud_filter", &SetPointCloudFilter, (arg("channel_step")=1u, arg("channel_offset")=0u, arg("min_range")=0.0f, arg("max_range")=0.0f, arg("roi_min")=object(), arg("roi_max")=object(), arg("voxel_size")=0.0f))
+        .def("clear_point_cloud_filter", +[](cc::ServerSideSensor &self) {
+          self.SetPointCloudFilter(carla::pointcloud::PointCloudFilterSettings{});
+        })
         .def(self_ns::str(self_ns::self))
     ;
 
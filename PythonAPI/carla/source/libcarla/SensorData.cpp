@@ -8,7 +8,11 @@
 #include <carla/image/ImageConverter.h>
 #include <carla/image/ImageIO.h>
 #include <carla/image/ImageView.h>
+#include <carla/image/ImageWriter.h>
 #include <carla/pointcloud/PointCloudIO.h>
+#include <carla/pointcloud/PointCloudFilter.h>
+#include <carla/pointcloud/PointCloudProjection.h>
+#include <carla/pointcloud/PointCloudWriter.h>
 #include <carla/sensor/SensorData.h>
 #include <carla/sensor/data/CollisionEvent.h>
 #include <carla/sensor/data/IMUMeasurement.h>
@@ -422,44 +426,127 @@ static FakeImage ColorCodedFlow(
   }
   return result;
 }
-// 定义一个保存图像到磁盘的模板函数
+
+// EColorConverter 与 ImageColorConversion 的枚举顺序相同
+static carla::image::ImageWriteOptions MakeImageWriteOptions(EColorConverter cc, int png_compression_level) {
+  carla::image::ImageWriteOptions options;
+  options.color_conversion = static_cast<carla::image::ImageColorConversion>(cc);
+  options.png_compression_level = png_compression_level;
+  return options;
+}
+
+// 定义一个保存图像到磁盘的模板函数，输出格式由扩展名决定
 template <typename T>
-static std::string SaveImageToDisk(T &self, std::string path, EColorConverter cc) {
+static std::string SaveImageToDisk(T &self, std::string path, EColorConverter cc, int png_compression_level) {
   // 释放 Python GIL（全局解释器锁），以便在 C++ 中执行多线程操作
   carla::PythonUtil::ReleaseGIL unlock;
-  using namespace carla::image;
-  // 将图像数据转换为图像视图
-  auto view = ImageView::MakeView(self);
-  // 根据不同的颜色转换类型进行不同的处理
-  switch (cc) {
-    case EColorConverter::Raw:
-      return ImageIO::WriteView(
-          std::move(path),
-          view);
-    case EColorConverter::Depth:
-      return ImageIO::WriteView(
-          std::move(path),
-          ImageView::MakeColorConvertedView(view, ColorConverter::Depth()));
-    case EColorConverter::LogarithmicDepth:
-      return ImageIO::WriteView(
-          std::move(path),
-          ImageView::MakeColorConvertedView(view, ColorConverter::LogarithmicDepth()));
-    case EColorConverter::CityScapesPalette:
-      return ImageIO::WriteView(
-          std::move(path),
-          ImageView::MakeColorConvertedView(view, ColorConverter::CityScapesPalette()));
-    default:
-      throw std::invalid_argument("invalid color converter!");
-  }
+  return carla::image::ImageWriter::WriteImage(
+      std::move(path),
+      self,
+      MakeImageWriteOptions(cc, png_compression_level));
+}
+
+// 将图像放入后台写入队列，颜色转换和编码在工作线程中完成
+static std::string SaveImageAsync(
+    carla::image::ImageWriter &self,
+    boost::shared_ptr<carla::sensor::data::Image> image,
+    std::string path,
+    EColorConverter cc,
+    int png_compression_level) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return self.Save(std::move(path), std::move(image), MakeImageWriteOptions(cc, png_compression_level));
 }
 
 template <typename T>
 // 定义一个静态函数 SavePointCloudToDisk，用于将点云数据保存到磁盘
-static std::string SavePointCloudToDisk(T &self, std::string path) {
+static std::string SavePointCloudToDisk(T &self, std::string path, bool binary) {
   carla::PythonUtil::ReleaseGIL unlock;
+  if (binary) {
+    return carla::pointcloud::PointCloudIO::SaveToDiskBinary(std::move(path), self.begin(), self.end());
+  }
   return carla::pointcloud::PointCloudIO::SaveToDisk(std::move(path), self.begin(), self.end());
 }
 
+// 将点云放入后台写入队列，队列满时可能阻塞，因此释放 GIL
+template <typename T>
+static std::string SavePointCloudAsync(
+    carla::pointcloud::PointCloudWriter &self,
+    boost::shared_ptr<T> measurement,
+    std::string path,
+    bool binary) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return self.Save(std::move(path), std::move(measurement), binary);
+}
+
+// 用 transform 变换点云中的所有点，返回 N x 3 的 float32 字节串
+template <typename T>
+static boost::python::object TransformLidarPoints(const T &self, const carla::geom::Transform &transform) {
+  std::vector<float> points;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    points = carla::pointcloud::PointCloudProjection::TransformPoints(
+        self.begin(), self.end(), transform.GetMatrix());
+  }
+  return VectorToPythonBytes(points);
+}
+
+// 将点云投影到位于 camera_transform 的针孔相机上，返回深度图和点下标图
+template <typename T>
+static boost::python::dict ProjectLidarToCamera(
+    const T &self,
+    const carla::geom::Transform &camera_transform,
+    uint32_t image_width,
+    uint32_t image_height,
+    float fov) {
+  using namespace carla::pointcloud;
+  ProjectedImage image;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    image = PointCloudProjection::Project(
+        self.begin(),
+        self.end(),
+        PointCloudProjection::MakeRelativeMatrix(self.GetSensorTransform(), camera_transform),
+        CameraIntrinsics::FromFov(image_width, image_height, fov));
+  }
+  boost::python::dict result;
+  result["width"] = image.width;
+  result["height"] = image.height;
+  result["depth"] = VectorToPythonBytes(image.depth);
+  result["index"] = VectorToPythonBytes(image.index);
+  result["point_count"] = image.number_of_points;
+  return result;
+}
+
+// 过滤点云，参数见 MakePointCloudFilterSettings
+template <typename T>
+static boost::shared_ptr<T> FilterLidarMeasurement(
+    const T &self,
+    uint32_t channel_step,
+    uint32_t channel_offset,
+    float min_range,
+    float max_range,
+    boost::python::object roi_min,
+    boost::python::object roi_max,
+    float voxel_size) {
+  const auto settings = MakePointCloudFilterSettings(
+      channel_step, channel_offset, min_range, max_range, roi_min, roi_max, voxel_size);
+  carla::PythonUtil::ReleaseGIL unlock;
+  return self.Filter(settings);
+}
+
+// 将写入队列的统计信息转换为 Python 字典
+static boost::python::dict GetWorkQueueStats(const carla::BoundedWorkQueue::Stats &stats) {
+  boost::python::dict result;
+  result["submitted"] = stats.submitted;
+  result["completed"] = stats.completed;
+  result["failed"] = stats.failed;
+  result["dropped"] = stats.dropped;
+  result["blocked"] = stats.blocked;
+  result["pending"] = stats.pending;
+  result["max_pending"] = stats.max_pending;
+  return result;
+}
+
 static boost::python::dict GetCAMData(const carla::sensor::data::CAMData message)
 {
     boost::python::dict myDict;
@@ -548,7 +635,7 @@ void export_sensor_data() {
     .add_property("fov", &csd::Image::GetFOVAngle)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::Image>)
     .def("convert", &ConvertImage<csd::Image>, (arg("color_converter")))
-    .def("save_to_disk", &SaveImageToDisk<csd::Image>, (arg("path"), arg("color_converter")=EColorConverter::Raw))
+    .def("save_to_disk", &SaveImageToDisk<csd::Image>, (arg("path"), arg("color_converter")=EColorConverter::Raw, arg("png_compression_level")=-1))
     .def("__len__", &csd::Image::size)
     .def("__iter__", iterator<csd::Image>())
     .def("__getitem__", +[](const csd::Image &self, size_t pos) -> csd::Color {
@@ -560,6 +647,19 @@ void export_sensor_data() {
     .def(self_ns::str(self_ns::self))
   ;
 
+  class_<carla::image::ImageWriter, boost::noncopyable, boost::shared_ptr<carla::image::ImageWriter>>("ImageWriter",
+      init<size_t, size_t, bool>((arg("num_threads")=0u, arg("max_queue_size")=32u, arg("block_when_full")=true)))
+    .def("save", &SaveImageAsync, (arg("image"), arg("path"), arg("color_converter")=EColorConverter::Raw, arg("png_compression_level")=-1))
+    .def("flush", +[](carla::image::ImageWriter &self) {
+      carla::PythonUtil::ReleaseGIL unlock;
+      self.Flush();
+    })
+    .add_property("num_threads", &carla::image::ImageWriter::GetNumberOfThreads)
+    .add_property("stats", +[](const carla::image::ImageWriter &self) {
+      return GetWorkQueueStats(self.GetStats());
+    })
+  ;
+
   class_<csd::OpticalFlowImage, bases<cs::SensorData>, boost::noncopyable, boost::shared_ptr<csd::OpticalFlowImage>>("OpticalFlowImage", no_init)
     .add_property("width", &csd::OpticalFlowImage::GetWidth)
     .add_property("height", &csd::OpticalFlowImage::GetHeight)
@@ -582,7 +682,10 @@ void export_sensor_data() {
     .add_property("channels", &csd::LidarMeasurement::GetChannelCount)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::LidarMeasurement>)
     .def("get_point_count", &csd::LidarMeasurement::GetPointCount, (arg("channel")))
-    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarMeasurement>, (arg("path")))
+    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarMeasurement>, (arg("path"), arg("binary")=false))
+    .def("transform_points", &TransformLidarPoints<csd::LidarMeasurement>, (arg("transform")))
+    .def("project_to_camera", &ProjectLidarToCamera<csd::LidarMeasurement>, (arg("camera_transform"), arg("image_width"), arg("image_height"), arg("fov")))
+    .def("filter", &FilterLidarMeasurement<csd::LidarMeasurement>, (arg("channel_step")=1u, arg("channel_offset")=0u, arg("min_range")=0.0f, arg("max_range")=0.0f, arg("roi_min")=object(), arg("roi_max")=object(), arg("voxel_size")=0.0f))
     .def("__len__", &csd::LidarMeasurement::size)
     .def("__iter__", iterator<csd::LidarMeasurement>())
     .def("__getitem__", +[](const csd::LidarMeasurement &self, size_t pos) -> csd::LidarDetection {
@@ -599,7 +702,10 @@ void export_sensor_data() {
     .add_property("channels", &csd::SemanticLidarMeasurement::GetChannelCount)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::SemanticLidarMeasurement>)
     .def("get_point_count", &csd::SemanticLidarMeasurement::GetPointCount, (arg("channel")))
-    .def("save_to_disk", &SavePointCloudToDisk<csd::SemanticLidarMeasurement>, (arg("path")))
+    .def("save_to_disk", &SavePointCloudToDisk<csd::SemanticLidarMeasurement>, (arg("path"), arg("binary")=false))
+    .def("transform_points", &TransformLidarPoints<csd::SemanticLidarMeasurement>, (arg("transform")))
+    .def("project_to_camera", &ProjectLidarToCamera<csd::SemanticLidarMeasurement>, (arg("camera_transform"), arg("image_width"), arg("image_height"), arg("fov")))
+    .def("filter", &FilterLidarMeasurement<csd::SemanticLidarMeasurement>, (arg("channel_step")=1u, arg("channel_offset")=0u, arg("min_range")=0.0f, arg("max_range")=0.0f, arg("roi_min")=object(), arg("roi_max")=object(), arg("voxel_size")=0.0f))
     .def("__len__", &csd::SemanticLidarMeasurement::size)
     .def("__iter__", iterator<csd::SemanticLidarMeasurement>())
     .def("__getitem__", +[](const csd::SemanticLidarMeasurement &self, size_t pos) -> csd::SemanticLidarDetection {
@@ -611,6 +717,19 @@ void export_sensor_data() {
     .def(self_ns::str(self_ns::self))
   ;
 
+  class_<carla::pointcloud::PointCloudWriter, boost::noncopyable, boost::shared_ptr<carla::pointcloud::PointCloudWriter>>("PointCloudWriter",
+      init<size_t, bool>((arg("max_queue_size")=16u, arg("block_when_full")=true)))
+    .def("save", &SavePointCloudAsync<csd::LidarMeasurement>, (arg("measurement"), arg("path"), arg("binary")=true))
+    .def("save", &SavePointCloudAsync<csd::SemanticLidarMeasurement>, (arg("measurement"), arg("path"), arg("binary")=true))
+    .def("flush", +[](carla::pointcloud::PointCloudWriter &self) {
+      carla::PythonUtil::ReleaseGIL unlock;
+      self.Flush();
+    })
+    .add_property("stats", +[](const carla::pointcloud::PointCloudWriter &self) {
+      return GetWorkQueueStats(self.GetStats());
+    })
+  ;
+
   class_<csd::CollisionEvent, bases<cs::SensorData>, boost::noncopyable, boost::shared_ptr<csd::CollisionEvent>>("CollisionEvent", no_init)
     .add_property("actor", &csd::CollisionEvent::GetActor)
     .add_property("other_actor", &csd::CollisionEvent::GetOtherActor)
@@ -27,6 +27,29 @@ namespace client {
 } // namespace client
 } // namespace carla
 
+// 将批量状态数组转换为 Python 字典，数值数组以字节串返回，可以直接
+// 用 numpy.frombuffer 读取；只有非空的可选数组才会出现在字典中
+static boost::python::dict ActorStateArraysToPython(const carla::client::ActorStateArrays &arrays) {
+  boost::python::dict result;
+  result["id"] = VectorToPythonBytes(arrays.ids);
+  result["transform"] = VectorToPythonBytes(arrays.transforms);
+  result["velocity"] = VectorToPythonBytes(arrays.velocities);
+  result["angular_velocity"] = VectorToPythonBytes(arrays.angular_velocities);
+  result["acceleration"] = VectorToPythonBytes(arrays.accelerations);
+  if (!arrays.bounding_boxes.empty()) {
+    result["bounding_box"] = VectorToPythonBytes(arrays.bounding_boxes);
+  }
+  if (!arrays.type_indices.empty()) {
+    result["type_index"] = VectorToPythonBytes(arrays.type_indices);
+    boost::python::list type_ids;
+    for (const auto &type_id : arrays.type_ids) {
+      type_ids.append(type_id);
+    }
+    result["type_id"] = type_ids;
+  }
+  return result;
+}
+
 void export_snapshot() {
   using namespace boost::python;
   namespace cc = carla::client;
@@ -56,6 +79,14 @@ void export_snapshot() {
     /// @}
     .def("has_actor", &cc::WorldSnapshot::Contains, (arg("actor_id")))
     .def("find", CALL_RETURNING_OPTIONAL_1(cc::WorldSnapshot, Find, carla::ActorId), (arg("actor_id")))
+    .def("get_state_arrays", +[](const cc::WorldSnapshot &self) {
+      carla::client::ActorStateArrays arrays;
+      {
+        carla::PythonUtil::ReleaseGIL unlock;
+        arrays = self.GetActorStateArrays();
+      }
+      return ActorStateArraysToPython(arrays);
+    })
     .def("__len__", &cc::WorldSnapshot::size)// 定义方法 __len__，返回 WorldSnapshot 中的元素数量
     .def("__iter__", range(&cc::WorldSnapshot::begin, &cc::WorldSnapshot::end)) // 定义方法 __iter__，用于迭代 WorldSnapshot 的元素
     .def("__eq__", &cc::WorldSnapshot::operator==)// 定义方法 __eq__，用于比较两个 WorldSnapshot 对象是否相等
@@ -87,6 +87,44 @@ boost::python::list InterGetActionBuffer(carla::traffic_manager::TrafficManager&
   return l;
 }
 
+// 从参与者对象或整数ID中取得参与者ID
+static ActorId ExtractActorId(const boost::python::object &item) {
+  boost::python::extract<ActorPtr> actor(item);
+  if (actor.check()) {
+    return actor()->GetId();
+  }
+  return boost::python::extract<ActorId>(item);
+}
+
+// 批量应用单车参数，列表中每一项为 (actor, parameter, value)
+void InterApplyParameterBatch(carla::traffic_manager::TrafficManager& self, boost::python::object input) {
+  namespace ctm = carla::traffic_manager;
+  ctm::ParameterBatch batch;
+  const auto size = boost::python::len(input);
+  batch.reserve(static_cast<size_t>(size));
+  for (auto i = 0; i < size; ++i) {
+    boost::python::object item = input[i];
+    batch.emplace_back(
+        ExtractActorId(item[0]),
+        boost::python::extract<ctm::VehicleParameter>(item[1]),
+        boost::python::extract<float>(item[2]));
+  }
+  carla::PythonUtil::ReleaseGIL unlock;
+  self.ApplyParameterBatch(batch);
+}
+
+// 为多辆车设置同一参数，列表中每一项为 (actor, value)
+void InterSetVehicleParameterBatch(carla::traffic_manager::TrafficManager& self, carla::traffic_manager::VehicleParameter parameter, boost::python::object input) {
+  std::vector<std::pair<ActorId, float>> values;
+  const auto size = boost::python::len(input);
+  values.reserve(static_cast<size_t>(size));
+  for (auto i = 0; i < size; ++i) {
+    boost::python::object item = input[i];
+    values.emplace_back(ExtractActorId(item[0]), boost::python::extract<float>(item[1]));
+  }
+  carla::PythonUtil::ReleaseGIL unlock;
+  self.SetVehicleParameterBatch(parameter, values);
+}
 
 // 导出TrafficManager相关功能的函数
 void export_trafficmanager() {
@@ -94,6 +132,23 @@ void export_trafficmanager() {
   namespace ctm = carla::traffic_manager; // 定义别名简化命名空间引用
   using namespace boost::python; // 使用Boost.Python命名空间，方便后续代码调用Boost.Python的功能
 
+  enum_<ctm::VehicleParameter>("VehicleParameter")
+    .value("PercentageSpeedDifference", ctm::VehicleParameter::PercentageSpeedDifference)
+    .value("LaneOffset", ctm::VehicleParameter::LaneOffset)
+    .value("DesiredSpeed", ctm::VehicleParameter::DesiredSpeed)
+    .value("UpdateVehicleLights", ctm::VehicleParameter::UpdateVehicleLights)
+    .value("AutoLaneChange", ctm::VehicleParameter::AutoLaneChange)
+    .value("ForceLaneChange", ctm::VehicleParameter::ForceLaneChange)
+    .value("DistanceToLeadingVehicle", ctm::VehicleParameter::DistanceToLeadingVehicle)
+    .value("IgnoreLightsPercentage", ctm::VehicleParameter::PercentageRunningLight)
+    .value("IgnoreSignsPercentage", ctm::VehicleParameter::PercentageRunningSign)
+    .value("IgnoreWalkersPercentage", ctm::VehicleParameter::PercentageIgnoreWalkers)
+    .value("IgnoreVehiclesPercentage", ctm::VehicleParameter::PercentageIgnoreVehicles)
+    .value("KeepRightRulePercentage", ctm::VehicleParameter::KeepRightPercentage)
+    .value("RandomLeftLaneChangePercentage", ctm::VehicleParameter::RandomLeftLaneChangePercentage)
+    .value("RandomRightLaneChangePercentage", ctm::VehicleParameter::RandomRightLaneChangePercentage)
+  ;
+
   class_<ctm::TrafficManager>("TrafficManager", no_init)
     .def("get_port", &ctm::TrafficManager::Port)
     .def("vehicle_percentage_speed_difference", &ctm::TrafficManager::SetPercentageSpeedDifference, (arg("actor"), arg("percentage")))
@@ -115,6 +170,7 @@ void export_trafficmanager() {
     .def("random_left_lanechange_percentage", &ctm::TrafficManager::SetRandomLeftLaneChangePercentage, (arg("actor"), arg("percentage")))
     .def("random_right_lanechange_percentage", &ctm::TrafficManager::SetRandomRightLaneChangePercentage, (arg("actor"), arg("percentage")))
     .def("set_synchronous_mode", &ctm::TrafficManager::SetSynchronousMode, (arg("mode_switch")))
+    .def("set_pipelined_mode", &ctm::TrafficManager::SetPipelinedMode, (arg("mode_switch")=true))
     .def("set_hybrid_physics_mode", &ctm::TrafficManager::SetHybridPhysicsMode, (arg("enabled")))
     .def("set_hybrid_physics_radius", &ctm::TrafficManager::SetHybridPhysicsRadius, (arg("r")))
     .def("set_random_device_seed", &ctm::TrafficManager::SetRandomDeviceSeed, (arg("value")))
@@ -125,5 +181,7 @@ void export_trafficmanager() {
     .def("set_boundaries_respawn_dormant_vehicles", &carla::traffic_manager::TrafficManager::SetBoundariesRespawnDormantVehicles, (arg("lower_bound"), arg("upper_bound")))
     .def("get_next_action", &InterGetNextAction, (arg("actor")))
     .def("get_all_actions", &InterGetActionBuffer, (arg("actor")))
+    .def("apply_parameter_batch", &InterApplyParameterBatch, (arg("batch")))
+    .def("set_vehicle_parameter_batch", &InterSetVehicleParameterBatch, (arg("parameter"), arg("values")))
     .def("shut_down", &ctm::TrafficManager::ShutDown);
 }
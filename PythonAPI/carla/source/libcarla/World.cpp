@@ -59,6 +59,15 @@ namespace rpc {
     return out;
   }
 
+  // 重载输出流操作符 "<<" 以方便打印EpisodeStateFilter对象
+  // 输出中心参与者的id、半径和参与者类型掩码
+  std::ostream &operator<<(std::ostream &out, const EpisodeStateFilter &filter) {
+    out << "EpisodeStateFilter(ego_id=" << std::to_string(filter.ego_id)
+        << ", radius=" << std::to_string(filter.radius)
+        << ", type_mask=" << std::to_string(filter.type_mask) << ')';
+    return out;
+  }
+
   // 重载输出流操作符 "<<" 以方便打印EnvironmentObject对象
   // 该操作符将输出环境对象的id、名称、变换矩阵和包围盒
   std::ostream &operator<<(std::ostream &out, const EnvironmentObject &environment_object) {
@@ -153,6 +162,7 @@ void export_world() {
   using namespace boost::python;
   namespace cc = carla::client;
   namespace cg = carla::geom;
+  namespace cn = carla::nav;
   namespace cr = carla::rpc;
   namespace csd = carla::sensor::data;
 
@@ -173,13 +183,23 @@ void export_world() {
     .def(self_ns::str(self_ns::self))
   ;
 
-  // 将cc::ActorList类型绑定到Python中名为"ActorList"的类，无默认构造函数
+  // 将cc::ActorList类型绑定到Python中名为"ActorList"的类，无默认构造函数且不可复制（按类型的索引只构建一次）
   // 为Python中的"ActorList"类定义一些方法，使其能调用对应的C++方法
-  class_<cc::ActorList, boost::shared_ptr<cc::ActorList>>("ActorList", no_init)
+  class_<cc::ActorList, boost::noncopyable, boost::shared_ptr<cc::ActorList>>("ActorList", no_init)
     // 绑定C++中ActorList类的Find方法到Python类的"find"方法，参数为"id"
     .def("find", &cc::ActorList::Find, (arg("id")))
     // 绑定Filter方法到Python类的"filter"方法，参数是"wildcard_pattern"
-    .def("filter", &cc::ActorList::Filter, (arg("wildcard_pattern")))
+    .def("filter", +[](const cc::ActorList &self, const std::string &wildcard_pattern) {
+      return self.Filter(wildcard_pattern);
+    }, (arg("wildcard_pattern")))
+    .def("get_state_arrays", +[](const cc::ActorList &self) {
+      cc::ActorStateArrays arrays;
+      {
+        carla::PythonUtil::ReleaseGIL unlock;
+        arrays = self.GetStateArrays();
+      }
+      return ActorStateArraysToPython(arrays);
+    })
     // 绑定at方法，使Python类支持通过索引访问，对应Python的"__getitem__"操作
     .def("__getitem__", &cc::ActorList::at)
     // 绑定size方法，让Python中可用len获取其长度，对应Python的"__len__"操作
@@ -193,7 +213,7 @@ void export_world() {
   // 将cr::EpisodeSettings类型绑定到Python里名为"WorldSettings"的类
   // 定义构造函数及各参数默认值，方便Python中创建对象
   class_<cr::EpisodeSettings>("WorldSettings")
-    .def(init<bool, bool, double, bool, double, int, float, bool, float, float, bool>(
+    .def(init<bool, bool, double, bool, double, int, float, bool, float, float, bool, uint32_t>(
         (arg("synchronous_mode")=false,
          arg("no_rendering_mode")=false,
          arg("fixed_delta_seconds")=0.0,
@@ -204,7 +224,8 @@ void export_world() {
          arg("deterministic_ragdolls")=false,
          arg("tile_stream_distance")=3000.f,
          arg("actor_active_distance")=2000.f,
-         arg("spectator_as_ego")=true)))
+         arg("spectator_as_ego")=true,
+         arg("state_keyframe_interval")=0u)))
     // 暴露C++类中的成员变量为Python类的可读写属性
     .def_readwrite("synchronous_mode", &cr::EpisodeSettings::synchronous_mode)
     .def_readwrite("no_rendering_mode", &cr::EpisodeSettings::no_rendering_mode)
@@ -225,6 +246,7 @@ void export_world() {
     .def_readwrite("tile_stream_distance", &cr::EpisodeSettings::tile_stream_distance)
     .def_readwrite("actor_active_distance", &cr::EpisodeSettings::actor_active_distance)
     .def_readwrite("spectator_as_ego", &cr::EpisodeSettings::spectator_as_ego)
+    .def_readwrite("state_keyframe_interval", &cr::EpisodeSettings::state_keyframe_interval)
      // 绑定相等比较（==）和不等比较（!=）的操作到Python类对应的方法
     .def("__eq__", &cr::EpisodeSettings::operator==)
     .def("__ne__", &cr::EpisodeSettings::operator!=)
@@ -232,6 +254,29 @@ void export_world() {
     .def(self_ns::str(self_ns::self))
   ;
 
+  enum_<cr::ActorTypeMask>("ActorTypeMask")
+    .value("NONE", cr::ActorTypeMask::None)
+    .value("Vehicle", cr::ActorTypeMask::Vehicle)
+    .value("Walker", cr::ActorTypeMask::Walker)
+    .value("TrafficLight", cr::ActorTypeMask::TrafficLight)
+    .value("TrafficSign", cr::ActorTypeMask::TrafficSign)
+    .value("Sensor", cr::ActorTypeMask::Sensor)
+    .value("Other", cr::ActorTypeMask::Other)
+    .value("All", cr::ActorTypeMask::All)
+  ;
+
+  // 世界状态的兴趣区域过滤条件
+  class_<cr::EpisodeStateFilter>("EpisodeStateFilter")
+    .def(init<carla::ActorId, float, uint8_t>(
+        (arg("ego_id")=0u,
+         arg("radius")=0.0f,
+         arg("type_mask")=static_cast<uint8_t>(cr::ActorTypeMask::All))))
+    .def_readwrite("ego_id", &cr::EpisodeStateFilter::ego_id)
+    .def_readwrite("radius", &cr::EpisodeStateFilter::radius)
+    .def_readwrite("type_mask", &cr::EpisodeStateFilter::type_mask)
+    .def(self_ns::str(self_ns::self))
+  ;
+
   // 将cr::EnvironmentObject类型绑定到Python中名为"EnvironmentObject"的类
   // 把C++类的多个成员变量暴露为Python类的可读写属性 
   class_<cr::EnvironmentObject>("EnvironmentObject", no_init)
@@ -287,6 +332,17 @@ void export_world() {
     .def_readonly("label", &cr::LabelledPoint::_label)
   ;
 
+  class_<cn::CrowdTickStats>("PedestriansTickStats", no_init)
+    .def_readonly("ticks", &cn::CrowdTickStats::ticks)
+    .def_readonly("crowd_update_us", &cn::CrowdTickStats::crowd_update_us)
+    .def_readonly("unblock_check_us", &cn::CrowdTickStats::unblock_check_us)
+    .def_readonly("walker_manager_us", &cn::CrowdTickStats::walker_manager_us)
+    .def_readonly("snapshot_us", &cn::CrowdTickStats::snapshot_us)
+    .def_readonly("last_tick_us", &cn::CrowdTickStats::last_tick_us)
+    .def_readonly("navigation_ticks", &cn::CrowdTickStats::navigation_ticks)
+    .def_readonly("navigation_us", &cn::CrowdTickStats::navigation_us)
+  ;
+
   enum_<cr::MapLayer>("MapLayer")
     .value("NONE", cr::MapLayer::None)
     .value("Buildings", cr::MapLayer::Buildings)
@@ -368,6 +424,8 @@ void export_world() {
     .def("get_imui_sensor_gravity", CONST_CALL_WITHOUT_GIL(cc::World, GetIMUISensorGravity))
     .def("set_imui_sensor_gravity", &cc::World::SetIMUISensorGravity, (arg("NewIMUISensorGravity")) )
     .def("get_snapshot", &cc::World::GetSnapshot)
+    .def("set_state_filter", CALL_WITHOUT_GIL_1(cc::World, SetStateFilter, const cr::EpisodeStateFilter &), (arg("filter")))
+    .def("clear_state_filter", CALL_WITHOUT_GIL(cc::World, ClearStateFilter))
     .def("get_actor", CONST_CALL_WITHOUT_GIL_1(cc::World, GetActor, carla::ActorId), (arg("actor_id")))
     .def("get_actors", CONST_CALL_WITHOUT_GIL(cc::World, GetActors))
     .def("get_actors", &GetActorsById, (arg("actor_ids")))
@@ -379,6 +437,8 @@ void export_world() {
     .def("tick", &Tick, (arg("seconds")=0.0))
     .def("set_pedestrians_cross_factor", CALL_WITHOUT_GIL_1(cc::World, SetPedestriansCrossFactor, float), (arg("percentage")))
     .def("set_pedestrians_seed", CALL_WITHOUT_GIL_1(cc::World, SetPedestriansSeed, unsigned int), (arg("seed")))
+    .def("set_pedestrians_tile_size", CALL_WITHOUT_GIL_1(cc::World, SetPedestriansTileSize, float), (arg("tile_size")))
+    .def("get_pedestrians_tick_stats", CONST_CALL_WITHOUT_GIL(cc::World, GetPedestriansTickStats))
     .def("get_traffic_sign", CONST_CALL_WITHOUT_GIL_1(cc::World, GetTrafficSign, cc::Landmark), arg("landmark"))
     .def("get_traffic_light", CONST_CALL_WITHOUT_GIL_1(cc::World, GetTrafficLight, cc::Landmark), arg("landmark"))
     .def("get_traffic_light_from_opendrive_id", CONST_CALL_WITHOUT_GIL_1(cc::World, GetTrafficLightFromOpenDRIVE, const carla::road::SignId&), arg("traffic_light_id"))
@@ -9,6 +9,7 @@
 #include <carla/Time.h>
 
 #include <ostream>
+#include <string>
 // 类型萃取，定义了一系列的类模板，用于获取类型
 // 可以用来在编译期判断类型的属性、对给定类型进行一些操作获得另一种特定类型、判断类型和类型之间的关系等
 #include <type_traits> 
@@ -247,6 +248,68 @@ static auto MakeCallback(boost::python::object callback) {
   };
 }
 
+// 将实现了缓冲区协议的对象（例如 float32/float64 的 NumPy 数组）按行优先
+// 读取为 N 个 T，每个 T 由 @a components 个浮点数构造。不支持缓冲区协议的
+// 对象则按 Python 序列逐个提取 T。
+template <typename T, typename BuilderT>
+static std::vector<T> PythonArrayToVector(
+    boost::python::object input,
+    size_t components,
+    BuilderT &&builder) {
+  namespace py = boost::python;
+  std::vector<T> result;
+  if (PyObject_CheckBuffer(input.ptr())) {
+    Py_buffer view;
+    if (PyObject_GetBuffer(input.ptr(), &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) {
+      py::throw_error_already_set();
+    }
+    const std::string format = view.format != nullptr ? view.format : "B";
+    const bool is_float = (format == "f" || format == "<f");
+    const bool is_double = (format == "d" || format == "<d");
+    const size_t item_count = static_cast<size_t>(view.len / view.itemsize);
+    if ((!is_float && !is_double) || (item_count % components) != 0u) {
+      PyBuffer_Release(&view);
+      PyErr_SetString(PyExc_TypeError, "expected a contiguous float32/float64 array of shape (N, components)");
+      py::throw_error_already_set();
+    }
+    const size_t count = item_count / components;
+    result.reserve(count);
+    std::vector<double> values(components);
+    for (size_t i = 0u; i < count; ++i) {
+      for (size_t j = 0u; j < components; ++j) {
+        const size_t k = i * components + j;
+        values[j] = is_float ?
+            static_cast<double>(static_cast<const float *>(view.buf)[k]) :
+            static_cast<const double *>(view.buf)[k];
+      }
+      result.emplace_back(builder(values.data()));
+    }
+    PyBuffer_Release(&view);
+    return result;
+  }
+  const auto size = py::len(input);
+  result.reserve(static_cast<size_t>(size));
+  for (py::ssize_t i = 0; i < size; ++i) {
+    result.emplace_back(py::extract<T>(input[i])());
+  }
+  return result;
+}
+
+// 将一段连续内存复制为 Python bytes 对象，可以直接用 numpy.frombuffer 读取。
+static boost::python::object MakePythonBytes(const void *data, size_t size) {
+  auto *ptr = PyBytes_FromStringAndSize(static_cast<const char *>(data), static_cast<Py_ssize_t>(size));
+  if (ptr == nullptr) {
+    boost::python::throw_error_already_set();
+  }
+  return boost::python::object(boost::python::handle<>(ptr));
+}
+
+template <typename T>
+static boost::python::object VectorToPythonBytes(const std::vector<T> &data) {
+  static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+  return MakePythonBytes(data.data(), sizeof(T) * data.size());
+}
+
 // 17个模块的源代码文件+1个RSS模块
 #include "V2XData.cpp"
 #include "Geom.cpp"
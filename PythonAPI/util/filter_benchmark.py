@@ -0,0 +1,110 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2024 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+"""Measures the cost of carla.ActorList.filter and carla.BlueprintLibrary.filter.
+
+Spawns a large number of static props (10000 by default) so the actor list
+has the size of a dense scene, then times repeated filter calls with a few
+common patterns. The spawned props are destroyed on exit.
+"""
+
+import glob
+import os
+import sys
+
+try:
+    sys.path.append(glob.glob('../carla/dist/carla-*%d.%d-%s.egg' % (
+        sys.version_info.major,
+        sys.version_info.minor,
+        'win-amd64' if os.name == 'nt' else 'linux-x86_64'))[0])
+except IndexError:
+    pass
+
+import carla
+
+import argparse
+import random
+import time
+
+
+PATTERNS = ['vehicle.*', '*walker*', 'static.prop.*', 'traffic.traffic_light', '*']
+
+
+def time_calls(function, iterations):
+    """Returns the mean time in milliseconds of calling function()."""
+    t0 = time.perf_counter()
+    for _ in range(iterations):
+        result = function()
+    return 1000.0 * (time.perf_counter() - t0) / iterations, result
+
+
+def main():
+    argparser = argparse.ArgumentParser(
+        description=__doc__)
+    argparser.add_argument(
+        '--host',
+        metavar='H',
+        default='127.0.0.1',
+        help='IP of the host server (default: 127.0.0.1)')
+    argparser.add_argument(
+        '-p', '--port',
+        metavar='P',
+        default=2000,
+        type=int,
+        help='TCP port to listen to (default: 2000)')
+    argparser.add_argument(
+        '-n', '--number-of-actors',
+        metavar='N',
+        default=10000,
+        type=int,
+        help='number of static props to spawn (default: 10000)')
+    argparser.add_argument(
+        '-i', '--iterations',
+        metavar='I',
+        default=100,
+        type=int,
+        help='filter calls per pattern (default: 100)')
+    args = argparser.parse_args()
+
+    client = carla.Client(args.host, args.port)
+    client.set_timeout(60.0)
+    world = client.get_world()
+    library = world.get_blueprint_library()
+
+    props = library.filter('static.prop.*')
+    spawn_points = world.get_map().get_spawn_points()
+    batch = []
+    for n in range(args.number_of_actors):
+        transform = random.choice(spawn_points)
+        transform.location.z += 50.0 + 2.0 * n
+        batch.append(carla.command.SpawnActor(random.choice(props), transform))
+    actor_ids = [r.actor_id for r in client.apply_batch_sync(batch) if not r.error]
+
+    try:
+        world.wait_for_tick()
+        actors = world.get_actors()
+        print('actors in the world: %d' % len(actors))
+        for pattern in PATTERNS:
+            # 第一次调用会构建列表的类型索引
+            first, _ = time_calls(lambda: actors.filter(pattern), 1)
+            mean, result = time_calls(lambda: actors.filter(pattern), args.iterations)
+            print('ActorList.filter(%r): %d actors, first %.3f ms, mean %.3f ms' % (
+                pattern, len(result), first, mean))
+        for pattern in PATTERNS:
+            mean, result = time_calls(lambda: library.filter(pattern), args.iterations)
+            print('BlueprintLibrary.filter(%r): %d blueprints, mean %.3f ms' % (
+                pattern, len(result), mean))
+    finally:
+        client.apply_batch([carla.command.DestroyActor(x) for x in actor_ids])
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        print('\ndone.')
@@ -164,7 +164,7 @@ void FCarlaEngine::NotifyInitGame(const UCarlaSettings &Settings)
             carla::streaming::detail::token_type token(Server.GetStreamingServer().GetToken(sensor_id));
             carla::Buffer buf(reinterpret_cast<unsigned char *>(&token), (size_t) sizeof(token));
             carla::log_info("responding with a token for port ", token.get_port());
-            Secondary->Write(std::move(buf));
+            Secondary->GetCommander().send_response(carla::multigpu::MultiGPUCommand::GET_TOKEN, std::move(buf));
             break;
           }
           case carla::multigpu::MultiGPUCommand::YOU_ALIVE:
@@ -172,7 +172,7 @@ void FCarlaEngine::NotifyInitGame(const UCarlaSettings &Settings)
             std::string msg("Yes, I'm alive");
             carla::Buffer buf((unsigned char *) msg.c_str(), (size_t) msg.size());
             carla::log_info("responding is alive command");
-            Secondary->Write(std::move(buf));
+            Secondary->GetCommander().send_response(carla::multigpu::MultiGPUCommand::YOU_ALIVE, std::move(buf));
             break;
           }
           case carla::multigpu::MultiGPUCommand::ENABLE_ROS:
@@ -185,7 +185,7 @@ void FCarlaEngine::NotifyInitGame(const UCarlaSettings &Settings)
             bool res = true;
             carla::Buffer buf(reinterpret_cast<unsigned char *>(&res), (size_t) sizeof(bool));
             carla::log_info("responding ENABLE_ROS with a true");
-            Secondary->Write(std::move(buf));
+            Secondary->GetCommander().send_response(carla::multigpu::MultiGPUCommand::ENABLE_ROS, std::move(buf));
             break;
           }
           case carla::multigpu::MultiGPUCommand::DISABLE_ROS:
@@ -198,7 +198,7 @@ void FCarlaEngine::NotifyInitGame(const UCarlaSettings &Settings)
             bool res = true;
             carla::Buffer buf(reinterpret_cast<unsigned char *>(&res), (size_t) sizeof(bool));
             carla::log_info("responding DISABLE_ROS with a true");
-            Secondary->Write(std::move(buf));
+            Secondary->GetCommander().send_response(carla::multigpu::MultiGPUCommand::DISABLE_ROS, std::move(buf));
             break;
           }
           case carla::multigpu::MultiGPUCommand::IS_ENABLED_ROS:
@@ -209,7 +209,7 @@ void FCarlaEngine::NotifyInitGame(const UCarlaSettings &Settings)
             bool res = Server.GetStreamingServer().IsEnabledForROS(sensor_id);
             carla::Buffer buf(reinterpret_cast<unsigned char *>(&res), (size_t) sizeof(bool));
             carla::log_info("responding IS_ENABLED_ROS with: ", res);
-            Secondary->Write(std::move(buf));
+            Secondary->GetCommander().send_response(carla::multigpu::MultiGPUCommand::IS_ENABLED_ROS, std::move(buf));
             break;
           }
         }
@@ -321,6 +321,7 @@ void FCarlaEngine::OnPreTick(UWorld *, ELevelTick TickType, float DeltaSeconds)
         Server.RunSome(1u);
       }
       while (!FramesToProcess.size());
+      SecondaryFrameStartSeconds = FPlatformTime::Seconds();
     }
 
     // 更新帧计数器
@@ -354,6 +355,8 @@ void FCarlaEngine::OnPostTick(UWorld *World, ELevelTick TickType, float DeltaSec
     if (bIsPrimaryServer)
     {
       if (SecondaryServer->HasClientsConnected()) {
+        // 有新连接时发送完整的帧，新的辅助服务器没有差异的基准
+        const bool bKeyFrame = bNewConnection;
         GetCurrentEpisode()->GetFrameData().GetFrameData(GetCurrentEpisode(), true, bNewConnection);
         bNewConnection = false;
         std::ostringstream OutStream;
@@ -361,7 +364,7 @@ void FCarlaEngine::OnPostTick(UWorld *World, ELevelTick TickType, float DeltaSec
 
         // 将帧数据发送到次级服务器
         std::string Tmp(OutStream.str());
-        SecondaryServer->GetCommander().SendFrameData(carla::Buffer(std::move((unsigned char *) Tmp.c_str()), (size_t) Tmp.size()));
+        SecondaryServer->GetCommander().SendFrameData(carla::Buffer(std::move((unsigned char *) Tmp.c_str()), (size_t) Tmp.size()), bKeyFrame);
 
         GetCurrentEpisode()->GetFrameData().Clear();
       }
@@ -393,6 +396,18 @@ void FCarlaEngine::OnPostTick(UWorld *World, ELevelTick TickType, float DeltaSec
     //2·虚拟现实和增强现实：在这些环境中，世界快照可以帮助记录用户的位置和交互，便于分析和重现体验。
     WorldObserver.BroadcastTick(*CurrentEpisode, DeltaSeconds, bMapChanged, LightUpdatePending);
     CurrentEpisode->GetSensorManager().PostPhysTick(World, TickType, DeltaSeconds);
+
+    // 次级服务器向主服务器报告本帧的处理时间和排队的帧数，主服务器据此放置新的传感器
+    if (!bIsPrimaryServer && Secondary)
+    {
+      const float FrameTimeMs = static_cast<float>((FPlatformTime::Seconds() - SecondaryFrameStartSeconds) * 1000.0);
+      uint32_t PendingFrames;
+      {
+        std::lock_guard<std::mutex> Lock(FrameToProcessMutex);
+        PendingFrames = static_cast<uint32_t>(FramesToProcess.size());
+      }
+      Secondary->GetCommander().send_load_report(FCarlaEngine::FrameCounter, FrameTimeMs, PendingFrames);
+    }
     ResetSimulationState();
   }
 }
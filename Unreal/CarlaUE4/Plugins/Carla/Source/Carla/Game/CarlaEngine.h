@@ -51,6 +51,11 @@ public:
   {
     return Server;
   }
+  // [获取世界观察者]
+  FWorldObserver &GetWorldObserver()
+  {
+    return WorldObserver;
+  }
   // [获取当前剧情]
  // 获取当前的UCarlaEpisode实例
 UCarlaEpisode *GetCurrentEpisode()
@@ -146,6 +151,7 @@ std::shared_ptr<carla::multigpu::Secondary> Secondary; // 次级实例的共享
 
 std::vector<FFrameData> FramesToProcess; // 待处理帧数据的向量
 std::mutex FrameToProcessMutex; // 帧数据处理的互斥锁
+double SecondaryFrameStartSeconds = 0.0; // 次级服务器开始处理当前帧的时间，用于负载报告
 };
 
 // Note: this has a circular dependency with FCarlaEngine; it must be included late.
@@ -67,6 +67,13 @@ public:
     return Stream->AreClientsListening();
   }
 
+  /// 返回订阅过此流的客户端会话总数，有新客户端订阅时增加。
+  uint64_t GetSessionConnections() const
+  {
+    check(Stream.has_value());
+    return Stream->GetSessionConnections();
+  }
+
 private:
 
   boost::optional<StreamType> Stream;
@@ -62,10 +62,14 @@ void ARayCastLidar::PostPhysTick(UWorld *World, ELevelTick TickType, float Delta
 
   auto DataStream = GetDataStream(*this);
   auto SensorTransform = DataStream.GetSensorTransform();
+  carla::SharedBufferView BufView;
 
   {
     TRACE_CPUPROFILER_EVENT_SCOPE_STR("Send Stream");
-    DataStream.SerializeAndSend(*this, LidarData, DataStream.PopBufferFromPool());
+    // Serialize once; the same view is sent to the client and published to ROS2.
+    carla::Buffer Data(carla::sensor::SensorRegistry::Serialize(*this, LidarData, DataStream.PopBufferFromPool()));
+    BufView = carla::BufferView::CreateFrom(std::move(Data));
+    DataStream.Send(*this, BufView);
   }
   // ROS2
   #if defined(WITH_ROS2)
@@ -78,11 +82,11 @@ void ARayCastLidar::PostPhysTick(UWorld *World, ELevelTick TickType, float Delta
     if (ParentActor)
     {
       FTransform LocalTransformRelativeToParent = GetActorTransform().GetRelativeTransform(ParentActor->GetActorTransform());
-      ROS2->ProcessDataFromLidar(DataStream.GetSensorType(), StreamId, LocalTransformRelativeToParent, LidarData, this);
+      ROS2->ProcessDataFromLidar(DataStream.GetSensorType(), StreamId, LocalTransformRelativeToParent, BufView, this);
     }
     else
     {
-      ROS2->ProcessDataFromLidar(DataStream.GetSensorType(), StreamId, SensorTransform, LidarData, this);
+      ROS2->ProcessDataFromLidar(DataStream.GetSensorType(), StreamId, SensorTransform, BufView, this);
     }
   }
   #endif
@@ -72,9 +72,13 @@ void ARayCastSemanticLidar::PostPhysTick(UWorld *World, ELevelTick TickType, flo
 
   auto DataStream = GetDataStream(*this);
   auto SensorTransform = DataStream.GetSensorTransform();
+  carla::SharedBufferView BufView;
   {
     TRACE_CPUPROFILER_EVENT_SCOPE_STR("Send Stream");
-    DataStream.SerializeAndSend(*this, SemanticLidarData, DataStream.PopBufferFromPool());
+    // Serialize once; the same view is sent to the client and published to ROS2.
+    carla::Buffer Data(carla::sensor::SensorRegistry::Serialize(*this, SemanticLidarData, DataStream.PopBufferFromPool()));
+    BufView = carla::BufferView::CreateFrom(std::move(Data));
+    DataStream.Send(*this, BufView);
   }
   // ROS2
   #if defined(WITH_ROS2)
@@ -87,11 +91,11 @@ void ARayCastSemanticLidar::PostPhysTick(UWorld *World, ELevelTick TickType, flo
     if (ParentActor)
     {
       FTransform LocalTransformRelativeToParent = GetActorTransform().GetRelativeTransform(ParentActor->GetActorTransform());
-      ROS2->ProcessDataFromSemanticLidar(DataStream.GetSensorType(), StreamId, LocalTransformRelativeToParent, SemanticLidarData, this);
+      ROS2->ProcessDataFromSemanticLidar(DataStream.GetSensorType(), StreamId, LocalTransformRelativeToParent, BufView, this);
     }
     else
     {
-      ROS2->ProcessDataFromSemanticLidar(DataStream.GetSensorType(), StreamId, SensorTransform, SemanticLidarData, this);
+      ROS2->ProcessDataFromSemanticLidar(DataStream.GetSensorType(), StreamId, SensorTransform, BufView, this);
     }
   }
   #endif
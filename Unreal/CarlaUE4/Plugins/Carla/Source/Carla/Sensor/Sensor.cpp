@@ -120,6 +120,13 @@ void ASensor::EndPlay(EEndPlayReason::Type EndPlayReason)
   auto StreamId = carla::streaming::detail::token_type(Stream.GetToken()).get_stream_id();
   StreamingServer.CloseStream(StreamId);
 
+  // release the sensor's load on the secondary server it was placed on
+  auto SecondaryServer = GameInstance->GetServer().GetSecondaryServer();
+  if (SecondaryServer)
+  {
+    SecondaryServer->GetCommander().ReleaseToken(StreamId);
+  }
+
   UCarlaEpisode* Episode = UCarlaStatics::GetCurrentEpisode(GetWorld());
   if(Episode)
   {
@@ -22,6 +22,8 @@
 #include "CoreGlobals.h"
 
 #include <compiler/disable-ue4-macros.h>
+#include <carla/MsgPack.h>
+#include <carla/geom/Math.h>
 #include <carla/rpc/String.h>
 #include <carla/sensor/SensorRegistry.h>
 #include <carla/sensor/data/ActorDynamicState.h>
@@ -265,51 +267,39 @@ static carla::geom::Vector3D FWorldObserver_GetAcceleration(
   return {Acceleration.X, Acceleration.Y, Acceleration.Z};
 }
 
-static carla::Buffer FWorldObserver_Serialize(
-    carla::Buffer &&buffer,
+static carla::rpc::ActorTypeMask FWorldObserver_GetActorTypeMask(FCarlaActor::ActorType Type)
+{
+  using AType = FCarlaActor::ActorType;
+  using Mask = carla::rpc::ActorTypeMask;
+  switch (Type)
+  {
+    case AType::Vehicle:      return Mask::Vehicle;
+    case AType::Walker:       return Mask::Walker;
+    case AType::TrafficLight: return Mask::TrafficLight;
+    case AType::TrafficSign:  return Mask::TrafficSign;
+    case AType::Sensor:       return Mask::Sensor;
+    default:                  return Mask::Other;
+  }
+}
+
+/// Collects the state of every actor in the registry. @a OutTypes receives the
+/// type of each actor, in the same order, for the filtered streams.
+static TArray<carla::sensor::data::ActorDynamicState> FWorldObserver_GatherActorStates(
     const UCarlaEpisode &Episode,
     float DeltaSeconds,
-    bool MapChange,
-    bool PendingLightUpdates)
+    TArray<carla::rpc::ActorTypeMask> &OutTypes)
 {
   TRACE_CPUPROFILER_EVENT_SCOPE_STR(__FUNCTION__);
-  using Serializer = carla::sensor::s11n::EpisodeStateSerializer;
-  using SimulationState = carla::sensor::s11n::EpisodeStateSerializer::SimulationState;
   using ActorDynamicState = carla::sensor::data::ActorDynamicState;
 
-
   const FActorRegistry &Registry = Episode.GetActorRegistry();
 
-  auto total_size = sizeof(Serializer::Header) + sizeof(ActorDynamicState) * Registry.Num();
-  auto current_size = 0;
-  // Set up buffer for writing.
-  buffer.reset(total_size);
-  auto write_data = [&current_size, &buffer](const auto &data)
-  {
-    auto begin = buffer.begin() + current_size;
-    std::memcpy(begin, &data, sizeof(data));
-    current_size += sizeof(data);
-  };
+  TArray<ActorDynamicState> States;
+  States.Reserve(Registry.Num());
+  OutTypes.Reset(Registry.Num());
 
   constexpr float TO_METERS = 1e-2;
 
-  // Write header.
-  Serializer::Header header;
-  header.episode_id = Episode.GetId();
-  header.platform_timestamp = FPlatformTime::Seconds();
-  header.delta_seconds = DeltaSeconds;
-  FIntVector MapOrigin = Episode.GetCurrentMapOrigin();
-  FIntVector MapOriginInMeters = MapOrigin / 100;
-  header.map_origin = carla::geom::Vector3DInt{ MapOriginInMeters.X, MapOriginInMeters.Y, MapOriginInMeters.Z };
-
-  uint8_t simulation_state = (SimulationState::MapChange * MapChange);
-  simulation_state |= (SimulationState::PendingLightUpdate * PendingLightUpdates);
-
-  header.simulation_state = static_cast<SimulationState>(simulation_state);
-
-  write_data(header);
-
-  // Write every actor.
   for (auto& It : Registry)
   {
     const FCarlaActor* View = It.Value.Get();
@@ -353,6 +343,166 @@ static carla::Buffer FWorldObserver_Serialize(
       Acceleration,
       State,
     };
+    States.Add(info);
+    OutTypes.Add(FWorldObserver_GetActorTypeMask(View->GetActorType()));
+  }
+  return States;
+}
+
+/// Selects the states that pass @a Filter. The ego actor is always included;
+/// if it does not exist the radius is ignored. The ids of the actors left out
+/// are added to @a OutFilteredOutIds, they still exist and the clients must
+/// not treat them as destroyed.
+static TArray<carla::sensor::data::ActorDynamicState> FWorldObserver_FilterActorStates(
+    const TArray<carla::sensor::data::ActorDynamicState> &States,
+    const TArray<carla::rpc::ActorTypeMask> &Types,
+    const carla::rpc::EpisodeStateFilter &Filter,
+    TArray<uint32> &OutFilteredOutIds)
+{
+  using ActorDynamicState = carla::sensor::data::ActorDynamicState;
+
+  bool bUseRadius = false;
+  carla::geom::Location EgoLocation;
+  if (Filter.HasRadius())
+  {
+    for (const ActorDynamicState &State : States)
+    {
+      if (State.id == Filter.ego_id)
+      {
+        EgoLocation = State.transform.location;
+        bUseRadius = true;
+        break;
+      }
+    }
+  }
+  const float RadiusSquared = Filter.radius * Filter.radius;
+
+  TArray<ActorDynamicState> Filtered;
+  for (int32 i = 0; i < States.Num(); ++i)
+  {
+    const ActorDynamicState &State = States[i];
+    if (State.id != Filter.ego_id)
+    {
+      if (!Filter.IsTypeAllowed(Types[i]))
+      {
+        OutFilteredOutIds.Add(State.id);
+        continue;
+      }
+      if (bUseRadius &&
+          carla::geom::Math::DistanceSquared(EgoLocation, State.transform.location) > RadiusSquared)
+      {
+        OutFilteredOutIds.Add(State.id);
+        continue;
+      }
+    }
+    Filtered.Add(State);
+  }
+  return Filtered;
+}
+
+/// Writes the header followed by @a States. When @a RemovedIds is not null the
+/// message is a delta on top of @a BaseFrame and carries only the given
+/// (changed) states and the ids of the actors destroyed since then. When
+/// @a Descriptions is not null it is written before the states, it contains
+/// the packed descriptions of the newly spawned actors. When @a FilteredOutIds
+/// is not null the ids of the existing actors without state are written
+/// before the descriptions.
+static carla::Buffer FWorldObserver_Serialize(
+    carla::Buffer &&buffer,
+    const UCarlaEpisode &Episode,
+    float DeltaSeconds,
+    bool MapChange,
+    bool PendingLightUpdates,
+    const TArray<carla::sensor::data::ActorDynamicState> &States,
+    const TArray<uint32> *RemovedIds,
+    uint64 BaseFrame,
+    const carla::Buffer *Descriptions = nullptr,
+    const TArray<uint32> *FilteredOutIds = nullptr)
+{
+  TRACE_CPUPROFILER_EVENT_SCOPE_STR(__FUNCTION__);
+  using Serializer = carla::sensor::s11n::EpisodeStateSerializer;
+  using SimulationState = carla::sensor::s11n::EpisodeStateSerializer::SimulationState;
+  using ActorDynamicState = carla::sensor::data::ActorDynamicState;
+
+  const bool bDelta = (RemovedIds != nullptr);
+
+  auto total_size = sizeof(Serializer::Header) + sizeof(ActorDynamicState) * States.Num();
+  if (bDelta)
+  {
+    total_size += sizeof(Serializer::DeltaHeader) + sizeof(carla::ActorId) * RemovedIds->Num();
+  }
+  if (FilteredOutIds != nullptr)
+  {
+    total_size += sizeof(Serializer::FilteredOutHeader) + sizeof(carla::ActorId) * FilteredOutIds->Num();
+  }
+  if (Descriptions != nullptr)
+  {
+    total_size += sizeof(Serializer::DescriptionsHeader) + Descriptions->size();
+  }
+  auto current_size = 0;
+  // Set up buffer for writing.
+  buffer.reset(total_size);
+  auto write_data = [&current_size, &buffer](const auto &data)
+  {
+    auto begin = buffer.begin() + current_size;
+    std::memcpy(begin, &data, sizeof(data));
+    current_size += sizeof(data);
+  };
+
+  // Write header.
+  Serializer::Header header;
+  header.episode_id = Episode.GetId();
+  header.platform_timestamp = FPlatformTime::Seconds();
+  header.delta_seconds = DeltaSeconds;
+  FIntVector MapOrigin = Episode.GetCurrentMapOrigin();
+  FIntVector MapOriginInMeters = MapOrigin / 100;
+  header.map_origin = carla::geom::Vector3DInt{ MapOriginInMeters.X, MapOriginInMeters.Y, MapOriginInMeters.Z };
+
+  uint8_t simulation_state = (SimulationState::MapChange * MapChange);
+  simulation_state |= (SimulationState::PendingLightUpdate * PendingLightUpdates);
+  simulation_state |= (SimulationState::Delta * bDelta);
+  simulation_state |= (SimulationState::ActorDescriptions * (Descriptions != nullptr));
+  simulation_state |= (SimulationState::FilteredOutActors * (FilteredOutIds != nullptr));
+
+  header.simulation_state = static_cast<SimulationState>(simulation_state);
+
+  write_data(header);
+
+  if (bDelta)
+  {
+    Serializer::DeltaHeader delta_header;
+    delta_header.base_frame = BaseFrame;
+    delta_header.removed_count = RemovedIds->Num();
+    write_data(delta_header);
+    for (uint32 Id : *RemovedIds)
+    {
+      write_data(carla::ActorId{Id});
+    }
+  }
+
+  if (FilteredOutIds != nullptr)
+  {
+    Serializer::FilteredOutHeader filtered_out_header;
+    filtered_out_header.count = FilteredOutIds->Num();
+    write_data(filtered_out_header);
+    for (uint32 Id : *FilteredOutIds)
+    {
+      write_data(carla::ActorId{Id});
+    }
+  }
+
+  if (Descriptions != nullptr)
+  {
+    Serializer::DescriptionsHeader descriptions_header;
+    descriptions_header.size = Descriptions->size();
+    write_data(descriptions_header);
+    std::memcpy(buffer.begin() + current_size, Descriptions->data(), Descriptions->size());
+    current_size += Descriptions->size();
+  }
+
+  // Write every actor.
+  for (const ActorDynamicState &info : States)
+  {
     write_data(info);
   }
 
@@ -371,18 +521,192 @@ void FWorldObserver::BroadcastTick(
     bool PendingLightUpdates)
 {
   TRACE_CPUPROFILER_EVENT_SCOPE_STR(__FUNCTION__);
+  using Serializer = carla::sensor::s11n::EpisodeStateSerializer;
+  using ActorDynamicState = carla::sensor::data::ActorDynamicState;
 
   if (!Stream.IsStreamReady())
+  {
+    // Nobody received this frame, the next message must be a keyframe.
+    ResetDeltaState();
     return;
+  }
 
   auto AsyncStream = Stream.MakeAsyncDataStream(*this, Episode.GetElapsedGameTime());
 
-  carla::Buffer buffer = FWorldObserver_Serialize(
-      AsyncStream.PopBufferFromPool(),
-      Episode,
-      DeltaSecond,
-      MapChange,
-      PendingLightUpdates);
+  TArray<carla::rpc::ActorTypeMask> Types;
+  TArray<ActorDynamicState> States = FWorldObserver_GatherActorStates(Episode, DeltaSecond, Types);
+
+  // Push the description of the actors spawned since the last tick, so the
+  // clients do not have to request them.
+  if (AnnouncedEpisodeId != Episode.GetId())
+  {
+    AnnouncedActorIds.Reset();
+    AnnouncedEpisodeId = Episode.GetId();
+  }
+  std::vector<carla::rpc::Actor> NewActors;
+  const FActorRegistry &Registry = Episode.GetActorRegistry();
+  for (const ActorDynamicState &State : States)
+  {
+    bool bAlreadyAnnounced = false;
+    AnnouncedActorIds.Add(State.id, &bAlreadyAnnounced);
+    if (!bAlreadyAnnounced)
+    {
+      // SerializeActor only reads the actor.
+      NewActors.emplace_back(Episode.SerializeActor(
+          const_cast<FCarlaActor *>(Registry.FindCarlaActor(State.id))));
+    }
+  }
+  if (AnnouncedActorIds.Num() > States.Num())
+  {
+    // Forget the destroyed actors.
+    AnnouncedActorIds.Reset();
+    for (const ActorDynamicState &State : States)
+    {
+      AnnouncedActorIds.Add(State.id);
+    }
+  }
+  carla::Buffer Descriptions;
+  if (!NewActors.empty())
+  {
+    Descriptions = carla::MsgPack::Pack(NewActors);
+  }
+  const carla::Buffer *DescriptionsPtr = NewActors.empty() ? nullptr : &Descriptions;
+
+  // Filtered streams always receive complete (filtered) frames, their set of
+  // actors changes as the ego moves so there is no common base for deltas.
+  // They get every new description, an actor spawned outside the area of
+  // interest may enter it later.
+  for (auto It = FilteredStreams.CreateIterator(); It; ++It)
+  {
+    FFilteredStream &Filtered = It.Value();
+    if (!Filtered.Stream.IsStreamReady())
+    {
+      It.RemoveCurrent();
+      continue;
+    }
+    if (!Filtered.Stream.AreClientsListening())
+    {
+      // The client subscribed and went away without closing the stream (e.g.
+      // it disconnected or the close request failed during a map change), or
+      // it never managed to subscribe.
+      if (Filtered.Stream.GetSessionConnections() > 0u ||
+          ++Filtered.IdleFrames >= FilteredStreamIdleFrames)
+      {
+        It.RemoveCurrent();
+      }
+      continue;
+    }
+    TArray<uint32> FilteredOutIds;
+    TArray<ActorDynamicState> FilteredStates =
+        FWorldObserver_FilterActorStates(States, Types, Filtered.Filter, FilteredOutIds);
+    auto FilteredAsyncStream = Filtered.Stream.MakeAsyncDataStream(*this, Episode.GetElapsedGameTime());
+    carla::Buffer FilteredBuffer = FWorldObserver_Serialize(
+        FilteredAsyncStream.PopBufferFromPool(),
+        Episode,
+        DeltaSecond,
+        MapChange,
+        PendingLightUpdates,
+        FilteredStates,
+        nullptr,
+        0u,
+        DescriptionsPtr,
+        &FilteredOutIds);
+    FilteredAsyncStream.SerializeAndSend(*this, std::move(FilteredBuffer));
+  }
+
+  // A client that subscribed since the last tick (late joiner, second client
+  // or reconnect) drops every delta until it gets a keyframe.
+  const uint64 SessionConnections = Stream.GetSessionConnections();
+  const bool bNewClient = (SessionConnections != LastSessionConnections);
+  LastSessionConnections = SessionConnections;
+
+  const uint32 KeyframeInterval = Episode.GetSettings().StateKeyframeInterval;
+  const uint64 Frame = FCarlaEngine::GetFrameCounter();
+  const bool bKeyframe =
+      (KeyframeInterval == 0u) ||
+      !bHasSentState ||
+      bNewClient ||
+      MapChange ||
+      (LastSentEpisodeId != Episode.GetId()) ||
+      (FramesSinceKeyframe + 1u >= KeyframeInterval);
+
+  carla::Buffer buffer;
+  if (bKeyframe)
+  {
+    buffer = FWorldObserver_Serialize(
+        AsyncStream.PopBufferFromPool(),
+        Episode,
+        DeltaSecond,
+        MapChange,
+        PendingLightUpdates,
+        States,
+        nullptr,
+        0u,
+        DescriptionsPtr);
+    FramesSinceKeyframe = 0u;
+  }
+  else
+  {
+    // Keep only the actors that changed since the last sent frame.
+    TArray<ActorDynamicState> Changed;
+    TSet<uint32> CurrentIds;
+    CurrentIds.Reserve(States.Num());
+    for (int32 i = 0; i < States.Num(); ++i)
+    {
+      const ActorDynamicState &State = States[i];
+      CurrentIds.Add(State.id);
+      const ActorDynamicState *Previous = LastSentStates.Find(State.id);
+      if (Previous == nullptr || Serializer::HasChanged(*Previous, State, Types[i]))
+      {
+        Changed.Add(State);
+      }
+    }
+    TArray<uint32> RemovedIds;
+    for (const auto &Item : LastSentStates)
+    {
+      if (!CurrentIds.Contains(Item.Key))
+      {
+        RemovedIds.Add(Item.Key);
+      }
+    }
+    buffer = FWorldObserver_Serialize(
+        AsyncStream.PopBufferFromPool(),
+        Episode,
+        DeltaSecond,
+        MapChange,
+        PendingLightUpdates,
+        Changed,
+        &RemovedIds,
+        LastSentFrame,
+        DescriptionsPtr);
+    ++FramesSinceKeyframe;
+    States = MoveTemp(Changed);
+    for (uint32 Id : RemovedIds)
+    {
+      LastSentStates.Remove(Id);
+    }
+  }
+
+  if (KeyframeInterval > 0u)
+  {
+    // Remember what the clients know; unchanged actors keep the state last
+    // sent so small drifts accumulate until they cross the threshold.
+    if (bKeyframe)
+    {
+      LastSentStates.Reset();
+    }
+    for (const ActorDynamicState &State : States)
+    {
+      LastSentStates.Add(State.id, State);
+    }
+    LastSentFrame = Frame;
+    LastSentEpisodeId = Episode.GetId();
+    bHasSentState = true;
+  }
+  else if (bHasSentState)
+  {
+    ResetDeltaState();
+  }
 
   AsyncStream.SerializeAndSend(*this, std::move(buffer));
 }
@@ -8,6 +8,11 @@
 
 #include "Carla/Sensor/DataStream.h"
 
+#include <compiler/disable-ue4-macros.h>
+#include <carla/rpc/EpisodeStateFilter.h>
+#include <carla/sensor/data/ActorDynamicState.h>
+#include <compiler/enable-ue4-macros.h>
+
 class UCarlaEpisode;
 
 /// Serializes and sends all the actors in the current UCarlaEpisode.
@@ -38,6 +43,20 @@ public:
     bool MapChange,
     bool PendingLightUpdate);
 
+  /// Add a stream that only receives the actors that pass @a Filter. The
+  /// filter is applied before serialization, every message is a keyframe.
+  void AddFilteredStream(FDataStream InStream, const carla::rpc::EpisodeStateFilter &Filter)
+  {
+    const uint64 StreamId = InStream.GetSensorType();
+    FilteredStreams.Add(StreamId, FFilteredStream{std::move(InStream), Filter});
+  }
+
+  /// Stop sending to the filtered stream with the given id.
+  void RemoveFilteredStream(uint64 StreamId)
+  {
+    FilteredStreams.Remove(StreamId);
+  }
+
   /// Dummy. Required for compatibility with other sensors only.
   FTransform GetActorTransform() const
   {
@@ -46,5 +65,49 @@ public:
 
 private:
 
+  /// Forget the last sent states so the next tick sends a keyframe.
+  void ResetDeltaState()
+  {
+    LastSentStates.Reset();
+    FramesSinceKeyframe = 0u;
+    bHasSentState = false;
+  }
+
   FDataMultiStream Stream;
+
+  struct FFilteredStream
+  {
+    FDataStream Stream;
+    carla::rpc::EpisodeStateFilter Filter;
+    /// Frames since the stream was opened while nobody has subscribed yet.
+    uint32 IdleFrames = 0u;
+  };
+
+  /// A filtered stream that no client subscribes to within this number of
+  /// frames is dropped (the client failed to subscribe or went away before).
+  static constexpr uint32 FilteredStreamIdleFrames = 600u;
+
+  /// Actors whose description has already been pushed on the main stream.
+  TSet<uint32> AnnouncedActorIds;
+
+  uint64 AnnouncedEpisodeId = 0u;
+
+  /// Per-client streams with an area of interest, by stream id.
+  TMap<uint64, FFilteredStream> FilteredStreams;
+
+  /// State of every actor as last sent to the clients, used to build the
+  /// deltas when the episode settings enable the keyframe interval.
+  TMap<uint32, carla::sensor::data::ActorDynamicState> LastSentStates;
+
+  uint64 LastSentFrame = 0u;
+
+  uint64 LastSentEpisodeId = 0u;
+
+  /// Number of client sessions that had subscribed to the main stream at
+  /// the last tick; a new client has no base frame for the deltas.
+  uint64 LastSessionConnections = 0u;
+
+  uint32 FramesSinceKeyframe = 0u;
+
+  bool bHasSentState = false;
 };
@@ -49,6 +49,7 @@
 #include <carla/rpc/EnvironmentObject.h>
 #include <carla/rpc/EpisodeInfo.h>
 #include <carla/rpc/EpisodeSettings.h>
+#include <carla/rpc/EpisodeStateFilter.h>
 #include <carla/rpc/LabelledPoint.h>
 #include <carla/rpc/LightState.h>
 #include <carla/rpc/MapInfo.h>
@@ -485,6 +486,36 @@ void FCarlaServer::FPimpl::BindActions()
     return cr::EpisodeInfo{Episode->GetId(), BroadcastStream.token()};
   };
 
+  BIND_SYNC(open_filtered_episode_stream) << [this](
+      const cr::EpisodeStateFilter &Filter) -> R<carla::streaming::Token>
+  {
+    REQUIRE_CARLA_EPISODE();
+    UCarlaGameInstance* GameInstance = UCarlaStatics::GetGameInstance(Episode->GetWorld());
+    if (!GameInstance || !GameInstance->GetCarlaEngine())
+    {
+      RESPOND_ERROR("unable to find CARLA game instance");
+    }
+    // 每个订阅一个独立的流，世界观察者在序列化之前按过滤条件筛选参与者
+    carla::streaming::Stream FilteredStream = StreamingServer.MakeStream();
+    auto Token = FilteredStream.token();
+    GameInstance->GetCarlaEngine()->GetWorldObserver().AddFilteredStream(
+        FDataStream(std::move(FilteredStream)), Filter);
+    return Token;
+  };
+
+  BIND_SYNC(close_filtered_episode_stream) << [this](
+      carla::streaming::detail::stream_id_type StreamId) -> R<void>
+  {
+    REQUIRE_CARLA_EPISODE();
+    UCarlaGameInstance* GameInstance = UCarlaStatics::GetGameInstance(Episode->GetWorld());
+    if (!GameInstance || !GameInstance->GetCarlaEngine())
+    {
+      RESPOND_ERROR("unable to find CARLA game instance");
+    }
+    GameInstance->GetCarlaEngine()->GetWorldObserver().RemoveFilteredStream(StreamId);
+    return R<void>::Success();
+  };
+
   BIND_SYNC(get_map_info) << [this]() -> R<cr::MapInfo>
   {
     REQUIRE_CARLA_EPISODE();
@@ -888,7 +919,10 @@ void FCarlaServer::FPimpl::BindActions()
     {
       // multi-gpu
       UE_LOG(LogCarla, Log, TEXT("Sensor %d '%s' created in secondary server"), sensor_id, *Desc);
-      return SecondaryServer->GetCommander().GetToken(sensor_id);
+      // cameras render the scene every frame, the rest are cheap in comparison;
+      // the secondaries' load reports correct for the actual cost
+      const float PlacementCost = Desc.StartsWith(TEXT("sensor.camera.")) ? 4.0f : 1.0f;
+      return SecondaryServer->GetCommander().GetToken(sensor_id, PlacementCost);
     }
     else
     {
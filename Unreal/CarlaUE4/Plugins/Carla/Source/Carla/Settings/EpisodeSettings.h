@@ -68,4 +68,7 @@ struct CARLA_API FEpisodeSettings
     // 设为false则旁观者和自我主体有不同的处理逻辑。
     bool SpectatorAsEgo = true;
 
+    // 世界状态流的关键帧间隔（帧数），0 表示每帧发送完整状态。
+    uint32 StateKeyframeInterval = 0u;
+
 };
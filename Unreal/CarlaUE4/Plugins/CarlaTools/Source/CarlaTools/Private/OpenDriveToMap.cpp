@@ -564,6 +564,22 @@ void UOpenDriveToMap::GenerateRoadMesh( const boost::optional<carla::road::Map>&
   UE_LOG(LogCarlaToolsMapGenerator, Log, TEXT(" GenerateOrderedChunkedMesh code executed in %f seconds. Simplification percentage is %f"), end - start, opg_parameters.simplification_percentage);
 
   start = FPlatformTime::Seconds();
+  // 行车道网格先贴合地形高度（需要在游戏线程中采样），再在共享线程池上并行简化
+  auto DrivingMeshes = Meshes.find(carla::road::Lane::LaneType::Driving);
+  if (DrivingMeshes != Meshes.end())
+  {
+    for (auto& Mesh : DrivingMeshes->second)
+    {
+      for( auto& Vertex : Mesh->GetVertices() )
+      {
+        FVector VertexFVector = Vertex.ToFVector();
+        Vertex.z += GetHeight(Vertex.x, Vertex.y, DistanceToLaneBorder(ParamCarlaMap,VertexFVector) > 65.0f );
+      }
+    }
+    carla::geom::Simplification Simplify(0.15);
+    Simplify.Simplificate(DrivingMeshes->second);
+  }
+
   // 定义一个静态变量index，用于给创建的静态网格演员设置唯一标签
   static int index = 0;
   for (const auto &PairMap : Meshes)
@@ -581,16 +597,8 @@ void UOpenDriveToMap::GenerateRoadMesh( const boost::optional<carla::road::Map>&
         continue;
       }
 
-      if(PairMap.first == carla::road::Lane::LaneType::Driving)
+      if(PairMap.first != carla::road::Lane::LaneType::Driving)
       {
-        for( auto& Vertex : Mesh->GetVertices() )
-        {
-          FVector VertexFVector = Vertex.ToFVector();
-          Vertex.z += GetHeight(Vertex.x, Vertex.y, DistanceToLaneBorder(ParamCarlaMap,VertexFVector) > 65.0f );
-        }
-        carla::geom::Simplification Simplify(0.15);
-        Simplify.Simplificate(Mesh);
-      }else{
         for( auto& Vertex : Mesh->GetVertices() )
         {
           Vertex.z += GetHeight(Vertex.x, Vertex.y, false) + 0.15f;